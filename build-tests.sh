@@ -0,0 +1,24 @@
+#!/bin/bash
+#
+# Build script for C++ hot-path tests
+#
+# Prerequisites (Ubuntu 24.04):
+#   sudo apt-get install -y build-essential libcurl4-openssl-dev libssl-dev
+#
+
+set -e
+
+echo "Building C++ hot-path tests..."
+
+# Create dist directory if not exists
+mkdir -p dist
+
+# Compile with the same optimizations as the production binaries
+g++ -O3 -o dist/test-hotpath src/cpp/test-hotpath.cpp -lcurl -lssl -lcrypto
+
+echo "Build complete: dist/test-hotpath"
+
+# Make executable
+chmod +x dist/test-hotpath
+
+echo "Done!"
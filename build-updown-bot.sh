@@ -15,7 +15,7 @@ mkdir -p dist
 
 # Compile C++ binary
 echo "Compiling src/updown-bot-cpp/updown-bot.cpp..."
-g++ -O3 -o dist/updown-bot-cpp src/updown-bot-cpp/updown-bot.cpp -lcurl -lssl -lcrypto
+g++ -O3 -pthread -o dist/updown-bot-cpp src/updown-bot-cpp/updown-bot.cpp -lcurl -lssl -lcrypto
 
 # Make executable
 chmod +x dist/updown-bot-cpp
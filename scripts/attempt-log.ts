@@ -0,0 +1,315 @@
+/**
+ * Export and query the engine's binary attempt log (updown-bot-attempts.bin)
+ *
+ * The engine appends every attempt of a run to the log (CPP_MODE.ATTEMPT_LOG,
+ * src/cpp/attempt-log.hpp). This tool turns it into:
+ *   stats   latency distribution and outcomes per market/outcome/price
+ *           (--by picks the grouping), time from an order's first send to its fill
+ *   export  --csv <file>: one row per attempt
+ *           --columns <dir>: one little-endian array per column plus schema.json
+ *           (numpy.fromfile(dir + '/latency_us.u32', dtype='<u4')); string columns
+ *           are uint16 codes into the schema's dictionary
+ *   replay  the recorded runs re-run by the engine on a simulated clock
+ *           (src/cpp/replay-sim.hpp) for every combination of the given pacing
+ *           lists; the log or an export --csv file. Prints how close each
+ *           run's replay comes to the recording, then the best combinations
+ *
+ * Usage:
+ *   npm run attempt-log -- stats [--file updown-bot-attempts.bin] [--by market,outcome,price] [--market btc-updown-15m] [--since <unix ms>]
+ *   npm run attempt-log -- export --csv attempts.csv [--file ...] [--market ...] [--since ...]
+ *   npm run attempt-log -- export --columns attempts-columns [--file ...] [--market ...] [--since ...]
+ *   npm run attempt-log -- replay [--file ...] [--interval 1,2,5] [--probe-interval 5,10] [--max-attempts 500,2000]
+ *                              [--delay-shift -2000,0,2000] [--http2] [--top 10]
+ */
+
+import * as fs from 'fs';
+import * as path from 'path';
+import { spawnSync } from 'child_process';
+import { parseArgs } from './mock-clob-server';
+import { AttemptLogEntry, AttemptLogFile, PHASE_NAMES } from '../src/attempt-log';
+
+const DEFAULT_LOG_FILE = path.join(__dirname, '..', 'updown-bot-attempts.bin');
+const CPP_BINARY = path.join(__dirname, '..', 'dist', 'updown-bot-cpp');
+const GROUP_KEYS = ['market', 'outcome', 'price', 'size', 'order'];
+
+interface Row {
+  segment: number;
+  entry: AttemptLogEntry;
+}
+
+function percentile(sorted: number[], p: number): number {
+  if (sorted.length === 0) return 0;
+  return sorted[Math.min(sorted.length - 1, Math.ceil((p / 100) * sorted.length) - 1)];
+}
+
+function readRows(file: string, marketPrefix: string, sinceMs: number): Row[] {
+  const log = new AttemptLogFile(file);
+  const rows: Row[] = [];
+  let segment = 0;
+  let dropped = 0;
+  for (const run of log.segments()) {
+    dropped += run.dropped;
+    for (const entry of run.entries) {
+      if (!entry.order.market.startsWith(marketPrefix) || entry.sentAtMs < sinceMs) continue;
+      rows.push({ segment, entry });
+    }
+    segment++;
+  }
+  console.error(`${file}: ${segment} runs, ${rows.length} attempts` +
+    `${dropped ? `, ${dropped} dropped by the engine` : ''}${log.unread ? `, ${log.unread} torn bytes at the end` : ''}`);
+  return rows;
+}
+
+function groupKey(entry: AttemptLogEntry, by: string[]): string {
+  return by.map((key) => {
+    switch (key) {
+      case 'market': return entry.order.market || '-';
+      case 'outcome': return entry.order.outcome || '-';
+      case 'price': return String(entry.order.price);
+      case 'size': return String(entry.order.size);
+      case 'order': return String(entry.order.orderIndex);
+      default: return '';
+    }
+  }).join(' ');
+}
+
+function printStats(rows: Row[], by: string[]) {
+  const groups = new Map<string, Row[]>();
+  for (const row of rows) {
+    const key = groupKey(row.entry, by);
+    if (!groups.has(key)) groups.set(key, []);
+    groups.get(key)!.push(row);
+  }
+
+  const header = [by.join(' ') || 'all', 'attempts', 'filled', 'not_open', 'rate_ltd', 'errors',
+    'p50_ms', 'p90_ms', 'p99_ms', 'max_ms', 'ttfb_p50_ms', 'fill_after_ms'];
+  const table: string[][] = [header];
+  for (const key of [...groups.keys()].sort()) {
+    const group = groups.get(key)!;
+    const latencies = group.map((row) => row.entry.latencyUs / 1000).sort((a, b) => a - b);
+    const ttfbs = group.filter((row) => row.entry.curlCode === 0)
+      .map((row) => row.entry.phasesUs[PHASE_NAMES.indexOf('ttfb')] / 1000).sort((a, b) => a - b);
+
+    // Per order of a run: first send to the send that filled
+    const firstSend = new Map<string, number>();
+    const fillAfter: number[] = [];
+    for (const { segment, entry } of group) {
+      const order = `${segment}:${entry.order.orderIndex}`;
+      if (!firstSend.has(order)) firstSend.set(order, entry.sentAtMs);
+      if (entry.success) fillAfter.push(entry.sentAtMs - firstSend.get(order)!);
+    }
+    fillAfter.sort((a, b) => a - b);
+
+    const count = (kind: string) => group.filter((row) => row.entry.kind === kind).length;
+    table.push([
+      key || 'all',
+      String(group.length),
+      String(count('filled')),
+      String(count('not_open')),
+      String(count('rate_limited')),
+      String(group.filter((row) => row.entry.curlCode !== 0).length),
+      percentile(latencies, 50).toFixed(1),
+      percentile(latencies, 90).toFixed(1),
+      percentile(latencies, 99).toFixed(1),
+      (latencies[latencies.length - 1] ?? 0).toFixed(1),
+      percentile(ttfbs, 50).toFixed(1),
+      fillAfter.length ? percentile(fillAfter, 50).toFixed(0) : '-',
+    ]);
+  }
+
+  printTable(table);
+}
+
+function printTable(table: string[][]) {
+  const widths = table[0].map((_, c) => Math.max(...table.map((row) => row[c].length)));
+  for (const row of table) {
+    console.log(row.map((cell, c) => (c === 0 ? cell.padEnd(widths[c]) : cell.padStart(widths[c]))).join('  '));
+  }
+}
+
+// key=value pairs of an engine line after its prefix; "recorded:" / "replayed:" prefix their keys
+function parseFields(line: string): Record<string, string> {
+  const fields: Record<string, string> = {};
+  let scope = '';
+  for (const part of line.split(',')) {
+    const [key, value] = part.split('=');
+    const colon = key.lastIndexOf(':');
+    if (colon >= 0) scope = key.slice(0, colon + 1);
+    fields[scope + key.slice(colon + 1)] = value;
+  }
+  return fields;
+}
+
+const list = (value: string | undefined) => (value ? value.split(',').map((v) => parseInt(v)) : undefined);
+
+function replay(file: string, args: Record<string, string>) {
+  if (!fs.existsSync(CPP_BINARY)) {
+    console.error(`Engine not built: ${CPP_BINARY} (bash build-updown-bot.sh)`);
+    process.exit(1);
+  }
+  const job = {
+    replay: file,
+    ...(args['http2'] && { http2: true }),
+    ...(args['interval'] && { replayIntervalMs: list(args['interval']) }),
+    ...(args['probe-interval'] && { replayProbeIntervalMs: list(args['probe-interval']) }),
+    ...(args['max-attempts'] && { replayMaxAttempts: list(args['max-attempts']) }),
+    ...(args['delay-shift'] && { replayDelayShiftMs: list(args['delay-shift']) }),
+  };
+  const engine = spawnSync(CPP_BINARY, [], {
+    input: JSON.stringify(job),
+    encoding: 'utf8',
+    maxBuffer: 256 * 1024 * 1024,
+  });
+  if (engine.status !== 0) {
+    process.stderr.write(engine.stderr || `engine exited with ${engine.status}\n`);
+    process.exit(1);
+  }
+
+  const lines = engine.stdout.split('\n');
+  const runs = lines.filter((line) => line.startsWith('REPLAY:run=')).map((line) => parseFields(line.slice(7)));
+  const model: string[][] = [['run', 'markets', 'limit_rps', 'attempts', 'replayed_attempts', 'ttf_mean_ms',
+    'replayed_ttf_mean_ms']];
+  for (const run of runs) {
+    model.push([run['run'], run['markets'], run['limit_rps'], run['recorded:attempts'], run['replayed:attempts'],
+      run['recorded:ttf_mean_ms'], run['replayed:ttf_mean_ms']]);
+  }
+  console.log('Recorded vs replayed with the recorded pacing:');
+  printTable(model);
+
+  const top = parseInt(args['top'] || '10');
+  const sweep: string[][] = [['rank', 'interval_ms', 'probe_ms', 'max_attempts', 'delay_shift_ms', 'filled',
+    'ttf_mean_ms', 'ttf_p50_ms', 'ttf_p90_ms', 'attempts', 'rate_ltd']];
+  for (const line of lines.filter((l) => l.startsWith('SWEEP:')).slice(0, top)) {
+    const f = parseFields(line.slice(6));
+    sweep.push([f['rank'], f['interval_ms'], f['probe_interval_ms'], f['max_attempts'], f['delay_shift_ms'],
+      `${f['filled']}/${f['orders']}`, f['ttf_mean_ms'], f['ttf_p50_ms'], f['ttf_p90_ms'], f['attempts'],
+      f['rate_limited']]);
+  }
+  console.log('');
+  printTable(sweep);
+  const done = lines.find((line) => line.startsWith('REPLAY:done:'));
+  if (done) {
+    const f = parseFields(done.slice(12));
+    console.log(`\n${f['combinations']} combinations x ${f['runs']} runs ` +
+      `(${f['skipped']} without an open window skipped): ${f['replayed_s']}s replayed in ${f['elapsed_ms']}ms`);
+  }
+}
+
+type ColumnType = 'f64' | 'i32' | 'u32' | 'u16' | 'u8' | 'str';
+
+interface Column {
+  name: string;
+  type: ColumnType;
+  value: (row: Row) => number | string;
+}
+
+const COLUMNS: Column[] = [
+  { name: 'run', type: 'u32', value: (row) => row.segment },
+  { name: 'market', type: 'str', value: (row) => row.entry.order.market },
+  { name: 'outcome', type: 'str', value: (row) => row.entry.order.outcome },
+  { name: 'price', type: 'f64', value: (row) => row.entry.order.price },
+  { name: 'size', type: 'f64', value: (row) => row.entry.order.size },
+  { name: 'order_index', type: 'i32', value: (row) => row.entry.order.orderIndex },
+  { name: 'attempt', type: 'i32', value: (row) => row.entry.attempt },
+  { name: 'sent_ms', type: 'f64', value: (row) => row.entry.sentAtMs },
+  { name: 'server_sent_ms', type: 'f64', value: (row) => row.entry.serverSentAtMs },
+  { name: 'latency_us', type: 'u32', value: (row) => row.entry.latencyUs },
+  { name: 'http_status', type: 'u16', value: (row) => row.entry.httpStatus },
+  { name: 'curl_code', type: 'u8', value: (row) => row.entry.curlCode },
+  { name: 'kind', type: 'str', value: (row) => row.entry.kind },
+  { name: 'error', type: 'str', value: (row) => row.entry.error },
+  { name: 'success', type: 'u8', value: (row) => Number(row.entry.success) },
+  { name: 'planned', type: 'u8', value: (row) => Number(row.entry.planned) },
+  { name: 'reused', type: 'u8', value: (row) => Number(row.entry.reused) },
+  { name: 'resumed', type: 'u8', value: (row) => Number(row.entry.resumed) },
+  { name: 'hedge_copy', type: 'u8', value: (row) => Number(row.entry.hedgeCopy) },
+  { name: 'batched', type: 'u8', value: (row) => Number(row.entry.batched) },
+  ...PHASE_NAMES.map((phase, p): Column => ({ name: `${phase}_us`, type: 'u32', value: (row) => row.entry.phasesUs[p] })),
+  { name: 'message', type: 'str', value: (row) => row.entry.message },
+];
+
+function csvCell(value: number | string): string {
+  const text = String(value);
+  return /[",\n]/.test(text) ? `"${text.replace(/"/g, '""')}"` : text;
+}
+
+function exportCsv(rows: Row[], file: string) {
+  const lines = [COLUMNS.map((column) => column.name).join(',')];
+  for (const row of rows) lines.push(COLUMNS.map((column) => csvCell(column.value(row))).join(','));
+  fs.writeFileSync(file, lines.join('\n') + '\n');
+  console.log(`Wrote ${rows.length} attempts to ${file}`);
+}
+
+function exportColumns(rows: Row[], dir: string) {
+  fs.mkdirSync(dir, { recursive: true });
+  const schema: { rows: number; columns: { name: string; type: string; file: string; dictionary?: string[] }[] } = {
+    rows: rows.length,
+    columns: [],
+  };
+  for (const column of COLUMNS) {
+    const type = column.type === 'str' ? 'u16' : column.type;
+    const file = `${column.name}.${type}`;
+    const width = { f64: 8, i32: 4, u32: 4, u16: 2, u8: 1 }[type];
+    const buf = Buffer.alloc(rows.length * width);
+    const dictionary: string[] = [];
+    const codes = new Map<string, number>();
+    rows.forEach((row, i) => {
+      let value = column.value(row);
+      if (column.type === 'str') {
+        const text = String(value);
+        if (!codes.has(text)) {
+          codes.set(text, dictionary.length);
+          dictionary.push(text);
+        }
+        value = codes.get(text)!;
+      }
+      const n = Number(value);
+      switch (type) {
+        case 'f64': buf.writeDoubleLE(n, i * 8); break;
+        case 'i32': buf.writeInt32LE(n, i * 4); break;
+        case 'u32': buf.writeUInt32LE(n, i * 4); break;
+        case 'u16': buf.writeUInt16LE(Math.min(n, 0xffff), i * 2); break;
+        case 'u8': buf.writeUInt8(n, i); break;
+      }
+    });
+    fs.writeFileSync(path.join(dir, file), buf);
+    schema.columns.push({ name: column.name, type, file, ...(column.type === 'str' && { dictionary }) });
+  }
+  fs.writeFileSync(path.join(dir, 'schema.json'), JSON.stringify(schema, null, 2));
+  console.log(`Wrote ${rows.length} attempts as ${COLUMNS.length} columns to ${dir}`);
+}
+
+function main() {
+  const command = process.argv[2];
+  const args = parseArgs(process.argv.slice(3));
+  const file = args['file'] || DEFAULT_LOG_FILE;
+  if (!fs.existsSync(file)) {
+    console.error(`Attempt log not found: ${file} (written by the engine with CPP_MODE.ATTEMPT_LOG)`);
+    process.exit(1);
+  }
+  if (command === 'replay') {
+    replay(path.resolve(file), args);
+    return;
+  }
+  const rows = readRows(file, args['market'] || '', parseInt(args['since'] || '0'));
+
+  if (command === 'stats') {
+    const by = (args['by'] || 'market,outcome,price').split(',').filter((key) => key);
+    const unknown = by.filter((key) => !GROUP_KEYS.includes(key));
+    if (unknown.length) {
+      console.error(`Unknown --by key ${unknown.join(',')} (one of ${GROUP_KEYS.join(',')})`);
+      process.exit(1);
+    }
+    printStats(rows, by);
+  } else if (command === 'export' && args['csv']) {
+    exportCsv(rows, args['csv']);
+  } else if (command === 'export' && args['columns']) {
+    exportColumns(rows, args['columns']);
+  } else {
+    console.error('Usage: attempt-log stats [--by market,outcome,price] | export --csv <file> | export --columns <dir>' +
+      ' | replay [--interval 1,2,5] [--probe-interval ..] [--max-attempts ..] [--delay-shift ..]');
+    process.exit(1);
+  }
+}
+
+main();
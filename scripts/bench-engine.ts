@@ -0,0 +1,353 @@
+/**
+ * End-to-end benchmark: dist/updown-bot-cpp against the local mock CLOB
+ *
+ * Starts scripts/mock-clob-server.ts in-process (window opens --open-in ms
+ * after the engine is spawned), runs the engine with dummy credentials and
+ * realistic order bodies, and reports attempts/sec and the time from
+ * window open to the first fill.
+ *
+ * With --ring, attempts are read from the engine's shared-memory ring
+ * (record timestamps) instead of timestamping ATTEMPT: lines on arrival.
+ * With --daemon, the engine runs as a warm daemon (src/engine-daemon.ts)
+ * started before the clock starts, and the orders go in as one job;
+ * start_to_first_response_ms then excludes process start and TLS setup.
+ * --idle-timeout makes the mock drop idle connections; with --fire-in the
+ * engine's keepalive heartbeat (--heartbeat ms, 0 = off) should keep
+ * first_attempt_handshakes at 0.
+ * --hedge N sends each attempt over up to N edges. --edges makes the mock
+ * listen on that many loopback IPs (--edge-rtt each; --stall-rate holds back
+ * random responses), which the engine binds as its edges. answer_p99_ms (an
+ * attempt's first send to its first answer) shows the tail hedging cuts,
+ * requests what it costs.
+ * --batch N packs up to N due orders into one POST; requests vs attempts
+ * (orders carried) shows the saving against the mock's rate limit.
+ * --cpus/--fifo/--mlock run the engine with its isolated execution profile;
+ * invol_cs and window_faults (from SCHED:) show what the box itself cost
+ * during the window.
+ * --wire software|hardware has the engine split each answer at the kernel's
+ * send/receive timestamps: wire_p50_us is network plus mock, self_p50_us what
+ * the engine's own send and receive path added on top.
+ * --discover (with --daemon) has the daemon prefetch the next slot's market
+ * from the mock's Gamma endpoint (listed --list-in ms after start):
+ * list_to_cached_ms is how long after listing the daemon had it, lookup_ms
+ * what the bot then pays per slot, against gamma_fetch_ms for a direct GET.
+ * --markets N tags the orders with N markets round robin, as the multi-asset
+ * pipeline does: the QUEUE: lines show how the shared rate budget split.
+ * --transport uring sends the orders over io_uring (one persistent connection
+ * per pooled request) instead of curl: cpu_us_per_attempt (the engine
+ * thread's CPU in the window, from SCHED:, per attempt) is the A/B figure.
+ * --log <file> appends the run to a binary attempt log (npm run attempt-log).
+ *
+ * Usage:
+ *   npm run bench:engine -- [--orders 10] [--attempts 500] [--interval 1] [--probe-interval 5] [--http2] [--expect-open] [--ring] [--daemon]
+ *     [--fire-in <ms>] [--rtt 100] [--jitter 20] [--open-in 2000] [--rate-limit 0] [--success-after 1]
+ *     [--idle-timeout 0] [--heartbeat 15000]
+ *     [--hedge 2] [--hedge-delay 0] [--edges 3] [--edge-rtt 20,20,80] [--stall-rate 0.05] [--stall-ms 200]
+ *     [--batch 10] [--discover] [--list-in 1000] [--markets 4]
+ *     [--cpus 1] [--fifo 50] [--mlock] [--wire software] [--transport uring] [--log attempts.bin]
+ *
+ * Build first: npm run build:updown-bot
+ */
+
+import * as fs from 'fs';
+import * as path from 'path';
+import * as crypto from 'crypto';
+import * as os from 'os';
+import * as https from 'https';
+import { spawn } from 'child_process';
+import { startMockClob, parseArgs, mockOptionsFromArgs } from './mock-clob-server';
+import { AttemptRingReader, attemptRingPath } from '../src/attempt-ring';
+import { EngineDaemon } from '../src/engine-daemon';
+
+const CPP_BINARY = path.join(__dirname, '..', 'dist', 'updown-bot-cpp');
+
+// Shape of a real GTD order body as built by updown-bot-cpp.ts
+function buildOrderBody(index: number, apiKey: string): string {
+  const tokenId = BigInt('0x' + crypto.randomBytes(32).toString('hex')).toString();
+  return JSON.stringify([{
+    deferExec: false,
+    order: {
+      salt: 1000000000000 + index,
+      maker: '0x' + crypto.randomBytes(20).toString('hex'),
+      signer: '0x' + crypto.randomBytes(20).toString('hex'),
+      taker: '0x0000000000000000000000000000000000000000',
+      tokenId,
+      makerAmount: '8800000',
+      takerAmount: '20000000',
+      expiration: String(Math.floor(Date.now() / 1000) + 900),
+      nonce: '0',
+      feeRateBps: '0',
+      side: 'BUY',
+      signatureType: 2,
+      signature: '0x' + crypto.randomBytes(65).toString('hex'),
+    },
+    owner: apiKey,
+    orderType: 'GTD',
+  }]);
+}
+
+function percentile(sorted: number[], p: number): number {
+  if (sorted.length === 0) return 0;
+  return sorted[Math.min(sorted.length - 1, Math.ceil((p / 100) * sorted.length) - 1)];
+}
+
+async function main() {
+  const args = parseArgs(process.argv.slice(2));
+  const orderCount = parseInt(args['orders'] || '10');
+  const maxAttempts = parseInt(args['attempts'] || '500');
+  const intervalMs = parseInt(args['interval'] || '1');
+  const probeIntervalMs = parseInt(args['probe-interval'] || String(intervalMs));
+  const http2 = args['http2'] === 'true';
+  const openInMs = parseInt(args['open-in'] || '2000');
+  const ringPath = args['ring'] === 'true' ? attemptRingPath('bench-engine') : undefined;
+  const daemonMode = args['daemon'] === 'true';
+  const discover = daemonMode && args['discover'] === 'true';
+
+  if (!fs.existsSync(CPP_BINARY)) {
+    console.error(`C++ binary not found: ${CPP_BINARY} (run: npm run build:updown-bot)`);
+    process.exit(1);
+  }
+
+  // Dummy credentials; the mock verifies signatures with the same secret
+  const secret = crypto.randomBytes(32).toString('base64').replace(/\+/g, '-').replace(/\//g, '_');
+  const apiKey = crypto.randomUUID();
+
+  const mockOptions = { port: 0, ...mockOptionsFromArgs(args), secret };
+  const mock = await startMockClob(mockOptions);
+
+  const marketCount = parseInt(args['markets'] || '0');
+  const orders = Array.from({ length: orderCount }, (_, i) => ({
+    body: buildOrderBody(i, apiKey),
+    orderIndex: i,
+    ...(marketCount > 0 && { market: `bench-market-${i % marketCount}` }),
+    // Attempt log labels; the body is 8.8 USDC for 20 shares
+    outcome: i % 2 === 0 ? 'UP' : 'DOWN',
+    price: 0.44,
+    size: 20,
+  }));
+  const transport = {
+    apiKey,
+    secret,
+    passphrase: crypto.randomBytes(32).toString('hex'),
+    address: '0x' + crypto.randomBytes(20).toString('hex'),
+    http2,
+    clobUrl: mock.url,
+    caFile: mock.caFile,
+    ...(args['heartbeat'] && { heartbeatMs: parseInt(args['heartbeat']) }),
+    ...(args['hedge'] && { hedgeCopies: parseInt(args['hedge']) }),
+    ...(args['hedge-delay'] && { hedgeDelayMs: parseInt(args['hedge-delay']) }),
+    ...(args['batch'] && { batchSize: parseInt(args['batch']) }),
+    ...(args['cpus'] && { cpus: args['cpus'] }),
+    ...(args['fifo'] && { fifoPriority: parseInt(args['fifo']) }),
+    ...(args['mlock'] && { lockMemory: true }),
+    ...(args['wire'] && { wireTimestamps: args['wire'] }),
+    ...(args['transport'] && { transport: args['transport'] }),
+    // localhost resolves to 127.0.0.1 only: name the mock's edges explicitly
+    ...(mock.options.edges > 1 && {
+      edgeAddresses: Array.from({ length: mock.options.edges }, (_, i) => `127.0.0.${i + 1}`).join(','),
+    }),
+  };
+
+  // Daemon: pay for process start and TLS before the clock starts, as the bot does between slots
+  let daemon: EngineDaemon | undefined;
+  const discoveryLines: string[] = [];
+  const slug = `btc-updown-15m-${(Math.floor(Date.now() / 900000) + 1) * 900}`;
+  if (discover) mock.options.listAtMs = Date.now() + parseInt(args['list-in'] || '1000');
+  if (daemonMode) {
+    daemon = new EngineDaemon(CPP_BINARY, path.join(os.tmpdir(), `bench-engine-${process.pid}.sock`), (line) => {
+      if (line.startsWith('MARKET:')) discoveryLines.push(line);
+    });
+    await daemon.start({
+      ...transport,
+      maxOrders: orderCount,
+      ...(args['fire-in'] && { burstOffsetsMs: [-50, -20, 0, 5] }),
+      ...(discover && { marketPrefixes: 'btc-updown-15m', gammaUrl: mock.url, marketLookahead: 1 }),
+    });
+  }
+
+  // Discovery: wait until the daemon has the next slot's market, then time a cached lookup
+  // against the direct Gamma GET the bot would otherwise make at that point
+  if (discover) {
+    let cachedAtMs = 0;
+    while (!cachedAtMs) {
+      if (await daemon!.market(slug)) cachedAtMs = Date.now();
+      else await new Promise((resolve) => setTimeout(resolve, 5));
+    }
+    const lookupStart = process.hrtime.bigint();
+    const cached = await daemon!.market(slug);
+    const lookupMs = Number(process.hrtime.bigint() - lookupStart) / 1e6;
+    const fetchStart = process.hrtime.bigint();
+    await new Promise<void>((resolve, reject) => {
+      https.get(`${mock.url}/markets/slug/${slug}`, { ca: fs.readFileSync(mock.caFile) }, (res) => {
+        res.resume();
+        res.on('end', () => resolve());
+      }).on('error', reject);
+    });
+    const fetchMs = Number(process.hrtime.bigint() - fetchStart) / 1e6;
+    for (const line of discoveryLines) console.log(line);
+    console.log(`BENCH:discovery:slug=${slug},found=${cached !== null},list_to_cached_ms=${cachedAtMs - mock.options.listAtMs},` +
+      `lookup_ms=${lookupMs.toFixed(2)},gamma_fetch_ms=${fetchMs.toFixed(1)},gamma_requests=${mock.stats.marketRequests}`);
+  }
+
+  const openAtMs = Date.now() + openInMs;
+  mock.options.openAtMs = openAtMs;
+
+  const config: Record<string, unknown> = {
+    orders,
+    maxAttempts,
+    intervalMs,
+    probeIntervalMs,
+  };
+  if (ringPath) config.attemptRing = ringPath;
+  if (args['log']) config.attemptLog = path.resolve(args['log']);
+  // Let the engine ramp its rate towards the (known) open instant
+  if (args['expect-open']) config.expectedOpenMs = openAtMs;
+  if (args['fire-in']) {
+    config.fireAtMs = Date.now() + parseInt(args['fire-in']);
+    config.burstOffsetsMs = [-50, -20, 0, 5];
+  }
+
+  console.log(`Mock CLOB ${mock.url}: rtt=${mock.options.rttMs}ms jitter=${mock.options.jitterMs}ms ` +
+    `open in ${openInMs}ms, rate_limit=${mock.options.rateLimitRps || 'off'}, success_after=${mock.options.successAfter}`);
+  console.log(`Engine: ${orderCount} orders, ${maxAttempts} attempts @ ${intervalMs}ms (probe ${probeIntervalMs}ms), ` +
+    `${http2 ? 'HTTP/2' : 'HTTP/1.1'}, attempts via ${ringPath ? 'ring' : 'stdout'}, ${daemon ? 'warm daemon' : 'one-shot process'}`);
+
+  const startMs = Date.now();
+  let firstAttemptMs = 0;
+  let lastAttemptMs = 0;
+  let firstSuccessMs = 0;
+  let attempts = 0;
+  let successes = 0;
+  let windowOpenSeenMs = 0;
+  let rateCuts = 0;
+  let firstAttemptHandshakes = -1;
+  let answerP50Ms = -1;
+  let answerP99Ms = -1;
+  let involuntarySwitches = -1;
+  let windowFaults = -1;
+  let windowCpuMs = -1;
+  let wireP50Us = -1;
+  let selfP50Us = -1;
+  const latencies: number[] = [];
+  const summaryLines: string[] = [];
+
+  const handleLine = (line: string, nowMs: number) => {
+    if (line.startsWith('ATTEMPT:')) {
+      // ATTEMPT:<orderIndex>:<attempt>:<latencyMs>:<success>:<message>
+      const parts = line.split(':');
+      attempts++;
+      if (!firstAttemptMs) firstAttemptMs = nowMs;
+      lastAttemptMs = nowMs;
+      latencies.push(parseInt(parts[3]));
+      if (parts[4] === 'true') {
+        successes++;
+        if (!firstSuccessMs) firstSuccessMs = nowMs;
+      }
+    } else if (line.startsWith('SIGNAL:window_open:')) {
+      windowOpenSeenMs = nowMs;
+      summaryLines.push(line);
+    } else if (line.startsWith('RATE:')) {
+      // Controller decisions: probe/ramp/open/decrease/...
+      summaryLines.push(line);
+      if (line.startsWith('RATE:decrease:')) rateCuts++;
+    } else if (line.startsWith('SCHED:')) {
+      // SCHED:window_ms=..,cpu_ms=..,vol_cs=..,invol_cs=..,minor_faults=..,major_faults=..,cpu=..
+      summaryLines.push(line);
+      involuntarySwitches = parseInt((line.match(/invol_cs=(\d+)/) || [])[1] ?? '-1');
+      windowCpuMs = parseInt((line.match(/cpu_ms=(\d+)/) || [])[1] ?? '-1');
+      windowFaults = parseInt((line.match(/minor_faults=(\d+)/) || [])[1] ?? '-1') +
+        parseInt((line.match(/major_faults=(\d+)/) || [])[1] ?? '0');
+    } else if (line.startsWith('CONNECTIONS:')) {
+      // CONNECTIONS:reused=..,new=..,resumed=..,first_attempt_new=..,heartbeats=..
+      summaryLines.push(line);
+      firstAttemptHandshakes = parseInt((line.match(/first_attempt_new=(\d+)/) || [])[1] ?? '-1');
+    } else if (line.startsWith('LATENCY:attempts:answer:')) {
+      summaryLines.push(line);
+      answerP50Ms = Math.round(parseInt((line.match(/p50_us=(\d+)/) || [])[1] ?? '-1000') / 1000);
+      answerP99Ms = Math.round(parseInt((line.match(/p99_us=(\d+)/) || [])[1] ?? '-1000') / 1000);
+    } else if (line.startsWith('LATENCY:wire:')) {
+      // LATENCY:wire:<user|send|ack|wire|recv|self>:count=..,p50_us=..
+      summaryLines.push(line);
+      const p50 = parseInt((line.match(/p50_us=(\d+)/) || [])[1] ?? '-1');
+      if (line.startsWith('LATENCY:wire:wire:')) wireP50Us = p50;
+      if (line.startsWith('LATENCY:wire:self:')) selfP50Us = p50;
+    } else if (line.startsWith('LATENCY:orders:') || line.startsWith('CLOCK:') || line.startsWith('RING:') ||
+               line.startsWith('WARMUP:') || line.startsWith('FIRE_STATS:') || line.startsWith('HEARTBEAT:') ||
+               line.startsWith('DNS:') || line.startsWith('HEDGE:') || line.startsWith('EDGE:') ||
+               line.startsWith('PROFILE:') || line.startsWith('WIRE_STATS:') || line.startsWith('QUEUE:') ||
+               line.startsWith('TRANSPORT:') || line.startsWith('LOG:')) {
+      summaryLines.push(line);
+    }
+  };
+
+  let exitCode: number;
+  if (daemon) {
+    exitCode = await daemon.submit(config, (line) => handleLine(line, Date.now()));
+    await daemon.stop();
+  } else {
+    exitCode = await new Promise<number>((resolve) => {
+      const cpp = spawn(CPP_BINARY, [], { stdio: ['pipe', 'pipe', 'inherit'] });
+      let pending = '';
+
+      cpp.stdout.on('data', (data) => {
+        pending += data.toString();
+        const lines = pending.split('\n');
+        pending = lines.pop() || '';
+        const nowMs = Date.now();
+        for (const line of lines) handleLine(line, nowMs);
+      });
+
+      cpp.on('close', (code) => resolve(code ?? 1));
+      cpp.stdin.write(JSON.stringify({ ...transport, ...config }));
+      cpp.stdin.end();
+    });
+  }
+
+  const endMs = Date.now();
+  await mock.close();
+
+  if (ringPath) {
+    const ring = new AttemptRingReader(ringPath);
+    for (const record of ring.poll()) {
+      attempts++;
+      if (!firstAttemptMs) firstAttemptMs = record.doneAtMs;
+      lastAttemptMs = record.doneAtMs;
+      latencies.push(record.latencyMs);
+      if (record.success) {
+        successes++;
+        if (!firstSuccessMs) firstSuccessMs = Math.round(record.doneAtMs);
+      }
+    }
+    ring.close();
+  }
+
+  const spamSeconds = Math.max(1, lastAttemptMs - firstAttemptMs) / 1000;
+  const sorted = [...latencies].sort((a, b) => a - b);
+  const openToFirstSuccess = firstSuccessMs ? firstSuccessMs - openAtMs : -1;
+  const openToSeen = windowOpenSeenMs ? windowOpenSeenMs - openAtMs : -1;
+  const serverOpenToFirstFill = mock.stats.firstFillAtMs ? mock.stats.firstFillAtMs - openAtMs : -1;
+
+  console.log('');
+  for (const line of summaryLines) console.log(line);
+  console.log(
+    `BENCH:engine:orders=${orderCount},filled=${successes},attempts=${attempts},` +
+    `attempts_per_sec=${(attempts / spamSeconds).toFixed(0)},` +
+    `start_to_first_response_ms=${firstAttemptMs ? Math.round(firstAttemptMs - startMs) : -1},` +
+    `open_to_seen_ms=${openToSeen},open_to_first_success_ms=${openToFirstSuccess},server_open_to_first_fill_ms=${serverOpenToFirstFill},` +
+    `latency_p50_ms=${percentile(sorted, 50)},latency_p99_ms=${percentile(sorted, 99)},` +
+    `answer_p50_ms=${answerP50Ms},answer_p99_ms=${answerP99Ms},requests=${mock.stats.orderRequests},stalled=${mock.stats.stalled},` +
+    `rate_limited=${mock.stats.rateLimited},rate_cuts=${rateCuts},unauthorized=${mock.stats.unauthorized},` +
+    `connections=${mock.stats.connections},resumed_sessions=${mock.stats.resumedSessions},idle_closed=${mock.stats.idleClosed},` +
+    `first_attempt_handshakes=${firstAttemptHandshakes},invol_cs=${involuntarySwitches},window_faults=${windowFaults},` +
+    `cpu_us_per_attempt=${windowCpuMs >= 0 && attempts > 0 ? Math.round(windowCpuMs * 1000 / attempts) : -1},` +
+    `wire_p50_us=${wireP50Us},self_p50_us=${selfP50Us},` +
+    `duration_ms=${endMs - startMs},exit=${exitCode}`
+  );
+
+  process.exit(mock.stats.unauthorized > 0 ? 1 : 0);
+}
+
+main().catch((error) => {
+  console.error('Benchmark failed:', error);
+  process.exit(1);
+});
@@ -0,0 +1,410 @@
+/**
+ * Mock CLOB server - benchmark the C++ engines without touching production
+ *
+ * Serves GET /time, POST /orders and Gamma's GET /markets/slug/<slug> over TLS (HTTP/2 with HTTP/1.1 fallback)
+ * using a self-signed localhost certificate generated on first run.
+ *
+ * Simulated behaviour:
+ * - RTT: every request waits rtt/2 before it is "processed" (clock read,
+ *   window check) and rtt/2 before the response, each +/- jitter/2
+ * - orders are rejected with "the orderbook ... does not exist" until openAtMs
+ * - rate limit: token bucket on POST /orders, over the limit -> 429
+ * - eventual success: each order body fills after successAfter accepted attempts
+ * - batch bodies ([order, order, ..] with more than one order) are answered 200 with
+ *   one result object per order ({errorMsg, orderID}), in request order; rate limit
+ *   and auth apply to the request as a whole
+ * - with --secret, POLY_SIGNATURE is verified like the real API
+ * - with --idle-timeout, connections idle that long are closed (server keepalive limit)
+ * - with --edges N, the same server listens on 127.0.0.1 .. 127.0.0.N like the edge
+ *   IPs of a CDN; --edge-rtt a,b,.. gives each edge its own RTT
+ * - with --stall-rate, that fraction of responses is held back --stall-ms longer
+ *   (a TCP retransmit or a congested path)
+ * - markets: /markets/slug/<prefix>-<unix s> answers 404 until listAtMs, then a Gamma
+ *   market object with synthetic clobTokenIds (derived from the slug)
+ *
+ * Usage:
+ *   npx ts-node scripts/mock-clob-server.ts [--port 18443] [--rtt 100] [--jitter 20]
+ *     [--open-in 3000 | --open-at <unix ms>] [--rate-limit <rps>] [--success-after 1] [--secret <base64>]
+ *     [--idle-timeout <ms>]
+ *     [--edges 3] [--edge-rtt 20,20,80] [--stall-rate 0.05] [--stall-ms 200]
+ *     [--list-in <ms> | --list-at <unix ms>]
+ *
+ * Engines: add "clobUrl":"https://localhost:<port>","caFile":"<printed ca path>" to the stdin config.
+ */
+
+import * as http2 from 'http2';
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import * as crypto from 'crypto';
+import { execFileSync } from 'child_process';
+
+export interface MockClobOptions {
+  port: number;           // 0 = any free port
+  rttMs: number;
+  jitterMs: number;
+  openAtMs: number;       // wall-clock instant orders start being accepted (0 = always open)
+  rateLimitRps: number;   // POST /orders per second, 0 = unlimited
+  successAfter: number;   // accepted attempts per order until it fills
+  idleTimeoutMs: number;  // close connections idle this long, 0 = never
+  edges: number;          // listen on 127.0.0.1 .. 127.0.0.<edges>
+  edgeRttMs: number[];    // per-edge RTT, rttMs where missing
+  stallRate: number;      // fraction of responses delayed by stallMs
+  stallMs: number;
+  listAtMs: number;       // wall-clock instant markets appear on /markets/slug (0 = always listed)
+  secret?: string;        // verify POLY_SIGNATURE when set
+  certDir: string;
+}
+
+export interface MockClobStats {
+  connections: number;
+  resumedSessions: number;  // TLS handshakes that resumed a session
+  idleClosed: number;
+  edgeRequests: number[];   // requests per edge
+  stalled: number;
+  timeRequests: number;
+  marketRequests: number;
+  orderRequests: number;
+  rejectedClosed: number;
+  rateLimited: number;
+  unauthorized: number;
+  filled: number;
+  firstOrderAtMs: number;
+  lastOrderAtMs: number;
+  firstFillAtMs: number;
+}
+
+export interface MockClob {
+  port: number;
+  url: string;
+  caFile: string;
+  options: MockClobOptions;
+  stats: MockClobStats;
+  close(): Promise<void>;
+}
+
+const DEFAULT_OPTIONS: MockClobOptions = {
+  port: 18443,
+  rttMs: 100,
+  jitterMs: 20,
+  openAtMs: 0,
+  rateLimitRps: 0,
+  successAfter: 1,
+  idleTimeoutMs: 0,
+  edges: 1,
+  edgeRttMs: [],
+  stallRate: 0,
+  stallMs: 200,
+  listAtMs: 0,
+  certDir: path.join(os.tmpdir(), 'mock-clob-certs'),
+};
+
+/**
+ * Self-signed certificate for localhost / 127.0.0.1 (openssl CLI, generated once)
+ */
+export function ensureCertificate(certDir: string): { keyFile: string; certFile: string } {
+  const keyFile = path.join(certDir, 'key.pem');
+  const certFile = path.join(certDir, 'cert.pem');
+  if (fs.existsSync(keyFile) && fs.existsSync(certFile)) {
+    return { keyFile, certFile };
+  }
+
+  fs.mkdirSync(certDir, { recursive: true });
+  execFileSync('openssl', [
+    'req', '-x509', '-newkey', 'rsa:2048', '-nodes', '-days', '3650',
+    '-keyout', keyFile, '-out', certFile,
+    '-subj', '/CN=localhost',
+    '-addext', 'subjectAltName=DNS:localhost,IP:127.0.0.1',
+    '-addext', 'basicConstraints=critical,CA:TRUE',
+  ], { stdio: 'ignore' });
+  return { keyFile, certFile };
+}
+
+function delay(baseMs: number, jitterMs: number): Promise<void> {
+  const ms = Math.max(0, baseMs + (Math.random() * 2 - 1) * jitterMs);
+  return new Promise((resolve) => setTimeout(resolve, ms));
+}
+
+// Same algorithm as the Node client / HmacSigner: URL-safe base64 HMAC-SHA256
+function expectedSignature(secret: string, timestamp: string, method: string, requestPath: string, body: string): string {
+  const key = Buffer.from(secret.replace(/-/g, '+').replace(/_/g, '/'), 'base64');
+  return crypto.createHmac('sha256', key)
+    .update(timestamp + method + requestPath + body)
+    .digest('base64')
+    .replace(/\+/g, '-')
+    .replace(/\//g, '_');
+}
+
+export function startMockClob(overrides: Partial<MockClobOptions> = {}): Promise<MockClob> {
+  const options: MockClobOptions = { ...DEFAULT_OPTIONS, ...overrides };
+  const { keyFile, certFile } = ensureCertificate(options.certDir);
+
+  const stats: MockClobStats = {
+    connections: 0,
+    resumedSessions: 0,
+    idleClosed: 0,
+    edgeRequests: new Array(Math.max(1, options.edges)).fill(0),
+    stalled: 0,
+    timeRequests: 0,
+    marketRequests: 0,
+    orderRequests: 0,
+    rejectedClosed: 0,
+    rateLimited: 0,
+    unauthorized: 0,
+    filled: 0,
+    firstOrderAtMs: 0,
+    lastOrderAtMs: 0,
+    firstFillAtMs: 0,
+  };
+
+  // Per order body: accepted attempts so far, orderID once filled
+  const orders = new Map<string, { accepted: number; orderId?: string }>();
+
+  let tokens = options.rateLimitRps;
+  let lastRefillMs = Date.now();
+  function takeToken(nowMs: number): boolean {
+    if (options.rateLimitRps <= 0) return true;
+    tokens = Math.min(options.rateLimitRps, tokens + ((nowMs - lastRefillMs) / 1000) * options.rateLimitRps);
+    lastRefillMs = nowMs;
+    if (tokens < 1) return false;
+    tokens -= 1;
+    return true;
+  }
+
+  function handleOrder(headers: http2.IncomingHttpHeaders, requestPath: string, body: string): { status: number; payload: object } {
+    const nowMs = Date.now();
+    stats.orderRequests++;
+    if (!stats.firstOrderAtMs) stats.firstOrderAtMs = nowMs;
+    stats.lastOrderAtMs = nowMs;
+
+    if (!takeToken(nowMs)) {
+      stats.rateLimited++;
+      return { status: 429, payload: { error: 'Too Many Requests' } };
+    }
+
+    const timestamp = String(headers['poly_timestamp'] || '');
+    const signature = String(headers['poly_signature'] || '');
+    if (!timestamp || !signature || !headers['poly_api_key'] || !headers['poly_passphrase'] || !headers['poly_address']) {
+      stats.unauthorized++;
+      return { status: 401, payload: { error: 'Unauthorized/Invalid api key' } };
+    }
+    if (options.secret && signature !== expectedSignature(options.secret, timestamp, 'POST', requestPath, body)) {
+      stats.unauthorized++;
+      return { status: 401, payload: { error: 'Unauthorized/Invalid api key' } };
+    }
+
+    let items: unknown[] | undefined;
+    try {
+      const parsed = JSON.parse(body);
+      if (Array.isArray(parsed) && parsed.length > 1) items = parsed;
+    } catch {
+      // not JSON: one order keyed by its raw body
+    }
+    return items ? handleBatch(items, nowMs) : placeOrder(body, nowMs);
+  }
+
+  // One order (key: its body); the error/fill a single POST /orders answers
+  function placeOrder(key: string, nowMs: number): { status: number; payload: object } {
+    if (nowMs < options.openAtMs) {
+      stats.rejectedClosed++;
+      const tokenId = (key.match(/"tokenId":"(\d+)"/) || [])[1] || '0';
+      return { status: 400, payload: { error: `the orderbook ${tokenId} does not exist` } };
+    }
+
+    const order = orders.get(key) || { accepted: 0 };
+    orders.set(key, order);
+    if (order.orderId) {
+      return { status: 400, payload: { error: 'order already exists', orderID: '' } };
+    }
+
+    order.accepted++;
+    if (order.accepted < options.successAfter) {
+      return { status: 400, payload: { error: 'not enough balance / allowance' } };
+    }
+
+    order.orderId = '0x' + crypto.randomBytes(32).toString('hex');
+    stats.filled++;
+    if (!stats.firstFillAtMs) stats.firstFillAtMs = nowMs;
+    return { status: 200, payload: { success: true, errorMsg: '', orderID: order.orderId, status: 'live' } };
+  }
+
+  // Batch: each order keyed like a single-order body ([order]), results in request order
+  function handleBatch(items: unknown[], nowMs: number): { status: number; payload: object } {
+    const results = items.map((item) => {
+      const { status, payload } = placeOrder(JSON.stringify([item]), nowMs);
+      if (status === 200) return payload;
+      return { success: true, errorMsg: (payload as { error: string }).error, orderID: '' };
+    });
+    return { status: 200, payload: results };
+  }
+
+  // Gamma market object as /markets/slug/<slug> returns it; null while not listed
+  function marketBySlug(slug: string, nowMs: number): object | null {
+    if (!/-\d+$/.test(slug) || nowMs < options.listAtMs) return null;
+    const digest = crypto.createHash('sha256').update(slug).digest('hex');
+    const tokenIds = [digest.slice(0, 32), digest.slice(32)].map((hex) => BigInt('0x' + hex).toString());
+    return {
+      slug,
+      active: true,
+      closed: false,
+      clobTokenIds: JSON.stringify(tokenIds),
+      acceptingOrders: true,
+      acceptingOrdersTimestamp: new Date(options.listAtMs || nowMs).toISOString().replace(/\.\d+Z$/, 'Z'),
+    };
+  }
+
+  function createEdgeServer(edge: number): http2.Http2SecureServer {
+    const server = http2.createSecureServer({
+      key: fs.readFileSync(keyFile),
+      cert: fs.readFileSync(certFile),
+      allowHTTP1: true,
+    });
+
+    server.on('secureConnection', (socket) => {
+      stats.connections++;
+      if (socket.isSessionReused()) stats.resumedSessions++;
+      socket.setNoDelay(true);
+      if (options.idleTimeoutMs > 0) {
+        socket.setTimeout(options.idleTimeoutMs, () => {
+          stats.idleClosed++;
+          socket.destroy();
+        });
+      }
+    });
+
+    server.on('request', (req: http2.Http2ServerRequest, res: http2.Http2ServerResponse) => {
+      const chunks: Buffer[] = [];
+      req.on('data', (chunk: Buffer) => chunks.push(chunk));
+      req.on('end', async () => {
+        const requestPath = (req.url || '/').split('?')[0];
+        stats.edgeRequests[edge]++;
+        const half = (options.edgeRttMs[edge] ?? options.rttMs) / 2;
+        const halfJitter = options.jitterMs / 2;
+
+        await delay(half, halfJitter);
+
+        let status = 404;
+        let payload: string | object = { error: 'not found' };
+        if (req.method === 'GET' && requestPath === '/time') {
+          stats.timeRequests++;
+          status = 200;
+          payload = String(Math.floor(Date.now() / 1000));
+        } else if (req.method === 'GET' && requestPath.startsWith('/markets/slug/')) {
+          stats.marketRequests++;
+          const market = marketBySlug(requestPath.slice('/markets/slug/'.length), Date.now());
+          if (market) {
+            status = 200;
+            payload = market;
+          }
+        } else if (req.method === 'POST' && requestPath === '/orders') {
+          ({ status, payload } = handleOrder(req.headers, requestPath, Buffer.concat(chunks).toString()));
+        }
+
+        await delay(half, halfJitter);
+        if (options.stallRate > 0 && Math.random() < options.stallRate) {
+          stats.stalled++;
+          await delay(options.stallMs, 0);
+        }
+
+        const text = typeof payload === 'string' ? payload : JSON.stringify(payload);
+        res.writeHead(status, { 'content-type': typeof payload === 'string' ? 'text/plain' : 'application/json' });
+        res.end(text);
+      });
+    });
+    return server;
+  }
+
+  // One server per edge address, all on the same port
+  const servers = Array.from({ length: Math.max(1, options.edges) }, (_, edge) => createEdgeServer(edge));
+
+  function listen(server: http2.Http2SecureServer, port: number, host: string): Promise<number> {
+    return new Promise((resolve, reject) => {
+      server.once('error', reject);
+      server.listen(port, host, () => {
+        const address = server.address();
+        resolve(typeof address === 'object' && address ? address.port : port);
+      });
+    });
+  }
+
+  return (async () => {
+    // Port 0 picks a free port on the first edge; the others share it
+    const port = await listen(servers[0], options.port, '127.0.0.1');
+    for (let edge = 1; edge < servers.length; edge++) await listen(servers[edge], port, `127.0.0.${edge + 1}`);
+    return {
+      port,
+      url: `https://localhost:${port}`,
+      caFile: certFile,
+      options,
+      stats,
+      close: () => new Promise<void>((done) => {
+        // HTTP/2 sessions keep the servers alive until they are closed; the timer also
+        // keeps the event loop alive when nothing else does
+        let open = servers.length;
+        for (const server of servers) server.close(() => { if (--open === 0) done(); });
+        setTimeout(() => done(), 200);
+      }),
+    };
+  })();
+}
+
+// ============================================================================
+// CLI
+// ============================================================================
+
+export function parseArgs(argv: string[]): Record<string, string> {
+  const args: Record<string, string> = {};
+  for (let i = 0; i < argv.length; i++) {
+    if (!argv[i].startsWith('--')) continue;
+    const key = argv[i].slice(2);
+    const next = argv[i + 1];
+    if (next === undefined || next.startsWith('--')) {
+      args[key] = 'true';
+    } else {
+      args[key] = next;
+      i++;
+    }
+  }
+  return args;
+}
+
+export function mockOptionsFromArgs(args: Record<string, string>): Partial<MockClobOptions> {
+  const options: Partial<MockClobOptions> = {};
+  if (args['port']) options.port = parseInt(args['port']);
+  if (args['rtt']) options.rttMs = parseFloat(args['rtt']);
+  if (args['jitter']) options.jitterMs = parseFloat(args['jitter']);
+  if (args['open-at']) options.openAtMs = parseInt(args['open-at']);
+  if (args['open-in']) options.openAtMs = Date.now() + parseInt(args['open-in']);
+  if (args['rate-limit']) options.rateLimitRps = parseFloat(args['rate-limit']);
+  if (args['success-after']) options.successAfter = parseInt(args['success-after']);
+  if (args['idle-timeout']) options.idleTimeoutMs = parseInt(args['idle-timeout']);
+  if (args['edges']) options.edges = parseInt(args['edges']);
+  if (args['edge-rtt']) options.edgeRttMs = args['edge-rtt'].split(',').map(parseFloat);
+  if (args['stall-rate']) options.stallRate = parseFloat(args['stall-rate']);
+  if (args['stall-ms']) options.stallMs = parseFloat(args['stall-ms']);
+  if (args['list-at']) options.listAtMs = parseInt(args['list-at']);
+  if (args['list-in']) options.listAtMs = Date.now() + parseInt(args['list-in']);
+  if (args['secret']) options.secret = args['secret'];
+  if (args['cert-dir']) options.certDir = args['cert-dir'];
+  return options;
+}
+
+async function main() {
+  const mock = await startMockClob(mockOptionsFromArgs(parseArgs(process.argv.slice(2))));
+  const o = mock.options;
+  console.log(`MOCK_READY:url=${mock.url},ca=${mock.caFile},open_at_ms=${o.openAtMs}`);
+  console.log(`  rtt=${o.rttMs}ms jitter=${o.jitterMs}ms rate_limit=${o.rateLimitRps || 'off'} success_after=${o.successAfter}${o.secret ? ' (signatures verified)' : ''}`);
+
+  process.on('SIGINT', async () => {
+    console.log(`MOCK_STATS:${JSON.stringify(mock.stats)}`);
+    await mock.close();
+    process.exit(0);
+  });
+}
+
+if (require.main === module) {
+  main().catch((error) => {
+    console.error('Mock CLOB failed:', error);
+    process.exit(1);
+  });
+}
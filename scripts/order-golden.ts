@@ -0,0 +1,191 @@
+/**
+ * Golden check: engine-signed order bodies against @polymarket/clob-client
+ *
+ * Builds every ORDER_CONFIG ladder order (both sides, a few tick sizes and
+ * odd sizes) with the client's OrderBuilder on an ethers wallet, turns each
+ * into the POST /orders body exactly as updown-bot-cpp.ts does, then has
+ * dist/updown-bot-cpp sign the same parameters with "signOnly" (the JS salt
+ * passed in, signatures are deterministic) and compares the bodies byte for
+ * byte. No network access; the key is a throwaway (keccak("cow")).
+ *
+ * --write-fixture also stores the client's bodies in
+ * src/cpp/fixtures/clob-client-orders.txt, which test-hotpath re-signs and
+ * compares on every run (no Node needed there).
+ *
+ * Usage: npm run order-golden [-- --pk <hex>] [-- --write-fixture]
+ * Build first: npm run build:updown-bot
+ */
+
+import * as fs from 'fs';
+import * as path from 'path';
+import { spawnSync } from 'child_process';
+import { Wallet } from 'ethers';
+import { Side } from '@polymarket/clob-client';
+import { OrderBuilder } from '@polymarket/clob-client/dist/order-builder/builder';
+import { BOT_CONFIG } from '../src/config';
+
+const CPP_BINARY = path.join(__dirname, '..', 'dist', 'updown-bot-cpp');
+const FIXTURE = path.join(__dirname, '..', 'src', 'cpp', 'fixtures', 'clob-client-orders.txt');
+const DEFAULT_PK = '0xc85ef7d79691fe79573b1a7064c19c1a9819ebdbd1faaab1a8ec92344438aaf4';
+const FUNDER = '0x1111111111111111111111111111111111111111';
+const API_KEY = 'golden-api-key';
+const CHAIN_ID = 137;
+const SIGNATURE_TYPE = 2;
+const TOKEN_IDS = [
+  '71321045679252212594626385532706912750332728571942532289631379312455583992563',
+  '52114319501245915516055106046884209969926127482827954674443846427813813222426',
+];
+
+interface GoldenCase {
+  tokenId: string;
+  price: number;
+  size: number;
+  side: 'BUY' | 'SELL';
+  expiration: number;
+  tickSize: '0.1' | '0.01' | '0.001' | '0.0001';
+}
+
+function goldenCases(): GoldenCase[] {
+  const expiration = 1764146700;
+  const cases: GoldenCase[] = [];
+  for (const config of BOT_CONFIG.ORDER_CONFIG) {
+    cases.push({ tokenId: TOKEN_IDS[0], price: config.price, size: config.up.size, side: 'BUY', expiration: expiration - config.up.expirationBuffer, tickSize: '0.01' });
+    cases.push({ tokenId: TOKEN_IDS[1], price: config.price, size: config.down.size, side: 'BUY', expiration: expiration - config.down.expirationBuffer, tickSize: '0.01' });
+  }
+  // Rounding paths of getOrderRawAmounts
+  cases.push({ tokenId: TOKEN_IDS[0], price: 0.57, size: 13.37, side: 'BUY', expiration, tickSize: '0.01' });
+  cases.push({ tokenId: TOKEN_IDS[0], price: 0.333, size: 7.777, side: 'SELL', expiration, tickSize: '0.001' });
+  cases.push({ tokenId: TOKEN_IDS[1], price: 0.1234, size: 99.99, side: 'BUY', expiration, tickSize: '0.0001' });
+  cases.push({ tokenId: TOKEN_IDS[1], price: 0.3, size: 5.5, side: 'SELL', expiration: 0, tickSize: '0.1' });
+  return cases;
+}
+
+// Same transform as buildOrderBody() in updown-bot-cpp.ts
+function clientBody(signedOrder: any): string {
+  return JSON.stringify([
+    {
+      deferExec: false,
+      order: {
+        ...signedOrder,
+        salt: parseInt(signedOrder.salt, 10),
+        side: signedOrder.side === 0 ? 'BUY' : 'SELL',
+      },
+      owner: API_KEY,
+      orderType: 'GTD',
+    },
+  ]);
+}
+
+// The cases and the client's bodies in the fixture format checkOrderFixture() reads
+function writeFixture(pk: string, cases: GoldenCase[], salts: number[], bodies: string[]) {
+  const lines = [
+    "# POST /orders bodies of @polymarket/clob-client's OrderBuilder on an ethers v5",
+    '# wallet, serialized like buildOrderBody() in updown-bot-cpp.ts. The order',
+    '# signer test (test-hotpath) signs every "order" line natively and compares',
+    '# the body with the line after it byte for byte.',
+    '#',
+    '# Regenerate from the client: npm run order-golden -- --write-fixture',
+    '#',
+    '# signer <private key> <funder> <signatureType> <chainId> <owner>',
+    '# order <tokenId> <price> <size> <BUY|SELL> <expiration> <tickSize> <salt>',
+    '# <body>',
+    `signer ${pk} ${FUNDER} ${SIGNATURE_TYPE} ${CHAIN_ID} ${API_KEY}`,
+  ];
+  cases.forEach((c, i) => {
+    lines.push(`order ${c.tokenId} ${c.price} ${c.size} ${c.side} ${c.expiration} ${c.tickSize} ${salts[i]}`);
+    lines.push(bodies[i]);
+  });
+  fs.writeFileSync(FIXTURE, lines.join('\n') + '\n');
+  console.log(`FIXTURE:${FIXTURE}:orders=${cases.length}`);
+}
+
+// Bodies the engine signs for one tick size, by orderIndex
+function engineBodies(pk: string, tickSize: string, orders: object[]): Map<number, string> {
+  const result = spawnSync(CPP_BINARY, [], {
+    input: JSON.stringify({
+      apiKey: API_KEY,
+      privateKey: pk,
+      funder: FUNDER,
+      signatureType: SIGNATURE_TYPE,
+      chainId: CHAIN_ID,
+      tickSize,
+      signOnly: true,
+      orders,
+    }),
+    encoding: 'utf8',
+  });
+  if (result.status !== 0) throw new Error(`engine exited ${result.status}: ${result.stderr}`);
+
+  const bodies = new Map<number, string>();
+  for (const line of result.stdout.split('\n')) {
+    if (!line.startsWith('ORDER:')) continue;
+    const sep = line.indexOf(':', 6);
+    bodies.set(parseInt(line.slice(6, sep), 10), line.slice(sep + 1));
+  }
+  return bodies;
+}
+
+async function main() {
+  const pkArg = process.argv.indexOf('--pk');
+  const pk = pkArg > 0 ? process.argv[pkArg + 1] : DEFAULT_PK;
+  const wallet = new Wallet(pk.startsWith('0x') ? pk : '0x' + pk);
+  const builder = new OrderBuilder(wallet, CHAIN_ID, SIGNATURE_TYPE, FUNDER);
+
+  const cases = goldenCases();
+  const expected: string[] = [];
+  const salts: number[] = [];
+  const byTick = new Map<string, object[]>();
+  for (let i = 0; i < cases.length; i++) {
+    const c = cases[i];
+    const signedOrder = await builder.buildOrder(
+      {
+        tokenID: c.tokenId,
+        price: c.price,
+        size: c.size,
+        side: c.side === 'BUY' ? Side.BUY : Side.SELL,
+        feeRateBps: 0,
+        ...(c.expiration > 0 && { expiration: c.expiration }),
+      },
+      { tickSize: c.tickSize, negRisk: false }
+    );
+    expected.push(clientBody(signedOrder));
+    salts.push(parseInt(signedOrder.salt, 10));
+
+    const orders = byTick.get(c.tickSize) || [];
+    orders.push({
+      orderIndex: i,
+      tokenId: c.tokenId,
+      price: c.price,
+      size: c.size,
+      side: c.side,
+      expiration: c.expiration,
+      salt: salts[i],
+    });
+    byTick.set(c.tickSize, orders);
+  }
+
+  if (process.argv.includes('--write-fixture')) writeFixture(pk.startsWith('0x') ? pk : '0x' + pk, cases, salts, expected);
+
+  const actual = new Map<number, string>();
+  for (const [tickSize, orders] of byTick) {
+    for (const [index, body] of engineBodies(pk, tickSize, orders)) actual.set(index, body);
+  }
+
+  let matches = 0;
+  cases.forEach((c, i) => {
+    if (actual.get(i) === expected[i]) {
+      matches++;
+      return;
+    }
+    console.log(`MISMATCH:${i}:price=${c.price},size=${c.size},side=${c.side},tick=${c.tickSize}`);
+    console.log(`  client: ${expected[i]}`);
+    console.log(`  engine: ${actual.get(i)}`);
+  });
+  console.log(`GOLDEN:orders=${cases.length},match=${matches},signer=${wallet.address}`);
+  process.exit(matches === cases.length ? 0 : 1);
+}
+
+main().catch((error) => {
+  console.error(error);
+  process.exit(1);
+});
@@ -0,0 +1,172 @@
+/**
+ * Reader for the engine's binary attempt log (src/cpp/attempt-log.hpp)
+ *
+ * The engine appends one segment per run ("attemptLog" in the job): the run's
+ * pacing, an order table (market, outcome, price, size) and a 64-byte record
+ * per attempt. Segments are read one at a time; a torn last segment is
+ * skipped (see AttemptLogFile.unread).
+ */
+
+import * as fs from 'fs';
+import {
+  KIND_NAMES, ERROR_NAMES, PHASE_NAMES,
+  FLAG_SUCCESS, FLAG_PLANNED, FLAG_TRUNCATED, FLAG_REUSED, FLAG_RESUMED, FLAG_HEDGE_COPY, FLAG_BATCHED,
+} from './attempt-ring';
+
+const MAGIC = 0x474c5441;
+const VERSION = 1;
+const HEADER_SIZE = 128;
+const ORDER_SIZE = 96;
+const RECORD_SIZE = 64;
+const MAX_BURST = 8;
+
+export interface AttemptLogOrder {
+  orderIndex: number;
+  market: string;          // slug
+  outcome: string;         // UP / DOWN
+  price: number;           // 0 when the job did not say
+  size: number;
+}
+
+export interface AttemptLogEntry {
+  order: AttemptLogOrder;
+  attempt: number;
+  sentAtMs: number;        // unix ms (fractional), engine clock
+  serverSentAtMs: number;  // the same on the CLOB's clock
+  latencyUs: number;       // send to completion
+  httpStatus: number;
+  curlCode: number;
+  kind: string;
+  error: string;
+  success: boolean;
+  planned: boolean;
+  reused: boolean;
+  resumed: boolean;
+  hedgeCopy: boolean;
+  batched: boolean;
+  truncated: boolean;
+  phasesUs: number[];      // indexed like PHASE_NAMES
+  message: string;         // orderID when filled, error text, or curl_<error> as in ATTEMPT: lines
+}
+
+export interface AttemptLogSegment {
+  startedAtMs: number;     // unix ms the run started
+  serverOffsetMs: number;  // CLOB clock minus the engine's
+  fireAtMs: number;        // server ms of the first planned send; 0 = immediately
+  expectedOpenMs: number;
+  intervalMs: number;
+  probeIntervalMs: number;
+  maxAttempts: number;
+  batchSize: number;
+  burstOffsetsMs: number[];
+  dropped: number;         // attempts the segment had no room for
+  orders: AttemptLogOrder[];
+  entries: AttemptLogEntry[];
+}
+
+export { PHASE_NAMES };
+
+export class AttemptLogFile {
+  unread = 0;              // bytes after the last complete segment
+
+  constructor(private readonly file: string) {}
+
+  // Segments in file order
+  *segments(): Generator<AttemptLogSegment> {
+    const fd = fs.openSync(this.file, 'r');
+    try {
+      const size = fs.fstatSync(fd).size;
+      const header = Buffer.alloc(HEADER_SIZE);
+      let offset = 0;
+      for (;;) {
+        this.unread = size - offset;
+        if (size - offset < HEADER_SIZE) return;
+        fs.readSync(fd, header, 0, HEADER_SIZE, offset);
+        const segmentBytes = Number(header.readBigUInt64LE(40));
+        if (header.readUInt32LE(0) !== MAGIC || header.readUInt32LE(4) !== VERSION ||
+            header.readUInt32LE(8) !== HEADER_SIZE || header.readUInt32LE(12) !== ORDER_SIZE ||
+            header.readUInt32LE(16) !== RECORD_SIZE || segmentBytes < HEADER_SIZE || segmentBytes > size - offset) {
+          return;
+        }
+        const segment = Buffer.alloc(segmentBytes);
+        fs.readSync(fd, segment, 0, segmentBytes, offset);
+        offset += segmentBytes;
+        yield decodeSegment(segment);
+      }
+    } finally {
+      fs.closeSync(fd);
+    }
+  }
+}
+
+function decodeSegment(buf: Buffer): AttemptLogSegment {
+  const orderCount = buf.readUInt32LE(20);
+  const recordCount = Number(buf.readBigUInt64LE(24));
+  const serverOffsetUs = Number(buf.readBigInt64LE(64));
+  const burstCount = Math.min(buf.readUInt32LE(120), MAX_BURST);
+  const burstOffsetsMs: number[] = [];
+  for (let i = 0; i < burstCount; i++) burstOffsetsMs.push(buf.readInt16LE(104 + i * 2));
+
+  const orders: AttemptLogOrder[] = [];
+  for (let i = 0; i < orderCount; i++) {
+    const at = HEADER_SIZE + i * ORDER_SIZE;
+    orders.push({
+      orderIndex: buf.readInt32LE(at),
+      market: buf.toString('utf8', at + 32, at + 32 + buf.readUInt8(at + 4)),
+      outcome: buf.toString('utf8', at + 24, at + 24 + buf.readUInt8(at + 5)),
+      price: buf.readDoubleLE(at + 8),
+      size: buf.readDoubleLE(at + 16),
+    });
+  }
+
+  const recordsAt = HEADER_SIZE + orderCount * ORDER_SIZE;
+  const textAt = recordsAt + recordCount * RECORD_SIZE;
+  const unknownOrder: AttemptLogOrder = { orderIndex: -1, market: '', outcome: '', price: 0, size: 0 };
+  const entries: AttemptLogEntry[] = [];
+  for (let i = 0; i < recordCount; i++) {
+    const at = recordsAt + i * RECORD_SIZE;
+    const sentNs = buf.readBigInt64LE(at);
+    const textOffset = textAt + buf.readUInt32LE(at + 16);
+    const curlCode = buf.readUInt8(at + 26);
+    const flags = buf.readUInt8(at + 29);
+    const text = buf.toString('utf8', textOffset, textOffset + buf.readUInt16LE(at + 22));
+    const phasesUs: number[] = [];
+    for (let p = 0; p < PHASE_NAMES.length; p++) phasesUs.push(buf.readUInt32LE(at + 32 + p * 4));
+    const sentAtMs = Number(sentNs / 1000n) / 1000;
+    entries.push({
+      order: orders[buf.readUInt16LE(at + 20)] || unknownOrder,
+      attempt: buf.readInt32LE(at + 12),
+      sentAtMs,
+      serverSentAtMs: sentAtMs + serverOffsetUs / 1000,
+      latencyUs: buf.readUInt32LE(at + 8),
+      httpStatus: buf.readUInt16LE(at + 24),
+      curlCode,
+      kind: KIND_NAMES[buf.readUInt8(at + 27)] || 'unknown',
+      error: ERROR_NAMES[buf.readUInt8(at + 28)] || 'unknown',
+      success: (flags & FLAG_SUCCESS) !== 0,
+      planned: (flags & FLAG_PLANNED) !== 0,
+      reused: (flags & FLAG_REUSED) !== 0,
+      resumed: (flags & FLAG_RESUMED) !== 0,
+      hedgeCopy: (flags & FLAG_HEDGE_COPY) !== 0,
+      batched: (flags & FLAG_BATCHED) !== 0,
+      truncated: (flags & FLAG_TRUNCATED) !== 0,
+      phasesUs,
+      message: curlCode !== 0 ? `curl_${text}` : text,
+    });
+  }
+
+  return {
+    startedAtMs: Number(buf.readBigInt64LE(56) / 1000n) / 1000,
+    serverOffsetMs: serverOffsetUs / 1000,
+    fireAtMs: Number(buf.readBigInt64LE(72)),
+    expectedOpenMs: Number(buf.readBigInt64LE(80)),
+    intervalMs: buf.readInt32LE(88),
+    probeIntervalMs: buf.readInt32LE(92),
+    maxAttempts: buf.readInt32LE(96),
+    batchSize: buf.readInt32LE(100),
+    burstOffsetsMs,
+    dropped: Number(buf.readBigUInt64LE(48)),
+    orders,
+    entries,
+  };
+}
@@ -0,0 +1,149 @@
+/**
+ * Reader for the C++ engines' shared-memory attempt ring (src/cpp/attempt-ring.hpp)
+ *
+ * The engines write one fixed-layout record per attempt into a file under
+ * /dev/shm instead of printing ATTEMPT: lines. The ring is sized for the
+ * whole run, so the wrapper can read it while the engine runs or after it
+ * exits; readIndex is left to C++ consumers (Node cannot store atomically
+ * into the mapping).
+ */
+
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+
+const MAGIC = 0x52545441;
+const VERSION = 1;
+const HEADER_SIZE = 256;
+const RECORD_SIZE = 192;
+const TEXT_OFFSET = 76;
+
+// Must match ResponseKind / OrderResponse::Error / PhaseHistograms::Phase
+export const KIND_NAMES = ['filled', 'not_open', 'rate_limited', 'bad_signature', 'rejected', 'transport_error'];
+export const ERROR_NAMES = ['none', 'not_open', 'duplicated', 'balance', 'unauthorized', 'rate_limited', 'other'];
+export const PHASE_NAMES = ['queue', 'dns', 'connect', 'tls', 'pretransfer', 'ttfb', 'transfer', 'total'];
+
+// AttemptRecord::Flags (also the attempt log's record flags)
+export const FLAG_SUCCESS = 1;
+export const FLAG_PLANNED = 2;
+export const FLAG_TRUNCATED = 4;
+export const FLAG_REUSED = 8;
+export const FLAG_RESUMED = 16;
+export const FLAG_HEDGE_COPY = 32;
+export const FLAG_BATCHED = 64;
+
+export interface AttemptRecord {
+  orderIndex: number;
+  attempt: number;
+  sentAtMs: number;        // unix ms (fractional)
+  doneAtMs: number;
+  latencyMs: number;       // whole ms, as in the ATTEMPT: lines
+  httpStatus: number;
+  curlCode: number;
+  kind: string;
+  error: string;
+  success: boolean;
+  planned: boolean;
+  reused: boolean;         // pooled connection (no DNS/TCP/TLS)
+  resumed: boolean;        // new connection with a resumed TLS session
+  hedgeCopy: boolean;      // a hedged attempt's second or later send
+  batched: boolean;        // sent in a batch POST with other orders
+  phasesUs: number[];      // indexed like PHASE_NAMES
+  message: string;         // orderID when filled, error text, or curl_<error> as in ATTEMPT: lines
+}
+
+// Ring file for one engine run (tmpfs when available)
+export function attemptRingPath(name: string): string {
+  const dir = fs.existsSync('/dev/shm') ? '/dev/shm' : os.tmpdir();
+  return path.join(dir, `${name}-${process.pid}-${Date.now()}.ring`);
+}
+
+export class AttemptRingReader {
+  private fd = -1;
+  private capacity = 0n;
+  private clockOffsetNs = 0n;
+  private next = 0n;
+  private readonly word = Buffer.alloc(8);
+  private readonly record = Buffer.alloc(RECORD_SIZE);
+
+  constructor(private readonly file: string) {}
+
+  // False until the engine has created and initialized the ring
+  private open(): boolean {
+    if (this.fd >= 0) return true;
+    if (!fs.existsSync(this.file)) return false;
+    const fd = fs.openSync(this.file, 'r');
+    const header = Buffer.alloc(32);
+    if (fs.readSync(fd, header, 0, header.length, 0) < header.length ||
+        header.readUInt32LE(0) !== MAGIC || header.readUInt32LE(4) !== VERSION ||
+        header.readUInt32LE(12) !== RECORD_SIZE) {
+      fs.closeSync(fd);
+      return false;
+    }
+    this.fd = fd;
+    this.capacity = header.readBigUInt64LE(16);
+    this.clockOffsetNs = header.readBigInt64LE(24);
+    return true;
+  }
+
+  private readWord(offset: number): bigint {
+    fs.readSync(this.fd, this.word, 0, 8, offset);
+    return this.word.readBigUInt64LE(0);
+  }
+
+  // Records published since the last call
+  poll(): AttemptRecord[] {
+    if (!this.open()) return [];
+    const records: AttemptRecord[] = [];
+    const end = this.readWord(64);
+    for (; this.next < end; this.next++) {
+      const offset = HEADER_SIZE + Number(this.next % this.capacity) * RECORD_SIZE;
+      fs.readSync(this.fd, this.record, 0, RECORD_SIZE, offset);
+      // seq lags writeIndex only if the slot was reused (not when sized for the run)
+      if (this.record.readBigUInt64LE(0) !== this.next + 1n) break;
+      records.push(this.decode(this.record));
+    }
+    return records;
+  }
+
+  get dropped(): number {
+    return this.open() ? Number(this.readWord(192)) : 0;
+  }
+
+  // Close and delete the ring file
+  close(): void {
+    if (this.fd >= 0) fs.closeSync(this.fd);
+    this.fd = -1;
+    fs.rmSync(this.file, { force: true });
+  }
+
+  private decode(buf: Buffer): AttemptRecord {
+    const sentNs = buf.readBigInt64LE(8);
+    const doneNs = buf.readBigInt64LE(16);
+    const curlCode = buf.readInt32LE(36);
+    const flags = buf.readUInt8(74);
+    const text = buf.toString('utf8', TEXT_OFFSET, TEXT_OFFSET + buf.readUInt8(75)) +
+      (flags & FLAG_TRUNCATED ? '...' : '');
+    const phasesUs: number[] = [];
+    for (let p = 0; p < PHASE_NAMES.length; p++) phasesUs.push(buf.readUInt32LE(40 + p * 4));
+    return {
+      orderIndex: buf.readInt32LE(24),
+      attempt: buf.readInt32LE(28),
+      sentAtMs: Number((sentNs + this.clockOffsetNs) / 1000n) / 1000,
+      doneAtMs: Number((doneNs + this.clockOffsetNs) / 1000n) / 1000,
+      latencyMs: Number((doneNs - sentNs) / 1000000n),
+      httpStatus: buf.readInt32LE(32),
+      curlCode,
+      kind: KIND_NAMES[buf.readUInt8(72)] || 'unknown',
+      error: ERROR_NAMES[buf.readUInt8(73)] || 'unknown',
+      success: (flags & FLAG_SUCCESS) !== 0,
+      planned: (flags & FLAG_PLANNED) !== 0,
+      reused: (flags & FLAG_REUSED) !== 0,
+      resumed: (flags & FLAG_RESUMED) !== 0,
+      hedgeCopy: (flags & FLAG_HEDGE_COPY) !== 0,
+      batched: (flags & FLAG_BATCHED) !== 0,
+      phasesUs,
+      message: curlCode !== 0 ? `curl_${text}` : text,
+    };
+  }
+}
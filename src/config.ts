@@ -99,6 +99,47 @@ export const BOT_CONFIG = {
     ENABLED: true,
     MAX_ATTEMPTS_PER_ORDER: 500,  // Lower than polling bot (500 vs 2000)
     INTERVAL_MS: 1,
+    PROBE_INTERVAL_MS: 5,         // Per-order pacing until any order sees the orderbook open
+    STOP_SIDE_ON_FILL: false,     // First fill on a side stops that side's other ladder orders
+    HTTP2: false,                 // Multiplex attempts as HTTP/2 streams (no RTT wait between attempts)
+    HTTP2_CONNECTIONS: 2,         // Warm connections kept to clob.polymarket.com in HTTP/2 mode
+    MAX_IN_FLIGHT: 64,            // Cap on concurrent in-flight streams (all orders combined)
+    ATTEMPT_RING: true,           // Per-attempt records via a /dev/shm ring instead of ATTEMPT: lines on stdout
+    ATTEMPT_LOG: true,            // Every attempt into updown-bot-attempts.bin (npm run attempt-log); CSV keeps one row per order
+    PIN_DNS: true,                // Resolve the CLOB host once at start and pin it for every connection
+    HEARTBEAT_MS: 15000,          // Keepalive request per warm connection while idle or holding for T (0 = off)
+    BATCH_SIZE: 1,                // Due orders packed into one POST /orders (1 = one order per request, max 15)
+    WIRE_TIMESTAMPS: 'off' as 'off' | 'software' | 'hardware',  // Kernel send/receive stamps per attempt (HTTP/1.1), updown-bot-wire.csv
+    TRANSPORT: 'curl' as 'curl' | 'uring',  // Order requests over io_uring (HTTP/1.1, no hedging/edges/wire stamps); curl without it
+    HEDGE: {
+      COPIES: 1,                  // Sends per attempt over distinct edge IPs (1 = off); HTTP/1.1
+      DELAY_MS: 0,                // Before each extra send; 0 = the edge's p95 latency
+      EDGE_ADDRESSES: [] as string[],  // Edge IPs to spread over; empty = the pinned DNS addresses
+    },
+    FIRE_MODE: {
+      ENABLED: false,             // Engine holds warm connections and fires at server time T itself
+      BURST_OFFSETS_MS: [-50, -20, 0, 5],  // Planned sends relative to T, then regular pacing
+    },
+    DAEMON: {
+      ENABLED: false,             // One long-running engine keeps warm connections and clock sync across slots
+      SOCKET_PATH: '/tmp/updown-bot-cpp.sock',
+      MAX_ORDERS: 40,             // Pool is sized for this many orders per slot at daemon start
+      DISCOVERY: {
+        ENABLED: true,            // Daemon prefetches upcoming MARKET_PATTERNS markets from Gamma
+        LOOKAHEAD_SLOTS: 3,       // Slots after the current one kept in its cache
+      },
+    },
+    PROFILE: {
+      CPUS: '',                   // Pin the engine thread, e.g. '3' (isolcpus core); '' = not pinned
+      HELPER_CPUS: '',            // Engine helper threads (market discovery); '' = every other CPU
+      FIFO_PRIORITY: 0,           // SCHED_FIFO priority 1-99 for the engine thread (needs CAP_SYS_NICE); 0 = off
+      LOCK_MEMORY: false,         // mlockall + pre-fault so the critical window takes no page faults (needs CAP_IPC_LOCK)
+    },
+    NATIVE_SIGNING: {
+      ENABLED: false,             // Engine signs orders itself (EIP-712) from price/size/token; no clob-client signing round
+      TICK_SIZE: '0.01',          // Market tick size: rounding of price and amounts
+      FEE_RATE_BPS: 0,            // feeRateBps signed into each order
+    },
     BINARY_PATH: require('path').join(__dirname, '..', 'dist', 'updown-bot-cpp'),
     CSV_LOG: require('path').join(__dirname, '..', 'updown-bot.csv'),
   },
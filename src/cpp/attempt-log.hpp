@@ -0,0 +1,373 @@
+/**
+ * AttemptLog - append-only binary log of every attempt, one segment per run
+ *
+ * With "attemptLog": <path> in a job the engine keeps a compact record per
+ * attempt (order of a batch) in memory while the run goes and appends the
+ * run as one segment, with a single write, once its last answer is in: the
+ * critical window never touches the file. The CSVs keep one summary row per
+ * order; the log keeps every attempt with its phases, flags and text
+ * (scripts/attempt-log.ts exports and queries it).
+ *
+ * Segment layout (little-endian, VERSION bumps on any change):
+ *   0    AttemptLogHeader              128 bytes: sizes, counts, the run's pacing
+ *   128  AttemptLogOrder[orderCount]    96 bytes: orderIndex, market, outcome, price, size
+ *        AttemptLogRecord[recordCount]  64 bytes: times, result, phases, text span
+ *        text                           order IDs and error texts, an order's repeats stored once
+ *        zero padding to segmentBytes (a multiple of 64)
+ *
+ * Every section is fixed-size and the segment says how long it is, so a reader
+ * maps the file and walks it segment by segment; a torn last segment (engine
+ * killed mid-write) is skipped. Times are unix ns of the engine's clock;
+ * header.serverOffsetUs converts them to the CLOB's.
+ */
+
+#pragma once
+
+#include "attempt-ring.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+struct AttemptLogHeader {
+    static const uint32_t MAGIC = 0x474c5441;  // "ATLG"
+    static const uint32_t VERSION = 1;
+    static const int MAX_BURST = 8;
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t orderSize;
+    uint32_t recordSize;
+    uint32_t orderCount;
+    uint64_t recordCount;
+    uint64_t textBytes;
+    uint64_t segmentBytes;             // header included
+    uint64_t dropped;                  // attempts beyond what the segment was sized for
+    int64_t startedNs;                 // unix ns the run started
+    int64_t serverOffsetUs;            // CLOB clock minus the engine's unix clock
+    int64_t fireAtMs;                  // server ms of the first planned send; 0 = immediately
+    int64_t expectedOpenMs;            // server ms the orderbook was expected to open
+    int32_t intervalMs;
+    int32_t probeIntervalMs;
+    int32_t maxAttempts;
+    int32_t batchSize;
+    int16_t burstOffsetsMs[MAX_BURST]; // planned sends relative to fireAtMs
+    uint32_t burstCount;
+};
+
+struct AttemptLogOrder {
+    static const size_t MARKET_LEN = 64;
+    static const size_t OUTCOME_LEN = 8;
+
+    int32_t orderIndex;
+    uint8_t marketLength;
+    uint8_t outcomeLength;
+    uint16_t reserved;
+    double price;                      // 0 when the job did not say
+    double size;
+    char outcome[OUTCOME_LEN];         // e.g. UP / DOWN
+    char market[MARKET_LEN];           // slug
+};
+
+struct AttemptLogRecord {
+    int64_t sentNs;                    // unix ns
+    uint32_t durationUs;               // send to completion
+    int32_t attempt;
+    uint32_t textOffset;               // into the segment's text
+    uint16_t order;                    // row of the segment's order table
+    uint16_t textLength;
+    uint16_t httpStatus;
+    uint8_t curlCode;
+    uint8_t kind;                      // ResponseKind
+    uint8_t error;                     // OrderResponse::Error
+    uint8_t flags;                     // AttemptRecord::Flags
+    uint16_t reserved;
+    uint32_t phaseUs[PhaseHistograms::PHASE_COUNT];  // 0 on transport errors
+
+    void setPhases(const int64_t phasesUs[PhaseHistograms::PHASE_COUNT]) {
+        for (int p = 0; p < PhaseHistograms::PHASE_COUNT; p++) phaseUs[p] = (uint32_t)std::max<int64_t>(0, phasesUs[p]);
+    }
+};
+
+static_assert(sizeof(AttemptLogHeader) == 128, "AttemptLogHeader layout");
+static_assert(sizeof(AttemptLogOrder) == 96, "AttemptLogOrder layout");
+static_assert(sizeof(AttemptLogRecord) == 64, "AttemptLogRecord layout");
+
+// Pacing of the run a segment records
+struct AttemptLogRun {
+    int64_t serverOffsetUs = 0;
+    int64_t fireAtMs = 0;
+    int64_t expectedOpenMs = 0;
+    int intervalMs = 0;
+    int probeIntervalMs = 0;
+    int maxAttempts = 0;
+    int batchSize = 1;
+    std::vector<int> burstOffsetsMs;
+};
+
+class AttemptLogWriter {
+public:
+    static const size_t TEXT_CAPACITY = 256 * 1024;
+
+    bool active() const { return active_; }
+    uint64_t records() const { return count_; }
+    uint64_t dropped() const { return dropped_; }
+    uint64_t bytes() const { return bytes_; }
+
+    // New segment for up to `capacity` attempts. Allocates (and touches) its
+    // storage here, before the run, so the run itself never does.
+    void begin(uint64_t capacity, const AttemptLogRun& run) {
+        records_.assign(capacity, AttemptLogRecord());
+        orders_.clear();
+        text_.clear();
+        text_.reserve(TEXT_CAPACITY);
+        lastText_.clear();
+        count_ = dropped_ = bytes_ = 0;
+
+        memset(&header_, 0, sizeof(header_));
+        int64_t unixNow = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        clockOffsetNs_ = unixNow - AttemptRingFile::steadyNs(std::chrono::steady_clock::now());
+        header_.startedNs = unixNow;
+        header_.serverOffsetUs = run.serverOffsetUs;
+        header_.fireAtMs = run.fireAtMs;
+        header_.expectedOpenMs = run.expectedOpenMs;
+        header_.intervalMs = run.intervalMs;
+        header_.probeIntervalMs = run.probeIntervalMs;
+        header_.maxAttempts = run.maxAttempts;
+        header_.batchSize = run.batchSize;
+        header_.burstCount = (uint32_t)std::min<size_t>(run.burstOffsetsMs.size(), AttemptLogHeader::MAX_BURST);
+        for (uint32_t i = 0; i < header_.burstCount; i++) header_.burstOffsetsMs[i] = (int16_t)run.burstOffsetsMs[i];
+        active_ = true;
+    }
+
+    // The clock estimate the run ended with (it is refined until the burst)
+    void setServerOffset(int64_t serverOffsetUs) { header_.serverOffsetUs = serverOffsetUs; }
+
+    // Order table row of an order of the run (rows are added in slot order)
+    void addOrder(int orderIndex, const std::string& market, const std::string& outcome, double price, double size) {
+        AttemptLogOrder order;
+        memset(&order, 0, sizeof(order));
+        order.orderIndex = orderIndex;
+        order.marketLength = (uint8_t)std::min(market.size(), AttemptLogOrder::MARKET_LEN);
+        order.outcomeLength = (uint8_t)std::min(outcome.size(), AttemptLogOrder::OUTCOME_LEN);
+        memcpy(order.market, market.data(), order.marketLength);
+        memcpy(order.outcome, outcome.data(), order.outcomeLength);
+        order.price = price;
+        order.size = size;
+        orders_.push_back(order);
+        lastText_.push_back(Span());
+    }
+
+    // Slot for the next record, or nullptr (counted as dropped) when the segment is full
+    AttemptLogRecord* claim() {
+        if (count_ == records_.size()) {
+            dropped_++;
+            return nullptr;
+        }
+        AttemptLogRecord* record = &records_[count_++];
+        record->flags = 0;
+        record->textLength = 0;
+        return record;
+    }
+
+    void setTimes(AttemptLogRecord* record, std::chrono::steady_clock::time_point sentAt,
+                  std::chrono::steady_clock::time_point end) const {
+        record->sentNs = AttemptRingFile::steadyNs(sentAt) + clockOffsetNs_;
+        record->durationUs = (uint32_t)std::max<int64_t>(0,
+            std::chrono::duration_cast<std::chrono::microseconds>(end - sentAt).count());
+    }
+
+    // Outcome fields of a completed order request, as AttemptRecord::setResult
+    void setResult(AttemptLogRecord* record, CURLcode res, long status, ResponseKind responseKind,
+                   const OrderResponse& response) {
+        record->httpStatus = (uint16_t)status;
+        record->curlCode = (uint8_t)res;
+        record->kind = (uint8_t)responseKind;
+        record->error = (uint8_t)response.error;
+        if (res != CURLE_OK) {
+            const char* curlError = curl_easy_strerror(res);
+            setText(record, curlError, strlen(curlError));
+        } else if (response.filled()) {
+            record->flags |= AttemptRecord::SUCCESS;
+            setText(record, response.orderId.data, response.orderId.length);
+        } else {
+            setText(record, response.message.data, response.message.length);
+        }
+    }
+
+    // Store text once per run of repeats: the same answer as the order's
+    // previous attempt (its "not open" error) points at the earlier copy.
+    // Set record->order first.
+    void setText(AttemptLogRecord* record, const char* data, size_t length) {
+        Span* last = record->order < lastText_.size() ? &lastText_[record->order] : nullptr;
+        if (last && last->length == length && memcmp(text_.data() + last->offset, data, length) == 0) {
+            record->textOffset = last->offset;
+            record->textLength = (uint16_t)length;
+            return;
+        }
+        if (length > UINT16_MAX || text_.size() + length > text_.capacity()) {
+            record->flags |= AttemptRecord::TRUNCATED;
+            record->textOffset = 0;
+            record->textLength = 0;
+            return;
+        }
+        record->textOffset = (uint32_t)text_.size();
+        record->textLength = (uint16_t)length;
+        text_.append(data, length);
+        if (last) *last = Span{record->textOffset, (uint32_t)length};
+    }
+
+    // Append the segment to path with one write and end it; false with errno set
+    bool commit(const std::string& path) {
+        active_ = false;
+        header_.magic = AttemptLogHeader::MAGIC;
+        header_.version = AttemptLogHeader::VERSION;
+        header_.headerSize = sizeof(AttemptLogHeader);
+        header_.orderSize = sizeof(AttemptLogOrder);
+        header_.recordSize = sizeof(AttemptLogRecord);
+        header_.orderCount = (uint32_t)orders_.size();
+        header_.recordCount = count_;
+        header_.textBytes = text_.size();
+        header_.dropped = dropped_;
+        uint64_t used = sizeof(AttemptLogHeader) + orders_.size() * sizeof(AttemptLogOrder) +
+                        count_ * sizeof(AttemptLogRecord) + text_.size();
+        header_.segmentBytes = (used + 63) & ~(uint64_t)63;
+
+        static const char padding[64] = {};
+        struct iovec parts[5] = {
+            {&header_, sizeof(AttemptLogHeader)},
+            {orders_.data(), orders_.size() * sizeof(AttemptLogOrder)},
+            {records_.data(), count_ * sizeof(AttemptLogRecord)},
+            {const_cast<char*>(text_.data()), text_.size()},
+            {const_cast<char*>(padding), header_.segmentBytes - used},
+        };
+
+        int fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) return false;
+        struct stat before;
+        bool ok = fstat(fd, &before) == 0;
+        ssize_t written = ok ? writev(fd, parts, 5) : -1;
+        int saved = errno;
+        if (ok && written != (ssize_t)header_.segmentBytes) {
+            // Disk full or similar: cut the torn segment off so later ones stay readable
+            saved = written < 0 ? errno : ENOSPC;
+            ok = false;
+            if (written > 0 && ftruncate(fd, before.st_size) != 0) saved = errno;
+        }
+        ::close(fd);
+        errno = saved;
+        if (ok) bytes_ = header_.segmentBytes;
+        return ok;
+    }
+
+private:
+    struct Span {
+        uint32_t offset = 0;
+        uint32_t length = UINT32_MAX;  // matches no text
+    };
+
+    AttemptLogHeader header_ = {};
+    std::vector<AttemptLogOrder> orders_;
+    std::vector<AttemptLogRecord> records_;
+    std::string text_;
+    std::vector<Span> lastText_;       // per order row: its previous attempt's text
+    uint64_t count_ = 0;
+    uint64_t dropped_ = 0;
+    uint64_t bytes_ = 0;
+    int64_t clockOffsetNs_ = 0;
+    bool active_ = false;
+};
+
+// One segment of a mapped log
+struct AttemptLogSegment {
+    const AttemptLogHeader* header;
+    const AttemptLogOrder* orders;
+    const AttemptLogRecord* records;
+    const char* text;
+
+    std::string textOf(const AttemptLogRecord& record) const {
+        if ((uint64_t)record.textOffset + record.textLength > header->textBytes) return std::string();
+        return std::string(text + record.textOffset, record.textLength);
+    }
+};
+
+class AttemptLogReader {
+public:
+    AttemptLogReader() = default;
+    AttemptLogReader(const AttemptLogReader&) = delete;
+    AttemptLogReader& operator=(const AttemptLogReader&) = delete;
+    ~AttemptLogReader() { close(); }
+
+    // Map the whole log read-only; false if it cannot be opened
+    bool open(const std::string& path) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        struct stat st;
+        bool ok = fstat(fd, &st) == 0;
+        if (ok && st.st_size > 0) {
+            void* base = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ok = base != MAP_FAILED;
+            if (ok) {
+                base_ = static_cast<const char*>(base);
+                size_ = (size_t)st.st_size;
+            }
+        }
+        ::close(fd);
+        return ok;
+    }
+
+    // Hand each complete segment to onSegment in file order; the count of them.
+    // Stops at the first one that is torn or not this layout (see unread()).
+    template <typename F>
+    size_t forEach(F&& onSegment) {
+        size_t offset = 0;
+        size_t count = 0;
+        while (offset + sizeof(AttemptLogHeader) <= size_) {
+            const AttemptLogHeader* header = reinterpret_cast<const AttemptLogHeader*>(base_ + offset);
+            if (header->magic != AttemptLogHeader::MAGIC || header->version != AttemptLogHeader::VERSION ||
+                header->headerSize != sizeof(AttemptLogHeader) || header->orderSize != sizeof(AttemptLogOrder) ||
+                header->recordSize != sizeof(AttemptLogRecord) || header->segmentBytes < sizeof(AttemptLogHeader) ||
+                header->segmentBytes > size_ - offset || header->recordCount > header->segmentBytes / sizeof(AttemptLogRecord)) {
+                break;
+            }
+            uint64_t recordsAt = sizeof(AttemptLogHeader) + (uint64_t)header->orderCount * sizeof(AttemptLogOrder);
+            uint64_t textAt = recordsAt + header->recordCount * sizeof(AttemptLogRecord);
+            if (textAt + header->textBytes > header->segmentBytes) break;
+
+            AttemptLogSegment segment;
+            segment.header = header;
+            segment.orders = reinterpret_cast<const AttemptLogOrder*>(base_ + offset + sizeof(AttemptLogHeader));
+            segment.records = reinterpret_cast<const AttemptLogRecord*>(base_ + offset + recordsAt);
+            segment.text = base_ + offset + textAt;
+            onSegment(segment);
+            offset += header->segmentBytes;
+            count++;
+        }
+        unread_ = size_ - offset;
+        return count;
+    }
+
+    // Bytes after the last segment forEach() could read (a torn write)
+    size_t unread() const { return unread_; }
+
+    void close() {
+        if (base_) munmap(const_cast<char*>(base_), size_);
+        base_ = nullptr;
+        size_ = unread_ = 0;
+    }
+
+private:
+    const char* base_ = nullptr;
+    size_t size_ = 0;
+    size_t unread_ = 0;
+};
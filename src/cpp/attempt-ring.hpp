@@ -0,0 +1,252 @@
+/**
+ * AttemptRing - per-attempt records in a shared-memory SPSC ring
+ *
+ * With "attemptRing": <path> in the stdin config the engines stop printing
+ * an ATTEMPT: line (formatted write + flush) per attempt and fill a
+ * fixed-layout record in a mapped file (normally under /dev/shm) instead;
+ * stdout only carries the summary lines.
+ *
+ * File layout (little-endian, VERSION bumps on any change):
+ *   0    AttemptRingHeader   256 bytes; writeIndex, readIndex and dropped
+ *                            each on their own cache line
+ *   256  AttemptRecord[capacity]  192 bytes each, 64-byte aligned
+ *
+ * The writer fills the slot in place, then publishes it by storing
+ * seq = index + 1 and writeIndex (release). It never blocks: when the
+ * consumer has not freed a slot yet the record is counted in `dropped`.
+ * AttemptRingReader (C++) advances readIndex as it consumes; the Node reader
+ * (src/attempt-ring.ts) cannot store atomically into the mapping, so callers
+ * size the ring for the whole run and it only follows writeIndex.
+ *
+ * Timestamps are steady_clock ns; header.clockOffsetNs converts them to
+ * unix ns.
+ */
+
+#pragma once
+
+#include "latency-histogram.hpp"
+#include "order-response.hpp"
+#include "rate-controller.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+struct AttemptRingHeader {
+    static const uint32_t MAGIC = 0x52545441;  // "ATTR"
+    static const uint32_t VERSION = 1;
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t recordSize;
+    uint64_t capacity;                 // records, power of two
+    int64_t clockOffsetNs;             // unix ns - steady_clock ns
+
+    alignas(64) std::atomic<uint64_t> writeIndex;
+    alignas(64) std::atomic<uint64_t> readIndex;
+    alignas(64) std::atomic<uint64_t> dropped;
+};
+
+struct alignas(64) AttemptRecord {
+    static const size_t TEXT_LEN = 116;
+    enum Flags : uint8_t { SUCCESS = 1, PLANNED = 2, TRUNCATED = 4, REUSED = 8, RESUMED = 16, HEDGE_COPY = 32, BATCHED = 64 };
+
+    std::atomic<uint64_t> seq;         // index + 1 once published
+    int64_t sentNs;                    // steady_clock
+    int64_t doneNs;
+    int32_t orderIndex;
+    int32_t attempt;
+    int32_t httpStatus;
+    int32_t curlCode;
+    uint32_t phaseUs[PhaseHistograms::PHASE_COUNT];  // 0 on transport errors
+    uint8_t kind;                      // ResponseKind
+    uint8_t error;                     // OrderResponse::Error
+    uint8_t flags;
+    uint8_t textLength;
+    char text[TEXT_LEN];               // orderID when filled, else error text (raw JSON) or curl error
+
+    void setText(const char* data, size_t length) {
+        if (length > TEXT_LEN) {
+            length = TEXT_LEN;
+            flags |= TRUNCATED;
+        }
+        memcpy(text, data, length);
+        textLength = (uint8_t)length;
+    }
+
+    // Outcome fields of a completed order request (timing/identity are the caller's)
+    void setResult(CURLcode res, long status, ResponseKind responseKind, const OrderResponse& response) {
+        httpStatus = (int32_t)status;
+        curlCode = (int32_t)res;
+        kind = (uint8_t)responseKind;
+        error = (uint8_t)response.error;
+        if (res != CURLE_OK) {
+            const char* curlError = curl_easy_strerror(res);
+            setText(curlError, strlen(curlError));
+        } else if (response.filled()) {
+            flags |= SUCCESS;
+            setText(response.orderId.data, response.orderId.length);
+        } else {
+            setText(response.message.data, response.message.length);
+        }
+    }
+
+    void setPhases(const int64_t phasesUs[PhaseHistograms::PHASE_COUNT]) {
+        for (int p = 0; p < PhaseHistograms::PHASE_COUNT; p++) phaseUs[p] = (uint32_t)std::max<int64_t>(0, phasesUs[p]);
+    }
+};
+
+static_assert(sizeof(AttemptRingHeader) == 256, "AttemptRingHeader layout");
+static_assert(sizeof(AttemptRecord) == 192, "AttemptRecord layout");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "ring indexes must be lock-free");
+
+// Mapping shared by the writer and the C++ reader
+class AttemptRingFile {
+public:
+    AttemptRingFile() = default;
+    AttemptRingFile(const AttemptRingFile&) = delete;
+    AttemptRingFile& operator=(const AttemptRingFile&) = delete;
+    ~AttemptRingFile() { close(); }
+
+    bool isOpen() const { return header_ != nullptr; }
+    uint64_t capacity() const { return mask_ + 1; }
+    uint64_t dropped() const { return header_->dropped.load(std::memory_order_relaxed); }
+
+    static int64_t steadyNs(std::chrono::steady_clock::time_point at) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(at.time_since_epoch()).count();
+    }
+
+    int64_t unixNs(int64_t steadyNs) const { return steadyNs + header_->clockOffsetNs; }
+
+    void close() {
+        if (header_) munmap(header_, size_);
+        if (fd_ >= 0) ::close(fd_);
+        header_ = nullptr;
+        records_ = nullptr;
+        fd_ = -1;
+    }
+
+protected:
+    int fd_ = -1;
+    size_t size_ = 0;
+    AttemptRingHeader* header_ = nullptr;
+    AttemptRecord* records_ = nullptr;
+    uint64_t mask_ = 0;
+
+    static size_t fileSize(uint64_t capacity) {
+        return sizeof(AttemptRingHeader) + capacity * sizeof(AttemptRecord);
+    }
+
+    bool map(size_t size, int extraFlags) {
+        void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | extraFlags, fd_, 0);
+        if (base == MAP_FAILED) return false;
+        size_ = size;
+        header_ = static_cast<AttemptRingHeader*>(base);
+        records_ = reinterpret_cast<AttemptRecord*>(static_cast<char*>(base) + sizeof(AttemptRingHeader));
+        return true;
+    }
+};
+
+class AttemptRingWriter : public AttemptRingFile {
+public:
+    // Smallest power of two holding `records` (whole run when the consumer reads at the end)
+    static uint64_t capacityFor(uint64_t records) {
+        uint64_t capacity = 64;
+        while (capacity < records) capacity <<= 1;
+        return capacity;
+    }
+
+    // Create (truncate) and pre-fault the ring file; false with errno set on failure
+    bool open(const std::string& path, uint64_t capacity) {
+        close();
+        capacity = capacityFor(capacity);
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+        if (fd_ < 0) return false;
+        if (ftruncate(fd_, (off_t)fileSize(capacity)) != 0 || !map(fileSize(capacity), MAP_POPULATE)) {
+            close();
+            return false;
+        }
+
+        mask_ = capacity - 1;
+        header_->magic = AttemptRingHeader::MAGIC;
+        header_->version = AttemptRingHeader::VERSION;
+        header_->headerSize = sizeof(AttemptRingHeader);
+        header_->recordSize = sizeof(AttemptRecord);
+        header_->capacity = capacity;
+        int64_t unixNow = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        header_->clockOffsetNs = unixNow - steadyNs(std::chrono::steady_clock::now());
+        writeIndex_ = cachedReadIndex_ = 0;
+        return true;
+    }
+
+    // Slot for the next record, or nullptr (counted as dropped) when the ring is full
+    AttemptRecord* claim() {
+        if (writeIndex_ - cachedReadIndex_ >= capacity()) {
+            cachedReadIndex_ = header_->readIndex.load(std::memory_order_acquire);
+            if (writeIndex_ - cachedReadIndex_ >= capacity()) {
+                header_->dropped.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+        }
+        AttemptRecord* record = &records_[writeIndex_ & mask_];
+        record->flags = 0;
+        record->textLength = 0;
+        return record;
+    }
+
+    // Make the claimed record visible to the reader
+    void publish(AttemptRecord* record) {
+        writeIndex_++;
+        record->seq.store(writeIndex_, std::memory_order_release);
+        header_->writeIndex.store(writeIndex_, std::memory_order_release);
+    }
+
+    uint64_t written() const { return writeIndex_; }
+
+private:
+    uint64_t writeIndex_ = 0;
+    uint64_t cachedReadIndex_ = 0;     // avoids touching the reader's cache line on every claim
+};
+
+class AttemptRingReader : public AttemptRingFile {
+public:
+    // Map an existing ring; false if missing or not a compatible layout
+    bool open(const std::string& path) {
+        close();
+        fd_ = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+        if (fd_ < 0) return false;
+        AttemptRingHeader header;
+        if (pread(fd_, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+            header.magic != AttemptRingHeader::MAGIC || header.version != AttemptRingHeader::VERSION ||
+            header.recordSize != sizeof(AttemptRecord) || header.capacity == 0 ||
+            (header.capacity & (header.capacity - 1)) != 0 || !map(fileSize(header.capacity), 0)) {
+            close();
+            return false;
+        }
+        mask_ = header.capacity - 1;
+        readIndex_ = header_->readIndex.load(std::memory_order_acquire);
+        return true;
+    }
+
+    // Hand every published record to onRecord, then free their slots
+    template <typename F>
+    size_t poll(F&& onRecord) {
+        uint64_t end = header_->writeIndex.load(std::memory_order_acquire);
+        size_t count = 0;
+        for (; readIndex_ < end; readIndex_++, count++) {
+            onRecord(records_[readIndex_ & mask_]);
+        }
+        if (count > 0) header_->readIndex.store(readIndex_, std::memory_order_release);
+        return count;
+    }
+
+private:
+    uint64_t readIndex_ = 0;
+};
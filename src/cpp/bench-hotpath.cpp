@@ -0,0 +1,548 @@
+/**
+ * C++ Hot-Path Microbenchmarks
+ *
+ * Measures ns/op and heap allocations/op of the per-attempt work done on
+ * the send path, with realistic inputs (real-sized order body, real API
+ * secret length). The legacy implementations in hotpath-fixtures.hpp are
+ * the "before" baseline. An interposed counting malloc tracks allocations;
+ * a case on a path promised not to allocate fails the run if it does.
+ * Correctness checks of the same components live in test-hotpath.cpp.
+ *
+ * Cache misses per op (last-level and L1d reads) come from perf_event
+ * counters of the benchmark thread where the kernel exposes a PMU. VMs and
+ * containers without one print minor page faults per op instead
+ * (page_faults_op): memory first touched inside the timed loop.
+ *
+ * Build: bash build-bench.sh
+ * Usage: ./dist/bench-hotpath [iterations] [filter]
+ *        filter: only cases whose name contains it are timed
+ */
+
+#include "hmac-signer.hpp"
+#include "request-template.hpp"
+#include "latency-histogram.hpp"
+#include "rate-controller.hpp"
+#include "order-response.hpp"
+#include "attempt-ring.hpp"
+#include "attempt-log.hpp"
+#include "edge-router.hpp"
+#include "order-signer.hpp"
+#include "uring-transport.hpp"
+#include "replay-sim.hpp"
+#include "hotpath-fixtures.hpp"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <atomic>
+#include <fstream>
+#include <thread>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// ============================================================================
+// Counting allocator: malloc is interposed (glibc), so allocations made by
+// libstdc++ operator new, libcurl and OpenSSL are all counted
+// ============================================================================
+static std::atomic<long> g_allocations{0};
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+
+void* malloc(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+}
+
+
+// ============================================================================
+// Harness
+// ============================================================================
+
+// Keep the compiler from discarding benchmarked work
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Last-level cache misses and L1d read misses of the calling thread, as one
+// perf_event group (user space only, so perf_event_paranoid 2 is enough).
+// Without a PMU it counts minor page faults instead, the coarse end of the
+// same working-set cost: a software event, else getrusage(RUSAGE_THREAD).
+class CacheCounters {
+public:
+    enum Source { HARDWARE, SOFTWARE, RUSAGE };
+
+    CacheCounters() {
+        leader_ = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, -1);
+        if (leader_ < 0) {
+            error_ = errno;
+            leader_ = open(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS_MIN, -1);
+            source_ = leader_ >= 0 ? SOFTWARE : RUSAGE;
+            return;
+        }
+        l1d_ = open(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16), leader_);
+    }
+
+    ~CacheCounters() {
+        if (l1d_ >= 0) close(l1d_);
+        if (leader_ >= 0) close(leader_);
+    }
+
+    // HARDWARE: cache misses; otherwise minor page faults
+    Source source() const { return source_; }
+    bool hasL1d() const { return l1d_ >= 0; }
+    int error() const { return error_; }  // why the PMU counters are off
+
+    void start() {
+        if (leader_ < 0) {
+            startFaults_ = threadFaults();
+            return;
+        }
+        ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    // Counts since start(): cache misses and L1d misses, or page faults and 0
+    void stop(uint64_t& misses, uint64_t& l1dMisses) {
+        misses = l1dMisses = 0;
+        if (leader_ < 0) {
+            misses = threadFaults() - startFaults_;
+            return;
+        }
+        ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        uint64_t values[3] = {};  // nr, leader, l1d
+        if (read(leader_, values, sizeof(values)) < (ssize_t)(2 * sizeof(uint64_t))) return;
+        misses = values[1];
+        if (values[0] > 1) l1dMisses = values[2];
+    }
+
+private:
+    int leader_ = -1;
+    int l1d_ = -1;
+    int error_ = 0;
+    Source source_ = HARDWARE;
+    uint64_t startFaults_ = 0;
+
+    static int open(uint32_t type, uint64_t config, int group) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = group < 0 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group, PERF_FLAG_FD_CLOEXEC);
+    }
+
+    static uint64_t threadFaults() {
+        rusage usage;
+        getrusage(RUSAGE_THREAD, &usage);
+        return (uint64_t)usage.ru_minflt;
+    }
+};
+
+struct BenchResult {
+    double nsPerOp = 0;
+    double allocsPerOp = 0;
+    bool skipped = false;
+};
+
+static CacheCounters* g_cacheCounters = nullptr;
+static const char* g_benchFilter = nullptr;
+
+template <typename Fn>
+BenchResult runBench(const char* name, long iterations, Fn fn) {
+    BenchResult result;
+    if (g_benchFilter && !strstr(name, g_benchFilter)) {
+        // Not timed, but run once: checks after a case may depend on its side effects
+        fn();
+        result.skipped = true;
+        return result;
+    }
+
+    // Warm caches and branch predictors
+    for (long i = 0; i < iterations / 10 + 1; i++) fn();
+
+    long allocsBefore = g_allocations.load();
+    g_cacheCounters->start();
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; i++) fn();
+    auto end = std::chrono::steady_clock::now();
+    uint64_t misses = 0;
+    uint64_t l1dMisses = 0;
+    g_cacheCounters->stop(misses, l1dMisses);
+    long allocs = g_allocations.load() - allocsBefore;
+
+    result.nsPerOp = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    result.allocsPerOp = (double)allocs / iterations;
+
+    std::cout << "BENCH:" << name << ":ns_op=" << std::fixed << std::setprecision(1)
+              << result.nsPerOp << ",allocs_op=" << std::setprecision(2) << result.allocsPerOp;
+    if (g_cacheCounters->source() == CacheCounters::HARDWARE) {
+        std::cout << ",cache_misses_op=" << std::setprecision(3) << (double)misses / iterations;
+        if (g_cacheCounters->hasL1d()) std::cout << ",l1d_misses_op=" << (double)l1dMisses / iterations;
+    } else {
+        std::cout << ",page_faults_op=" << std::setprecision(3) << (double)misses / iterations;
+    }
+    std::cout << ",iters=" << iterations << std::endl;
+    return result;
+}
+
+int main(int argc, char** argv) {
+    long iterations = argc > 1 ? std::atol(argv[1]) : 200000;
+    if (argc > 2) g_benchFilter = argv[2];
+    CacheCounters cacheCounters;
+    g_cacheCounters = &cacheCounters;
+
+    const std::string secret = SAMPLE_SECRET;
+    const std::string timestamp = SAMPLE_TIMESTAMP;
+    const std::string body = SAMPLE_BODY;
+    const HmacSigner signer(secret);
+
+    std::cout << "INPUT:body_bytes=" << body.length() << ",secret_bytes=" << secret.length() << std::endl;
+    static const char* SOURCES[] = {"pmu", "page_faults", "page_faults_rusage"};
+    std::cout << "PERF:cache_counters=" << SOURCES[cacheCounters.source()];
+    if (cacheCounters.source() != CacheCounters::HARDWARE) std::cout << ",pmu_error=" << strerror(cacheCounters.error());
+    std::cout << std::endl;
+
+    // Signature building blocks: secret decoding (once per signer) and digest encoding (per attempt)
+    runBench("base64_decode_legacy", iterations, [&]() {
+        std::string decoded = legacy::base64Decode(secret);
+        doNotOptimize(decoded);
+    });
+
+    runBench("base64_decode", iterations, [&]() {
+        std::string decoded = HmacSigner::decodeSecret(secret);
+        doNotOptimize(decoded);
+    });
+
+    unsigned char digest[SHA256_DIGEST_LENGTH];
+    SHA256(reinterpret_cast<const unsigned char*>(body.data()), body.length(), digest);
+    char encoded[HmacSigner::SIGNATURE_LEN];
+
+    runBench("base64_encode_legacy", iterations, [&]() {
+        std::string out = legacy::base64Encode(digest, SHA256_DIGEST_LENGTH);
+        doNotOptimize(out);
+    });
+
+    runBench("base64_encode", iterations, [&]() {
+        HmacSigner::encodeUrlSafe(digest, encoded);
+        doNotOptimize(encoded);
+    });
+
+    runBench("signature_legacy", iterations, [&]() {
+        std::string message = timestamp + "POST" + ORDER_PATH + body;
+        std::string signature = legacy::generateSignature(secret, message);
+        doNotOptimize(signature);
+    });
+
+    runBench("signature_hmac_signer", iterations, [&]() {
+        char out[HmacSigner::SIGNATURE_LEN];
+        signer.sign(timestamp.data(), timestamp.length(), "POST", 4, ORDER_PATH, 7,
+                    body.data(), body.length(), out);
+        doNotOptimize(out);
+    });
+
+    // Per-attempt request preparation: legacy postOrder() vs RequestTemplate
+    const std::string address = SAMPLE_ADDRESS;
+    const std::string apiKey = SAMPLE_API_KEY;
+    const std::string passphrase = SAMPLE_PASSPHRASE;
+
+    runBench("request_build_legacy", iterations, [&]() {
+        std::string orderUrl = std::string("https://clob.polymarket.com") + ORDER_PATH;
+        std::string message = timestamp + "POST" + ORDER_PATH + body;
+        std::string signature = legacy::generateSignature(secret, message);
+
+        struct curl_slist* headers = nullptr;
+        headers = curl_slist_append(headers, "Content-Type: application/json");
+        headers = curl_slist_append(headers, ("POLY_ADDRESS: " + address).c_str());
+        headers = curl_slist_append(headers, ("POLY_SIGNATURE: " + signature).c_str());
+        headers = curl_slist_append(headers, ("POLY_TIMESTAMP: " + timestamp).c_str());
+        headers = curl_slist_append(headers, ("POLY_API_KEY: " + apiKey).c_str());
+        headers = curl_slist_append(headers, ("POLY_PASSPHRASE: " + passphrase).c_str());
+        doNotOptimize(orderUrl);
+        doNotOptimize(headers);
+        curl_slist_free_all(headers);
+    });
+
+    RequestTemplate tmpl("https://clob.polymarket.com", ORDER_PATH, address, apiKey, passphrase);
+    BenchResult patchResult = runBench("request_template_patch", iterations, [&]() {
+        tmpl.patch(signer, timestamp, body);
+        doNotOptimize(tmpl.headers());
+    });
+    // Zero-allocation guarantee of the per-attempt path
+    if (patchResult.allocsPerOp != 0) {
+        std::cerr << "ERROR: RequestTemplate::patch allocates ("
+                  << patchResult.allocsPerOp << " allocs/op)" << std::endl;
+        return 1;
+    }
+    // Each attempt's timestamp, formatted into the template's slot
+    char slot[RequestTemplate::TIMESTAMP_LEN];
+    long long seconds = std::atoll(timestamp.c_str());
+    BenchResult formatResult = runBench("timestamp_format", iterations, [&]() {
+        doNotOptimize(RequestTemplate::formatTimestamp(seconds++, slot));
+    });
+    if (formatResult.allocsPerOp != 0) {
+        std::cerr << "ERROR: RequestTemplate::formatTimestamp allocates" << std::endl;
+        return 1;
+    }
+
+    // Per-completion latency recording (values spread like real 50-500ms latencies)
+    LatencyHistogram histogram;
+    uint64_t sampleUs = 50000;
+    BenchResult recordResult = runBench("latency_histogram_record", iterations, [&]() {
+        sampleUs = 50000 + (sampleUs * 2654435761ULL) % 450000;
+        histogram.record((int64_t)sampleUs);
+    });
+    if (recordResult.allocsPerOp != 0) {
+        std::cerr << "ERROR: LatencyHistogram::record allocates" << std::endl;
+        return 1;
+    }
+
+    // Response handling: legacy append + rescans vs streaming classifier in the write callback
+    const std::string notOpen = RESPONSE_CASES[2].body;
+    legacy::ResponseBuffer legacyBuf;
+    runBench("response_parse_legacy", iterations, [&]() {
+        legacyBuf.data.clear();
+        legacy::writeCallback((void*)notOpen.data(), 1, notOpen.size(), &legacyBuf);
+        std::string orderId;
+        if (!legacy::isSuccess(legacyBuf.data, orderId)) {
+            std::string error = legacy::extractError(legacyBuf.data);
+            doNotOptimize(error);
+        }
+    });
+
+    OrderResponseParser parser;
+    BenchResult parseResult = runBench("response_parse_streaming", iterations, [&]() {
+        parser.reset();
+        OrderResponseParser::writeCallback((void*)notOpen.data(), 1, notOpen.size(), &parser);
+        OrderResponse response = parser.result();
+        doNotOptimize(response.error);
+    });
+    if (parseResult.allocsPerOp != 0) {
+        std::cerr << "ERROR: OrderResponseParser allocates" << std::endl;
+        return 1;
+    }
+
+    // The pieces of the legacy path on their own: one key lookup, and the fill
+    // verdict on a filled response (a hit costs two lookups and a copy)
+    runBench("json_extract_string", iterations, [&]() {
+        std::string error = legacy::extractJsonString(notOpen, "errorMsg");
+        doNotOptimize(error);
+    });
+
+    const std::string filled = RESPONSE_CASES[0].body;
+    runBench("is_success_legacy", iterations, [&]() {
+        std::string orderId;
+        bool success = legacy::isSuccess(filled, orderId);
+        doNotOptimize(success);
+        doNotOptimize(orderId);
+    });
+
+    BenchResult filledResult = runBench("is_success_streaming", iterations, [&]() {
+        parser.reset();
+        OrderResponseParser::writeCallback((void*)filled.data(), 1, filled.size(), &parser);
+        bool success = parser.result().filled();
+        doNotOptimize(success);
+    });
+    if (filledResult.allocsPerOp != 0) {
+        std::cerr << "ERROR: OrderResponseParser allocates on a fill" << std::endl;
+        return 1;
+    }
+
+    // Per-send/per-completion rate control: refill, token, feedback
+    RateController rate(200, 10000, 64);
+    int inFlight = 0;
+    BenchResult rateResult = runBench("rate_controller_step", iterations, [&]() {
+        auto now = RateController::Clock::now();
+        rate.update(now);
+        if (rate.tryAcquire(inFlight)) inFlight = (inFlight + 1) % 64;
+        doNotOptimize(rate.onResponse(ResponseKind::NOT_OPEN, 400, now, now));
+    });
+    if (rateResult.allocsPerOp != 0) {
+        std::cerr << "ERROR: RateController allocates" << std::endl;
+        return 1;
+    }
+
+    // Attempt reporting: formatted line + flush (one write syscall each) vs a record
+    // in the shared-memory ring, drained by a reader thread as the wrapper would
+    OrderResponse attemptResponse = parser.result();
+    std::ofstream devNull("/dev/null");
+    int attempt = 0;
+    runBench("attempt_line_stdout", iterations, [&]() {
+        devNull << "ATTEMPT:" << 3 << ":" << ++attempt << ":" << 104 << ":false:";
+        devNull.write(attemptResponse.message.data, attemptResponse.message.length) << std::endl;
+    });
+
+    std::string ringPath = scratchPath("bench-hotpath", ".ring");
+    AttemptRingWriter ringWriter;
+    AttemptRingReader ringReader;
+    if (!ringWriter.open(ringPath, 4096) || !ringReader.open(ringPath)) {
+        std::cerr << "ERROR: AttemptRing open " << ringPath << std::endl;
+        return 1;
+    }
+    unlink(ringPath.c_str());
+    std::atomic<bool> draining{true};
+    std::thread drain([&]() {
+        while (draining.load(std::memory_order_relaxed)) {
+            ringReader.poll([](const AttemptRecord& record) { doNotOptimize(record.attempt); });
+        }
+    });
+    int64_t phasesUs[PhaseHistograms::PHASE_COUNT] = {};
+    auto sentAt = std::chrono::steady_clock::now();
+    BenchResult ringResult = runBench("attempt_record_ring", iterations, [&]() {
+        AttemptRecord* record = ringWriter.claim();
+        if (!record) return;
+        record->sentNs = AttemptRingFile::steadyNs(sentAt);
+        record->doneNs = AttemptRingFile::steadyNs(std::chrono::steady_clock::now());
+        record->orderIndex = 3;
+        record->attempt = ++attempt;
+        record->setPhases(phasesUs);
+        record->setResult(CURLE_OK, 200, ResponseKind::NOT_OPEN, attemptResponse);
+        ringWriter.publish(record);
+    });
+    draining = false;
+    drain.join();
+    if (ringResult.allocsPerOp != 0) {
+        std::cerr << "ERROR: AttemptRingWriter allocates" << std::endl;
+        return 1;
+    }
+
+    // "attemptLog": the same attempt kept for the run's log segment (written after the run)
+    AttemptLogWriter logWriter;
+    AttemptLogRun logRun;
+    logWriter.begin(4096, logRun);
+    logWriter.addOrder(3, "btc-updown-15m-1764929700", "UP", 0.45, 20);
+    BenchResult logResult = runBench("attempt_record_log", iterations, [&]() {
+        AttemptLogRecord* record = logWriter.claim();
+        if (!record) {
+            logWriter.begin(4096, logRun);  // a new run's segment; reuses its storage
+            record = logWriter.claim();
+        }
+        logWriter.setTimes(record, sentAt, std::chrono::steady_clock::now());
+        record->order = 0;
+        record->attempt = ++attempt;
+        record->setPhases(phasesUs);
+        logWriter.setResult(record, CURLE_OK, 200, ResponseKind::NOT_OPEN, attemptResponse);
+    });
+    if (logResult.allocsPerOp != 0) {
+        std::cerr << "ERROR: AttemptLogWriter allocates" << std::endl;
+        return 1;
+    }
+
+    // "replay": one recorded run replayed on the simulated clock (off the hot path;
+    // a parameter sweep is combinations x runs of these)
+    ReplayScenario replayScenario = recordedScenario(6, 5, 2000, 0);
+    ReplaySimulator replaySimulator;
+    ReplayParams replayParams;
+    ReplayResult replayResult;
+    runBench("replay_run", std::max(1L, iterations / 1000), [&]() {
+        replayResult.clear();
+        replaySimulator.run(replayScenario, replayParams, replayResult);
+        doNotOptimize(replayResult.attempts);
+    });
+
+    // "transport":"uring": the response reader per answer, and a launch pass of 16
+    // sends as one syscall each vs one ring submission (written to /dev/null, so
+    // only the syscall and submission overhead differ)
+    const std::string httpAnswer = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: " +
+                                   std::to_string(notOpen.size()) + "\r\nConnection: keep-alive\r\n\r\n" + notOpen;
+    HttpResponseReader httpReader;
+    BenchResult readerResult = runBench("http_response_read", iterations, [&]() {
+        parser.reset();
+        httpReader.reset(&parser);
+        httpReader.feed(httpAnswer.data(), httpAnswer.size());
+        doNotOptimize(httpReader);
+    });
+    if (readerResult.allocsPerOp != 0 || !httpReader.done()) {
+        std::cerr << "ERROR: HttpResponseReader allocates or stops early" << std::endl;
+        return 1;
+    }
+
+    const int launchSends = 16;
+    int devNullFd = open("/dev/null", O_WRONLY | O_CLOEXEC);
+    runBench("send_16_syscalls", std::max(1L, iterations / 10), [&]() {
+        for (int i = 0; i < launchSends; i++) {
+            ssize_t written = write(devNullFd, httpAnswer.data(), httpAnswer.size());
+            doNotOptimize(written);
+        }
+    });
+    UringRing sendRing;
+    if (sendRing.init(2 * launchSends)) {
+        runBench("send_16_uring_submit", std::max(1L, iterations / 10), [&]() {
+            for (int i = 0; i < launchSends; i++) {
+                struct io_uring_sqe* sqe = sendRing.sqe();
+                sqe->opcode = IORING_OP_WRITE;
+                sqe->fd = devNullFd;
+                sqe->addr = (uint64_t)(uintptr_t)httpAnswer.data();
+                sqe->len = (unsigned)httpAnswer.size();
+                sqe->off = (uint64_t)-1;
+            }
+            sendRing.submit();
+            for (int reaped = 0; reaped < launchSends;) {
+                if (!sendRing.peek() && !sendRing.wait(1000)) break;
+                while (sendRing.peek()) {
+                    sendRing.advance();
+                    reaped++;
+                }
+            }
+        });
+    }
+    close(devNullFd);
+
+    // Per completion and per send of a hedged attempt: record the answer, pick the edge
+    EdgeRouter edgeRouter;
+    edgeRouter.init("clob.polymarket.com", 443, {"104.18.1.1", "104.18.2.2", "104.18.3.3", "104.18.4.4"});
+    int64_t answerUs = 20000;
+    BenchResult edgeResult = runBench("edge_answer_rank", iterations, [&]() {
+        answerUs = answerUs * 1103515245 % 50000 + 15000;
+        edgeRouter.onAnswer((int)(answerUs & 3), answerUs);
+        int edge = edgeRouter.rank(0);
+        doNotOptimize(edge);
+        int64_t delayUs = edgeRouter.hedgeDelayUs(edge);
+        doNotOptimize(delayUs);
+    });
+    if (edgeResult.allocsPerOp != 0) {
+        std::cerr << "ERROR: EdgeRouter allocates" << std::endl;
+        return 1;
+    }
+
+    // Signing a ladder order in the engine (off the per-attempt path: once per order and slot)
+    OrderSigner orderSigner;
+    orderSigner.init(SAMPLE_PRIVATE_KEY, "", 2, 137, OrderSigner::exchangeAddress(137, false));
+    OrderSigner::RoundConfig orderRound;
+    OrderParams orderParams;
+    orderParams.tokenId = "71321045679252212594626385532706912750332728571942532289631379312455583992563";
+    orderParams.price = 0.44;
+    orderParams.size = 20;
+    orderParams.expiration = 1760000000;
+    std::string orderBody;
+    runBench("order_sign_body", std::max(1L, iterations / 1000), [&]() {
+        orderSigner.buildBody(orderParams, orderRound, "key-1", orderBody);
+        doNotOptimize(orderBody);
+    });
+
+    return 0;
+}
+
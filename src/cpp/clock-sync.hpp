@@ -0,0 +1,178 @@
+/**
+ * ClockSync - server clock offset/drift estimator for the CLOB /time endpoint
+ *
+ * /time only returns whole seconds, so a single sample says little: the
+ * server clock read S at some instant between our send and receive.
+ * Each sample therefore bounds the offset (server - local) to an interval:
+ *
+ *   offset in [S*1000 - recv, S*1000 + 1000 - send]      (ms)
+ *
+ * Intersecting intervals across samples narrows the bound. Samples whose
+ * RTT window straddles a second boundary are the informative ones, so
+ * nextSampleAt() aims probes so the server reads its clock right at a
+ * predicted boundary. Intersection is done in min-RTT order; samples that
+ * would empty the intersection (outliers, other backends) are discarded.
+ * With samples spanning DRIFT_MIN_SPAN_MS the local-vs-server rate
+ * difference is estimated from the two halves and compensated.
+ *
+ * Local clock is CLOCK_MONOTONIC_RAW (not slewed by NTP). localTimeFor()
+ * converts a server instant to a steady_clock (CLOCK_MONOTONIC) time_point
+ * for timerfd scheduling.
+ */
+
+#pragma once
+
+#include <time.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+class ClockSync {
+public:
+    static const size_t MAX_SAMPLES = 64;
+    static constexpr double DRIFT_MIN_SPAN_MS = 10000.0;
+    static constexpr double MAX_DRIFT_PPM = 500.0;
+
+    static int64_t rawNowNs() {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+        return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    }
+
+    // sendRawNs must be <= the instant the request left, recvRawNs >= the
+    // instant the response arrived (conservative bounds keep the estimate safe)
+    void addSample(int64_t sendRawNs, int64_t recvRawNs, int64_t serverSec) {
+        if (recvRawNs < sendRawNs || serverSec <= 0) return;
+        Sample s;
+        s.sendMs = sendRawNs / 1e6;
+        s.recvMs = recvRawNs / 1e6;
+        s.serverMs = (double)serverSec * 1000.0;
+        samples_.push_back(s);
+        if (samples_.size() > MAX_SAMPLES) samples_.erase(samples_.begin());
+        recompute();
+    }
+
+    bool synced() const { return valid_; }
+    size_t sampleCount() const { return samples_.size(); }
+    size_t usedSamples() const { return used_; }
+
+    // Offset at the reference instant, half-width of the bound, drift
+    double offsetMs() const { return offsetMs_; }
+    double errorMs() const { return errorMs_; }
+    double driftPpm() const { return drift_ * 1e6; }
+    double minRttMs() const { return minRttMs_; }
+
+    // Estimated server time (unix ms) at a local raw instant
+    int64_t serverMsAt(int64_t rawNs) const {
+        double localMs = rawNs / 1e6;
+        return (int64_t)(localMs + offsetMs_ + drift_ * (localMs - refMs_));
+    }
+
+    int64_t nowServerMs() const { return serverMsAt(rawNowNs()); }
+
+    // Local raw instant (ns) at which the server clock reads serverMs
+    int64_t rawNsFor(int64_t serverMs) const {
+        // serverMs = local + offset + drift*(local - ref)  =>  solve for local
+        double localMs = ((double)serverMs - offsetMs_ + drift_ * refMs_) / (1.0 + drift_);
+        return (int64_t)(localMs * 1e6);
+    }
+
+    // steady_clock time_point at which the server clock reads serverMs
+    std::chrono::steady_clock::time_point localTimeFor(int64_t serverMs) const {
+        int64_t deltaNs = rawNsFor(serverMs) - rawNowNs();
+        return std::chrono::steady_clock::now() + std::chrono::nanoseconds(deltaNs);
+    }
+
+    // Raw instant to send the next probe so that the server reads its clock
+    // near a second boundary (alternately just before / just after it)
+    int64_t nextSampleAt(int64_t notBeforeRawNs) {
+        if (!valid_) return notBeforeRawNs;
+        double halfRtt = minRttMs_ / 2.0;
+        int64_t earliestServer = serverMsAt(notBeforeRawNs) + (int64_t)halfRtt;
+        int64_t boundary = (earliestServer / 1000 + 1) * 1000;
+        double nudge = std::max(1.0, errorMs_ / 2.0) * ((probeCount_++ % 2) ? 1.0 : -1.0);
+        return rawNsFor(boundary) - (int64_t)((halfRtt - nudge) * 1e6);
+    }
+
+private:
+    struct Sample {
+        double sendMs;
+        double recvMs;
+        double serverMs;
+        double rtt() const { return recvMs - sendMs; }
+        double mid() const { return (sendMs + recvMs) / 2.0; }
+    };
+
+    std::vector<Sample> samples_;
+    bool valid_ = false;
+    size_t used_ = 0;
+    double offsetMs_ = 0;
+    double errorMs_ = 0;
+    double drift_ = 0;
+    double refMs_ = 0;
+    double minRttMs_ = 0;
+    unsigned probeCount_ = 0;
+
+    // Intersect sample bounds (min-RTT first), with drift compensation
+    // around refMs. Returns false if no sample was usable.
+    static bool intersect(const std::vector<Sample>& samples, double drift, double refMs,
+                          double& lower, double& upper, size_t& used) {
+        std::vector<const Sample*> order;
+        for (const auto& s : samples) order.push_back(&s);
+        std::sort(order.begin(), order.end(),
+                  [](const Sample* a, const Sample* b) { return a->rtt() < b->rtt(); });
+
+        lower = -1e300;
+        upper = 1e300;
+        used = 0;
+        for (const Sample* s : order) {
+            double correction = drift * (s->mid() - refMs);
+            double lo = s->serverMs - s->recvMs - correction;
+            double hi = s->serverMs + 1000.0 - s->sendMs - correction;
+            double newLower = std::max(lower, lo);
+            double newUpper = std::min(upper, hi);
+            if (newLower > newUpper) continue;  // inconsistent with better samples
+            lower = newLower;
+            upper = newUpper;
+            used++;
+        }
+        return used > 0;
+    }
+
+    void recompute() {
+        if (samples_.empty()) return;
+
+        minRttMs_ = samples_.front().rtt();
+        for (const auto& s : samples_) minRttMs_ = std::min(minRttMs_, s.rtt());
+
+        // Drift: offset estimated independently on each half of the window
+        double drift = 0;
+        double span = samples_.back().mid() - samples_.front().mid();
+        if (span >= DRIFT_MIN_SPAN_MS && samples_.size() >= 8) {
+            size_t half = samples_.size() / 2;
+            std::vector<Sample> first(samples_.begin(), samples_.begin() + half);
+            std::vector<Sample> second(samples_.begin() + half, samples_.end());
+            double lo1, hi1, lo2, hi2;
+            size_t u1, u2;
+            double ref1 = first[first.size() / 2].mid();
+            double ref2 = second[second.size() / 2].mid();
+            if (intersect(first, 0, ref1, lo1, hi1, u1) && intersect(second, 0, ref2, lo2, hi2, u2)) {
+                drift = (((lo2 + hi2) / 2.0) - ((lo1 + hi1) / 2.0)) / (ref2 - ref1);
+                drift = std::max(-MAX_DRIFT_PPM / 1e6, std::min(MAX_DRIFT_PPM / 1e6, drift));
+            }
+        }
+
+        double ref = samples_.back().mid();
+        double lower, upper;
+        size_t used;
+        if (!intersect(samples_, drift, ref, lower, upper, used)) return;
+
+        drift_ = drift;
+        refMs_ = ref;
+        offsetMs_ = (lower + upper) / 2.0;
+        errorMs_ = (upper - lower) / 2.0;
+        used_ = used;
+        valid_ = true;
+    }
+};
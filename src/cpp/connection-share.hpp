@@ -0,0 +1,180 @@
+/**
+ * ConnectionShare - DNS pinning and TLS session sharing across curl handles
+ *
+ * A dropped connection (server idle timeout, a transfer timeout) otherwise
+ * costs a DNS lookup plus a full TLS handshake on the next attempt, inside
+ * the critical window. ConnectionShare:
+ *   - resolves the CLOB host once and pins every address with
+ *     CURLOPT_RESOLVE, so no handle ever waits on the resolver again;
+ *   - puts all handles on one curl share object (DNS cache + TLS session
+ *     cache), so a handle that has to reconnect resumes a session another
+ *     handle negotiated instead of doing a full handshake.
+ * The engines are single-threaded, so the share needs no lock callbacks.
+ *
+ * ConnectionInfo records per transfer whether the connection came from the
+ * pool and, for new ones, whether the TLS handshake was a resumption. It is
+ * filled by CURLOPT_PREREQFUNCTION, the last point where the connection
+ * (and its SSL*) is still attached to the transfer.
+ */
+
+#pragma once
+
+#include <curl/curl.h>
+#include <openssl/ssl.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+class ConnectionShare {
+public:
+    ConnectionShare() = default;
+    ConnectionShare(const ConnectionShare&) = delete;
+    ConnectionShare& operator=(const ConnectionShare&) = delete;
+
+    ~ConnectionShare() {
+        if (resolve_) curl_slist_free_all(resolve_);
+        if (share_) curl_share_cleanup(share_);
+    }
+
+    // Create the share and, with pinDns, resolve baseUrl's host; false if the share
+    // cannot be created (a failed lookup leaves resolution to curl, see pinned())
+    bool init(const std::string& baseUrl, bool pinDns) {
+        share_ = curl_share_init();
+        if (!share_) return false;
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+
+        pinDns_ = pinDns;
+        if (hostOf(baseUrl)) refresh();
+        return true;
+    }
+
+    // Re-resolve the pinned host; true if the address set changed (re-apply to every handle)
+    bool refresh() {
+        if (!pinDns_ || host_.empty()) return false;
+        auto start = std::chrono::steady_clock::now();
+        std::string addresses = lookup(host_, port_);
+        resolveMs_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (addresses.empty() || addresses == addresses_) return false;
+
+        addresses_ = addresses;
+        if (resolve_) curl_slist_free_all(resolve_);
+        // Replaces any earlier entry for host:port in the shared DNS cache
+        std::string entry = host_ + ":" + std::to_string(port_) + ":" + addresses_;
+        resolve_ = curl_slist_append(nullptr, entry.c_str());
+        return true;
+    }
+
+    void apply(CURL* curl) const {
+        curl_easy_setopt(curl, CURLOPT_SHARE, share_);
+        if (resolve_) curl_easy_setopt(curl, CURLOPT_RESOLVE, resolve_);
+    }
+
+    bool pinned() const { return resolve_ != nullptr; }
+    const std::string& host() const { return host_; }
+    long port() const { return port_; }
+    const std::string& addresses() const { return addresses_; }  // "ip,ip,[v6]"
+
+    // Pinned addresses one by one (the edges hedged sends spread over)
+    std::vector<std::string> addressList() const {
+        std::vector<std::string> list;
+        splitAddresses(addresses_, list);
+        return list;
+    }
+
+    // "ip,ip,[v6]" -> one entry per address
+    static void splitAddresses(const std::string& addresses, std::vector<std::string>& out) {
+        size_t start = 0;
+        while (start < addresses.size()) {
+            size_t comma = addresses.find(',', start);
+            if (comma == std::string::npos) comma = addresses.size();
+            if (comma > start) out.push_back(addresses.substr(start, comma - start));
+            start = comma + 1;
+        }
+    }
+    double resolveMs() const { return resolveMs_; }
+
+private:
+    CURLSH* share_ = nullptr;
+    struct curl_slist* resolve_ = nullptr;
+    bool pinDns_ = false;
+    std::string host_;
+    long port_ = 0;
+    std::string addresses_;
+    double resolveMs_ = 0;
+
+    bool hostOf(const std::string& baseUrl) {
+        CURLU* url = curl_url();
+        char* host = nullptr;
+        char* port = nullptr;
+        bool ok = url && curl_url_set(url, CURLUPART_URL, baseUrl.c_str(), 0) == CURLUE_OK &&
+                  curl_url_get(url, CURLUPART_HOST, &host, 0) == CURLUE_OK &&
+                  curl_url_get(url, CURLUPART_PORT, &port, CURLU_DEFAULT_PORT) == CURLUE_OK;
+        if (ok) {
+            host_ = host;
+            port_ = std::stol(port);
+        }
+        curl_free(host);
+        curl_free(port);
+        curl_url_cleanup(url);
+        return ok;
+    }
+
+    // All addresses of host in resolver order, as a CURLOPT_RESOLVE address list
+    static std::string lookup(const std::string& host, long port) {
+        struct addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        struct addrinfo* result = nullptr;
+        if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &result) != 0) return "";
+
+        std::string addresses;
+        char text[INET6_ADDRSTRLEN];
+        for (struct addrinfo* ai = result; ai; ai = ai->ai_next) {
+            const void* addr = ai->ai_family == AF_INET
+                ? (const void*)&reinterpret_cast<struct sockaddr_in*>(ai->ai_addr)->sin_addr
+                : (const void*)&reinterpret_cast<struct sockaddr_in6*>(ai->ai_addr)->sin6_addr;
+            if (!inet_ntop(ai->ai_family, addr, text, sizeof(text))) continue;
+            std::string address = ai->ai_family == AF_INET6 ? "[" + std::string(text) + "]" : text;
+            if (addresses.find(address) != std::string::npos) continue;
+            if (!addresses.empty()) addresses += ",";
+            addresses += address;
+        }
+        freeaddrinfo(result);
+        return addresses;
+    }
+};
+
+// How one transfer got its connection (reset before each transfer)
+struct ConnectionInfo {
+    CURL* curl = nullptr;
+    bool reused = false;               // taken from the pool (no DNS/TCP/TLS)
+    bool resumed = false;              // new connection, abbreviated TLS handshake from a shared session
+
+    void track(CURL* handle) {
+        curl = handle;
+        curl_easy_setopt(handle, CURLOPT_PREREQFUNCTION, prereqCallback);
+        curl_easy_setopt(handle, CURLOPT_PREREQDATA, this);
+    }
+
+    void reset() { reused = resumed = false; }
+
+private:
+    // Connection is up (new or from the pool), request not sent yet
+    static int prereqCallback(void* clientp, char*, char*, int, int) {
+        ConnectionInfo* info = static_cast<ConnectionInfo*>(clientp);
+        long connects = 0;
+        curl_easy_getinfo(info->curl, CURLINFO_NUM_CONNECTS, &connects);
+        info->reused = connects == 0;
+        if (!info->reused) {
+            struct curl_tlssessioninfo* tls = nullptr;
+            if (curl_easy_getinfo(info->curl, CURLINFO_TLS_SSL_PTR, &tls) == CURLE_OK && tls &&
+                tls->backend == CURLSSLBACKEND_OPENSSL && tls->internals) {
+                info->resumed = SSL_session_reused(static_cast<SSL*>(tls->internals)) == 1;
+            }
+        }
+        return CURL_PREREQFUNC_OK;
+    }
+};
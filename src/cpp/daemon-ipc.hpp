@@ -0,0 +1,233 @@
+/**
+ * Daemon IPC - framed messages over a Unix domain stream socket
+ *
+ * Frame: u32 payload length (little-endian) | u8 type | payload
+ *
+ *   client -> daemon
+ *     'S' SUBMIT   job JSON (orders + pacing/fire fields of the stdin config)
+ *     'P' PING     empty; answered with STATUS
+ *     'M' MARKET   slug; answered with STATUS "MARKET:slug=..,.." from the
+ *                  discovery cache, never waiting on Gamma
+ *     'Q' QUIT     empty; the daemon exits after the current job
+ *   daemon -> client
+ *     'L' LINE     one protocol line as the process mode prints it (no '\n')
+ *     'D' DONE     job exit code as text ("0" every order filled, "1" otherwise)
+ *     'R' STATUS   "STATUS:key=..,key=.."
+ *     'E' ERROR    rejected job (the oldest SUBMIT not yet answered), reason as text
+ *
+ * A frame of unknown type or over FRAME_MAX_PAYLOAD is a protocol error: the
+ * daemon closes the connection rather than answer it, so an ERROR always
+ * belongs to a job.
+ *
+ * The daemon's end is non-blocking. FrameWriter queues outbound frames and
+ * sends what the socket takes; the rest goes out as the daemon (or a run's
+ * waits) sees POLLOUT, so a client slow to read never stalls the engine
+ * thread. FrameStreamBuf turns an std::ostream into LINE frames, so engine
+ * code keeps writing lines and flushing with std::endl; each flush queues the
+ * complete lines buffered so far. Writes use MSG_NOSIGNAL: a client that
+ * went away (or let FRAME_OUT_LIMIT pile up) only loses its results, the
+ * daemon keeps running.
+ */
+
+#pragma once
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <streambuf>
+#include <string>
+
+enum FrameType : uint8_t {
+    FRAME_SUBMIT = 'S',
+    FRAME_PING = 'P',
+    FRAME_MARKET = 'M',
+    FRAME_QUIT = 'Q',
+    FRAME_LINE = 'L',
+    FRAME_DONE = 'D',
+    FRAME_STATUS = 'R',
+    FRAME_ERROR = 'E',
+};
+
+const size_t FRAME_HEADER_LEN = 5;
+const size_t FRAME_MAX_PAYLOAD = 16 * 1024 * 1024;
+const size_t FRAME_OUT_LIMIT = 16 * 1024 * 1024;     // unsent bytes before the client counts as gone
+
+// Outbound frames of a non-blocking socket: queued and sent as far as the socket
+// takes them; flush() sends more once it polls writable (see pending())
+class FrameWriter {
+public:
+    void reset(int fd) {
+        fd_ = fd;
+        buffer_.clear();
+        buffer_.reserve(64 * 1024);
+        sent_ = 0;
+        failed_ = false;
+    }
+
+    // Queue a frame and send what the socket takes; false once the peer is gone or too slow
+    bool send(FrameType type, const char* data, size_t length) {
+        if (failed_) return false;
+        if (buffer_.size() - sent_ + FRAME_HEADER_LEN + length > FRAME_OUT_LIMIT) return fail();
+        char header[FRAME_HEADER_LEN];
+        for (int i = 0; i < 4; i++) header[i] = (char)(unsigned char)(length >> (8 * i));
+        header[4] = (char)type;
+        buffer_.append(header, FRAME_HEADER_LEN);
+        buffer_.append(data, length);
+        return flush();
+    }
+
+    bool send(FrameType type, const std::string& payload) { return send(type, payload.data(), payload.size()); }
+
+    // Send queued bytes until the socket would block; false once the peer is gone
+    bool flush() {
+        while (!failed_ && sent_ < buffer_.size()) {
+            ssize_t n = ::send(fd_, buffer_.data() + sent_, buffer_.size() - sent_, MSG_NOSIGNAL | MSG_DONTWAIT);
+            if (n > 0) {
+                sent_ += (size_t)n;
+            } else if (n < 0 && errno == EINTR) {
+                continue;
+            } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            } else {
+                return fail();
+            }
+        }
+        // Keep the unsent tail at the front, without moving bytes on every partial send
+        if (sent_ == buffer_.size()) {
+            buffer_.clear();
+            sent_ = 0;
+        } else if (sent_ >= buffer_.size() / 2) {
+            buffer_.erase(0, sent_);
+            sent_ = 0;
+        }
+        return !failed_;
+    }
+
+    // Wait up to timeoutMs for everything queued to go out (closing time only)
+    bool drain(int timeoutMs) {
+        for (int waited = 0; pending() && waited < timeoutMs; waited += 10) {
+            struct pollfd pfd = {fd_, POLLOUT, 0};
+            if (poll(&pfd, 1, 10) < 0 && errno != EINTR) return fail();
+            flush();
+        }
+        return !pending() && !failed_;
+    }
+
+    bool pending() const { return !failed_ && sent_ < buffer_.size(); }
+    bool failed() const { return failed_; }
+
+private:
+    int fd_ = -1;
+    std::string buffer_;
+    size_t sent_ = 0;
+    bool failed_ = false;
+
+    bool fail() {
+        failed_ = true;
+        buffer_.clear();
+        sent_ = 0;
+        return false;
+    }
+};
+
+// Incremental frame decoder for a socket read without blocking
+class FrameReader {
+public:
+    // Drain what the socket has; false on EOF, error or an oversized frame
+    bool readFrom(int fd) {
+        char chunk[4096];
+        while (true) {
+            ssize_t n = recv(fd, chunk, sizeof(chunk), MSG_DONTWAIT);
+            if (n > 0) {
+                buffer_.append(chunk, (size_t)n);
+                continue;
+            }
+            if (n == 0) return false;
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+            break;
+        }
+        return buffer_.size() < FRAME_HEADER_LEN || payloadLength() <= FRAME_MAX_PAYLOAD;
+    }
+
+    // Next complete frame, if any
+    bool next(FrameType& type, std::string& payload) {
+        if (buffer_.size() < FRAME_HEADER_LEN) return false;
+        size_t length = payloadLength();
+        if (buffer_.size() < FRAME_HEADER_LEN + length) return false;
+        type = (FrameType)(unsigned char)buffer_[4];
+        payload.assign(buffer_, FRAME_HEADER_LEN, length);
+        buffer_.erase(0, FRAME_HEADER_LEN + length);
+        return true;
+    }
+
+    void clear() { buffer_.clear(); }
+
+private:
+    std::string buffer_;
+
+    size_t payloadLength() const {
+        size_t length = 0;
+        for (int i = 3; i >= 0; i--) length = (length << 8) | (unsigned char)buffer_[i];
+        return length;
+    }
+};
+
+// std::ostream sink queueing each complete line as a LINE frame on flush
+class FrameStreamBuf : public std::streambuf {
+public:
+    explicit FrameStreamBuf(FrameWriter& out) : out_(out) {}
+
+protected:
+    int_type overflow(int_type c) override {
+        if (c != traits_type::eof()) pending_.push_back((char)c);
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize xsputn(const char* data, std::streamsize count) override {
+        pending_.append(data, (size_t)count);
+        return count;
+    }
+
+    int sync() override {
+        size_t start = 0;
+        size_t eol;
+        while ((eol = pending_.find('\n', start)) != std::string::npos) {
+            out_.send(FRAME_LINE, pending_.data() + start, eol - start);
+            start = eol + 1;
+        }
+        pending_.erase(0, start);
+        return 0;
+    }
+
+private:
+    FrameWriter& out_;
+    std::string pending_;
+};
+
+// Listening socket at path (a stale socket file is replaced); -1 with errno on failure
+inline int listenUnix(const std::string& path) {
+    struct sockaddr_un addr = {};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (fd < 0) return -1;
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, 4) != 0) {
+        int error = errno;
+        close(fd);
+        errno = error;
+        return -1;
+    }
+    return fd;
+}
@@ -0,0 +1,161 @@
+/**
+ * EdgeRouter - per-IP latency tracking and routing for hedged sends
+ *
+ * The CLOB host resolves to several edge IPs. Each pool handle is bound to
+ * one of them with CURLOPT_CONNECT_TO (TLS verification and Host still use
+ * the real hostname), so the pool keeps warm connections to every edge and
+ * one slow TCP path (a retransmit, a congested edge) only stalls the
+ * requests that happen to use it.
+ *
+ * Each edge keeps its last WINDOW answer latencies; a transport error
+ * counts as an ERROR_PENALTY_US answer. rank() orders edges by median
+ * (unmeasured edges last), so one stalled response does not move traffic
+ * but a path that keeps being slow or failing drops out of first place.
+ * hedgeDelayUs() is the edge's p95: an answer later than that is in the
+ * tail, and a copy over another edge pays off for about one attempt in
+ * twenty. (An SRTT/RTTVAR estimate would let the stalls it should hedge
+ * against inflate the threshold.)
+ *
+ * Summary line per edge, after each run:
+ *   EDGE:<i>:address=..,sends=..,first=..,errors=..,p50_us=..,p95_us=..
+ *     first: hedged attempts this edge answered first
+ */
+
+#pragma once
+
+#include <curl/curl.h>
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class EdgeRouter {
+public:
+    static const int MAX_EDGES = 16;
+    static const int WINDOW = 64;
+    static const int64_t ERROR_PENALTY_US = 1000000;
+    static const int64_t MIN_HEDGE_DELAY_US = 1000;
+
+    EdgeRouter() = default;
+    EdgeRouter(const EdgeRouter&) = delete;
+    EdgeRouter& operator=(const EdgeRouter&) = delete;
+
+    ~EdgeRouter() { clear(); }
+
+    // One edge per address ("ip" or "[ipv6]") of host:port, at most MAX_EDGES;
+    // without addresses size() is 0 and handles connect as curl resolves them
+    void init(const std::string& host, long port, const std::vector<std::string>& addresses) {
+        clear();
+        for (const auto& address : addresses) {
+            if (edges_.size() >= (size_t)MAX_EDGES) break;
+            Edge edge;
+            edge.address = address;
+            std::string entry = host + ":" + std::to_string(port) + ":" + address + ":" + std::to_string(port);
+            edge.connectTo = curl_slist_append(nullptr, entry.c_str());
+            edges_.push_back(edge);
+        }
+    }
+
+    int size() const { return (int)edges_.size(); }
+    const std::string& address(int edge) const { return edges_[edge].address; }
+
+    // Route every connection of this handle through the edge
+    void bind(CURL* curl, int edge) const {
+        curl_easy_setopt(curl, CURLOPT_CONNECT_TO, edges_.empty() ? nullptr : edges_[edge].connectTo);
+    }
+
+    void onSend(int edge) {
+        if (!edges_.empty()) edges_[edge].sends++;
+    }
+
+    // An HTTP answer latencyUs after the send; first: it decided a hedged attempt
+    void onAnswer(int edge, int64_t latencyUs, bool first = false) {
+        if (edges_.empty()) return;
+        addSample(edges_[edge], std::max<int64_t>(latencyUs, 0));
+        if (first) edges_[edge].first++;
+    }
+
+    void onError(int edge) {
+        if (edges_.empty()) return;
+        edges_[edge].errors++;
+        addSample(edges_[edge], ERROR_PENALTY_US);
+    }
+
+    // k-th fastest edge (0 = fastest), -1 past the last; no allocation
+    int rank(int k) const {
+        int order[MAX_EDGES];
+        int count = size();
+        for (int i = 0; i < count; i++) {
+            int j = i;
+            while (j > 0 && faster(i, order[j - 1])) {
+                order[j] = order[j - 1];
+                j--;
+            }
+            order[j] = i;
+        }
+        return k < count ? order[k] : -1;
+    }
+
+    // How long an answer over this edge may take before a hedged copy goes out
+    int64_t hedgeDelayUs(int edge) const {
+        if (edges_.empty() || edges_[edge].count == 0) return MIN_HEDGE_DELAY_US;
+        return std::max(MIN_HEDGE_DELAY_US, edges_[edge].p95Us);
+    }
+
+    // Per-run counters; latency estimates carry over
+    void resetCounts() {
+        for (auto& e : edges_) e.sends = e.first = e.errors = 0;
+    }
+
+    void print(std::ostream& out) const {
+        for (size_t i = 0; i < edges_.size(); i++) {
+            const Edge& e = edges_[i];
+            out << "EDGE:" << i << ":address=" << e.address << ",sends=" << e.sends << ",first=" << e.first
+                << ",errors=" << e.errors << ",p50_us=" << e.p50Us << ",p95_us=" << e.p95Us << std::endl;
+        }
+    }
+
+private:
+    struct Edge {
+        std::string address;
+        struct curl_slist* connectTo = nullptr;
+        int64_t samples[WINDOW];       // ring of the last answer latencies
+        int count = 0;
+        int next = 0;
+        int64_t p50Us = 0;             // of the window, updated per sample
+        int64_t p95Us = 0;
+        long sends = 0;
+        long first = 0;
+        long errors = 0;
+    };
+    std::vector<Edge> edges_;
+
+    bool faster(int a, int b) const {
+        const Edge& ea = edges_[a];
+        const Edge& eb = edges_[b];
+        if ((ea.count > 0) != (eb.count > 0)) return ea.count > 0;
+        return ea.p50Us < eb.p50Us;
+    }
+
+    // Window percentiles by selection on a stack copy (WINDOW values, no allocation)
+    static void addSample(Edge& e, int64_t latencyUs) {
+        e.samples[e.next] = latencyUs;
+        e.next = (e.next + 1) % WINDOW;
+        e.count = std::min(e.count + 1, WINDOW);
+
+        int64_t sorted[WINDOW];
+        std::copy(e.samples, e.samples + e.count, sorted);
+        int p50 = e.count / 2;
+        int p95 = std::min(e.count - 1, e.count * 95 / 100);
+        std::nth_element(sorted, sorted + p95, sorted + e.count);
+        e.p95Us = sorted[p95];
+        std::nth_element(sorted, sorted + p50, sorted + p95);
+        e.p50Us = p50 < p95 ? sorted[p50] : e.p95Us;
+    }
+
+    void clear() {
+        for (auto& e : edges_) curl_slist_free_all(e.connectTo);
+        edges_.clear();
+    }
+};
@@ -0,0 +1,200 @@
+/**
+ * ExecProfile - isolated execution profile for the engine thread
+ *
+ * Sends and receives all run on the engine's one curl_multi thread. On a
+ * small VPS it shares cores with Node, PM2, the Telegram bot and cron jobs,
+ * and a preemption in the hot second shows up as a max_ms outlier. Each
+ * step is optional:
+ *   - cpus: pin the engine thread (e.g. "3" or "2-3"); helper threads
+ *     (market discovery) go to helperCpus, by default every other CPU the
+ *     process may use
+ *   - fifoPriority: SCHED_FIFO for the engine thread (CAP_SYS_NICE or an
+ *     rtprio limit); the kernel's RT throttling still leaves other tasks
+ *     ~5% of the core while the engine spins before T
+ *   - lockMemory: mlockall(MCL_CURRENT | MCL_FUTURE) (CAP_IPC_LOCK or a
+ *     memlock limit), malloc never giving memory back, PREFAULT_STACK of
+ *     stack and PREFAULT_HEAP of heap touched up front, so the window takes
+ *     no page faults
+ * A step that fails is reported in the PROFILE: line and skipped; the
+ * engine runs either way.
+ *
+ * WindowUsage brackets the critical window (first send to last answer) with
+ * getrusage(RUSAGE_THREAD):
+ *   SCHED:window_ms=..,cpu_ms=..,vol_cs=..,invol_cs=..,minor_faults=..,major_faults=..,cpu=..
+ * invol_cs counts preemptions of the engine thread; vol_cs includes its own
+ * waits in poll between sends.
+ */
+
+#pragma once
+
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct ExecConfig {
+    std::vector<int> cpus;             // engine thread; empty = not pinned
+    std::vector<int> helperCpus;       // other threads; empty = the rest of the process mask
+    int fifoPriority = 0;              // 1..99; 0 = normal scheduling
+    bool lockMemory = false;
+
+    bool any() const { return !cpus.empty() || !helperCpus.empty() || fifoPriority > 0 || lockMemory; }
+};
+
+class ExecProfile {
+public:
+    static const size_t PREFAULT_STACK = 512 * 1024;
+    static const size_t PREFAULT_HEAP = 8 * 1024 * 1024;
+
+    // "2", "2,3", "0-1,6" -> CPU numbers; false on anything else
+    static bool parseCpuList(const std::string& text, std::vector<int>& out) {
+        out.clear();
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t comma = text.find(',', pos);
+            std::string part = text.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+            pos = comma == std::string::npos ? text.size() : comma + 1;
+            if (part.empty()) continue;
+            char* end = nullptr;
+            long first = std::strtol(part.c_str(), &end, 10);
+            long last = first;
+            if (*end == '-') last = std::strtol(end + 1, &end, 10);
+            if (*end != '\0' || first < 0 || last < first || last >= CPU_SETSIZE) return false;
+            for (long cpu = first; cpu <= last; cpu++) out.push_back((int)cpu);
+        }
+        return true;
+    }
+
+    static int pinThread(pthread_t thread, const std::vector<int>& cpus) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : cpus) CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(thread, sizeof(set), &set);
+    }
+
+    // Apply config to the calling (engine) thread and pin helpers; writes one PROFILE: line
+    static void apply(const ExecConfig& config, const std::vector<pthread_t>& helpers, std::ostream& out) {
+        out << "PROFILE:";
+
+        // Helpers first, from the mask the process started with
+        std::vector<int> helperCpus = config.helperCpus;
+        if (helperCpus.empty() && !config.cpus.empty()) {
+            cpu_set_t mask;
+            if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+                for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+                    bool engineCpu = false;
+                    for (int c : config.cpus) engineCpu = engineCpu || c == cpu;
+                    if (CPU_ISSET(cpu, &mask) && !engineCpu) helperCpus.push_back(cpu);
+                }
+            }
+        }
+
+        out << "cpus=";
+        if (config.cpus.empty()) {
+            out << "any";
+        } else {
+            int err = pinThread(pthread_self(), config.cpus);
+            if (err) out << "failed:" << strerror(err);
+            else printCpus(out, config.cpus);
+        }
+
+        out << ",helper_cpus=";
+        if (helperCpus.empty() || helpers.empty()) {
+            out << "any";
+        } else {
+            int err = 0;
+            for (pthread_t helper : helpers) err = err ? err : pinThread(helper, helperCpus);
+            if (err) out << "failed:" << strerror(err);
+            else printCpus(out, helperCpus);
+        }
+
+        out << ",fifo=";
+        if (config.fifoPriority <= 0) {
+            out << "off";
+        } else {
+            sched_param param = {};
+            param.sched_priority = config.fifoPriority;
+            int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+            if (err) out << "failed:" << strerror(err);
+            else out << config.fifoPriority;
+        }
+
+        out << ",mlock=";
+        if (!config.lockMemory) {
+            out << "off";
+        } else {
+            // Freed memory stays in the (locked) heap instead of going back to the kernel
+            mallopt(M_TRIM_THRESHOLD, -1);
+            mallopt(M_MMAP_MAX, 0);
+            if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+                out << "failed:" << strerror(errno);
+            } else {
+                prefaultStack();
+                prefaultHeap();
+                out << "on,prefault_kb=" << (PREFAULT_STACK + PREFAULT_HEAP) / 1024;
+            }
+        }
+        out << std::endl;
+    }
+
+private:
+    static void printCpus(std::ostream& out, const std::vector<int>& cpus) {
+        for (size_t i = 0; i < cpus.size(); i++) out << (i ? "+" : "") << cpus[i];
+    }
+
+    // Touch the stack pages the engine loop (and curl/OpenSSL under it) may reach
+    __attribute__((noinline)) static void prefaultStack() {
+        volatile char stack[PREFAULT_STACK];
+        for (size_t i = 0; i < PREFAULT_STACK; i += 4096) stack[i] = 0;
+        asm volatile("" : : "r"(stack) : "memory");
+    }
+
+    // Grow the heap once; with trimming off the pages stay mapped and locked
+    static void prefaultHeap() {
+        char* block = static_cast<char*>(malloc(PREFAULT_HEAP));
+        if (!block) return;
+        for (size_t i = 0; i < PREFAULT_HEAP; i += 4096) block[i] = 0;
+        asm volatile("" : : "r"(block) : "memory");
+        free(block);
+    }
+};
+
+class WindowUsage {
+public:
+    bool active() const { return active_; }
+
+    void begin() {
+        active_ = true;
+        startedAt_ = std::chrono::steady_clock::now();
+        getrusage(RUSAGE_THREAD, &start_);
+    }
+
+    // SCHED: line for the window since begin(); nothing if it never began
+    void end(std::ostream& out) {
+        if (!active_) return;
+        active_ = false;
+        rusage now;
+        getrusage(RUSAGE_THREAD, &now);
+        double windowMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startedAt_).count();
+        double cpuMs = (micros(now.ru_utime) + micros(now.ru_stime) - micros(start_.ru_utime) - micros(start_.ru_stime)) / 1000.0;
+        out << "SCHED:window_ms=" << (long)windowMs << ",cpu_ms=" << (long)cpuMs
+            << ",vol_cs=" << now.ru_nvcsw - start_.ru_nvcsw << ",invol_cs=" << now.ru_nivcsw - start_.ru_nivcsw
+            << ",minor_faults=" << now.ru_minflt - start_.ru_minflt
+            << ",major_faults=" << now.ru_majflt - start_.ru_majflt << ",cpu=" << sched_getcpu() << std::endl;
+    }
+
+private:
+    bool active_ = false;
+    std::chrono::steady_clock::time_point startedAt_;
+    rusage start_ = {};
+
+    static long long micros(const timeval& t) { return (long long)t.tv_sec * 1000000 + t.tv_usec; }
+};
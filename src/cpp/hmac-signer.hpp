@@ -0,0 +1,153 @@
+/**
+ * HmacSigner - allocation-free POLY_SIGNATURE generation
+ *
+ * Built once at startup from the base64 API secret. The HMAC-SHA256 key
+ * schedule (SHA256 state after absorbing key^ipad and key^opad) is computed
+ * in the constructor, so each signature is two struct copies plus the
+ * SHA256 compression of the message - no key decoding, no heap, no BIO.
+ *
+ * Message = timestamp + method + path + body, streamed straight into the
+ * inner hash (no concatenated message string).
+ * Output = URL-safe base64 with padding (44 chars), identical to the
+ * HMAC() + BIO base64 + '+'->'-', '/'->'_' path used by the Node client.
+ */
+
+#pragma once
+
+#include <openssl/crypto.h>
+#include <openssl/sha.h>
+#include <cstring>
+#include <string>
+
+// The SHA256_CTX calls are deprecated in OpenSSL 3, but it is the only digest
+// state that copies without a heap allocation: EVP_MD_CTX_copy_ex and
+// EVP_MAC_CTX_dup allocate a provider context on every copy. The warning is
+// silenced around those calls only, not for the including translation unit.
+#define HMAC_SIGNER_SHA256_BEGIN \
+    _Pragma("GCC diagnostic push") _Pragma("GCC diagnostic ignored \"-Wdeprecated-declarations\"")
+#define HMAC_SIGNER_SHA256_END _Pragma("GCC diagnostic pop")
+
+class HmacSigner {
+public:
+    static const size_t SIGNATURE_LEN = 44;  // base64(32 bytes) incl. padding
+
+    explicit HmacSigner(const std::string& base64Secret) {
+        std::string decoded = decodeSecret(base64Secret);
+
+        // Keys longer than the block size are hashed first (RFC 2104)
+        unsigned char key[SHA256_CBLOCK];
+        std::memset(key, 0, sizeof(key));
+        if (decoded.length() > SHA256_CBLOCK) {
+            SHA256(reinterpret_cast<const unsigned char*>(decoded.data()), decoded.length(), key);
+        } else {
+            std::memcpy(key, decoded.data(), decoded.length());
+        }
+        OPENSSL_cleanse(&decoded[0], decoded.length());
+
+        unsigned char pad[SHA256_CBLOCK];
+        HMAC_SIGNER_SHA256_BEGIN
+        for (size_t i = 0; i < SHA256_CBLOCK; i++) pad[i] = key[i] ^ 0x36;
+        SHA256_Init(&inner_);
+        SHA256_Update(&inner_, pad, SHA256_CBLOCK);
+
+        for (size_t i = 0; i < SHA256_CBLOCK; i++) pad[i] = key[i] ^ 0x5c;
+        SHA256_Init(&outer_);
+        SHA256_Update(&outer_, pad, SHA256_CBLOCK);
+        HMAC_SIGNER_SHA256_END
+
+        // Plain memset of dead locals may be dropped by the compiler
+        OPENSSL_cleanse(key, sizeof(key));
+        OPENSSL_cleanse(pad, sizeof(pad));
+    }
+
+    ~HmacSigner() {
+        OPENSSL_cleanse(&inner_, sizeof(inner_));
+        OPENSSL_cleanse(&outer_, sizeof(outer_));
+    }
+
+    // Sign timestamp + method + path + body, write SIGNATURE_LEN chars to out (not NUL-terminated)
+    void sign(const char* timestamp, size_t timestampLen,
+              const char* method, size_t methodLen,
+              const char* path, size_t pathLen,
+              const char* body, size_t bodyLen,
+              char* out) const {
+        HMAC_SIGNER_SHA256_BEGIN
+        SHA256_CTX ctx = inner_;
+        SHA256_Update(&ctx, timestamp, timestampLen);
+        SHA256_Update(&ctx, method, methodLen);
+        SHA256_Update(&ctx, path, pathLen);
+        SHA256_Update(&ctx, body, bodyLen);
+
+        unsigned char digest[SHA256_DIGEST_LENGTH];
+        SHA256_Final(digest, &ctx);
+
+        ctx = outer_;
+        SHA256_Update(&ctx, digest, SHA256_DIGEST_LENGTH);
+        SHA256_Final(digest, &ctx);
+        HMAC_SIGNER_SHA256_END
+
+        encodeUrlSafe(digest, out);
+    }
+
+    // Convenience overload (allocates) for non-hot-path callers
+    std::string sign(const std::string& timestamp, const std::string& method,
+                     const std::string& path, const std::string& body) const {
+        char out[SIGNATURE_LEN];
+        sign(timestamp.data(), timestamp.length(), method.data(), method.length(),
+             path.data(), path.length(), body.data(), body.length(), out);
+        return std::string(out, SIGNATURE_LEN);
+    }
+
+    // Base64 decode - supports both standard and URL-safe base64
+    static std::string decodeSecret(const std::string& input) {
+        std::string output;
+        output.reserve((input.length() * 3) / 4);
+        int val = 0;
+        int bits = 0;
+
+        for (char c : input) {
+            int idx;
+            if (c >= 'A' && c <= 'Z') idx = c - 'A';
+            else if (c >= 'a' && c <= 'z') idx = c - 'a' + 26;
+            else if (c >= '0' && c <= '9') idx = c - '0' + 52;
+            else if (c == '+' || c == '-') idx = 62;
+            else if (c == '/' || c == '_') idx = 63;
+            else continue;  // '=', whitespace, invalid chars
+
+            val = (val << 6) | idx;
+            bits += 6;
+
+            if (bits >= 8) {
+                bits -= 8;
+                output.push_back(static_cast<char>((val >> bits) & 0xFF));
+            }
+        }
+        return output;
+    }
+
+    // 32-byte digest -> 44 chars URL-safe base64 with '=' padding
+    static void encodeUrlSafe(const unsigned char* digest, char* out) {
+        static const char table[] =
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+        size_t o = 0;
+        size_t i = 0;
+        for (; i + 3 <= SHA256_DIGEST_LENGTH; i += 3) {
+            unsigned v = (digest[i] << 16) | (digest[i + 1] << 8) | digest[i + 2];
+            out[o++] = table[(v >> 18) & 0x3F];
+            out[o++] = table[(v >> 12) & 0x3F];
+            out[o++] = table[(v >> 6) & 0x3F];
+            out[o++] = table[v & 0x3F];
+        }
+        // 32 = 10*3 + 2: two trailing bytes -> 3 chars + '='
+        unsigned v = (digest[i] << 16) | (digest[i + 1] << 8);
+        out[o++] = table[(v >> 18) & 0x3F];
+        out[o++] = table[(v >> 12) & 0x3F];
+        out[o++] = table[(v >> 6) & 0x3F];
+        out[o++] = '=';
+    }
+
+private:
+    SHA256_CTX inner_;
+    SHA256_CTX outer_;
+};
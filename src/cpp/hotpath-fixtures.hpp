@@ -0,0 +1,327 @@
+/**
+ * Hot-Path Fixtures
+ *
+ * Inputs shared by the hot-path benchmarks (bench-hotpath.cpp) and their
+ * correctness tests (test-hotpath.cpp): a real-sized order as sent by
+ * updown-bot-cpp.ts, the pre-HmacSigner implementations (the benchmarks'
+ * "before" baseline and the response parser's reference), the captured
+ * response corpus and a recorded run for the replay simulator.
+ */
+
+#pragma once
+
+#include "order-response.hpp"
+#include "replay-sim.hpp"
+#include <openssl/hmac.h>
+#include <openssl/bio.h>
+#include <openssl/evp.h>
+#include <openssl/buffer.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+// Realistic inputs: one GTD order as sent by updown-bot-cpp.ts
+const char* SAMPLE_SECRET = "dGhpcy1pcy1hLTMyLWJ5dGUtdGVzdC1zZWNyZXQtISE=";
+const char* SAMPLE_TIMESTAMP = "1765343700";
+const char* ORDER_PATH = "/orders";
+const char* SAMPLE_ADDRESS = "0x9f8e7d6c5b4a39281706f5e4d3c2b1a098765432";
+const char* SAMPLE_API_KEY = "8a1b2c3d-4e5f-6789-abcd-ef0123456789";
+const char* SAMPLE_PASSPHRASE = "0f1e2d3c4b5a69788796a5b4c3d2e1f00f1e2d3c4b5a69788796a5b4c3d2e1f0";
+const char* SAMPLE_BODY =
+    "[{\"deferExec\":false,\"order\":{\"salt\":1234567890123,"
+    "\"maker\":\"0x5c2a9d6e2b4f0f1a3e8c7d6b5a4f3e2d1c0b9a87\","
+    "\"signer\":\"0x9f8e7d6c5b4a39281706f5e4d3c2b1a098765432\","
+    "\"taker\":\"0x0000000000000000000000000000000000000000\","
+    "\"tokenId\":\"71321045679252212594626385532706912750332728571942532289631379312455583992563\","
+    "\"makerAmount\":\"8800000\",\"takerAmount\":\"20000000\",\"expiration\":\"1765343670\","
+    "\"nonce\":\"0\",\"feeRateBps\":\"0\",\"side\":\"BUY\",\"signatureType\":2,"
+    "\"signature\":\"0x3b5e1f0c2a9d8e7f6b5a4c3d2e1f0a9b8c7d6e5f4a3b2c1d0e9f8a7b6c5d4e3f"
+    "2a1b0c9d8e7f6a5b4c3d2e1f0a9b8c7d6e5f4a3b2c1d0e9f8a7b6c5d4e3f2a1b1c\"},"
+    "\"owner\":\"8a1b2c3d-4e5f-6789-abcd-ef0123456789\",\"orderType\":\"GTD\"}]";
+// keccak("cow"), the EIP-712 spec's example key; a throwaway
+const char* SAMPLE_PRIVATE_KEY = "0xc85ef7d79691fe79573b1a7064c19c1a9819ebdbd1faaab1a8ec92344438aaf4";
+
+// ============================================================================
+// Legacy implementations (pre-HmacSigner), unchanged from updown-bot.cpp
+// ============================================================================
+namespace legacy {
+
+std::string base64Decode(const std::string& input) {
+    static const std::string base64_chars =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    auto indexOf = [&](char c) -> int {
+        if (c == '=') return -1;
+        if (c == '-') c = '+';
+        if (c == '_') c = '/';
+        size_t pos = base64_chars.find(c);
+        return (pos != std::string::npos) ? (int)pos : -2;
+    };
+
+    std::string output;
+    output.reserve((input.length() * 3) / 4);
+
+    int val = 0;
+    int bits = 0;
+
+    for (char c : input) {
+        if (c == '=' || c == '\n' || c == '\r' || c == ' ') continue;
+
+        int idx = indexOf(c);
+        if (idx < 0) continue;
+
+        val = (val << 6) | idx;
+        bits += 6;
+
+        if (bits >= 8) {
+            bits -= 8;
+            output.push_back(static_cast<char>((val >> bits) & 0xFF));
+        }
+    }
+
+    return output;
+}
+
+std::string base64Encode(const unsigned char* input, int length) {
+    BIO* bio = BIO_new(BIO_s_mem());
+    BIO* b64 = BIO_new(BIO_f_base64());
+    BIO_set_flags(b64, BIO_FLAGS_BASE64_NO_NL);
+    bio = BIO_push(b64, bio);
+
+    BIO_write(bio, input, length);
+    BIO_flush(bio);
+
+    BUF_MEM* bufferPtr;
+    BIO_get_mem_ptr(bio, &bufferPtr);
+
+    std::string output(bufferPtr->data, bufferPtr->length);
+    BIO_free_all(bio);
+    return output;
+}
+
+std::string generateSignature(const std::string& secret, const std::string& message) {
+    std::string decodedSecret = base64Decode(secret);
+
+    unsigned char hash[EVP_MAX_MD_SIZE];
+    unsigned int hashLen;
+
+    HMAC(EVP_sha256(),
+         decodedSecret.data(), decodedSecret.length(),
+         reinterpret_cast<const unsigned char*>(message.data()), message.length(),
+         hash, &hashLen);
+
+    std::string signature = base64Encode(hash, hashLen);
+
+    for (char& c : signature) {
+        if (c == '+') c = '-';
+        else if (c == '/') c = '_';
+    }
+
+    return signature;
+}
+
+// Response handling as in updown-bot.cpp before OrderResponseParser
+struct ResponseBuffer {
+    std::string data;
+};
+
+size_t writeCallback(void* contents, size_t size, size_t nmemb, void* userp) {
+    size_t totalSize = size * nmemb;
+    static_cast<ResponseBuffer*>(userp)->data.append(static_cast<char*>(contents), totalSize);
+    return totalSize;
+}
+
+std::string extractJsonString(const std::string& json, const std::string& key) {
+    std::string searchKey = "\"" + key + "\"";
+    size_t keyPos = json.find(searchKey);
+    if (keyPos == std::string::npos) return "";
+
+    size_t colonPos = json.find(':', keyPos);
+    if (colonPos == std::string::npos) return "";
+
+    size_t valueStart = json.find('"', colonPos);
+    if (valueStart == std::string::npos) return "";
+    valueStart++;
+
+    size_t valueEnd = valueStart;
+    while (valueEnd < json.length()) {
+        if (json[valueEnd] == '"' && (valueEnd == 0 || json[valueEnd - 1] != '\\')) break;
+        valueEnd++;
+    }
+
+    // Unescape the value
+    std::string value = json.substr(valueStart, valueEnd - valueStart);
+    std::string unescaped;
+    for (size_t i = 0; i < value.length(); i++) {
+        if (value[i] == '\\' && i + 1 < value.length()) {
+            char next = value[i + 1];
+            if (next == '"') { unescaped += '"'; i++; }
+            else if (next == '\\') { unescaped += '\\'; i++; }
+            else if (next == 'n') { unescaped += '\n'; i++; }
+            else if (next == 'r') { unescaped += '\r'; i++; }
+            else if (next == 't') { unescaped += '\t'; i++; }
+            else unescaped += value[i];
+        } else {
+            unescaped += value[i];
+        }
+    }
+    return unescaped;
+}
+
+bool isSuccess(const std::string& response, std::string& orderId) {
+    size_t orderIdPos = response.find("\"orderID\"");
+    if (orderIdPos == std::string::npos) {
+        orderIdPos = response.find("\"orderId\"");
+    }
+    if (orderIdPos != std::string::npos) {
+        orderId = extractJsonString(response, "orderID");
+        if (orderId.empty()) {
+            orderId = extractJsonString(response, "orderId");
+        }
+        return !orderId.empty();
+    }
+    return false;
+}
+
+std::string extractError(const std::string& response) {
+    std::string error = extractJsonString(response, "error");
+    if (error.empty()) {
+        error = extractJsonString(response, "errorMsg");
+    }
+    if (error.empty()) {
+        error = extractJsonString(response, "message");
+    }
+    if (error.empty() && !response.empty()) {
+        error = response.substr(0, std::min(response.length(), (size_t)100));
+    }
+    return error;
+}
+
+}  // namespace legacy
+
+// Scratch file of this process next to the real rings (tmpfs) when available
+std::string scratchPath(const char* program, const char* extension) {
+    const char* dir = access("/dev/shm", W_OK) == 0 ? "/dev/shm" : "/tmp";
+    return std::string(dir) + "/" + program + "-" + std::to_string(getpid()) + extension;
+}
+
+// A recorded run as the engine would have logged it over HTTP/1.1: `orders` orders,
+// each sending intervalMs after its previous 20ms answer, the orderbook open after
+// openAfterMs. A server bucket of limitRps (0: none) answers 429 when empty.
+ReplayScenario recordedScenario(int orders, int intervalMs, int openAfterMs, double limitRps) {
+    const int64_t startUs = 1764929700000000;
+    const uint32_t latencyUs = 20000;
+    ReplayScenarioBuilder builder;
+    std::vector<int64_t> nextUs;
+    for (int i = 0; i < orders; i++) {
+        builder.addOrder(i, "btc-updown-15m-1764929700");
+        nextUs.push_back(startUs + i * intervalMs * 1000LL / orders);
+    }
+    double tokens = limitRps;
+    int64_t refillUs = startUs;
+    for (;;) {
+        int i = (int)(std::min_element(nextUs.begin(), nextUs.end()) - nextUs.begin());
+        int64_t sentUs = nextUs[i];
+        if (sentUs == INT64_MAX) break;
+        int64_t arrivedUs = sentUs + latencyUs / 2;
+        bool limited = false;
+        if (limitRps > 0) {
+            tokens = std::min(limitRps, tokens + (arrivedUs - refillUs) / 1e6 * limitRps);
+            refillUs = arrivedUs;
+            limited = tokens < 1.0;
+            if (!limited) tokens -= 1.0;
+        }
+        bool open = !limited && arrivedUs >= startUs + openAfterMs * 1000LL;
+        ResponseKind kind = limited ? ResponseKind::RATE_LIMITED : open ? ResponseKind::FILLED : ResponseKind::NOT_OPEN;
+        builder.addAttempt(i, sentUs, latencyUs, false, kind, limited ? 429 : open ? 200 : 400, open);
+        nextUs[i] = open ? INT64_MAX : sentUs + latencyUs + intervalMs * 1000LL;
+    }
+    ReplayScenario& scenario = builder.scenario;
+    scenario.intervalMs = scenario.probeIntervalMs = intervalMs;
+    scenario.maxAttempts = 100000;
+    builder.finish();
+    return std::move(builder.scenario);
+}
+
+// ============================================================================
+// Response corpus: POST /orders answers captured from the live API
+// (LATENCY_RESULTS.md, LATENCY_STREAM_*.md) plus proxy/mock shapes
+// ============================================================================
+struct ResponseCase {
+    const char* name;
+    const char* body;
+    OrderResponse::Status status;
+    OrderResponse::Error error;
+    const char* expected;              // orderID or error text
+    bool legacyAgrees;                 // legacy substring search reads the same verdict
+};
+
+const ResponseCase RESPONSE_CASES[] = {
+    {"filled",
+     "{\"errorMsg\":\"\",\"orderID\":\"0xf625d9e6e4a44ceb73e7c537087c527b20c1d1231ddd78f1cd29c61c0a9153ff\","
+     "\"takingAmount\":\"\",\"makingAmount\":\"\",\"status\":\"live\",\"success\":true}",
+     OrderResponse::FILLED, OrderResponse::NONE,
+     "0xf625d9e6e4a44ceb73e7c537087c527b20c1d1231ddd78f1cd29c61c0a9153ff", true},
+    {"filled_pretty",
+     "{\n  \"orderID\": \"0xf625d9e6e4a44ceb73e7c537087c527b20c1d1231ddd78f1cd29c61c0a9153ff\",\n"
+     "  \"status\": \"live\",\n  \"success\": true\n}",
+     OrderResponse::FILLED, OrderResponse::NONE,
+     "0xf625d9e6e4a44ceb73e7c537087c527b20c1d1231ddd78f1cd29c61c0a9153ff", true},
+    {"not_open",
+     "{\"errorMsg\":\"the orderbook 86362524611116041012058324569056663539911098926631571012384588533603041653252 "
+     "does not exist\",\"orderID\":\"\",\"takingAmount\":\"\",\"makingAmount\":\"\",\"status\":\"\",\"success\":true}",
+     OrderResponse::REJECTED, OrderResponse::NOT_OPEN,
+     "the orderbook 86362524611116041012058324569056663539911098926631571012384588533603041653252 does not exist", true},
+    {"not_open_error",
+     "{\"error\":\"the orderbook 71321045679252212594626385532706912750332728571942532289631379312455583992563 does not exist\"}",
+     OrderResponse::REJECTED, OrderResponse::NOT_OPEN,
+     "the orderbook 71321045679252212594626385532706912750332728571942532289631379312455583992563 does not exist", true},
+    {"duplicated",
+     "{\"errorMsg\":\"order 0xf197e2b85c614a2451d49061b00f19a3ab1274107ce347d2d6a7ef9771cffaf7 is invalid. Duplicated.\","
+     "\"orderID\":\"\",\"takingAmount\":\"\",\"makingAmount\":\"\",\"status\":\"\",\"success\":true}",
+     OrderResponse::REJECTED, OrderResponse::DUPLICATED,
+     "order 0xf197e2b85c614a2451d49061b00f19a3ab1274107ce347d2d6a7ef9771cffaf7 is invalid. Duplicated.", true},
+    {"already_exists",
+     "{\"error\":\"order already exists\",\"orderID\":\"\"}",
+     OrderResponse::REJECTED, OrderResponse::DUPLICATED, "order already exists", true},
+    {"balance",
+     "{\"error\":\"not enough balance / allowance\"}",
+     OrderResponse::REJECTED, OrderResponse::BALANCE, "not enough balance / allowance", true},
+    {"unauthorized",
+     "{\"error\":\"Unauthorized/Invalid api key\"}",
+     OrderResponse::REJECTED, OrderResponse::UNAUTHORIZED, "Unauthorized/Invalid api key", true},
+    {"rate_limited_json",
+     "{\"error\":\"Too Many Requests\"}",
+     OrderResponse::REJECTED, OrderResponse::RATE_LIMITED, "Too Many Requests", true},
+    {"rate_limited_text",
+     "Too Many Requests\n",
+     OrderResponse::REJECTED, OrderResponse::RATE_LIMITED, "Too Many Requests", true},
+    {"proxy_html",
+     "<html>\r\n<head><title>502 Bad Gateway</title></head>\r\n<body>cloudflare</body>\r\n</html>",
+     OrderResponse::REJECTED, OrderResponse::OTHER, "<html>", true},
+    {"message_key",
+     "{\"message\":\"Internal server error\"}",
+     OrderResponse::REJECTED, OrderResponse::OTHER, "Internal server error", true},
+    {"escaped_error",
+     "{\"error\":\"invalid \\\"price\\\" \\\\ tick\",\"orderID\":\"\"}",
+     OrderResponse::REJECTED, OrderResponse::OTHER, "invalid \\\"price\\\" \\\\ tick", true},
+    {"batch",
+     "[{\"errorMsg\":\"the orderbook 1 does not exist\",\"orderID\":\"\",\"success\":true},"
+     "{\"errorMsg\":\"\",\"orderID\":\"0xabc123\",\"status\":\"live\",\"success\":true}]",
+     OrderResponse::FILLED, OrderResponse::NONE, "0xabc123", false},
+    {"batch_nested",
+     "[{\"errorMsg\":\"not enough balance / allowance\",\"orderID\":\"\",\"transactionsHashes\":[],\"success\":true},\n"
+     " {\"errorMsg\":\"\",\"orderID\":\"0xdef456\",\"transactionsHashes\":[\"0x01\"],\"status\":\"matched\",\"success\":true},\n"
+     " {\"errorMsg\":\"order 0x1 is invalid. Duplicated.\",\"orderID\":\"\",\"success\":true}]",
+     OrderResponse::FILLED, OrderResponse::NONE, "0xdef456", false},
+    {"key_as_value",
+     "{\"status\":\"error\",\"detail\":\"orderID\",\"errorMsg\":\"price out of range\"}",
+     OrderResponse::REJECTED, OrderResponse::OTHER, "price out of range", false},
+    {"empty_fields",
+     "{\"errorMsg\":\"\",\"orderID\":\"\",\"status\":\"\",\"success\":true}",
+     OrderResponse::REJECTED, OrderResponse::OTHER,
+     "{\"errorMsg\":\"\",\"orderID\":\"\",\"status\":\"\",\"success\":true}", true},
+    {"empty", "", OrderResponse::EMPTY, OrderResponse::NONE, "", true},
+};
+
@@ -0,0 +1,146 @@
+/**
+ * Keccak256 - Ethereum's Keccak-256 (original Keccak padding, not SHA3-256)
+ *
+ * OpenSSL's "KECCAK-256" digest where the provider has it (3.2+), fetched
+ * once per process; each hasher keeps its EVP_MD_CTX and re-initializes it,
+ * so a reused one does not allocate. OpenSSL 3.0/3.1 only ship the FIPS SHA3
+ * padding: there the permutation below runs instead (Keccak-f[1600], rate
+ * 136 bytes, domain byte 0x01, no heap use).
+ * Streaming (update/final, then reusable); one-shot hash() for short input.
+ */
+
+#pragma once
+
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+class Keccak256 {
+public:
+    static const size_t HASH_LEN = 32;
+    static const size_t RATE = 136;
+
+    Keccak256() {
+        if (const EVP_MD* md = provided()) {
+            evp_ = EVP_MD_CTX_new();
+            if (evp_ && !EVP_DigestInit_ex2(evp_, md, nullptr)) {
+                EVP_MD_CTX_free(evp_);
+                evp_ = nullptr;
+            }
+        }
+        std::memset(state_, 0, sizeof(state_));
+        offset_ = 0;
+    }
+
+    ~Keccak256() { EVP_MD_CTX_free(evp_); }
+
+    Keccak256(const Keccak256&) = delete;
+    Keccak256& operator=(const Keccak256&) = delete;
+
+    // True if hashing goes through OpenSSL rather than the built-in permutation
+    static bool openssl() { return provided() != nullptr; }
+
+    void reset() {
+        if (evp_) {
+            EVP_DigestInit_ex2(evp_, provided(), nullptr);
+            return;
+        }
+        std::memset(state_, 0, sizeof(state_));
+        offset_ = 0;
+    }
+
+    void update(const void* data, size_t length) {
+        if (evp_) {
+            EVP_DigestUpdate(evp_, data, length);
+            return;
+        }
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < length; i++) {
+            state_[offset_ / 8] ^= (uint64_t)bytes[i] << (8 * (offset_ % 8));
+            if (++offset_ == RATE) {
+                permute(state_);
+                offset_ = 0;
+            }
+        }
+    }
+
+    void final(uint8_t out[HASH_LEN]) {
+        if (evp_) {
+            EVP_DigestFinal_ex(evp_, out, nullptr);
+            reset();
+            return;
+        }
+        state_[offset_ / 8] ^= (uint64_t)0x01 << (8 * (offset_ % 8));
+        state_[(RATE - 1) / 8] ^= (uint64_t)0x80 << (8 * ((RATE - 1) % 8));
+        permute(state_);
+        for (size_t i = 0; i < HASH_LEN; i++) out[i] = (uint8_t)(state_[i / 8] >> (8 * (i % 8)));
+        reset();
+    }
+
+    static void hash(const void* data, size_t length, uint8_t out[HASH_LEN]) {
+        Keccak256 keccak;
+        keccak.update(data, length);
+        keccak.final(out);
+    }
+
+private:
+    EVP_MD_CTX* evp_ = nullptr;
+    uint64_t state_[25];
+    size_t offset_;
+
+    // Fetched once; the failed fetch on an older provider leaves no error queued
+    static const EVP_MD* provided() {
+        static const EVP_MD* md = [] {
+            ERR_set_mark();
+            EVP_MD* fetched = EVP_MD_fetch(nullptr, "KECCAK-256", nullptr);
+            ERR_pop_to_mark();
+            return fetched;
+        }();
+        return md;
+    }
+
+    static uint64_t rotl(uint64_t x, int n) { return n == 0 ? x : (x << n) | (x >> (64 - n)); }
+
+    static void permute(uint64_t a[25]) {
+        static const uint64_t ROUND_CONSTANTS[24] = {
+            0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+            0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+            0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+            0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+            0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+            0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL,
+        };
+        // Rotation offsets and pi lane order, walked from lane 1
+        static const int RHO[24] = {1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14,
+                                    27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44};
+        static const int PI[24] = {10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4,
+                                   15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1};
+
+        for (int round = 0; round < 24; round++) {
+            // Theta
+            uint64_t c[5];
+            for (int x = 0; x < 5; x++) c[x] = a[x] ^ a[x + 5] ^ a[x + 10] ^ a[x + 15] ^ a[x + 20];
+            for (int x = 0; x < 5; x++) {
+                uint64_t d = c[(x + 4) % 5] ^ rotl(c[(x + 1) % 5], 1);
+                for (int y = 0; y < 25; y += 5) a[y + x] ^= d;
+            }
+            // Rho + pi
+            uint64_t carry = a[1];
+            for (int i = 0; i < 24; i++) {
+                uint64_t next = a[PI[i]];
+                a[PI[i]] = rotl(carry, RHO[i]);
+                carry = next;
+            }
+            // Chi
+            for (int y = 0; y < 25; y += 5) {
+                uint64_t row[5];
+                for (int x = 0; x < 5; x++) row[x] = a[y + x];
+                for (int x = 0; x < 5; x++) a[y + x] = row[x] ^ (~row[(x + 1) % 5] & row[(x + 2) % 5]);
+            }
+            // Iota
+            a[0] ^= ROUND_CONSTANTS[round];
+        }
+    }
+};
@@ -0,0 +1,194 @@
+/**
+ * LatencyHistogram / PhaseHistograms - per-phase request latency percentiles
+ *
+ * LatencyHistogram is an HDR-style log-linear histogram of microsecond
+ * values: power-of-two buckets split into SUB_BUCKETS/2 linear sub-buckets,
+ * so every recorded value is kept with < 1% relative error over
+ * 1µs..~71min. Counters are allocated once; record() is a couple of shifts
+ * and an increment (no allocation, safe on the send path).
+ *
+ * PhaseHistograms splits each completed transfer with CURLINFO_*_TIME_T:
+ *   queue        wall time not covered by curl's transfer timer (waiting in
+ *                the multi for a connection/stream, completion pickup)
+ *   dns          name lookup
+ *   connect      TCP connect
+ *   tls          TLS handshake
+ *   pretransfer  from connection ready until the request starts going out
+ *   ttfb         request sent -> first response byte (network RTT + server time)
+ *   transfer     first response byte -> done
+ *   total        curl's total transfer time
+ * Reused connections report 0 for dns/connect/tls.
+ *
+ * libcurl 7.x sets STARTTRANSFER for HTTP/2 uploads when the request body
+ * has been sent, not when the response starts, so the first response byte
+ * is timestamped by our own header callback (trackFirstByte) and mapped
+ * back onto curl's timeline from the completion instant.
+ *
+ * Summary lines (machine-readable):
+ *   LATENCY:<scope>:<phase>:count=N,min_us=..,p50_us=..,p90_us=..,p99_us=..,p999_us=..,max_us=..
+ */
+
+#pragma once
+
+#include <curl/curl.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+class LatencyHistogram {
+public:
+    static const int SUB_BUCKET_BITS = 8;  // 256 sub-buckets: < 0.8% error
+    static const int MAX_VALUE_BITS = 32;  // values clamp at 2^32-1 µs
+
+    LatencyHistogram() : counts_(countsLength(), 0) {}
+
+    void record(int64_t valueUs) {
+        uint64_t v = valueUs < 0 ? 0 : (uint64_t)valueUs;
+        if (v > MAX_VALUE) v = MAX_VALUE;
+        counts_[indexFor(v)]++;
+        total_++;
+        if (v < min_) min_ = v;
+        if (v > max_) max_ = v;
+    }
+
+    uint64_t count() const { return total_; }
+    uint64_t min() const { return total_ ? min_ : 0; }
+    uint64_t max() const { return max_; }
+
+    // Value at percentile p (0..100): highest value equivalent to the
+    // bucket holding the p-th ranked sample, capped at the recorded max
+    uint64_t percentile(double p) const {
+        if (total_ == 0) return 0;
+        uint64_t rank = (uint64_t)(p / 100.0 * (double)total_ + 0.999999);
+        rank = std::max<uint64_t>(1, std::min(rank, total_));
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts_.size(); i++) {
+            seen += counts_[i];
+            if (seen >= rank) return std::min(highestEquivalent(i), max_);
+        }
+        return max_;
+    }
+
+    void reset() {
+        std::fill(counts_.begin(), counts_.end(), 0);
+        total_ = 0;
+        min_ = UINT64_MAX;
+        max_ = 0;
+    }
+
+    void print(std::ostream& out, const char* scope, const char* phase) const {
+        out << "LATENCY:" << scope << ":" << phase << ":count=" << total_
+            << ",min_us=" << min() << ",p50_us=" << percentile(50) << ",p90_us=" << percentile(90)
+            << ",p99_us=" << percentile(99) << ",p999_us=" << percentile(99.9)
+            << ",max_us=" << max_ << "\n";
+    }
+
+private:
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static const int HALF_BITS = SUB_BUCKET_BITS - 1;
+    static const int HALF = 1 << HALF_BITS;
+    static const uint64_t MAX_VALUE = (1ULL << MAX_VALUE_BITS) - 1;
+
+    std::vector<uint64_t> counts_;
+    uint64_t total_ = 0;
+    uint64_t min_ = UINT64_MAX;
+    uint64_t max_ = 0;
+
+    static size_t countsLength() {
+        return (size_t)(MAX_VALUE_BITS - SUB_BUCKET_BITS + 2) << HALF_BITS;
+    }
+
+    // Bucket 0 covers [0, SUB_BUCKETS) at unit resolution; bucket b covers
+    // [HALF << b, SUB_BUCKETS << b) in HALF steps of 2^b
+    static size_t indexFor(uint64_t v) {
+        int bucket = 63 - __builtin_clzll(v | (SUB_BUCKETS - 1)) - HALF_BITS;
+        uint64_t sub = v >> bucket;
+        return ((size_t)(bucket + 1) << HALF_BITS) + (size_t)(sub - HALF);
+    }
+
+    static uint64_t highestEquivalent(size_t index) {
+        if (index < (size_t)SUB_BUCKETS) return index;
+        int bucket = (int)(index >> HALF_BITS) - 1;
+        uint64_t sub = (index & (HALF - 1)) + HALF;
+        return ((sub + 1) << bucket) - 1;
+    }
+};
+
+class PhaseHistograms {
+public:
+    enum Phase { QUEUE, DNS, CONNECT, TLS, PRETRANSFER, TTFB, TRANSFER, TOTAL, PHASE_COUNT };
+
+    PhaseHistograms() : phases_(PHASE_COUNT) {}
+
+    static int64_t nowUs() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Store nowUs() of the first response header in *firstByteUs (reset it to 0 before each transfer)
+    static void trackFirstByte(CURL* curl, int64_t* firstByteUs) {
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, headerCallback);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, firstByteUs);
+    }
+
+    // Break down one completed transfer. wallUs = our own add_handle -> completion time;
+    // firstByteUs/doneUs (nowUs() clock) refine TTFB when the first byte was tracked.
+    void record(CURL* curl, int64_t wallUs, int64_t firstByteUs = 0, int64_t doneUs = 0) {
+        int64_t phasesUs[PHASE_COUNT];
+        breakdown(curl, wallUs, firstByteUs, doneUs, phasesUs);
+        record(phasesUs);
+    }
+
+    void record(const int64_t phasesUs[PHASE_COUNT]) {
+        for (int p = 0; p < PHASE_COUNT; p++) phases_[p].record(phasesUs[p]);
+    }
+
+    // Per-phase durations of one transfer, without recording them
+    static void breakdown(CURL* curl, int64_t wallUs, int64_t firstByteUs, int64_t doneUs,
+                          int64_t phasesUs[PHASE_COUNT]) {
+        curl_off_t dns = 0, connect = 0, appConnect = 0, pretransfer = 0, startTransfer = 0, total = 0;
+        curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME_T, &dns);
+        curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME_T, &connect);
+        curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME_T, &appConnect);
+        curl_easy_getinfo(curl, CURLINFO_PRETRANSFER_TIME_T, &pretransfer);
+        curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME_T, &startTransfer);
+        curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &total);
+
+        // First byte offset on curl's timeline = total - (done - first byte)
+        if (firstByteUs > 0 && doneUs >= firstByteUs) {
+            startTransfer = std::max<curl_off_t>(pretransfer, total - (doneUs - firstByteUs));
+        }
+
+        // Timings are cumulative from transfer start; zeros mean "phase skipped"
+        curl_off_t connected = std::max(dns, std::max(connect, appConnect));
+        phasesUs[QUEUE] = wallUs - total;
+        phasesUs[DNS] = dns;
+        phasesUs[CONNECT] = connect > dns ? connect - dns : 0;
+        phasesUs[TLS] = appConnect > connect ? appConnect - connect : 0;
+        phasesUs[PRETRANSFER] = pretransfer > connected ? pretransfer - connected : 0;
+        phasesUs[TTFB] = startTransfer > pretransfer ? startTransfer - pretransfer : 0;
+        phasesUs[TRANSFER] = total > startTransfer ? total - startTransfer : 0;
+        phasesUs[TOTAL] = total;
+    }
+
+    const LatencyHistogram& phase(Phase p) const { return phases_[p]; }
+
+    void print(std::ostream& out, const char* scope) const {
+        static const char* names[PHASE_COUNT] = {
+            "queue", "dns", "connect", "tls", "pretransfer", "ttfb", "transfer", "total"};
+        if (phases_[TOTAL].count() == 0) return;
+        for (int p = 0; p < PHASE_COUNT; p++) phases_[p].print(out, scope, names[p]);
+    }
+
+private:
+    std::vector<LatencyHistogram> phases_;
+
+    static size_t headerCallback(char*, size_t size, size_t nitems, void* userdata) {
+        int64_t* firstByteUs = static_cast<int64_t*>(userdata);
+        if (*firstByteUs == 0) *firstByteUs = nowUs();
+        return size * nitems;
+    }
+};
@@ -0,0 +1,373 @@
+/**
+ * MarketDiscovery - background prefetch of upcoming up/down markets
+ *
+ * Up/down markets are listed on Gamma well ahead of their slot under
+ * predictable slugs, "<prefix>-<slot start, unix s>" with a slot every
+ * SLOT_SECONDS. A background thread keeps the current slot and the next
+ * `lookahead` ones of every prefix in a small cache, fetching
+ * GET <gammaUrl>/markets/slug/<slug> on its own keep-alive curl handle:
+ *   - not listed yet (404, no clobTokenIds): polled, nearest slot first,
+ *     one request per pollMs across all pending markets
+ *   - listed without acceptingOrdersTimestamp: refetched every
+ *     ACCEPTING_REFRESH_POLLS * pollMs
+ *   - complete: never fetched again; evicted one slot after it started
+ * Slugs outside the schedule are fetched once lookup() asked for them.
+ *
+ * lookup() only copies a cache entry under a mutex that the thread never
+ * holds across a request, so the engine loop and the daemon's socket
+ * never wait on Gamma. Events (a market first cached) are queued for the
+ * caller's thread:
+ *   MARKET:found:slug=..,polls=..,fetch_ms=..,lead_s=..
+ *     lead_s: seconds before the slot start the market was cached
+ */
+
+#pragma once
+
+#include <curl/curl.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct MarketInfo {
+    std::string slug;
+    long long slotStart = 0;           // unix s, from the slug
+    std::string yesTokenId;            // clobTokenIds[0]
+    std::string noTokenId;             // clobTokenIds[1]
+    std::string acceptingOrdersTimestamp;  // ISO 8601; empty until Gamma sets it
+    int polls = 0;
+    double fetchMs = 0;                // the request that found it
+
+    bool listed() const { return !yesTokenId.empty() && !noTokenId.empty(); }
+    bool complete() const { return listed() && !acceptingOrdersTimestamp.empty(); }
+};
+
+class MarketDiscovery {
+public:
+    static const long long SLOT_SECONDS = 900;
+    static const int ACCEPTING_REFRESH_POLLS = 20;
+    static const size_t MAX_MARKETS = 64;
+
+    struct Config {
+        std::string gammaUrl = "https://gamma-api.polymarket.com";
+        std::string caFile;            // extra CA bundle (mock server)
+        std::vector<std::string> prefixes;  // e.g. "btc-updown-15m"
+        int lookahead = 3;             // slots after the current one
+        int pollMs = 250;
+    };
+
+    MarketDiscovery() = default;
+    MarketDiscovery(const MarketDiscovery&) = delete;
+    MarketDiscovery& operator=(const MarketDiscovery&) = delete;
+
+    ~MarketDiscovery() { stop(); }
+
+    bool start(const Config& config) {
+        stop();
+        config_ = config;
+        config_.pollMs = std::max(1, config_.pollMs);
+        curl_ = curl_easy_init();
+        if (!curl_) return false;
+        curl_easy_setopt(curl_, CURLOPT_NOSIGNAL, 1L);
+        curl_easy_setopt(curl_, CURLOPT_TCP_KEEPALIVE, 1L);
+        curl_easy_setopt(curl_, CURLOPT_TIMEOUT, 10L);
+        curl_easy_setopt(curl_, CURLOPT_ACCEPT_ENCODING, "");
+        curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, writeCallback);
+        curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &body_);
+        if (!config_.caFile.empty()) curl_easy_setopt(curl_, CURLOPT_CAINFO, config_.caFile.c_str());
+
+        stopping_ = false;
+        thread_ = std::thread([this]() { loop(); });
+        return true;
+    }
+
+    void stop() {
+        if (thread_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            wake_.notify_all();
+            thread_.join();
+        }
+        if (curl_) curl_easy_cleanup(curl_);
+        curl_ = nullptr;
+    }
+
+    bool running() const { return thread_.joinable(); }
+    std::thread::native_handle_type nativeHandle() { return thread_.native_handle(); }
+
+    // Cached market for slug; false (and the slug queued for a fetch) if not listed yet
+    bool lookup(const std::string& slug, MarketInfo& out) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& market : markets_) {
+            if (market.info.slug != slug) continue;
+            out = market.info;
+            return market.info.listed();
+        }
+        long long slotStart = slotOf(slug);
+        if (slotStart > 0 && markets_.size() < MAX_MARKETS) {
+            Entry entry;
+            entry.info.slug = slug;
+            entry.info.slotStart = slotStart;
+            entry.requested = true;
+            markets_.push_back(entry);
+            wake_.notify_all();
+        }
+        out = MarketInfo();
+        out.slug = slug;
+        return false;
+    }
+
+    // Write and clear the queued MARKET: lines
+    void printEvents(std::ostream& out) {
+        std::vector<std::string> events;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            events.swap(events_);
+        }
+        for (const auto& line : events) out << line << std::endl;
+    }
+
+    // "<prefix>-<slot start>" for the slot k slots after the one containing unixS
+    static std::string slugFor(const std::string& prefix, long long unixS, int k) {
+        return prefix + "-" + std::to_string(unixS / SLOT_SECONDS * SLOT_SECONDS + k * SLOT_SECONDS);
+    }
+
+    // Slot start from the slug's trailing number, 0 if it has none
+    static long long slotOf(const std::string& slug) {
+        size_t dash = slug.rfind('-');
+        if (dash == std::string::npos || dash + 1 >= slug.size()) return 0;
+        long long value = 0;
+        for (size_t i = dash + 1; i < slug.size(); i++) {
+            if (slug[i] < '0' || slug[i] > '9') return 0;
+            value = value * 10 + (slug[i] - '0');
+        }
+        return value;
+    }
+
+    // Fill clobTokenIds / acceptingOrdersTimestamp from a Gamma market object
+    // (top-level keys only; clobTokenIds may be a JSON array or a string holding one)
+    static bool parseMarket(const std::string& json, MarketInfo& info) {
+        size_t start = 0;
+        size_t end = 0;
+        if (topLevelValue(json, "clobTokenIds", start, end)) {
+            std::vector<std::string> ids;
+            for (size_t i = start; i < end;) {
+                if (json[i] < '0' || json[i] > '9') {
+                    i++;
+                    continue;
+                }
+                size_t digits = i;
+                while (i < end && json[i] >= '0' && json[i] <= '9') i++;
+                ids.push_back(json.substr(digits, i - digits));
+            }
+            if (ids.size() >= 2) {
+                info.yesTokenId = ids[0];
+                info.noTokenId = ids[1];
+            }
+        }
+        if (topLevelValue(json, "acceptingOrdersTimestamp", start, end) && json[start] == '"') {
+            info.acceptingOrdersTimestamp = json.substr(start + 1, end - start - 2);
+        }
+        return info.listed();
+    }
+
+private:
+    struct Entry {
+        MarketInfo info;
+        bool requested = false;        // asked for by lookup(), outside the schedule
+        long long nextFetchMs = 0;     // steady ms
+    };
+
+    Config config_;
+    CURL* curl_ = nullptr;
+    std::string body_;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::vector<Entry> markets_;
+    std::vector<std::string> events_;
+
+    static size_t writeCallback(void* contents, size_t size, size_t nmemb, void* userp) {
+        static_cast<std::string*>(userp)->append(static_cast<const char*>(contents), size * nmemb);
+        return size * nmemb;
+    }
+
+    static long long steadyMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static long long unixNow() {
+        return std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    // Value span [start, end) of a key of the outermost object
+    static bool topLevelValue(const std::string& json, const char* key, size_t& start, size_t& end) {
+        size_t keyLength = strlen(key);
+        int depth = 0;
+        for (size_t i = 0; i < json.size(); i++) {
+            char c = json[i];
+            if (c == '{' || c == '[') {
+                depth++;
+            } else if (c == '}' || c == ']') {
+                depth--;
+            } else if (c == '"') {
+                size_t close = skipString(json, i);
+                bool match = depth == 1 && close - i - 1 == keyLength && json.compare(i + 1, keyLength, key) == 0;
+                i = close;
+                if (!match) continue;
+                size_t colon = json.find_first_not_of(" \t\r\n", i + 1);
+                if (colon == std::string::npos || json[colon] != ':') continue;
+                start = json.find_first_not_of(" \t\r\n", colon + 1);
+                if (start == std::string::npos) return false;
+                end = valueEnd(json, start);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Index of the quote closing the string opened at `open`
+    static size_t skipString(const std::string& json, size_t open) {
+        size_t i = open + 1;
+        while (i < json.size() && json[i] != '"') i += json[i] == '\\' ? 2 : 1;
+        return std::min(i, json.size() - 1);
+    }
+
+    static size_t valueEnd(const std::string& json, size_t start) {
+        if (json[start] == '"') return skipString(json, start) + 1;
+        int depth = 0;
+        for (size_t i = start; i < json.size(); i++) {
+            char c = json[i];
+            if (c == '"') {
+                i = skipString(json, i);
+            } else if (c == '{' || c == '[') {
+                depth++;
+            } else if (c == '}' || c == ']') {
+                if (depth == 0) return i;
+                if (--depth == 0) return i + 1;
+            } else if (c == ',' && depth == 0) {
+                return i;
+            }
+        }
+        return json.size();
+    }
+
+    // Add the scheduled slugs, drop markets whose slot is over
+    void refreshSchedule(long long nowS) {
+        long long currentSlot = nowS / SLOT_SECONDS * SLOT_SECONDS;
+        markets_.erase(std::remove_if(markets_.begin(), markets_.end(), [currentSlot](const Entry& e) {
+            return e.info.slotStart < currentSlot - SLOT_SECONDS;
+        }), markets_.end());
+
+        for (const auto& prefix : config_.prefixes) {
+            for (int k = 0; k <= config_.lookahead; k++) {
+                std::string slug = slugFor(prefix, nowS, k);
+                bool known = std::any_of(markets_.begin(), markets_.end(),
+                                         [&slug](const Entry& e) { return e.info.slug == slug; });
+                if (known || markets_.size() >= MAX_MARKETS) continue;
+                Entry entry;
+                entry.info.slug = slug;
+                entry.info.slotStart = currentSlot + k * SLOT_SECONDS;
+                markets_.push_back(entry);
+            }
+        }
+    }
+
+    // Next market to fetch: not listed before listed, then nearest slot; -1 if none is due
+    int nextDue(long long nowMs, long long& wakeAtMs) const {
+        int pick = -1;
+        for (size_t i = 0; i < markets_.size(); i++) {
+            const Entry& e = markets_[i];
+            if (e.info.complete()) continue;
+            if (e.nextFetchMs > nowMs) {
+                wakeAtMs = std::min(wakeAtMs, e.nextFetchMs);
+                continue;
+            }
+            if (pick < 0) {
+                pick = (int)i;
+                continue;
+            }
+            const MarketInfo& best = markets_[pick].info;
+            if (e.info.listed() != best.listed() ? !e.info.listed() : e.info.slotStart < best.slotStart) {
+                pick = (int)i;
+            }
+        }
+        return pick;
+    }
+
+    void loop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        long long lastFetchMs = 0;
+        while (!stopping_) {
+            long long nowMs = steadyMs();
+            long long nowS = unixNow();
+            refreshSchedule(nowS);
+
+            // Wake at the next slot boundary at the latest (new slugs to schedule)
+            long long wakeAtMs = nowMs + ((nowS / SLOT_SECONDS + 1) * SLOT_SECONDS - nowS) * 1000;
+            int due = nowMs - lastFetchMs >= config_.pollMs ? nextDue(nowMs, wakeAtMs)
+                                                             : -1;
+            if (due < 0) {
+                if (nowMs - lastFetchMs < config_.pollMs) wakeAtMs = std::min(wakeAtMs, lastFetchMs + config_.pollMs);
+                wake_.wait_for(lock, std::chrono::milliseconds(std::max(1LL, wakeAtMs - nowMs)));
+                continue;
+            }
+
+            std::string slug = markets_[due].info.slug;
+            lock.unlock();
+            MarketInfo fetched;
+            auto fetchStart = std::chrono::steady_clock::now();
+            bool ok = fetch(slug, fetched);
+            double fetchMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - fetchStart).count();
+            lock.lock();
+            lastFetchMs = steadyMs();
+
+            // The entry may have been evicted meanwhile
+            for (auto& e : markets_) {
+                if (e.info.slug != slug) continue;
+                e.info.polls++;
+                bool wasListed = e.info.listed();
+                if (ok && fetched.listed()) {
+                    e.info.yesTokenId = fetched.yesTokenId;
+                    e.info.noTokenId = fetched.noTokenId;
+                    e.info.acceptingOrdersTimestamp = fetched.acceptingOrdersTimestamp;
+                    if (!wasListed) e.info.fetchMs = fetchMs;
+                }
+                e.nextFetchMs = lastFetchMs + (e.info.listed() ? config_.pollMs * ACCEPTING_REFRESH_POLLS
+                                                               : config_.pollMs);
+                if (!wasListed && e.info.listed()) {
+                    std::ostringstream line;
+                    line << "MARKET:found:slug=" << slug << ",polls=" << e.info.polls << std::fixed
+                         << std::setprecision(1) << ",fetch_ms=" << fetchMs
+                         << ",lead_s=" << (e.info.slotStart - unixNow());
+                    events_.push_back(line.str());
+                }
+                break;
+            }
+        }
+    }
+
+    // GET /markets/slug/<slug>; false on transport errors and non-2xx answers
+    bool fetch(const std::string& slug, MarketInfo& info) {
+        std::string url = config_.gammaUrl + "/markets/slug/" + slug;
+        body_.clear();
+        curl_easy_setopt(curl_, CURLOPT_URL, url.c_str());
+        if (curl_easy_perform(curl_) != CURLE_OK) return false;
+        long status = 0;
+        curl_easy_getinfo(curl_, CURLINFO_RESPONSE_CODE, &status);
+        if (status < 200 || status >= 300) return false;
+        return parseMarket(body_, info);
+    }
+};
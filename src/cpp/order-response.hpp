@@ -0,0 +1,296 @@
+/**
+ * OrderResponseParser - single-pass, allocation-free POST /orders response classifier
+ *
+ * Runs inside the curl write callback: each chunk is copied into a fixed
+ * buffer reused across attempts and scanned once, incrementally, by a small
+ * JSON tokenizer that only tracks the keys we care about:
+ *   orderID / orderId          -> filled when non-empty
+ *   error / errorMsg / message -> error text: first non-empty, in that priority
+ * Bodies without any of them (proxy pages, plain text) keep their first
+ * line, up to FALLBACK_MESSAGE_LEN bytes, as the error text. The result holds spans into
+ * the buffer (raw JSON text, escapes not decoded), valid until reset().
+ * Bodies longer than CAPACITY are truncated and flagged, never reallocated.
+ *
+ * Error codes (from the error text):
+ *   NOT_OPEN      "does not exist"                 orderbook not open yet
+ *   DUPLICATED    "Duplicated" / "already exists"  an earlier attempt was placed
+ *   BALANCE       "not enough balance"
+ *   UNAUTHORIZED  "Unauthorized" / "Invalid api key"
+ *   RATE_LIMITED  "Too Many Requests"
+ *   OTHER         anything else
+ * The API answers "success":true for rejected orders too, so it is ignored.
+ *
+ * A batch POST (several orders in one array body) is answered with one
+ * result object per order, in request order. The tokenizer also tracks the
+ * same fields per top-level array element (up to MAX_ITEMS); item(i) is
+ * the result for the i-th order. A body that is not such an array (429,
+ * auth error, proxy page) has itemCount() 0 and applies to every order.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+
+struct Span {
+    const char* data = nullptr;
+    size_t length = 0;
+
+    bool empty() const { return length == 0; }
+    bool contains(const char* needle) const {
+        return length > 0 && memmem(data, length, needle, strlen(needle)) != nullptr;
+    }
+    std::string str() const { return std::string(data ? data : "", length); }
+};
+
+struct OrderResponse {
+    enum Status { EMPTY, FILLED, REJECTED };
+    enum Error { NONE, NOT_OPEN, DUPLICATED, BALANCE, UNAUTHORIZED, RATE_LIMITED, OTHER };
+
+    Status status = EMPTY;
+    Error error = NONE;
+    Span orderId;
+    Span message;                      // error text, raw JSON
+    bool truncated = false;
+
+    bool filled() const { return status == FILLED; }
+
+    static const char* errorName(Error error) {
+        static const char* names[] = {"none", "not_open", "duplicated", "balance",
+                                      "unauthorized", "rate_limited", "other"};
+        return names[error];
+    }
+};
+
+class OrderResponseParser {
+public:
+    static const size_t CAPACITY = 8192;
+    static const size_t FALLBACK_MESSAGE_LEN = 100;
+    static const size_t MAX_ITEMS = 16;
+
+    OrderResponseParser() { reset(); }
+
+    OrderResponseParser(const OrderResponseParser&) = delete;
+    OrderResponseParser& operator=(const OrderResponseParser&) = delete;
+
+    // CURLOPT_WRITEFUNCTION; CURLOPT_WRITEDATA = the parser
+    static size_t writeCallback(void* contents, size_t size, size_t nmemb, void* userp) {
+        size_t totalSize = size * nmemb;
+        static_cast<OrderResponseParser*>(userp)->append(static_cast<const char*>(contents), totalSize);
+        return totalSize;
+    }
+
+    void reset() {
+        size_ = 0;
+        truncated_ = false;
+        inString_ = false;
+        escape_ = false;
+        stringStart_ = 0;
+        keyCandidate_ = NO_FIELD;
+        valueFor_ = NO_FIELD;
+        for (auto& field : fields_) field = FieldSpan();
+        depth_ = 0;
+        opened_ = false;
+        topArray_ = false;
+        itemCount_ = 0;
+        buf_[0] = '\0';
+    }
+
+    // Store and scan one chunk
+    void append(const char* data, size_t length) {
+        if (length > CAPACITY - size_) {
+            length = CAPACITY - size_;
+            truncated_ = true;
+        }
+        memcpy(buf_ + size_, data, length);
+        size_t end = size_ + length;
+        for (size_t pos = size_; pos < end; pos++) scan(pos);
+        size_ = end;
+        buf_[size_] = '\0';
+    }
+
+    // Classify everything received so far
+    OrderResponse result() const {
+        return build(fields_);
+    }
+
+    // Result objects of a batch response so far (0 unless the body is an array of objects)
+    size_t itemCount() const { return itemCount_; }
+
+    // Result for the i-th order of a batch: the whole body unless it is an array,
+    // EMPTY for an order the array has no result for (truncated body)
+    OrderResponse item(size_t i) const {
+        if (!topArray_) return result();
+        if (i < itemCount_) return build(items_[i]);
+        OrderResponse missing;
+        missing.truncated = truncated_;
+        return missing;
+    }
+
+    // Raw body (NUL-terminated)
+    const char* data() const { return buf_; }
+    size_t size() const { return size_; }
+
+private:
+    enum Field { ORDER_ID, ORDER_ID_LOWER, ERROR, ERROR_MSG, MESSAGE, FIELD_COUNT, NO_FIELD = FIELD_COUNT };
+
+    struct FieldSpan {
+        size_t start = 0;
+        size_t length = 0;
+    };
+
+    char buf_[CAPACITY + 1];
+    size_t size_ = 0;
+    bool truncated_ = false;
+
+    // Tokenizer state, carried across chunks
+    bool inString_ = false;
+    bool escape_ = false;
+    size_t stringStart_ = 0;
+    Field keyCandidate_ = NO_FIELD;    // last string, if it may be a key we track
+    Field valueFor_ = NO_FIELD;        // after "key": - the next string is its value
+    FieldSpan fields_[FIELD_COUNT];
+
+    // Batch items: nesting depth, whether the body opened with '[', item fields
+    int depth_ = 0;
+    bool opened_ = false;
+    bool topArray_ = false;
+    size_t itemCount_ = 0;
+    FieldSpan items_[MAX_ITEMS][FIELD_COUNT];
+
+    OrderResponse build(const FieldSpan* fields) const {
+        OrderResponse response;
+        response.truncated = truncated_;
+        if (size_ == 0) return response;
+
+        response.orderId = span(fields[ORDER_ID].length ? fields[ORDER_ID] : fields[ORDER_ID_LOWER]);
+        if (!response.orderId.empty()) {
+            response.status = OrderResponse::FILLED;
+            return response;
+        }
+
+        response.status = OrderResponse::REJECTED;
+        for (Field field : {ERROR, ERROR_MSG, MESSAGE}) {
+            if (fields[field].length == 0) continue;
+            response.message = span(fields[field]);
+            break;
+        }
+        if (response.message.empty()) {
+            // First line only: the text ends up in line-based output
+            size_t length = size_ < FALLBACK_MESSAGE_LEN ? size_ : FALLBACK_MESSAGE_LEN;
+            const char* eol = static_cast<const char*>(memchr(buf_, '\n', length));
+            if (eol) length = eol - buf_;
+            if (length > 0 && buf_[length - 1] == '\r') length--;
+            response.message.data = buf_;
+            response.message.length = length;
+        }
+        response.error = errorCode(response.message);
+        return response;
+    }
+
+    void scan(size_t pos) {
+        char c = buf_[pos];
+        if (inString_) {
+            if (escape_) {
+                escape_ = false;
+            } else if (c == '\\') {
+                escape_ = true;
+            } else if (c == '"') {
+                inString_ = false;
+                closeString(stringStart_, pos);
+            }
+            return;
+        }
+
+        if (!opened_ && c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+            opened_ = true;
+            topArray_ = c == '[';
+        }
+        switch (c) {
+            case '"':
+                inString_ = true;
+                stringStart_ = pos + 1;
+                break;
+            case ':':
+                valueFor_ = keyCandidate_;
+                keyCandidate_ = NO_FIELD;
+                break;
+            case ' ': case '\t': case '\r': case '\n':
+                break;
+            case '[': case '{':
+                // A result object directly inside the top-level array
+                if (topArray_ && depth_ == 1 && c == '{' && itemCount_ < MAX_ITEMS) {
+                    for (auto& field : items_[itemCount_]) field = FieldSpan();
+                    itemCount_++;
+                }
+                depth_++;
+                valueFor_ = NO_FIELD;
+                keyCandidate_ = NO_FIELD;
+                break;
+            case ']': case '}':
+                if (depth_ > 0) depth_--;
+                valueFor_ = NO_FIELD;
+                keyCandidate_ = NO_FIELD;
+                break;
+            default:
+                // , or a non-string value
+                valueFor_ = NO_FIELD;
+                keyCandidate_ = NO_FIELD;
+                break;
+        }
+    }
+
+    void closeString(size_t start, size_t end) {
+        if (valueFor_ != NO_FIELD) {
+            // First non-empty value wins (batch responses repeat the keys)
+            FieldSpan& field = fields_[valueFor_];
+            if (field.length == 0 && end > start) {
+                field.start = start;
+                field.length = end - start;
+            }
+            if (topArray_ && depth_ >= 2 && itemCount_ > 0) {
+                FieldSpan& itemField = items_[itemCount_ - 1][valueFor_];
+                if (itemField.length == 0 && end > start) {
+                    itemField.start = start;
+                    itemField.length = end - start;
+                }
+            }
+            valueFor_ = NO_FIELD;
+            keyCandidate_ = NO_FIELD;
+            return;
+        }
+        keyCandidate_ = matchKey(buf_ + start, end - start);
+    }
+
+    static Field matchKey(const char* key, size_t length) {
+        switch (length) {
+            case 5: if (memcmp(key, "error", 5) == 0) return ERROR; break;
+            case 7:
+                if (memcmp(key, "orderID", 7) == 0) return ORDER_ID;
+                if (memcmp(key, "orderId", 7) == 0) return ORDER_ID_LOWER;
+                if (memcmp(key, "message", 7) == 0) return MESSAGE;
+                break;
+            case 8: if (memcmp(key, "errorMsg", 8) == 0) return ERROR_MSG; break;
+        }
+        return NO_FIELD;
+    }
+
+    Span span(const FieldSpan& field) const {
+        Span s;
+        if (field.length == 0) return s;
+        s.data = buf_ + field.start;
+        s.length = field.length;
+        return s;
+    }
+
+    static OrderResponse::Error errorCode(const Span& message) {
+        if (message.contains("does not exist")) return OrderResponse::NOT_OPEN;
+        if (message.contains("Duplicated") || message.contains("already exists")) return OrderResponse::DUPLICATED;
+        if (message.contains("not enough balance")) return OrderResponse::BALANCE;
+        if (message.contains("Unauthorized") || message.contains("Invalid api key")) return OrderResponse::UNAUTHORIZED;
+        if (message.contains("Too Many Requests")) return OrderResponse::RATE_LIMITED;
+        return OrderResponse::OTHER;
+    }
+};
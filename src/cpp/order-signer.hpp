@@ -0,0 +1,553 @@
+/**
+ * OrderSigner - native Polymarket CTF Exchange orders (EIP-712 + secp256k1)
+ *
+ * Builds the POST /orders body that TradingService.createSignedOrder() and
+ * buildOrderBody() produce with @polymarket/clob-client on an ethers v5
+ * wallet, byte for byte, so the engine can (re)sign ladder orders itself:
+ *   - amounts follow the client's getOrderRawAmounts(): the same rounding on
+ *     doubles as JS, printed with JS Number -> string rules before
+ *     parseUnits(.., 6)
+ *   - digest: EIP-712 over the exchange domain ("Polymarket CTF Exchange",
+ *     "1", chainId, exchange contract) and the Order struct
+ *   - ECDSA with RFC 6979 nonces and low s (elliptic's canonical mode, as
+ *     ethers signs), v = 27/28
+ *   - salt is random in [0, now ms] like the client's unless given
+ *
+ * Key, signer address and domain separator are set up once in init(); a
+ * signature is then one Keccak of the struct, one RFC 6979 nonce, k*G with
+ * OpenSSL's EC_POINT_mul (its constant-time Montgomery ladder, ~0.5 ms on
+ * secp256k1's generic prime-field code) and a few BN operations mod n.
+ * OpenSSL's own ECDSA draws a random k before 3.2, so the nonce is derived
+ * here to match ethers' signatures. buildBody() reuses the signer's scratch
+ * strings: after the first order only OpenSSL's EC/BN internals allocate.
+ */
+
+#pragma once
+
+#include "hmac-signer.hpp"
+#include "keccak.hpp"
+#include <openssl/bn.h>
+#include <openssl/crypto.h>
+#include <openssl/ec.h>
+#include <openssl/obj_mac.h>
+#include <openssl/sha.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+
+struct OrderParams {
+    std::string tokenId;               // decimal uint256
+    double price = 0;
+    double size = 0;                   // shares
+    int side = 0;                      // OrderSigner::BUY / SELL
+    long long expiration = 0;          // unix s; 0 = none
+    int feeRateBps = 0;
+    unsigned long long salt = 0;       // 0 = random, like the JS client
+};
+
+class OrderSigner {
+public:
+    static const size_t SIGNATURE_LEN = 65;
+    enum Side { BUY = 0, SELL = 1 };
+
+    // Decimal places of price / size / amounts per tick size (the client's ROUNDING_CONFIG)
+    struct RoundConfig {
+        int price = 2;
+        int size = 2;
+        int amount = 4;
+    };
+
+    OrderSigner() = default;
+    OrderSigner(const OrderSigner&) = delete;
+    OrderSigner& operator=(const OrderSigner&) = delete;
+
+    ~OrderSigner() {
+        OPENSSL_cleanse(keyBytes_, sizeof(keyBytes_));
+        BN_clear_free(key_);
+        BN_free(halfOrder_);
+        EC_POINT_free(point_);
+        EC_GROUP_free(group_);
+        BN_CTX_free(ctx_);
+    }
+
+    // Private key (hex, optional 0x); maker = funder address ("" = the signer's own)
+    bool init(const std::string& privateKeyHex, const std::string& maker, int signatureType,
+              long long chainId, const std::string& exchange) {
+        ctx_ = BN_CTX_new();
+        group_ = EC_GROUP_new_by_curve_name(NID_secp256k1);
+        point_ = group_ ? EC_POINT_new(group_) : nullptr;
+        halfOrder_ = BN_new();
+        if (!ctx_ || !point_ || !halfOrder_) return false;
+        order_ = EC_GROUP_get0_order(group_);
+        BN_rshift1(halfOrder_, order_);
+
+        uint8_t keyBytes[32];
+        std::string keyHex = strip0x(privateKeyHex);
+        if (keyHex.size() != 64 || !hexToBytes(keyHex, keyBytes, 32)) return false;
+        key_ = BN_bin2bn(keyBytes, 32, nullptr);
+        memcpy(keyBytes_, keyBytes, 32);
+        OPENSSL_cleanse(keyBytes, sizeof(keyBytes));
+        if (!key_ || BN_is_zero(key_) || BN_cmp(key_, order_) >= 0) return false;
+        BN_set_flags(key_, BN_FLG_CONSTTIME);
+
+        // Signer address: last 20 bytes of keccak(X || Y), EIP-55 checksummed like getAddress()
+        uint8_t point[64];
+        if (!mulG(key_, point)) return false;
+        uint8_t hash[Keccak256::HASH_LEN];
+        Keccak256::hash(point, 64, hash);
+        address_ = checksumAddress(hash + 12);
+
+        maker_ = maker.empty() ? address_ : maker;
+        signatureType_ = signatureType;
+        if (!parseAddress(maker_, makerBytes_) || !parseAddress(address_, signerBytes_)) return false;
+
+        // Domain separator: fixed for the signer's lifetime
+        if (!domainSeparator("Polymarket CTF Exchange", "1", chainId, exchange, domainSeparator_)) return false;
+
+        static const char* ORDER_TYPE =
+            "Order(uint256 salt,address maker,address signer,address taker,uint256 tokenId,"
+            "uint256 makerAmount,uint256 takerAmount,uint256 expiration,uint256 nonce,"
+            "uint256 feeRateBps,uint8 side,uint8 signatureType)";
+        Keccak256::hash(ORDER_TYPE, strlen(ORDER_TYPE), orderTypeHash_);
+
+        salts_.seed(std::random_device{}());
+        return true;
+    }
+
+    const std::string& address() const { return address_; }
+    const std::string& maker() const { return maker_; }
+
+    // hashStruct(EIP712Domain{name, version, chainId, verifyingContract})
+    static bool domainSeparator(const std::string& name, const std::string& version, long long chainId,
+                                const std::string& contract, uint8_t out[Keccak256::HASH_LEN]) {
+        static const char* DOMAIN_TYPE = "EIP712Domain(string name,string version,uint256 chainId,address verifyingContract)";
+        uint8_t words[5][32] = {};
+        if (!parseAddress(contract, words[4] + 12)) return false;
+        Keccak256::hash(DOMAIN_TYPE, strlen(DOMAIN_TYPE), words[0]);
+        Keccak256::hash(name.data(), name.size(), words[1]);
+        Keccak256::hash(version.data(), version.size(), words[2]);
+        putUint(words[3], (unsigned long long)chainId);
+        Keccak256::hash(words, sizeof(words), out);
+        return true;
+    }
+
+    // CTF Exchange contract on Polygon mainnet; "" for other chains (pass it explicitly)
+    static const char* exchangeAddress(long long chainId, bool negRisk) {
+        if (chainId != 137) return "";
+        return negRisk ? "0xC5d563A36AE78145C45a50134d48A1215220f80a" : "0x4bFb41d5B3570DeFd03C39a9A4D8dE6Bd8B8982E";
+    }
+
+    static bool roundConfig(const std::string& tickSize, RoundConfig& out) {
+        static const char* TICKS[] = {"0.1", "0.01", "0.001", "0.0001"};
+        for (int i = 0; i < 4; i++) {
+            if (tickSize != TICKS[i]) continue;
+            out.price = i + 1;
+            out.size = 2;
+            out.amount = i + 3;
+            return true;
+        }
+        return false;
+    }
+
+    // makerAmount / takerAmount (6-decimal base units) as getOrderRawAmounts + parseUnits
+    static bool amounts(int side, double price, double size, const RoundConfig& round,
+                        std::string& makerAmount, std::string& takerAmount) {
+        double rawPrice = roundNormal(price, round.price);
+        double rawShares = roundDown(size, round.size);
+        double rawAmount = rawShares * rawPrice;
+        if (decimalPlaces(rawAmount) > round.amount) {
+            rawAmount = roundUp(rawAmount, round.amount + 4);
+            if (decimalPlaces(rawAmount) > round.amount) rawAmount = roundDown(rawAmount, round.amount);
+        }
+        // BUY pays collateral for shares, SELL the other way round
+        char maker[JS_NUMBER_MAX];
+        char taker[JS_NUMBER_MAX];
+        return parseUnits(maker, jsNumber(side == BUY ? rawAmount : rawShares, maker), makerAmount) &&
+               parseUnits(taker, jsNumber(side == BUY ? rawShares : rawAmount, taker), takerAmount);
+    }
+
+    // EIP-712 digest of an order
+    void digest(const OrderParams& params, unsigned long long salt, const std::string& makerAmount,
+                const std::string& takerAmount, uint8_t out[Keccak256::HASH_LEN]) {
+        uint8_t words[13][32] = {};
+        memcpy(words[0], orderTypeHash_, 32);
+        putUint(words[1], salt);
+        memcpy(words[2] + 12, makerBytes_, 20);
+        memcpy(words[3] + 12, signerBytes_, 20);
+        // words[4]: taker = zero address
+        putDecimal(words[5], params.tokenId);
+        putDecimal(words[6], makerAmount);
+        putDecimal(words[7], takerAmount);
+        putUint(words[8], (unsigned long long)params.expiration);
+        // words[9]: nonce 0
+        putUint(words[10], (unsigned long long)params.feeRateBps);
+        putUint(words[11], (unsigned long long)params.side);
+        putUint(words[12], (unsigned long long)signatureType_);
+        uint8_t structHash[32];
+        keccak_.update(words, sizeof(words));
+        keccak_.final(structHash);
+
+        keccak_.update("\x19\x01", 2);
+        keccak_.update(domainSeparator_, 32);
+        keccak_.update(structHash, 32);
+        keccak_.final(out);
+    }
+
+    // r || s || v over a 32-byte digest; deterministic (RFC 6979), low s
+    bool sign(const uint8_t digest[32], uint8_t signature[SIGNATURE_LEN]) {
+        BN_CTX_start(ctx_);
+        BIGNUM* z = BN_CTX_get(ctx_);
+        BIGNUM* k = BN_CTX_get(ctx_);
+        BIGNUM* r = BN_CTX_get(ctx_);
+        BIGNUM* s = BN_CTX_get(ctx_);
+        BIGNUM* x = BN_CTX_get(ctx_);
+        BIGNUM* limit = BN_CTX_get(ctx_);
+        bool ok = limit && BN_bin2bn(digest, 32, z) && BN_sub(limit, order_, BN_value_one());
+        if (ok && BN_cmp(z, order_) >= 0) ok = BN_sub(z, z, order_);
+
+        // RFC 6979 HMAC-DRBG seeded with the key and the reduced digest
+        uint8_t zBytes[32];
+        uint8_t v[32];
+        uint8_t kMac[32];
+        BN_bn2binpad(z, zBytes, 32);
+        memset(v, 0x01, 32);
+        memset(kMac, 0x00, 32);
+        drbgUpdate(kMac, v, 0x00, zBytes);
+        drbgUpdate(kMac, v, 0x01, zBytes);
+
+        int recovery = 0;
+        while (ok) {
+            uint8_t point[64];
+            hmac(kMac, v, 32, nullptr, 0, v);
+            ok = BN_bin2bn(v, 32, k) != nullptr;
+            BN_set_flags(k, BN_FLG_CONSTTIME);
+            // elliptic's range: 1 < k < n - 1
+            if (ok && BN_cmp(k, BN_value_one()) > 0 && BN_cmp(k, limit) < 0 && mulG(k, point)) {
+                ok = BN_bin2bn(point, 32, x) && BN_nnmod(r, x, order_, ctx_) &&
+                     BN_mod_mul(s, r, key_, order_, ctx_) && BN_mod_add(s, s, z, order_, ctx_) &&
+                     BN_mod_inverse(k, k, order_, ctx_) && BN_mod_mul(s, s, k, order_, ctx_);
+                if (ok && !BN_is_zero(r) && !BN_is_zero(s)) {
+                    recovery = (point[63] & 1) | (BN_cmp(x, r) != 0 ? 2 : 0);
+                    if (BN_cmp(s, halfOrder_) > 0) {
+                        BN_sub(s, order_, s);
+                        recovery ^= 1;
+                    }
+                    break;
+                }
+            }
+            // Rejected nonce: next DRBG output
+            uint8_t zero = 0x00;
+            hmac(kMac, v, 32, &zero, 1, kMac);
+            hmac(kMac, v, 32, nullptr, 0, v);
+        }
+        OPENSSL_cleanse(kMac, sizeof(kMac));
+        OPENSSL_cleanse(v, sizeof(v));
+
+        ok = ok && BN_bn2binpad(r, signature, 32) == 32 && BN_bn2binpad(s, signature + 32, 32) == 32;
+        signature[64] = (uint8_t)(27 + (recovery & 1));
+        BN_clear(k);
+        BN_CTX_end(ctx_);
+        return ok;
+    }
+
+    // POST /orders body of one signed order, as buildOrderBody() in updown-bot-cpp.ts
+    bool buildBody(const OrderParams& params, const RoundConfig& round, const std::string& owner, std::string& body) {
+        if (params.tokenId.empty() || !amounts(params.side, params.price, params.size, round, makerAmount_, takerAmount_)) {
+            return false;
+        }
+        unsigned long long salt = params.salt ? params.salt : nextSalt();
+
+        uint8_t hash[32];
+        uint8_t signature[SIGNATURE_LEN];
+        digest(params, salt, makerAmount_, takerAmount_, hash);
+        if (!sign(hash, signature)) return false;
+        char signatureHex[2 * SIGNATURE_LEN];
+        bytesToHex(signature, SIGNATURE_LEN, signatureHex);
+        char number[24];
+
+        body.clear();
+        body.reserve(768);
+        body += "[{\"deferExec\":false,\"order\":{\"salt\":";
+        body.append(number, (size_t)snprintf(number, sizeof(number), "%llu", salt));
+        body += ",\"maker\":\"";
+        body += maker_;
+        body += "\",\"signer\":\"";
+        body += address_;
+        body += "\",\"taker\":\"0x0000000000000000000000000000000000000000\",\"tokenId\":\"";
+        body += params.tokenId;
+        body += "\",\"makerAmount\":\"";
+        body += makerAmount_;
+        body += "\",\"takerAmount\":\"";
+        body += takerAmount_;
+        body += "\",\"expiration\":\"";
+        body.append(number, (size_t)snprintf(number, sizeof(number), "%lld", params.expiration));
+        body += "\",\"nonce\":\"0\",\"feeRateBps\":\"";
+        body.append(number, (size_t)snprintf(number, sizeof(number), "%d", params.feeRateBps));
+        body += "\",\"side\":\"";
+        body += params.side == BUY ? "BUY" : "SELL";
+        body += "\",\"signatureType\":";
+        body.append(number, (size_t)snprintf(number, sizeof(number), "%d", signatureType_));
+        body += ",\"signature\":\"0x";
+        body.append(signatureHex, sizeof(signatureHex));
+        body += "\"},\"owner\":\"";
+        body += owner;
+        body += "\",\"orderType\":\"GTD\"}]";
+        return true;
+    }
+
+    // Longest jsNumber() text: "0." + 323 zeros + 17 digits for the smallest subnormal
+    static const size_t JS_NUMBER_MAX = 352;
+
+    // JS Number.prototype.toString for finite values in plain (non-exponent) range
+    static std::string jsNumber(double value) {
+        char text[JS_NUMBER_MAX];
+        return std::string(text, jsNumber(value, text));
+    }
+
+    // Same into text (no heap use); returns its length
+    static size_t jsNumber(double value, char text[JS_NUMBER_MAX]) {
+        if (value == 0) {
+            text[0] = '0';
+            return 1;
+        }
+        char digits[32];
+        int exponent = 0;
+        // Shortest digit string that reads back as the same double
+        for (int precision = 1; precision <= 17; precision++) {
+            char buffer[40];
+            snprintf(buffer, sizeof(buffer), "%.*e", precision - 1, std::fabs(value));
+            if (strtod(buffer, nullptr) != std::fabs(value) && precision < 17) continue;
+            size_t n = 0;
+            for (const char* p = buffer; *p && *p != 'e'; p++) {
+                if (*p != '.') digits[n++] = *p;
+            }
+            while (n > 1 && digits[n - 1] == '0') n--;
+            digits[n] = '\0';
+            exponent = atoi(strchr(buffer, 'e') + 1);
+            break;
+        }
+        size_t length = 0;
+        if (value < 0) text[length++] = '-';
+        int count = (int)strlen(digits);
+        if (exponent < 0) {
+            text[length++] = '0';
+            text[length++] = '.';
+            for (int i = 0; i < -exponent - 1; i++) text[length++] = '0';
+            for (int i = 0; i < count; i++) text[length++] = digits[i];
+        } else {
+            for (int i = 0; i < count || i <= exponent; i++) {
+                if (i == exponent + 1) text[length++] = '.';
+                text[length++] = i < count ? digits[i] : '0';
+            }
+        }
+        return length;
+    }
+
+private:
+    BN_CTX* ctx_ = nullptr;
+    EC_GROUP* group_ = nullptr;
+    EC_POINT* point_ = nullptr;        // k*G of the signature in progress
+    const BIGNUM* order_ = nullptr;    // n, owned by group_
+    BIGNUM* halfOrder_ = nullptr;
+    BIGNUM* key_ = nullptr;
+    uint8_t keyBytes_[32] = {};
+    std::string address_;
+    std::string maker_;
+    int signatureType_ = 0;
+    uint8_t makerBytes_[20] = {};
+    uint8_t signerBytes_[20] = {};
+    uint8_t domainSeparator_[32] = {};
+    uint8_t orderTypeHash_[32] = {};
+    std::mt19937_64 salts_;
+    Keccak256 keccak_;
+    std::string makerAmount_;          // buildBody() scratch, kept for its capacity
+    std::string takerAmount_;
+
+    // scalar*G as big-endian affine x || y; false for the point at infinity
+    bool mulG(const BIGNUM* scalar, uint8_t out[64]) {
+        BN_CTX_start(ctx_);
+        BIGNUM* x = BN_CTX_get(ctx_);
+        BIGNUM* y = BN_CTX_get(ctx_);
+        bool ok = y && EC_POINT_mul(group_, point_, scalar, nullptr, nullptr, ctx_) &&
+                  !EC_POINT_is_at_infinity(group_, point_) &&
+                  EC_POINT_get_affine_coordinates(group_, point_, x, y, ctx_) &&
+                  BN_bn2binpad(x, out, 32) == 32 && BN_bn2binpad(y, out + 32, 32) == 32;
+        BN_CTX_end(ctx_);
+        return ok;
+    }
+
+    // Math.round(Math.random() * Date.now())
+    unsigned long long nextSalt() {
+        double nowMs = (double)std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        double salt = std::round(std::generate_canonical<double, 53>(salts_) * nowMs);
+        return salt < 1 ? 1 : (unsigned long long)salt;
+    }
+
+    // HMAC-SHA256 with a 32-byte key over a || b (out may alias key or a). On the
+    // SHA256_CTX calls like HmacSigner: the one-shot HMAC() fetches its digest per
+    // call, several times per signature.
+    static void hmac(const uint8_t key[32], const uint8_t* a, size_t aLength, const uint8_t* b, size_t bLength,
+                     uint8_t out[32]) {
+        uint8_t pad[SHA256_CBLOCK];
+        SHA256_CTX inner;
+        SHA256_CTX outer;
+        HMAC_SIGNER_SHA256_BEGIN
+        memset(pad, 0x36, sizeof(pad));
+        for (int i = 0; i < 32; i++) pad[i] ^= key[i];
+        SHA256_Init(&inner);
+        SHA256_Update(&inner, pad, sizeof(pad));
+        memset(pad, 0x5c, sizeof(pad));
+        for (int i = 0; i < 32; i++) pad[i] ^= key[i];
+        SHA256_Init(&outer);
+        SHA256_Update(&outer, pad, sizeof(pad));
+        OPENSSL_cleanse(pad, sizeof(pad));
+
+        uint8_t digest[SHA256_DIGEST_LENGTH];
+        SHA256_Update(&inner, a, aLength);
+        if (bLength) SHA256_Update(&inner, b, bLength);
+        SHA256_Final(digest, &inner);
+        SHA256_Update(&outer, digest, sizeof(digest));
+        SHA256_Final(out, &outer);
+        HMAC_SIGNER_SHA256_END
+        OPENSSL_cleanse(digest, sizeof(digest));
+        OPENSSL_cleanse(&inner, sizeof(inner));
+        OPENSSL_cleanse(&outer, sizeof(outer));
+    }
+
+    // K = HMAC_K(V || tag || key || z), V = HMAC_K(V)
+    void drbgUpdate(uint8_t k[32], uint8_t v[32], uint8_t tag, const uint8_t z[32]) const {
+        uint8_t seed[1 + 64];
+        seed[0] = tag;
+        memcpy(seed + 1, keyBytes_, 32);
+        memcpy(seed + 33, z, 32);
+        hmac(k, v, 32, seed, sizeof(seed), k);
+        hmac(k, v, 32, nullptr, 0, v);
+        OPENSSL_cleanse(seed, sizeof(seed));
+    }
+
+    // Helpers of the JS client (decimalPlaces/roundNormal/roundDown/roundUp), on doubles
+    static double pow10(int decimals) {
+        static const double POWERS[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12};
+        return POWERS[decimals < 0 ? 0 : decimals > 12 ? 12 : decimals];
+    }
+
+    static int decimalPlaces(double value) {
+        if (value == std::floor(value)) return 0;
+        char text[JS_NUMBER_MAX];
+        size_t length = jsNumber(value, text);
+        const char* dot = (const char*)memchr(text, '.', length);
+        return dot ? (int)(text + length - dot - 1) : 0;
+    }
+
+    static double roundNormal(double value, int decimals) {
+        if (decimalPlaces(value) <= decimals) return value;
+        double scaled = (value + 2.220446049250313e-16) * pow10(decimals);  // Number.EPSILON
+        double rounded = std::floor(scaled);
+        if (scaled - rounded >= 0.5) rounded += 1;                         // Math.round
+        return rounded / pow10(decimals);
+    }
+
+    static double roundDown(double value, int decimals) {
+        if (decimalPlaces(value) <= decimals) return value;
+        return std::floor(value * pow10(decimals)) / pow10(decimals);
+    }
+
+    static double roundUp(double value, int decimals) {
+        if (decimalPlaces(value) <= decimals) return value;
+        return std::ceil(value * pow10(decimals)) / pow10(decimals);
+    }
+
+    // ethers parseUnits(text, 6).toString(); out keeps its capacity
+    static bool parseUnits(const char* text, size_t length, std::string& out) {
+        const char* dot = (const char*)memchr(text, '.', length);
+        size_t wholeLength = dot ? (size_t)(dot - text) : length;
+        size_t fractionLength = dot ? length - wholeLength - 1 : 0;
+        if (wholeLength == 0 || text[0] == '-' || fractionLength > 6) return false;
+        out.assign(text, wholeLength);
+        if (dot) out.append(dot + 1, fractionLength);
+        out.append(6 - fractionLength, '0');
+        size_t first = out.find_first_not_of('0');
+        if (first == std::string::npos) {
+            out.assign(1, '0');
+        } else if (first > 0) {
+            out.erase(0, first);
+        }
+        return true;
+    }
+
+    static void putUint(uint8_t word[32], unsigned long long value) {
+        for (int i = 31; i >= 24; i--, value >>= 8) word[i] = (uint8_t)value;
+    }
+
+    // Decimal uint256 -> big-endian word (no overflow check beyond 78 digits)
+    static void putDecimal(uint8_t word[32], const std::string& decimal) {
+        memset(word, 0, 32);
+        for (char c : decimal) {
+            if (c < '0' || c > '9') continue;
+            unsigned carry = (unsigned)(c - '0');
+            for (int i = 31; i >= 0; i--) {
+                carry += word[i] * 10u;
+                word[i] = (uint8_t)carry;
+                carry >>= 8;
+            }
+        }
+    }
+
+    static std::string strip0x(const std::string& hex) {
+        return hex.size() >= 2 && hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X') ? hex.substr(2) : hex;
+    }
+
+    static int nibble(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    static bool hexToBytes(const std::string& hex, uint8_t* out, size_t length) {
+        if (hex.size() != length * 2) return false;
+        for (size_t i = 0; i < length; i++) {
+            int high = nibble(hex[2 * i]);
+            int low = nibble(hex[2 * i + 1]);
+            if (high < 0 || low < 0) return false;
+            out[i] = (uint8_t)(high << 4 | low);
+        }
+        return true;
+    }
+
+    static bool parseAddress(const std::string& address, uint8_t out[20]) {
+        return hexToBytes(strip0x(address), out, 20);
+    }
+
+    static std::string bytesToHex(const uint8_t* bytes, size_t length) {
+        std::string out(length * 2, '0');
+        bytesToHex(bytes, length, &out[0]);
+        return out;
+    }
+
+    // 2 * length lowercase hex digits into out (no terminator)
+    static void bytesToHex(const uint8_t* bytes, size_t length, char* out) {
+        static const char* HEX = "0123456789abcdef";
+        for (size_t i = 0; i < length; i++) {
+            out[2 * i] = HEX[bytes[i] >> 4];
+            out[2 * i + 1] = HEX[bytes[i] & 0x0f];
+        }
+    }
+
+    // EIP-55: uppercase a hex letter when the matching nibble of keccak(lowercase hex) is >= 8
+    static std::string checksumAddress(const uint8_t bytes[20]) {
+        std::string hex = bytesToHex(bytes, 20);
+        uint8_t hash[Keccak256::HASH_LEN];
+        Keccak256::hash(hex.data(), hex.size(), hash);
+        for (size_t i = 0; i < hex.size(); i++) {
+            int bits = i % 2 == 0 ? hash[i / 2] >> 4 : hash[i / 2] & 0x0f;
+            if (hex[i] >= 'a' && bits >= 8) hex[i] = (char)(hex[i] - 'a' + 'A');
+        }
+        return "0x" + hex;
+    }
+};
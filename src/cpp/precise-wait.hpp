@@ -0,0 +1,79 @@
+/**
+ * PreciseWaiter - hybrid timerfd + busy-spin wait on CLOCK_MONOTONIC
+ *
+ * Sleeping for the whole interval (sleep_for / poll timeouts) has
+ * millisecond granularity plus scheduler wakeup jitter. Spinning for the
+ * whole interval burns a core. The hybrid:
+ *   1. arm an absolute timerfd SPIN_WINDOW before the target; the fd can be
+ *      handed to curl_multi_poll() as an extra fd, so sockets keep being
+ *      serviced while we sleep
+ *   2. busy-spin on steady_clock for the last SPIN_WINDOW
+ * gives sub-100µs release accuracy at the cost of ~SPIN_WINDOW CPU per shot.
+ *
+ * std::chrono::steady_clock is CLOCK_MONOTONIC on Linux/libstdc++, so its
+ * time_since_epoch() can be used directly as a TFD_TIMER_ABSTIME value.
+ */
+
+#pragma once
+
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdint>
+
+class PreciseWaiter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::chrono::microseconds SPIN_WINDOW{200};
+
+    PreciseWaiter() : fd_(timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) {}
+
+    ~PreciseWaiter() {
+        if (fd_ >= 0) close(fd_);
+    }
+
+    PreciseWaiter(const PreciseWaiter&) = delete;
+    PreciseWaiter& operator=(const PreciseWaiter&) = delete;
+
+    int fd() const { return fd_; }
+
+    // Arm the timer SPIN_WINDOW before target. Returns false if target is
+    // already inside the spin window (caller should spin right away).
+    bool arm(Clock::time_point target) {
+        Clock::time_point wakeAt = target - SPIN_WINDOW;
+        if (fd_ < 0 || wakeAt <= Clock::now()) return false;
+
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(wakeAt.time_since_epoch()).count();
+        struct itimerspec spec = {};
+        spec.it_value.tv_sec = ns / 1000000000LL;
+        spec.it_value.tv_nsec = ns % 1000000000LL;
+        return timerfd_settime(fd_, TFD_TIMER_ABSTIME, &spec, nullptr) == 0;
+    }
+
+    // Consume pending expirations so the fd stops polling readable
+    void drain() {
+        uint64_t expirations;
+        if (fd_ >= 0) {
+            ssize_t n = read(fd_, &expirations, sizeof(expirations));
+            (void)n;
+        }
+    }
+
+    // Busy-wait until target
+    static void spinUntil(Clock::time_point target) {
+        while (Clock::now() < target) {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+        }
+    }
+
+    // True if target is close enough that sleeping would overshoot
+    static bool withinSpinWindow(Clock::time_point target) {
+        return target - Clock::now() <= SPIN_WINDOW;
+    }
+
+private:
+    int fd_;
+};
@@ -0,0 +1,251 @@
+/**
+ * RateController - adaptive order attempt rate (token bucket + AIMD)
+ *
+ * Every order response is classified (classifyResponse, from the parsed
+ * OrderResponse) and fed back:
+ *   NOT_OPEN / REJECTED / FILLED  in-flight window +1/window; the rate regains
+ *                                 INCREASE_PER_SEC of its pre-cut level per second
+ *   RATE_LIMITED (429)            rate (measured send rate) and window halved,
+ *                                 bucket drained - once per episode: only for
+ *                                 requests sent after the previous cut
+ *   BAD_SIGNATURE (401/403)       rate held at probeRps until a non-auth
+ *                                 response; a rejected signature is not fixed
+ *                                 by retrying faster
+ *   TRANSPORT_ERROR               window halved, rate kept
+ *
+ * The ceiling follows the expected open time: probeRps until RAMP_LEAD_MS
+ * before it, a linear ramp to maxRps, maxRps from then on - and maxRps as
+ * soon as any response shows the orderbook open.
+ *
+ * Regular sends take a token from a bucket refilled at the current rate
+ * (BURST_MS worth of tokens, at least one). Decisions are returned to the
+ * caller for logging:
+ *   RATE:<decision>:rate_rps=..,window=..[,order=..,attempt=..,kind=..]
+ */
+
+#pragma once
+
+#include "order-response.hpp"
+#include <curl/curl.h>
+#include <algorithm>
+#include <chrono>
+#include <ostream>
+
+// What a completed order response says about the market
+enum class ResponseKind {
+    FILLED,
+    NOT_OPEN,         // "the orderbook ... does not exist": window not open yet
+    RATE_LIMITED,     // HTTP 429
+    BAD_SIGNATURE,    // HTTP 401/403: credentials, signature or timestamp rejected
+    REJECTED,         // any other API error
+    TRANSPORT_ERROR   // curl failure, no HTTP response
+};
+
+inline const char* responseKindName(ResponseKind kind) {
+    switch (kind) {
+        case ResponseKind::FILLED: return "filled";
+        case ResponseKind::NOT_OPEN: return "not_open";
+        case ResponseKind::RATE_LIMITED: return "rate_limited";
+        case ResponseKind::BAD_SIGNATURE: return "bad_signature";
+        case ResponseKind::REJECTED: return "rejected";
+        case ResponseKind::TRANSPORT_ERROR: return "transport_error";
+    }
+    return "unknown";
+}
+
+inline ResponseKind classifyResponse(CURLcode res, long httpStatus, const OrderResponse& response) {
+    if (res != CURLE_OK) return ResponseKind::TRANSPORT_ERROR;
+    if (response.filled()) return ResponseKind::FILLED;
+    if (httpStatus == 429) return ResponseKind::RATE_LIMITED;
+    if (httpStatus == 401 || httpStatus == 403) return ResponseKind::BAD_SIGNATURE;
+    if (response.error == OrderResponse::NOT_OPEN) return ResponseKind::NOT_OPEN;
+    return ResponseKind::REJECTED;
+}
+
+// The orderbook accepted the order for processing: filled, or rejected on its
+// merits (balance, price...) rather than by auth, a proxy or a server error
+inline bool impliesWindowOpen(ResponseKind kind, long httpStatus) {
+    if (kind == ResponseKind::FILLED) return true;
+    return kind == ResponseKind::REJECTED && httpStatus >= 200 && httpStatus < 500;
+}
+
+class RateController {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum Decision { NONE, PROBE, RAMP, FULL, OPEN, DECREASE, AUTH_HOLD, AUTH_RELEASE, TRANSPORT_BACKOFF };
+
+    static constexpr double RAMP_LEAD_MS = 500.0;
+    static constexpr double INCREASE_PER_SEC = 0.5;   // fraction of the pre-cut rate regained per second
+    static constexpr double DECREASE_FACTOR = 0.5;
+    static constexpr double BURST_MS = 5.0;           // bucket capacity, in time at the current rate
+    static constexpr double MIN_RPS = 2.0;
+    static constexpr double MEASURE_WINDOW_MS = 250.0;
+
+    // probeRps/maxRps: all orders combined; maxWindow: in-flight cap for regular sends;
+    // now: start of the bucket's clock (a simulated one in ReplaySimulator)
+    RateController(double probeRps, double maxRps, int maxWindow, Clock::time_point now = Clock::now())
+        : probeRps_(std::max(MIN_RPS, std::min(probeRps, maxRps))),
+          maxRps_(std::max(MIN_RPS, maxRps)),
+          maxWindow_(std::max(1, maxWindow)),
+          rate_(maxRps_),
+          step_(maxRps_),
+          window_(maxWindow_) {
+        lastRefill_ = measureStart_ = now;
+    }
+
+    // Combined rate of streams senders that each send once per intervalMs (0: unpaced)
+    static double ratePerInterval(size_t streams, int intervalMs) {
+        return intervalMs > 0 ? streams * 1000.0 / intervalMs : 1e6;
+    }
+
+    static const char* decisionName(Decision decision) {
+        static const char* names[] = {"none", "probe", "ramp", "full", "open", "decrease",
+                                      "auth_hold", "auth_release", "transport_backoff"};
+        return names[decision];
+    }
+
+    void setExpectedOpen(Clock::time_point at) {
+        expectedOpen_ = at;
+        hasExpectedOpen_ = true;
+    }
+
+    bool windowOpen() const { return windowOpen_; }
+
+    // Past the probe phase: orders should pace at their full interval
+    bool ramping() const { return phase_ != PROBE; }
+
+    double rate(Clock::time_point now) const { return std::min(rate_, ceiling(now)); }
+    int window() const { return (int)window_; }
+
+    // Refill the bucket and advance the time-driven phase (probe -> ramp -> full)
+    Decision update(Clock::time_point now) {
+        double dtSec = std::chrono::duration<double>(now - lastRefill_).count();
+        lastRefill_ = now;
+        if (dtSec > 0) {
+            rate_ = std::min(maxRps_, rate_ + INCREASE_PER_SEC * step_ * dtSec);
+            double current = rate(now);
+            tokens_ = std::min(capacity(current), tokens_ + current * dtSec);
+        }
+
+        double measuredMs = std::chrono::duration<double, std::milli>(now - measureStart_).count();
+        if (measuredMs >= MEASURE_WINDOW_MS) {
+            measuredRps_ = sentInWindow_ * 1000.0 / measuredMs;
+            sentInWindow_ = 0;
+            measureStart_ = now;
+        }
+
+        Decision phase = phaseAt(now);
+        if (phase == phase_) return NONE;
+        phase_ = phase;
+        return phase;
+    }
+
+    // Take a token for one regular send (call update() first)
+    bool tryAcquire(int inFlight) {
+        if (inFlight >= (int)window_ || tokens_ < 1.0) return false;
+        tokens_ -= 1.0;
+        sentInWindow_++;
+        return true;
+    }
+
+    // When the next token will be available at the current rate
+    Clock::time_point nextTokenAt(Clock::time_point now) const {
+        if (tokens_ >= 1.0) return now;
+        double current = rate(now);
+        return now + std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>((1.0 - tokens_) / current));
+    }
+
+    Decision onResponse(ResponseKind kind, long httpStatus, Clock::time_point sentAt, Clock::time_point now) {
+        // Any answer past authentication ends the hold
+        Decision released = NONE;
+        if (authHold_ && kind != ResponseKind::BAD_SIGNATURE && kind != ResponseKind::TRANSPORT_ERROR) {
+            authHold_ = false;
+            released = AUTH_RELEASE;
+        }
+
+        switch (kind) {
+            case ResponseKind::RATE_LIMITED: {
+                if (hasDecreased_ && sentAt < lastDecrease_) return released;
+                // Cut from what was actually sent: a ceiling far above the achieved rate would not slow anything
+                double sending = measuredRps_ > 0 ? std::min(rate(now), measuredRps_) : rate(now);
+                rate_ = std::max(MIN_RPS, sending * DECREASE_FACTOR);
+                step_ = std::max(MIN_RPS, sending);
+                window_ = std::max(1.0, window_ * DECREASE_FACTOR);
+                tokens_ = 0;
+                lastDecrease_ = now;
+                hasDecreased_ = true;
+                return DECREASE;
+            }
+            case ResponseKind::BAD_SIGNATURE:
+                if (authHold_) return NONE;
+                authHold_ = true;
+                tokens_ = std::min(tokens_, 1.0);
+                return AUTH_HOLD;
+            case ResponseKind::TRANSPORT_ERROR:
+                window_ = std::max(1.0, window_ * DECREASE_FACTOR);
+                return TRANSPORT_BACKOFF;
+            default:
+                break;
+        }
+
+        window_ = std::min((double)maxWindow_, window_ + 1.0 / window_);
+        if (!windowOpen_ && impliesWindowOpen(kind, httpStatus)) {
+            windowOpen_ = true;
+            phase_ = OPEN;
+            return OPEN;
+        }
+        return released;
+    }
+
+    void print(std::ostream& out, Decision decision, Clock::time_point now) const {
+        out << "RATE:" << decisionName(decision) << ":rate_rps=" << (long)rate(now) << ",window=" << (int)window_;
+    }
+
+    void print(std::ostream& out, Decision decision, Clock::time_point now,
+               int orderIndex, int attempt, ResponseKind kind) const {
+        print(out, decision, now);
+        out << ",order=" << orderIndex << ",attempt=" << attempt << ",kind=" << responseKindName(kind);
+    }
+
+private:
+    double probeRps_;
+    double maxRps_;
+    int maxWindow_;
+    double rate_;                      // AIMD rate, capped by the ceiling
+    double step_;                      // additive increase base: send rate before the last cut
+    double window_;                    // AIMD in-flight window
+    double tokens_ = 1.0;
+    Clock::time_point lastRefill_;
+    Clock::time_point lastDecrease_;
+    bool hasDecreased_ = false;
+    bool authHold_ = false;
+    bool windowOpen_ = false;
+    bool hasExpectedOpen_ = false;
+    Clock::time_point expectedOpen_;
+    Decision phase_ = PROBE;
+    Clock::time_point measureStart_;
+    int sentInWindow_ = 0;
+    double measuredRps_ = 0;
+
+    static double capacity(double rps) { return std::max(1.0, rps * BURST_MS / 1000.0); }
+
+    Decision phaseAt(Clock::time_point now) const {
+        if (windowOpen_) return OPEN;
+        if (!hasExpectedOpen_) return PROBE;
+        double untilMs = std::chrono::duration<double, std::milli>(expectedOpen_ - now).count();
+        if (untilMs <= 0) return FULL;
+        return untilMs <= RAMP_LEAD_MS ? RAMP : PROBE;
+    }
+
+    double ceiling(Clock::time_point now) const {
+        if (authHold_) return probeRps_;
+        if (windowOpen_) return maxRps_;
+        if (!hasExpectedOpen_) return probeRps_;
+        double untilMs = std::chrono::duration<double, std::milli>(expectedOpen_ - now).count();
+        if (untilMs <= 0) return maxRps_;
+        if (untilMs >= RAMP_LEAD_MS) return probeRps_;
+        return probeRps_ + (maxRps_ - probeRps_) * (1.0 - untilMs / RAMP_LEAD_MS);
+    }
+};
@@ -0,0 +1,660 @@
+/**
+ * ReplaySimulator - recorded order attempts replayed under other pacing
+ *
+ * Live, every setting of intervalMs, probeIntervalMs, maxAttempts or the start
+ * delay (DELAY_BEFORE_SPAM_MS) costs a market. A recorded run - a segment of
+ * the attempt log, or one run of `attempt-log export --csv` - is reduced to a
+ * ReplayScenario instead:
+ *   open instant  per market, on the server clock: between the last attempt
+ *                 that reached the server while the orderbook did not exist
+ *                 (NOT_OPEN) and the first it took (impliesWindowOpen). An
+ *                 attempt reaches the server half its latency after its send.
+ *   latency       every attempt of the run, answered or failed, drawn at random;
+ *                 the draws are seeded per run, so every parameter set replays
+ *                 against the same sequence
+ *   rate limit    a token bucket holding one second of its rate (as the mock
+ *                 CLOB's), the rate fitted to the attempts the server took in
+ *                 the second before the run's first 429, if it had one
+ *
+ * ReplaySimulator::run() drives a RateController and the engine's per-order
+ * pacing (SpamEngine::schedule, launchDue, completeRequest, waitForNextSend:
+ * one order per request, HTTP/1.1 or HTTP/2) on a simulated clock - the
+ * server's, in microseconds - and answers every attempt from the scenario.
+ * Nothing waits: a run of a few thousand attempts replays in well under a
+ * millisecond. Batching, hedging and edge routing are not modelled.
+ *
+ * Time to fill runs from the market's open instant to the answer of the
+ * attempt that filled.
+ */
+
+#pragma once
+
+#include "attempt-log.hpp"
+#include "rate-controller.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct ReplayMarket {
+    std::string slug;
+    int64_t closedUntilUs = 0;          // last NOT_OPEN arrival (0: none)
+    int64_t openedByUs = INT64_MAX;     // first arrival the orderbook took (INT64_MAX: never)
+    int64_t openUs = INT64_MAX;         // estimated open instant
+};
+
+struct ReplayOrder {
+    int orderIndex = 0;
+    int market = 0;                     // into ReplayScenario::markets
+    int64_t filledUs = 0;               // answer of the recorded fill; 0 = not filled
+};
+
+struct ReplayLatency {
+    uint32_t us;
+    bool failed;                        // transport error: no answer
+};
+
+// One recorded run, server clock throughout
+struct ReplayScenario {
+    int64_t firstSendUs = INT64_MAX;
+    int64_t fireAtMs = 0;               // 0 = started immediately
+    int64_t expectedOpenMs = 0;
+    int intervalMs = 0;                 // pacing as recorded; 0 = not recorded (CSV)
+    int probeIntervalMs = 0;
+    int maxAttempts = 0;
+    std::vector<int> burstOffsetsMs;
+    double limitRps = 0;                // 0: no 429 recorded
+    long attempts = 0;
+    long rateLimited = 0;
+    std::vector<ReplayMarket> markets;
+    std::vector<ReplayOrder> orders;
+    std::vector<ReplayLatency> latencies;
+};
+
+// Collects one run's attempts, in any order, into a ReplayScenario
+class ReplayScenarioBuilder {
+public:
+    ReplayScenario scenario;
+
+    // Position of the order in scenario.orders
+    int addOrder(int orderIndex, const std::string& slug) {
+        for (size_t i = 0; i < scenario.orders.size(); i++) {
+            if (scenario.orders[i].orderIndex == orderIndex) return (int)i;
+        }
+        size_t market = 0;
+        while (market < scenario.markets.size() && scenario.markets[market].slug != slug) market++;
+        if (market == scenario.markets.size()) {
+            scenario.markets.emplace_back();
+            scenario.markets.back().slug = slug;
+        }
+        ReplayOrder order;
+        order.orderIndex = orderIndex;
+        order.market = (int)market;
+        scenario.orders.push_back(order);
+        return (int)scenario.orders.size() - 1;
+    }
+
+    void addAttempt(int order, int64_t sentUs, uint32_t durationUs, bool failed, ResponseKind kind,
+                    long httpStatus, bool filled) {
+        scenario.attempts++;
+        scenario.firstSendUs = std::min(scenario.firstSendUs, sentUs);
+        scenario.latencies.push_back({durationUs, failed});
+        if (failed) return;
+
+        int64_t arrivedUs = sentUs + durationUs / 2;
+        arrivalsUs_.push_back(arrivedUs);
+        ReplayMarket& market = scenario.markets[scenario.orders[order].market];
+        if (kind == ResponseKind::NOT_OPEN) {
+            market.closedUntilUs = std::max(market.closedUntilUs, arrivedUs);
+        } else if (impliesWindowOpen(kind, httpStatus)) {
+            market.openedByUs = std::min(market.openedByUs, arrivedUs);
+        } else if (kind == ResponseKind::RATE_LIMITED) {
+            scenario.rateLimited++;
+            firstLimitedUs_ = std::min(firstLimitedUs_, arrivedUs);
+        }
+        int64_t& filledUs = scenario.orders[order].filledUs;
+        if (filled && (filledUs == 0 || sentUs + durationUs < filledUs)) filledUs = sentUs + durationUs;
+    }
+
+    // Place each market's open instant and the rate limit; false if no market opened
+    bool finish() {
+        bool opened = false;
+        for (auto& market : scenario.markets) {
+            if (market.openedByUs == INT64_MAX) continue;
+            opened = true;
+            // Arrivals overtaking each other leave only the upper bound
+            market.openUs = market.closedUntilUs > 0 && market.closedUntilUs < market.openedByUs
+                                ? market.closedUntilUs + (market.openedByUs - market.closedUntilUs) / 2
+                                : market.openedByUs;
+        }
+        // A full bucket emptied over that second: its capacity plus what it refilled
+        if (firstLimitedUs_ != INT64_MAX) {
+            int64_t fromUs = std::max(firstLimitedUs_ - 1000000,
+                                      *std::min_element(arrivalsUs_.begin(), arrivalsUs_.end()));
+            long taken = 0;
+            for (int64_t arrivedUs : arrivalsUs_) {
+                if (arrivedUs < firstLimitedUs_ && arrivedUs >= fromUs) taken++;
+            }
+            scenario.limitRps = std::max(1.0, taken / (1.0 + (firstLimitedUs_ - fromUs) / 1e6));
+        }
+        return opened && scenario.firstSendUs != INT64_MAX;
+    }
+
+private:
+    std::vector<int64_t> arrivalsUs_;
+    int64_t firstLimitedUs_ = INT64_MAX;
+};
+
+// The runs of an attempt log (AttemptLogReader); runs in which no market opened
+// cannot place a window and are counted in skipped
+inline bool loadReplayLog(const std::string& path, std::vector<ReplayScenario>& scenarios, size_t& skipped) {
+    AttemptLogReader reader;
+    if (!reader.open(path)) return false;
+    reader.forEach([&](const AttemptLogSegment& segment) {
+        const AttemptLogHeader& header = *segment.header;
+        ReplayScenarioBuilder builder;
+        std::vector<int> orders;
+        for (uint32_t i = 0; i < header.orderCount; i++) {
+            const AttemptLogOrder& order = segment.orders[i];
+            orders.push_back(builder.addOrder(order.orderIndex, std::string(order.market, order.marketLength)));
+        }
+        for (uint64_t i = 0; i < header.recordCount; i++) {
+            const AttemptLogRecord& record = segment.records[i];
+            if (record.order >= header.orderCount) continue;
+            builder.addAttempt(orders[record.order], record.sentNs / 1000 + header.serverOffsetUs, record.durationUs,
+                               record.curlCode != 0, (ResponseKind)record.kind, record.httpStatus,
+                               (record.flags & AttemptRecord::SUCCESS) != 0);
+        }
+        ReplayScenario& scenario = builder.scenario;
+        scenario.fireAtMs = header.fireAtMs;
+        scenario.expectedOpenMs = header.expectedOpenMs;
+        scenario.intervalMs = header.intervalMs;
+        scenario.probeIntervalMs = header.probeIntervalMs;
+        scenario.maxAttempts = header.maxAttempts;
+        for (uint32_t i = 0; i < std::min<uint32_t>(header.burstCount, AttemptLogHeader::MAX_BURST); i++) {
+            scenario.burstOffsetsMs.push_back(header.burstOffsetsMs[i]);
+        }
+        if (builder.finish()) {
+            scenarios.push_back(std::move(scenario));
+        } else {
+            skipped++;
+        }
+    });
+    return true;
+}
+
+// The runs of a per-attempt CSV (`attempt-log export --csv`, rows grouped by run).
+// It carries no pacing: the runs replay with the caller's.
+inline bool loadReplayCsv(const std::string& path, std::vector<ReplayScenario>& scenarios, size_t& skipped) {
+    std::ifstream in(path);
+    std::string line;
+    if (!in || !std::getline(in, line)) return false;
+
+    auto split = [](const std::string& row, std::vector<std::string>& cells) {
+        cells.clear();
+        cells.emplace_back();
+        bool quoted = false;
+        for (size_t i = 0; i < row.size(); i++) {
+            char c = row[i];
+            if (quoted) {
+                if (c == '"' && i + 1 < row.size() && row[i + 1] == '"') {
+                    cells.back() += '"';
+                    i++;
+                } else if (c == '"') {
+                    quoted = false;
+                } else {
+                    cells.back() += c;
+                }
+            } else if (c == '"') {
+                quoted = true;
+            } else if (c == ',') {
+                cells.emplace_back();
+            } else if (c != '\r') {
+                cells.back() += c;
+            }
+        }
+    };
+
+    std::vector<std::string> cells;
+    split(line, cells);
+    const char* names[] = {"run", "market", "order_index", "server_sent_ms", "latency_us",
+                           "http_status", "curl_code", "kind", "success"};
+    const int columnCount = sizeof(names) / sizeof(names[0]);
+    size_t columns[columnCount];
+    size_t widest = 0;
+    for (int c = 0; c < columnCount; c++) {
+        columns[c] = std::find(cells.begin(), cells.end(), names[c]) - cells.begin();
+        if (columns[c] == cells.size()) return false;
+        widest = std::max(widest, columns[c]);
+    }
+
+    ReplayScenarioBuilder builder;
+    std::string run;
+    auto flush = [&]() {
+        if (builder.scenario.attempts == 0) return;
+        if (builder.finish()) {
+            scenarios.push_back(std::move(builder.scenario));
+        } else {
+            skipped++;
+        }
+        builder = ReplayScenarioBuilder();
+    };
+    while (std::getline(in, line)) {
+        split(line, cells);
+        if (cells.size() <= widest) continue;
+        if (cells[columns[0]] != run) {
+            flush();
+            run = cells[columns[0]];
+        }
+        ResponseKind kind = ResponseKind::REJECTED;
+        for (int k = 0; k <= (int)ResponseKind::TRANSPORT_ERROR; k++) {
+            if (cells[columns[7]] == responseKindName((ResponseKind)k)) kind = (ResponseKind)k;
+        }
+        int order = builder.addOrder(std::atoi(cells[columns[2]].c_str()), cells[columns[1]]);
+        builder.addAttempt(order, (int64_t)(std::strtod(cells[columns[3]].c_str(), nullptr) * 1000),
+                           (uint32_t)std::strtoul(cells[columns[4]].c_str(), nullptr, 10),
+                           std::atoi(cells[columns[6]].c_str()) != 0, kind, std::atol(cells[columns[5]].c_str()),
+                           cells[columns[8]] == "1");
+    }
+    flush();
+    return true;
+}
+
+struct ReplayParams {
+    static const int RECORDED = -1;     // the run's own value
+
+    int intervalMs = RECORDED;
+    int probeIntervalMs = RECORDED;
+    int maxAttempts = RECORDED;
+    int delayShiftMs = 0;               // start (first send or fire instant) moved by this much
+    bool http2 = false;                 // pace by send instead of by answer
+    int perOrderInFlight = 1;
+};
+
+// Outcome of one or more replayed runs under one parameter set
+struct ReplayResult {
+    int orders = 0;
+    int filled = 0;
+    long attempts = 0;
+    long rateLimited = 0;
+    int64_t replayedUs = 0;             // simulated time
+    std::vector<int64_t> fillUs;        // per filled order: open instant to the filling answer
+
+    void clear() {
+        orders = filled = 0;
+        attempts = rateLimited = 0;
+        replayedUs = 0;
+        fillUs.clear();
+    }
+
+    double meanFillMs() const {
+        if (fillUs.empty()) return 0;
+        double sum = 0;
+        for (int64_t us : fillUs) sum += us;
+        return sum / fillUs.size() / 1000.0;
+    }
+
+    // Sorts fillUs
+    double fillPercentileMs(double p) {
+        if (fillUs.empty()) return 0;
+        std::sort(fillUs.begin(), fillUs.end());
+        size_t index = std::min(fillUs.size() - 1, (size_t)(p / 100.0 * fillUs.size()));
+        return fillUs[index] / 1000.0;
+    }
+
+    // More orders filled first, then sooner, then with fewer attempts
+    bool betterThan(const ReplayResult& other) const {
+        if (filled != other.filled) return filled > other.filled;
+        double mean = meanFillMs();
+        double otherMean = other.meanFillMs();
+        if (mean != otherMean) return mean < otherMean;
+        return attempts < other.attempts;
+    }
+
+    void print(std::ostream& out) {
+        auto tenths = [](double ms) { return (long)(ms * 10) / 10.0; };
+        double p50 = fillPercentileMs(50);
+        double p90 = fillPercentileMs(90);
+        out << "orders=" << orders << ",filled=" << filled << ",ttf_mean_ms=" << tenths(meanFillMs())
+            << ",ttf_p50_ms=" << tenths(p50) << ",ttf_p90_ms=" << tenths(p90) << ",attempts=" << attempts
+            << ",rate_limited=" << rateLimited;
+    }
+
+    // What the recorded run itself achieved
+    static void recorded(const ReplayScenario& scenario, ReplayResult& result) {
+        for (const auto& order : scenario.orders) {
+            result.orders++;
+            if (order.filledUs == 0) continue;
+            result.filled++;
+            result.fillUs.push_back(order.filledUs - scenario.markets[order.market].openUs);
+        }
+        result.attempts += scenario.attempts;
+        result.rateLimited += scenario.rateLimited;
+    }
+};
+
+class ReplaySimulator {
+public:
+    using Clock = RateController::Clock;
+
+    static constexpr int64_t HORIZON_US = 600LL * 1000000;  // a replayed run gives up 10 minutes after its start
+
+    // Replay scenario under params and add its outcome to result
+    void run(const ReplayScenario& scenario, const ReplayParams& params, ReplayResult& result) {
+        scenario_ = &scenario;
+        intervalMs_ = params.intervalMs != ReplayParams::RECORDED ? params.intervalMs : scenario.intervalMs;
+        probeIntervalMs_ = params.probeIntervalMs != ReplayParams::RECORDED ? params.probeIntervalMs
+                                                                             : scenario.probeIntervalMs;
+        maxAttempts_ = params.maxAttempts != ReplayParams::RECORDED ? params.maxAttempts : scenario.maxAttempts;
+        http2_ = params.http2;
+        perOrderInFlight_ = std::max(1, params.perOrderInFlight);
+        rng_ = (uint64_t)scenario.firstSendUs * 0x9e3779b97f4a7c15ULL | 1;
+
+        // SpamEngine::schedule: the burst plan in server time, or a start right away
+        int64_t shiftUs = params.delayShiftMs * 1000LL;
+        int64_t startUs = scenario.firstSendUs + shiftUs;
+        plan_.clear();
+        if (scenario.fireAtMs > 0) {
+            for (int offset : scenario.burstOffsetsMs) plan_.push_back((scenario.fireAtMs + offset) * 1000 + shiftUs);
+            if (plan_.empty()) plan_.push_back(scenario.fireAtMs * 1000 + shiftUs);
+            std::sort(plan_.begin(), plan_.end());
+            startUs = plan_.front();
+        }
+
+        // Stream the markets interleaved, staggered over one pace interval
+        size_t orderCount = scenario.orders.size();
+        slots_.assign(orderCount, Slot());
+        launchOrder_.clear();
+        for (size_t k = 0; launchOrder_.size() < orderCount; k++) {
+            for (size_t m = 0; m < scenario.markets.size(); m++) {
+                size_t seen = 0;
+                for (size_t i = 0; i < orderCount; i++) {
+                    if (scenario.orders[i].market != (int)m) continue;
+                    if (seen++ == k) launchOrder_.push_back((int)i);
+                }
+            }
+        }
+        launchCursor_ = 0;
+        remaining_ = (int)orderCount;
+        inFlight_ = 0;
+        requests_.clear();
+        freeRequests_.clear();
+        events_.clear();
+        limitTokens_ = scenario.limitRps;
+        limitRefillUs_ = startUs;
+
+        RateController rate(RateController::ratePerInterval(orderCount, probeIntervalMs_),
+                            RateController::ratePerInterval(orderCount, intervalMs_),
+                            perOrderInFlight_ * (int)orderCount, at(startUs));
+        rate_ = &rate;
+        if (scenario.expectedOpenMs > 0) rate.setExpectedOpen(at(scenario.expectedOpenMs * 1000));
+        rate.update(at(startUs));
+        for (size_t i = 0; i < orderCount; i++) {
+            slots_[launchOrder_[i]].nextSendUs = startUs + paceUs() * (int64_t)i / (int64_t)orderCount;
+        }
+
+        int64_t now = startUs;
+        while (remaining_ > 0 && now - startUs < HORIZON_US) {
+            while (!events_.empty() && events_.front().atUs <= now) {
+                std::pop_heap(events_.begin(), events_.end(), Event::later);
+                Event event = events_.back();
+                events_.pop_back();
+                if (event.complete) {
+                    complete(event, now);
+                } else {
+                    arrive(event);
+                }
+            }
+            if (remaining_ == 0) break;
+            launchDue(now);
+            int64_t wake = nextWake(now);
+            if (wake == INT64_MAX) break;
+            now = wake;
+        }
+        rate_ = nullptr;
+
+        result.replayedUs += now - startUs;
+        for (size_t i = 0; i < orderCount; i++) {
+            const Slot& slot = slots_[i];
+            result.orders++;
+            result.attempts += slot.attempts;
+            if (!slot.success) continue;
+            result.filled++;
+            result.fillUs.push_back(slot.filledUs - scenario.markets[scenario.orders[i].market].openUs);
+        }
+        result.rateLimited += rateLimited_;
+        rateLimited_ = 0;
+    }
+
+private:
+    struct Slot {
+        int attempts = 0;
+        int inFlight = 0;
+        bool done = false;
+        bool success = false;
+        size_t planIndex = 0;
+        int64_t nextSendUs = 0;
+        int64_t filledUs = 0;
+    };
+
+    struct Request {
+        int slot;
+        uint32_t generation;            // events of a cancelled request no longer match
+        bool live;
+        bool planned;
+        bool failed;
+        int64_t sentUs;
+        ResponseKind kind;
+        long httpStatus;
+    };
+
+    struct Event {
+        int64_t atUs;
+        uint32_t seq;                   // ties in push order
+        int request;
+        uint32_t generation;
+        bool complete;                  // answer at the engine; else arrival at the server
+
+        static bool later(const Event& a, const Event& b) {
+            return a.atUs != b.atUs ? a.atUs > b.atUs : a.seq > b.seq;
+        }
+    };
+
+    const ReplayScenario* scenario_ = nullptr;
+    RateController* rate_ = nullptr;
+    int intervalMs_ = 0;
+    int probeIntervalMs_ = 0;
+    int maxAttempts_ = 0;
+    bool http2_ = false;
+    int perOrderInFlight_ = 1;
+    uint64_t rng_ = 1;
+    std::vector<int64_t> plan_;
+    std::vector<Slot> slots_;
+    std::vector<int> launchOrder_;
+    size_t launchCursor_ = 0;
+    int remaining_ = 0;
+    int inFlight_ = 0;                  // regular sends in flight (the rate window)
+    std::vector<Request> requests_;
+    std::vector<int> freeRequests_;
+    std::vector<Event> events_;         // heap, earliest first
+    uint32_t seq_ = 0;
+    uint32_t generation_ = 0;
+    double limitTokens_ = 0;            // the server's bucket
+    int64_t limitRefillUs_ = 0;
+    long rateLimited_ = 0;
+
+    static Clock::time_point at(int64_t us) { return Clock::time_point(std::chrono::microseconds(us)); }
+
+    static int64_t usOf(Clock::time_point t) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(t.time_since_epoch()).count();
+    }
+
+    int64_t paceUs() const { return (rate_->ramping() ? intervalMs_ : probeIntervalMs_) * 1000LL; }
+
+    // xorshift64*
+    uint64_t draw() {
+        rng_ ^= rng_ >> 12;
+        rng_ ^= rng_ << 25;
+        rng_ ^= rng_ >> 27;
+        return rng_ * 0x2545f4914f6cdd1dULL;
+    }
+
+    void push(int64_t atUs, int request, bool complete) {
+        events_.push_back({atUs, seq_++, request, requests_[request].generation, complete});
+        std::push_heap(events_.begin(), events_.end(), Event::later);
+    }
+
+    // SpamEngine::sendRequest / dispatch
+    void send(int slotIndex, int64_t now, bool planned) {
+        Slot& slot = slots_[slotIndex];
+        slot.attempts++;
+        slot.inFlight++;
+        int index;
+        if (freeRequests_.empty()) {
+            index = (int)requests_.size();
+            requests_.emplace_back();
+        } else {
+            index = freeRequests_.back();
+            freeRequests_.pop_back();
+        }
+        const ReplayLatency& latency = scenario_->latencies[draw() % scenario_->latencies.size()];
+        Request& req = requests_[index];
+        req.slot = slotIndex;
+        req.generation = ++generation_;
+        req.live = true;
+        req.planned = planned;
+        req.failed = latency.failed;
+        req.sentUs = now;
+        req.kind = ResponseKind::TRANSPORT_ERROR;
+        req.httpStatus = 0;
+        if (!latency.failed) push(now + latency.us / 2, index, false);
+        push(now + latency.us, index, true);
+        if (http2_) slot.nextSendUs = now + paceUs();
+    }
+
+    // The simulated server: rate limit, then the orderbook
+    void arrive(const Event& event) {
+        bool limited = false;
+        double limitRps = scenario_->limitRps;
+        if (limitRps > 0) {
+            limitTokens_ = std::min(limitRps, limitTokens_ + (event.atUs - limitRefillUs_) / 1e6 * limitRps);
+            limitRefillUs_ = event.atUs;
+            limited = limitTokens_ < 1.0;
+            if (!limited) limitTokens_ -= 1.0;
+        }
+        Request& req = requests_[event.request];
+        if (!req.live || req.generation != event.generation) return;
+        if (limited) {
+            req.kind = ResponseKind::RATE_LIMITED;
+            req.httpStatus = 429;
+        } else if (event.atUs >= scenario_->markets[scenario_->orders[req.slot].market].openUs) {
+            req.kind = ResponseKind::FILLED;
+            req.httpStatus = 200;
+        } else {
+            req.kind = ResponseKind::NOT_OPEN;
+            req.httpStatus = 400;
+        }
+    }
+
+    void release(int index) {
+        Request& req = requests_[index];
+        Slot& slot = slots_[req.slot];
+        slot.inFlight--;
+        if (!req.planned) inFlight_--;
+        req.live = false;
+        freeRequests_.push_back(index);
+    }
+
+    // SpamEngine::finishSlot: the order's other requests are cancelled
+    void finish(int slotIndex) {
+        slots_[slotIndex].done = true;
+        remaining_--;
+        for (size_t i = 0; i < requests_.size(); i++) {
+            if (requests_[i].live && requests_[i].slot == slotIndex) release((int)i);
+        }
+    }
+
+    // SpamEngine::completeRequest / applySignal
+    void complete(const Event& event, int64_t now) {
+        Request& req = requests_[event.request];
+        if (!req.live || req.generation != event.generation) return;
+        int slotIndex = req.slot;
+        Slot& slot = slots_[slotIndex];
+        ResponseKind kind = req.kind;
+        long httpStatus = req.httpStatus;
+        int64_t sentUs = req.sentUs;
+        release(event.request);
+
+        if (kind == ResponseKind::RATE_LIMITED) rateLimited_++;
+        if (kind == ResponseKind::FILLED) {
+            slot.success = true;
+            slot.filledUs = now;
+        }
+        if (rate_->onResponse(kind, httpStatus, at(sentUs), at(now)) == RateController::OPEN) {
+            for (auto& other : slots_) {
+                if (!other.done) other.nextSendUs = std::min(other.nextSendUs, now);
+            }
+        }
+
+        bool planPending = slot.planIndex < plan_.size();
+        if (slot.success || (slot.attempts >= maxAttempts_ && slot.inFlight == 0 && !planPending)) {
+            finish(slotIndex);
+        } else if (!http2_ && !planPending) {
+            slot.nextSendUs = now + paceUs();
+        }
+    }
+
+    // SpamEngine::launchDue, one order per request and enough handles
+    void launchDue(int64_t now) {
+        rate_->update(at(now));
+        bool throttled = false;
+        size_t count = launchOrder_.size();
+        size_t resumeAt = count;
+        for (size_t k = 0; k < count; k++) {
+            size_t position = (launchCursor_ + k) % count;
+            int slotIndex = launchOrder_[position];
+            Slot& slot = slots_[slotIndex];
+            if (slot.done || slot.attempts >= maxAttempts_) continue;
+
+            if (slot.planIndex < plan_.size()) {
+                if (now < plan_[slot.planIndex]) continue;
+                send(slotIndex, now, true);
+                slot.planIndex++;
+                continue;
+            }
+
+            if (throttled || slot.inFlight >= perOrderInFlight_ || now < slot.nextSendUs) continue;
+            if (!rate_->tryAcquire(inFlight_)) {
+                throttled = true;
+                resumeAt = position;
+                continue;
+            }
+            send(slotIndex, now, false);
+            inFlight_++;
+        }
+        if (resumeAt < count) launchCursor_ = resumeAt;
+    }
+
+    // SpamEngine::waitForNextSend: the next answer, planned send or paced send.
+    // Token waits round up to whole ms like the engine's poll timeout.
+    int64_t nextWake(int64_t now) const {
+        int64_t wake = events_.empty() ? INT64_MAX : events_.front().atUs;
+        int64_t nextToken = usOf(rate_->nextTokenAt(at(now)));
+        bool windowFull = inFlight_ >= rate_->window();
+        for (const auto& slot : slots_) {
+            if (slot.done || slot.attempts >= maxAttempts_) continue;
+            if (slot.planIndex < plan_.size()) {
+                wake = std::min(wake, plan_[slot.planIndex]);
+                continue;
+            }
+            if (windowFull || slot.inFlight >= perOrderInFlight_) continue;
+            int64_t due = std::max(slot.nextSendUs, nextToken);
+            if (due == nextToken && due > now) due = now + (due - now + 999) / 1000 * 1000;
+            wake = std::min(wake, std::max(due, now + 1));
+        }
+        return wake;
+    }
+};
@@ -0,0 +1,105 @@
+/**
+ * RequestTemplate - pre-serialized authenticated POST /orders request
+ *
+ * URL and the six CLOB headers are built once per curl handle. Only the two
+ * fields that change between attempts live in fixed-width slots inside the
+ * curl_slist nodes and are overwritten in place:
+ *   POLY_TIMESTAMP: <10 digits>
+ *   POLY_SIGNATURE: <44 chars URL-safe base64>
+ *
+ * Per attempt: patch() + setBody() = zero heap allocations in our code
+ * (POSTFIELDS is passed by pointer, curl does not copy it).
+ *
+ * A template must not be patched while its handle has a transfer in flight;
+ * use one template per concurrently active handle.
+ */
+
+#pragma once
+
+#include "hmac-signer.hpp"
+#include <curl/curl.h>
+#include <cstring>
+#include <string>
+
+class RequestTemplate {
+public:
+    static const size_t TIMESTAMP_LEN = 10;  // unix seconds, fixed width until 2286
+
+    RequestTemplate(const std::string& baseUrl, const char* path,
+                    const std::string& address, const std::string& apiKey,
+                    const std::string& passphrase)
+        : url_(baseUrl + path), path_(path), pathLen_(std::strlen(path)) {
+        headers_ = curl_slist_append(headers_, "Content-Type: application/json");
+        headers_ = curl_slist_append(headers_, ("POLY_ADDRESS: " + address).c_str());
+        signature_ = appendSlot("POLY_SIGNATURE: ", HmacSigner::SIGNATURE_LEN);
+        timestamp_ = appendSlot("POLY_TIMESTAMP: ", TIMESTAMP_LEN);
+        headers_ = curl_slist_append(headers_, ("POLY_API_KEY: " + apiKey).c_str());
+        headers_ = curl_slist_append(headers_, ("POLY_PASSPHRASE: " + passphrase).c_str());
+    }
+
+    ~RequestTemplate() {
+        curl_slist_free_all(headers_);
+    }
+
+    RequestTemplate(const RequestTemplate&) = delete;
+    RequestTemplate& operator=(const RequestTemplate&) = delete;
+
+    // Set URL, method and headers on a handle (once, or after the handle was used for another request)
+    void apply(CURL* curl) const {
+        curl_easy_setopt(curl, CURLOPT_URL, url_.c_str());
+        curl_easy_setopt(curl, CURLOPT_POST, 1L);
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers_);
+    }
+
+    // Point the handle at this attempt's body (no copy)
+    static void setBody(CURL* curl, const std::string& body) {
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.c_str());
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, (long)body.length());
+    }
+
+    // Write timestamp and signature(timestamp + POST + path + body) into their slots.
+    // Returns false if the timestamp does not fit the fixed-width slot.
+    bool patch(const HmacSigner& signer, const char* timestamp, size_t timestampLen,
+               const char* body, size_t bodyLen) {
+        if (timestampLen != TIMESTAMP_LEN) return false;
+        std::memcpy(timestamp_, timestamp, TIMESTAMP_LEN);
+        signer.sign(timestamp, timestampLen, "POST", 4, path_, pathLen_, body, bodyLen, signature_);
+        return true;
+    }
+
+    bool patch(const HmacSigner& signer, const std::string& timestamp, const std::string& body) {
+        return patch(signer, timestamp.data(), timestamp.length(), body.data(), body.length());
+    }
+
+    // Unix seconds as TIMESTAMP_LEN digits into out (no allocation); false if they do not fit
+    static bool formatTimestamp(long long seconds, char* out) {
+        if (seconds < 0 || seconds >= 10000000000LL) return false;
+        for (size_t i = TIMESTAMP_LEN; i-- > 0;) {
+            out[i] = (char)('0' + seconds % 10);
+            seconds /= 10;
+        }
+        return true;
+    }
+
+    struct curl_slist* headers() const { return headers_; }
+    std::string signature() const { return std::string(signature_, HmacSigner::SIGNATURE_LEN); }
+    std::string timestamp() const { return std::string(timestamp_, TIMESTAMP_LEN); }
+
+private:
+    std::string url_;
+    const char* path_;
+    size_t pathLen_;
+    struct curl_slist* headers_ = nullptr;
+    char* signature_ = nullptr;
+    char* timestamp_ = nullptr;
+
+    // Append "<name><width placeholder chars>" and return a pointer to the value slot
+    char* appendSlot(const char* name, size_t width) {
+        std::string header = std::string(name) + std::string(width, '0');
+        headers_ = curl_slist_append(headers_, header.c_str());
+
+        struct curl_slist* node = headers_;
+        while (node->next) node = node->next;
+        return node->data + std::strlen(name);
+    }
+};
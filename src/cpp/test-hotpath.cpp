@@ -0,0 +1,849 @@
+/**
+ * C++ Hot-Path Tests
+ *
+ * Correctness checks of the send-path components the benchmarks time:
+ * known vectors, agreement with the legacy implementations, chunk-split
+ * invariance and fuzzing of the response parser, ring/log round trips,
+ * replay, the io_uring response reader, market discovery, edge ranking and
+ * native order signing against the clob-client fixture. Each passing check
+ * prints a CHECK: line; the first failure prints ERROR: and exits 1.
+ *
+ * Run from the repository root (fixtures are read by relative path).
+ *
+ * Build: bash build-tests.sh
+ * Usage: ./dist/test-hotpath
+ */
+
+#include "hmac-signer.hpp"
+#include "request-template.hpp"
+#include "latency-histogram.hpp"
+#include "rate-controller.hpp"
+#include "order-response.hpp"
+#include "attempt-ring.hpp"
+#include "attempt-log.hpp"
+#include "edge-router.hpp"
+#include "market-discovery.hpp"
+#include "order-signer.hpp"
+#include "uring-transport.hpp"
+#include "replay-sim.hpp"
+#include "hotpath-fixtures.hpp"
+#include <openssl/ec.h>
+#include <openssl/obj_mac.h>
+#include <openssl/rand.h>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <cstdlib>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+// POLY_SIGNATURE and its url-safe digest encoding agree with the legacy path
+bool checkHmacSigner() {
+    const std::string secret = SAMPLE_SECRET;
+    const std::string timestamp = SAMPLE_TIMESTAMP;
+    const std::string body = SAMPLE_BODY;
+    const HmacSigner signer(secret);
+    std::string expected = legacy::generateSignature(secret, timestamp + "POST" + ORDER_PATH + body);
+    std::string actual = signer.sign(timestamp, "POST", ORDER_PATH, body);
+    if (expected != actual) {
+        std::cerr << "ERROR: HmacSigner mismatch: " << actual << " != " << expected << std::endl;
+        return false;
+    }
+
+    unsigned char digest[SHA256_DIGEST_LENGTH];
+    SHA256(reinterpret_cast<const unsigned char*>(body.data()), body.length(), digest);
+    std::string legacyEncoded = legacy::base64Encode(digest, SHA256_DIGEST_LENGTH);
+    char encoded[HmacSigner::SIGNATURE_LEN];
+    HmacSigner::encodeUrlSafe(digest, encoded);
+    for (char& c : legacyEncoded) c = c == '+' ? '-' : c == '/' ? '_' : c;
+    if (legacyEncoded != std::string(encoded, HmacSigner::SIGNATURE_LEN) ||
+        HmacSigner::decodeSecret(secret) != legacy::base64Decode(secret)) {
+        std::cerr << "ERROR: HmacSigner base64 mismatch" << std::endl;
+        return false;
+    }
+
+    std::cout << "CHECK:hmac_signer:signature=" << actual << std::endl;
+    return true;
+}
+
+// A patched template signs like the legacy path; timestamps are formatted into
+// the slot's width, and one that does not fit is refused
+bool checkRequestTemplate() {
+    const std::string secret = SAMPLE_SECRET;
+    const std::string timestamp = SAMPLE_TIMESTAMP;
+    const std::string body = SAMPLE_BODY;
+    const HmacSigner signer(secret);
+    RequestTemplate tmpl("https://clob.polymarket.com", ORDER_PATH, SAMPLE_ADDRESS, SAMPLE_API_KEY, SAMPLE_PASSPHRASE);
+    tmpl.patch(signer, timestamp, body);
+    if (tmpl.signature() != legacy::generateSignature(secret, timestamp + "POST" + ORDER_PATH + body)) {
+        std::cerr << "ERROR: RequestTemplate signature mismatch" << std::endl;
+        return false;
+    }
+
+    char slot[RequestTemplate::TIMESTAMP_LEN];
+    bool formatted = RequestTemplate::formatTimestamp(std::atoll(timestamp.c_str()), slot) &&
+                     std::string(slot, sizeof(slot)) == timestamp;
+    if (!formatted || RequestTemplate::formatTimestamp(10000000000LL, slot) ||
+        tmpl.patch(signer, slot, sizeof(slot) - 1, body.data(), body.length())) {
+        std::cerr << "ERROR: RequestTemplate timestamp formatting" << std::endl;
+        return false;
+    }
+
+    std::cout << "CHECK:request_template:timestamp=" << std::string(slot, sizeof(slot)) << std::endl;
+    return true;
+}
+
+// Percentiles of 1..100000us must be within the histogram's 1% precision
+bool checkLatencyHistogram() {
+    LatencyHistogram histogram;
+    for (int64_t v = 1; v <= 100000; v++) histogram.record(v);
+    const double checks[][2] = {{50, 50000}, {90, 90000}, {99, 99000}, {99.9, 99900}};
+    for (const auto& check : checks) {
+        double got = (double)histogram.percentile(check[0]);
+        if (got < check[1] || got > check[1] * 1.01) {
+            std::cerr << "ERROR: LatencyHistogram p" << check[0] << " = " << got
+                      << ", expected ~" << check[1] << std::endl;
+            return false;
+        }
+    }
+
+    std::cout << "CHECK:latency_histogram:samples=100000" << std::endl;
+    return true;
+}
+
+// A 429 must cut both the rate and the in-flight window; one cut per episode
+bool checkRateController() {
+    auto now = RateController::Clock::now();
+    RateController aimd(10000, 10000, 64);
+    aimd.update(now);
+    auto sentBefore = now;
+    now += std::chrono::milliseconds(1);
+    if (aimd.onResponse(ResponseKind::RATE_LIMITED, 429, sentBefore, now) != RateController::DECREASE ||
+        aimd.rate(now) > 5000 || aimd.window() != 32 ||
+        aimd.onResponse(ResponseKind::RATE_LIMITED, 429, sentBefore, now) != RateController::NONE) {
+        std::cerr << "ERROR: RateController AIMD decrease" << std::endl;
+        return false;
+    }
+
+    std::cout << "CHECK:rate_controller:window=" << aimd.window() << std::endl;
+    return true;
+}
+
+OrderResponse parseChunked(OrderResponseParser& parser, const std::string& body, const size_t* chunks, size_t chunkCount) {
+    parser.reset();
+    size_t pos = 0;
+    for (size_t i = 0; pos < body.size(); i++) {
+        size_t length = std::min(chunks[i % chunkCount], body.size() - pos);
+        parser.append(body.data() + pos, length);
+        pos += length;
+    }
+    return parser.result();
+}
+
+bool sameResult(const OrderResponse& a, const OrderResponse& b) {
+    return a.status == b.status && a.error == b.error && a.truncated == b.truncated &&
+           a.orderId.str() == b.orderId.str() && a.message.str() == b.message.str();
+}
+
+// Whole-body result and every batch item agree
+bool sameParse(const OrderResponseParser& a, const OrderResponseParser& b) {
+    if (!sameResult(a.result(), b.result()) || a.itemCount() != b.itemCount()) return false;
+    for (size_t i = 0; i <= a.itemCount(); i++) {
+        if (!sameResult(a.item(i), b.item(i))) return false;
+    }
+    return true;
+}
+
+bool spanWithin(const Span& span, const OrderResponseParser& parser) {
+    if (span.empty()) return true;
+    return span.data >= parser.data() && span.data + span.length <= parser.data() + parser.size();
+}
+
+// Corpus expectations, agreement with the legacy parser, chunk-split
+// invariance and mutation fuzzing (spans must stay inside the buffer)
+bool checkResponseParser() {
+    OrderResponseParser parser;
+    OrderResponseParser chunked;
+    std::vector<std::string> corpus;
+
+    for (const auto& c : RESPONSE_CASES) {
+        std::string body = c.body;
+        corpus.push_back(body);
+
+        const size_t whole[] = {body.size() + 1};
+        OrderResponse r = parseChunked(parser, body, whole, 1);
+        std::string got = r.filled() ? r.orderId.str() : r.message.str();
+        if (r.status != c.status || r.error != c.error || got != c.expected) {
+            std::cerr << "ERROR: OrderResponseParser case " << c.name << ": status=" << r.status
+                      << " error=" << OrderResponse::errorName(r.error) << " text=[" << got << "]" << std::endl;
+            return false;
+        }
+
+        // Same verdict as the legacy isSuccess(), except where its substring search misreads
+        std::string legacyOrderId;
+        bool legacyFilled = legacy::isSuccess(body, legacyOrderId);
+        if (c.legacyAgrees && (legacyFilled != r.filled() || (legacyFilled && legacyOrderId != got))) {
+            std::cerr << "ERROR: OrderResponseParser disagrees with legacy isSuccess on " << c.name << std::endl;
+            return false;
+        }
+    }
+
+    // Captured Gamma market payload: large, nested, escaped, no order fields
+    std::ifstream market("api-response.json");
+    if (market) {
+        std::stringstream text;
+        text << market.rdbuf();
+        corpus.push_back(text.str());
+        const size_t whole[] = {text.str().size() + 1};
+        OrderResponse r = parseChunked(parser, text.str(), whole, 1);
+        if (r.filled() || r.message.empty() || r.message.length > OrderResponseParser::FALLBACK_MESSAGE_LEN) {
+            std::cerr << "ERROR: OrderResponseParser misread api-response.json" << std::endl;
+            return false;
+        }
+    }
+
+    // Batch bodies: one result per order, in request order; other bodies apply to every order
+    struct BatchExpectation {
+        const char* name;
+        std::vector<std::string> texts;  // orderID or error text per item
+    };
+    const BatchExpectation batches[] = {
+        {"batch", {"the orderbook 1 does not exist", "0xabc123"}},
+        {"batch_nested", {"not enough balance / allowance", "0xdef456", "order 0x1 is invalid. Duplicated."}},
+    };
+    for (const auto& batch : batches) {
+        const ResponseCase* c = nullptr;
+        for (const auto& candidate : RESPONSE_CASES) {
+            if (strcmp(candidate.name, batch.name) == 0) c = &candidate;
+        }
+        std::string body = c->body;
+        const size_t whole[] = {body.size() + 1};
+        parseChunked(parser, body, whole, 1);
+        bool ok = parser.itemCount() == batch.texts.size() &&
+                  parser.item(batch.texts.size()).status == OrderResponse::EMPTY;
+        for (size_t i = 0; ok && i < batch.texts.size(); i++) {
+            OrderResponse item = parser.item(i);
+            ok = (item.filled() ? item.orderId.str() : item.message.str()) == batch.texts[i];
+        }
+        if (!ok) {
+            std::cerr << "ERROR: OrderResponseParser batch items of " << batch.name << std::endl;
+            return false;
+        }
+    }
+    for (const char* name : {"not_open_error", "rate_limited_text", "filled"}) {
+        for (const auto& c : RESPONSE_CASES) {
+            if (strcmp(c.name, name) != 0) continue;
+            std::string body = c.body;
+            const size_t whole[] = {body.size() + 1};
+            parseChunked(parser, body, whole, 1);
+            if (parser.itemCount() != 0 || !sameResult(parser.item(1), parser.result())) {
+                std::cerr << "ERROR: OrderResponseParser non-batch body " << name << " as batch" << std::endl;
+                return false;
+            }
+        }
+    }
+
+    // Any chunking must give the same result as one chunk
+    uint64_t seed = 0x9e3779b97f4a7c15ULL;
+    auto nextRandom = [&seed]() {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        return seed;
+    };
+    for (const auto& body : corpus) {
+        const size_t whole[] = {body.size() + 1};
+        parseChunked(parser, body, whole, 1);
+        for (size_t split = 1; split < body.size(); split++) {
+            const size_t chunks[] = {split, body.size()};
+            parseChunked(chunked, body, chunks, 2);
+            if (!sameParse(chunked, parser)) {
+                std::cerr << "ERROR: OrderResponseParser result depends on chunk split at " << split << std::endl;
+                return false;
+            }
+        }
+        for (int round = 0; round < 50; round++) {
+            size_t chunks[4];
+            for (auto& size : chunks) size = 1 + nextRandom() % 16;
+            parseChunked(chunked, body, chunks, 4);
+            if (!sameParse(chunked, parser)) {
+                std::cerr << "ERROR: OrderResponseParser result depends on chunking" << std::endl;
+                return false;
+            }
+        }
+    }
+
+    // Mutations: flipped/structural bytes and truncation must never escape the buffer
+    const char structural[] = {'"', '\\', ':', ',', '{', '}', '[', ']', ' ', '\n', '\0'};
+    for (int round = 0; round < 20000; round++) {
+        std::string body = corpus[nextRandom() % corpus.size()];
+        if (body.empty()) continue;
+        int edits = 1 + nextRandom() % 4;
+        for (int e = 0; e < edits; e++) {
+            size_t pos = nextRandom() % body.size();
+            body[pos] = (nextRandom() % 2) ? structural[nextRandom() % sizeof(structural)] : (char)nextRandom();
+        }
+        if (nextRandom() % 4 == 0) body.resize(nextRandom() % body.size());
+        const size_t chunks[] = {1 + nextRandom() % 64};
+        OrderResponse r = parseChunked(parser, body, chunks, 1);
+        bool itemsWithin = parser.itemCount() <= OrderResponseParser::MAX_ITEMS;
+        for (size_t i = 0; i < parser.itemCount(); i++) {
+            OrderResponse item = parser.item(i);
+            itemsWithin = itemsWithin && spanWithin(item.orderId, parser) && spanWithin(item.message, parser);
+        }
+        if (!spanWithin(r.orderId, parser) || !spanWithin(r.message, parser) || !itemsWithin ||
+            (r.status == OrderResponse::EMPTY) != body.empty()) {
+            std::cerr << "ERROR: OrderResponseParser fuzz failure" << std::endl;
+            return false;
+        }
+    }
+
+    // Oversized bodies are truncated, not reallocated
+    std::string huge(OrderResponseParser::CAPACITY * 2, 'x');
+    const size_t hugeChunks[] = {1000};
+    OrderResponse r = parseChunked(parser, huge, hugeChunks, 1);
+    if (!r.truncated || parser.size() != OrderResponseParser::CAPACITY) {
+        std::cerr << "ERROR: OrderResponseParser truncation" << std::endl;
+        return false;
+    }
+
+    std::cout << "CHECK:order_response:cases=" << corpus.size() << ",fuzz_rounds=20000" << std::endl;
+    return true;
+}
+
+// Edges rank by median, a few stalls move the hedge threshold (p95) but not
+// the ranking, and a failing edge drops to last place
+bool checkEdgeRouter() {
+    EdgeRouter edges;
+    edges.init("clob.polymarket.com", 443, {"104.18.1.1", "104.18.2.2", "104.18.3.3"});
+    bool ok = edges.size() == 3 && edges.rank(0) == 0 && edges.hedgeDelayUs(0) == EdgeRouter::MIN_HEDGE_DELAY_US;
+
+    for (int i = 0; i < EdgeRouter::WINDOW; i++) {
+        edges.onAnswer(0, 30000 + i % 5 * 100);
+        edges.onAnswer(1, 20000 + i % 5 * 100 + (i % 16 == 0 ? 200000 : 0));  // 1 in 16 stalls
+        edges.onAnswer(2, 25000 + i % 5 * 100);
+    }
+    ok = ok && edges.rank(0) == 1 && edges.rank(1) == 2 && edges.rank(2) == 0 && edges.rank(3) == -1;
+    ok = ok && edges.hedgeDelayUs(1) > 200000 && edges.hedgeDelayUs(2) < 26000;
+
+    for (int i = 0; i < EdgeRouter::WINDOW / 2 + 1; i++) edges.onError(1);
+    ok = ok && edges.rank(2) == 1;
+    if (!ok) {
+        std::cerr << "ERROR: EdgeRouter ranking" << std::endl;
+        return false;
+    }
+
+    std::cout << "CHECK:edge_router:edges=" << edges.size() << std::endl;
+    return true;
+}
+
+// Gamma market payloads (trimmed api-response.json): only top-level keys
+// count, clobTokenIds comes as a string holding a JSON array or as an array
+bool checkMarketDiscovery() {
+    const std::string gamma =
+        "{\"id\":\"702845\",\"slug\":\"eth-updown-15m-1764146700\","
+        "\"description\":\"resolves to \\\"Up\\\" if {\\\"clobTokenIds\\\": 1}\","
+        "\"events\":[{\"id\":\"1\",\"acceptingOrdersTimestamp\":\"2000-01-01T00:00:00Z\",\"clobTokenIds\":\"[\\\"7\\\", \\\"8\\\"]\"}],"
+        "\"clobTokenIds\":\"[\\\"114553696025920673753275050796419825458680018542924970907699411768912948254192\\\", "
+        "\\\"23216907076426757100990226849628982817498662086864898297218711044516250064314\\\"]\","
+        "\"acceptingOrders\":true,\"acceptingOrdersTimestamp\":\"2025-11-25T08:47:25Z\"}";
+    MarketInfo market;
+    bool ok = MarketDiscovery::parseMarket(gamma, market) && market.complete() &&
+              market.yesTokenId == "114553696025920673753275050796419825458680018542924970907699411768912948254192" &&
+              market.noTokenId == "23216907076426757100990226849628982817498662086864898297218711044516250064314" &&
+              market.acceptingOrdersTimestamp == "2025-11-25T08:47:25Z";
+
+    MarketInfo arrayForm;
+    ok = ok && MarketDiscovery::parseMarket("{\"clobTokenIds\":[\"11\",\"22\"],\"acceptingOrdersTimestamp\":null}", arrayForm) &&
+         arrayForm.yesTokenId == "11" && arrayForm.noTokenId == "22" && !arrayForm.complete();
+    MarketInfo unlisted;
+    ok = ok && !MarketDiscovery::parseMarket("{\"slug\":\"x\",\"clobTokenIds\":null}", unlisted) &&
+         !MarketDiscovery::parseMarket("[]", unlisted) && !MarketDiscovery::parseMarket("", unlisted);
+
+    ok = ok && MarketDiscovery::slugFor("eth-updown-15m", 1764146700 + 899, 0) == "eth-updown-15m-1764146700" &&
+         MarketDiscovery::slugFor("eth-updown-15m", 1764146700, 2) == "eth-updown-15m-1764148500" &&
+         MarketDiscovery::slotOf("eth-updown-15m-1764146700") == 1764146700 &&
+         MarketDiscovery::slotOf("eth-updown-15m") == 0 && MarketDiscovery::slotOf("x-12a") == 0;
+    if (!ok) {
+        std::cerr << "ERROR: MarketDiscovery parse" << std::endl;
+        return false;
+    }
+
+    std::cout << "CHECK:market_discovery:gamma_bytes=" << gamma.size() << std::endl;
+    return true;
+}
+
+std::string toHex(const uint8_t* bytes, size_t length) {
+    std::ostringstream out;
+    for (size_t i = 0; i < length; i++) out << std::hex << std::setw(2) << std::setfill('0') << (int)bytes[i];
+    return out.str();
+}
+
+// Keccak-256 vectors, the EIP-712 spec example (Mail domain, key
+// keccak("cow")), signatures recovered to the key and the client's amount rounding
+bool checkOrderSigner() {
+    uint8_t hash[Keccak256::HASH_LEN];
+    Keccak256::hash("", 0, hash);
+    bool ok = toHex(hash, 32) == "c5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470";
+    Keccak256::hash("abc", 3, hash);
+    ok = ok && toHex(hash, 32) == "4e03657aea45a94fc7d47ba826c8d667c0d1e6e33a64a036ec44f58fa12d6c45";
+    std::string longInput(300, 'a');  // spans several 136-byte blocks
+    Keccak256 streamed;
+    streamed.update(longInput.data(), 100);
+    streamed.update(longInput.data() + 100, 200);
+    uint8_t streamedHash[Keccak256::HASH_LEN];
+    streamed.final(streamedHash);
+    Keccak256::hash(longInput.data(), longInput.size(), hash);
+    ok = ok && memcmp(hash, streamedHash, 32) == 0;
+    if (!ok) {
+        std::cerr << "ERROR: Keccak256 vectors" << std::endl;
+        return false;
+    }
+
+    Keccak256::hash("cow", 3, hash);
+    const std::string sampleKey = "0x" + toHex(hash, 32);
+    if (sampleKey != SAMPLE_PRIVATE_KEY) {
+        std::cerr << "ERROR: Keccak256 of the sample key" << std::endl;
+        return false;
+    }
+    OrderSigner signer;
+    uint8_t domain[32];
+    uint8_t mailDigest[32];
+    uint8_t signature[OrderSigner::SIGNATURE_LEN];
+    const char* MAIL_DIGEST = "be609aee343fb3c4b28e1df9e632fca64fcfaede20f02e86244efddf30957bd2";
+    for (int i = 0; i < 32; i++) mailDigest[i] = (uint8_t)std::stoi(std::string(MAIL_DIGEST + 2 * i, 2), nullptr, 16);
+    ok = signer.init(sampleKey, "0x1111111111111111111111111111111111111111", 2, 137,
+                     OrderSigner::exchangeAddress(137, false)) &&
+         signer.address() == "0xCD2a3d9F938E13CD947Ec05AbC7FE734Df8DD826" &&
+         OrderSigner::domainSeparator("Ether Mail", "1", 1, "0xCcCCccccCCCCcCCCCCCcCcCccCcCCCcCcccccccC", domain) &&
+         toHex(domain, 32) == "f2cee375fa42b42143804025fc449deafd50cc031ca257e0b194a650a912090f" &&
+         signer.sign(mailDigest, signature) &&
+         toHex(signature, 65) == "4355c47d63924e8a72e509b65029052eb6c299d53a04e167c5775fd466751c9d"
+                                 "07299936d304c153f6443dfa05f40ff007d72911b6f72307f996231605b915621c";
+    if (!ok) {
+        std::cerr << "ERROR: OrderSigner EIP-712 example" << std::endl;
+        return false;
+    }
+
+    // Random digests: low s, and v recovers the signer's key (R from r and v's parity)
+    EC_GROUP* group = EC_GROUP_new_by_curve_name(NID_secp256k1);
+    EC_POINT* publicKey = EC_POINT_new(group);
+    EC_POINT* recovered = EC_POINT_new(group);
+    BN_CTX* ctx = BN_CTX_new();
+    BIGNUM* key = nullptr;
+    BIGNUM* z = BN_new();
+    BIGNUM* r = BN_new();
+    BIGNUM* s = BN_new();
+    BIGNUM* u1 = BN_new();
+    BIGNUM* u2 = BN_new();
+    const BIGNUM* n = EC_GROUP_get0_order(group);
+    BIGNUM* halfN = BN_new();
+    BN_rshift1(halfN, n);
+    ok = BN_hex2bn(&key, sampleKey.c_str() + 2) && EC_POINT_mul(group, publicKey, key, nullptr, nullptr, ctx);
+    for (int i = 0; i < 16 && ok; i++) {
+        uint8_t randomDigest[32];
+        RAND_bytes(randomDigest, 32);
+        ok = signer.sign(randomDigest, signature) && (signature[64] == 27 || signature[64] == 28) &&
+             BN_bin2bn(randomDigest, 32, z) && BN_bin2bn(signature, 32, r) && BN_bin2bn(signature + 32, 32, s) &&
+             BN_cmp(s, halfN) <= 0 &&
+             EC_POINT_set_compressed_coordinates(group, recovered, r, signature[64] - 27, ctx) &&
+             BN_mod_inverse(u2, r, n, ctx) && BN_mod_mul(u1, z, u2, n, ctx) && BN_sub(u1, n, u1) &&
+             BN_mod_mul(u2, s, u2, n, ctx) &&
+             EC_POINT_mul(group, recovered, u1, recovered, u2, ctx) &&
+             EC_POINT_cmp(group, recovered, publicKey, ctx) == 0;
+    }
+    BN_free(halfN);
+    BN_free(u2);
+    BN_free(u1);
+    BN_free(s);
+    BN_free(r);
+    BN_free(z);
+    BN_clear_free(key);
+    BN_CTX_free(ctx);
+    EC_POINT_free(recovered);
+    EC_POINT_free(publicKey);
+    EC_GROUP_free(group);
+    if (!ok) {
+        std::cerr << "ERROR: OrderSigner signature does not recover its key" << std::endl;
+        return false;
+    }
+
+    // Amounts as the JS client rounds them (BUY: maker = collateral, SELL: maker = shares)
+    OrderSigner::RoundConfig round;
+    std::string makerAmount;
+    std::string takerAmount;
+    ok = OrderSigner::amounts(OrderSigner::BUY, 0.44, 20, round, makerAmount, takerAmount) &&
+         makerAmount == "8800000" && takerAmount == "20000000" &&
+         OrderSigner::amounts(OrderSigner::BUY, 0.57, 13.37, round, makerAmount, takerAmount) &&
+         makerAmount == "7620900" && takerAmount == "13370000" &&
+         OrderSigner::amounts(OrderSigner::SELL, 0.333, 7.777, round, makerAmount, takerAmount) &&
+         makerAmount == "7770000" && takerAmount == "2564100" &&
+         OrderSigner::roundConfig("0.001", round) && round.price == 3 && round.amount == 5 &&
+         !OrderSigner::roundConfig("0.05", round) &&
+         OrderSigner::jsNumber(0.1 + 0.2) == "0.30000000000000004" && OrderSigner::jsNumber(8.8) == "8.8";
+    if (!ok) {
+        std::cerr << "ERROR: OrderSigner amounts" << std::endl;
+        return false;
+    }
+
+    std::cout << "CHECK:order_signer:signer=" << signer.address()
+              << ",keccak=" << (Keccak256::openssl() ? "openssl" : "builtin") << std::endl;
+    return true;
+}
+
+// Bodies captured from clob-client (npm run order-golden -- --write-fixture), relative to the repo root
+const char* ORDER_FIXTURE = "src/cpp/fixtures/clob-client-orders.txt";
+
+// Every fixture order signed natively must come out as the client's body, byte for byte
+bool checkOrderFixture() {
+    std::ifstream in(ORDER_FIXTURE);
+    if (!in) {
+        std::cerr << "ERROR: Cannot open " << ORDER_FIXTURE << " (run from the repository root)" << std::endl;
+        return false;
+    }
+    OrderSigner signer;
+    bool haveSigner = false;
+    std::string owner;
+    std::string line;
+    int orders = 0;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream fields(line);
+        std::string kind;
+        fields >> kind;
+        if (kind == "signer" && !haveSigner) {
+            std::string key;
+            std::string funder;
+            int signatureType = 0;
+            long long chainId = 0;
+            fields >> key >> funder >> signatureType >> chainId >> owner;
+            haveSigner = fields && signer.init(key, funder, signatureType, chainId, OrderSigner::exchangeAddress(chainId, false));
+            if (!haveSigner) break;
+            continue;
+        }
+
+        OrderParams params;
+        std::string side;
+        std::string tickSize;
+        OrderSigner::RoundConfig round;
+        std::string expected;
+        std::string body;
+        fields >> params.tokenId >> params.price >> params.size >> side >> params.expiration >> tickSize >> params.salt;
+        params.side = side == "SELL" ? OrderSigner::SELL : OrderSigner::BUY;
+        if (kind != "order" || !haveSigner || !fields || !OrderSigner::roundConfig(tickSize, round) ||
+            !std::getline(in, expected)) {
+            break;
+        }
+        if (!signer.buildBody(params, round, owner, body) || body != expected) {
+            std::cerr << "ERROR: OrderSigner body differs from clob-client (" << ORDER_FIXTURE << ", order " << orders
+                      << ")\n  client: " << expected << "\n  engine: " << body << std::endl;
+            return false;
+        }
+        orders++;
+    }
+    if (!in.eof() || orders == 0) {
+        std::cerr << "ERROR: Malformed " << ORDER_FIXTURE << " near: " << line << std::endl;
+        return false;
+    }
+    std::cout << "CHECK:order_fixture:orders=" << orders << ",signer=" << signer.address() << std::endl;
+    return true;
+}
+
+// Full ring drops instead of blocking, records arrive in order with their
+// contents across wrap-around, and a concurrent reader sees every record
+bool checkAttemptRing() {
+    std::string path = scratchPath("test-hotpath", ".ring");
+    AttemptRingWriter writer;
+    AttemptRingReader reader;
+    if (!writer.open(path, 64) || !reader.open(path)) {
+        std::cerr << "ERROR: AttemptRing open " << path << std::endl;
+        return false;
+    }
+    unlink(path.c_str());
+
+    OrderResponseParser parser;
+    const char* body = "{\"orderID\":\"0xf625d9e6e4a44ceb73e7c537087c527b20c1d1231ddd78f1cd29c61c0a9153ff\"}";
+    parser.append(body, strlen(body));
+    OrderResponse filled = parser.result();
+
+    for (int i = 0; i < 64; i++) {
+        AttemptRecord* record = writer.claim();
+        record->attempt = i + 1;
+        record->setResult(CURLE_OK, 200, ResponseKind::FILLED, filled);
+        writer.publish(record);
+    }
+    bool ok = writer.claim() == nullptr && writer.dropped() == 1;
+    int expected = 1;
+    ok = ok && reader.poll([&](const AttemptRecord& record) {
+        ok = ok && record.attempt == expected++ && (record.flags & AttemptRecord::SUCCESS) &&
+             std::string(record.text, record.textLength) == filled.orderId.str();
+    }) == 64;
+    if (!ok) {
+        std::cerr << "ERROR: AttemptRing full/ordering" << std::endl;
+        return false;
+    }
+
+    // Producer and consumer on separate threads, many wraps of a 64-slot ring
+    const int total = 200000;
+    std::atomic<bool> failed{false};
+    std::thread consumer([&]() {
+        int next = 65;
+        while (next <= 64 + total && !failed) {
+            reader.poll([&](const AttemptRecord& record) {
+                if (record.attempt != next || record.orderIndex != next % 10 ||
+                    record.sentNs != (int64_t)next * 3 || record.seq.load() != (uint64_t)next) {
+                    failed = true;
+                }
+                next++;
+            });
+        }
+    });
+    for (int i = 65; i <= 64 + total; i++) {
+        AttemptRecord* record;
+        while (!(record = writer.claim())) {}
+        record->attempt = i;
+        record->orderIndex = i % 10;
+        record->sentNs = (int64_t)i * 3;
+        writer.publish(record);
+    }
+    consumer.join();
+    if (failed) {
+        std::cerr << "ERROR: AttemptRing concurrent read" << std::endl;
+        return false;
+    }
+
+    std::cout << "CHECK:attempt_ring:records=" << writer.written() << std::endl;
+    return true;
+}
+
+// Two runs appended as segments read back with their order tables, an order's
+// repeated text stored once, a full segment dropping, and a torn tail skipped
+bool checkAttemptLog() {
+    std::string path = scratchPath("test-hotpath", ".log");
+    OrderResponseParser parser;
+    const char* notOpenBody = "{\"error\":\"the orderbook 0x5a3c does not exist\"}";
+    parser.append(notOpenBody, strlen(notOpenBody));
+    OrderResponse notOpenResponse = parser.result();
+    OrderResponseParser filledParser;
+    const char* filledBody = "{\"orderID\":\"0xf625d9e6e4a44ceb73e7c537087c527b20c1d1231ddd78f1cd29c61c0a9153ff\"}";
+    filledParser.append(filledBody, strlen(filledBody));
+    OrderResponse filled = filledParser.result();
+
+    AttemptLogWriter writer;
+    int64_t phasesUs[PhaseHistograms::PHASE_COUNT] = {1, 2, 3, 4, 5, 6, 7, 8};
+    auto sentAt = std::chrono::steady_clock::now();
+    bool ok = true;
+    for (int run = 0; run < 2; run++) {
+        AttemptLogRun pacing;
+        pacing.fireAtMs = 1764929700000 + run;
+        pacing.intervalMs = 1;
+        pacing.burstOffsetsMs = {-50, -20, 0, 5};
+        writer.begin(10, pacing);
+        writer.addOrder(0, "btc-updown-15m-1764929700", "UP", 0.45, 20);
+        writer.addOrder(1, "btc-updown-15m-1764929700", "DOWN", 0.45, 20);
+        for (int i = 0; i < 12; i++) {
+            AttemptLogRecord* record = writer.claim();
+            if (!record) continue;
+            writer.setTimes(record, sentAt + std::chrono::milliseconds(i), sentAt + std::chrono::milliseconds(i + 20));
+            record->order = (uint16_t)(i % 2);
+            record->attempt = i / 2 + 1;
+            record->setPhases(phasesUs);
+            bool last = i == 9;
+            writer.setResult(record, CURLE_OK, last ? 200 : 400, last ? ResponseKind::FILLED : ResponseKind::NOT_OPEN,
+                             last ? filled : notOpenResponse);
+        }
+        ok = ok && writer.records() == 10 && writer.dropped() == 2 && writer.commit(path);
+    }
+    // A segment cut short by a crash
+    uint32_t magic = AttemptLogHeader::MAGIC;
+    int fd = open(path.c_str(), O_WRONLY | O_APPEND);
+    ok = ok && fd >= 0 && write(fd, &magic, sizeof(magic)) == sizeof(magic);
+    if (fd >= 0) close(fd);
+
+    AttemptLogReader reader;
+    size_t records = 0;
+    ok = ok && reader.open(path);
+    unlink(path.c_str());
+    size_t segments = reader.forEach([&](const AttemptLogSegment& segment) {
+        const AttemptLogHeader& header = *segment.header;
+        ok = ok && header.recordCount == 10 && header.dropped == 2 && header.orderCount == 2 &&
+             header.burstCount == 4 && header.burstOffsetsMs[0] == -50 && header.segmentBytes % 64 == 0 &&
+             std::string(segment.orders[1].outcome, segment.orders[1].outcomeLength) == "DOWN" &&
+             std::string(segment.orders[0].market, segment.orders[0].marketLength) == "btc-updown-15m-1764929700" &&
+             header.textBytes == 2 * notOpenResponse.message.length + filled.orderId.length;
+        for (uint64_t i = 0; i < header.recordCount; i++) {
+            const AttemptLogRecord& record = segment.records[i];
+            bool last = i == 9;
+            ok = ok && record.order == i % 2 && record.attempt == (int)(i / 2 + 1) && record.durationUs == 20000 &&
+                 record.phaseUs[7] == 8 && ((record.flags & AttemptRecord::SUCCESS) != 0) == last &&
+                 segment.textOf(record) == (last ? filled.orderId.str() : notOpenResponse.message.str());
+            if (i > 0) ok = ok && record.sentNs - segment.records[i - 1].sentNs == 1000000;
+            records++;
+        }
+    });
+    if (!ok || segments != 2 || reader.unread() != 4) {
+        std::cerr << "ERROR: AttemptLog round trip" << std::endl;
+        return false;
+    }
+
+    std::cout << "CHECK:attempt_log:segments=" << segments << ",records=" << records << std::endl;
+    return true;
+}
+
+bool checkReplay() {
+    // The open instant lies between the last refused and the first taken arrival
+    ReplayScenario scenario = recordedScenario(4, 5, 500, 0);
+    const ReplayMarket& market = scenario.markets[0];
+    int64_t openAtUs = scenario.firstSendUs + 500000;
+    bool ok = scenario.orders.size() == 4 && market.closedUntilUs < openAtUs && market.openedByUs >= openAtUs &&
+              market.openUs > market.closedUntilUs && market.openUs <= market.openedByUs && scenario.limitRps == 0;
+
+    // Replayed as recorded: every order fills, the same way every time
+    ReplaySimulator simulator;
+    ReplayParams params;
+    ReplayResult first;
+    ReplayResult second;
+    simulator.run(scenario, params, first);
+    simulator.run(scenario, params, second);
+    ok = ok && first.filled == 4 && first.fillUs == second.fillUs && first.attempts == second.attempts &&
+         first.attempts >= scenario.attempts - 4 && first.attempts <= scenario.attempts + 4;
+
+    // Slower probing fills later; too few attempts never fill
+    ReplayResult slow;
+    params.probeIntervalMs = params.intervalMs = 50;
+    simulator.run(scenario, params, slow);
+    ReplayResult exhausted;
+    params.maxAttempts = 5;
+    simulator.run(scenario, params, exhausted);
+    ok = ok && slow.filled == 4 && slow.meanFillMs() > first.meanFillMs() && exhausted.filled == 0 &&
+         exhausted.attempts == 20 && first.betterThan(slow) && slow.betterThan(exhausted);
+
+    // The server's rate is fitted from the run's first 429
+    ReplayScenario limited = recordedScenario(40, 1, 3000, 100);
+    ok = ok && limited.rateLimited > 0 && limited.limitRps > 90 && limited.limitRps < 110;
+    if (!ok) {
+        std::cerr << "ERROR: ReplaySimulator scenario or replay" << std::endl;
+        return false;
+    }
+
+    std::cout << "CHECK:replay:recorded_attempts=" << scenario.attempts << ",replayed_attempts=" << first.attempts
+              << ",limit_rps=" << (long)limited.limitRps << std::endl;
+    return true;
+}
+
+// Feed a response to a fresh reader in two pieces split at `split`
+bool readSplit(const std::string& response, size_t split, OrderResponseParser& body, HttpResponseReader& reader) {
+    body.reset();
+    reader.reset(&body);
+    reader.feed(response.data(), split);
+    if (reader.done()) return false;
+    reader.feed(response.data() + split, response.size() - split);
+    return reader.done();
+}
+
+// HTTP/1.1 responses as the order path reads them, split at every byte
+// (Content-Length, chunked with an extension and trailer, 100 Continue,
+// body until close), and one ring round trip over a non-blocking socket:
+// a RECV armed before the data arrives waits for it
+bool checkUringTransport() {
+    const std::string json = "{\"orderID\":\"0xabc\",\"status\":\"matched\"}";
+    const std::string lengthForm = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: " +
+                                   std::to_string(json.size()) + "\r\n\r\n" + json;
+    char secondChunk[16];
+    snprintf(secondChunk, sizeof(secondChunk), "%zX", json.size() - 16);
+    const std::string chunkedForm = "HTTP/1.1 200 OK\r\ntransfer-encoding: Chunked\r\n\r\n10;x=1\r\n" + json.substr(0, 16) +
+                                    "\r\n" + secondChunk + "\r\n" + json.substr(16) + "\r\n0\r\nX-Trailer: 1\r\n\r\n";
+    OrderResponseParser body;
+    HttpResponseReader reader;
+    bool ok = true;
+    for (const std::string* response : {&lengthForm, &chunkedForm}) {
+        for (size_t split = 1; split < response->size() && ok; split++) {
+            ok = readSplit(*response, split, body, reader) && reader.status() == 200 && reader.keepAlive() &&
+                 std::string(body.data(), body.size()) == json && body.result().filled();
+        }
+    }
+
+    std::string continued = "HTTP/1.1 100 Continue\r\n\r\nHTTP/1.1 429 Too Many Requests\r\nConnection: close\r\n"
+                            "Content-Length: 2\r\n\r\n{}";
+    ok = ok && readSplit(continued, 20, body, reader) && reader.status() == 429 && !reader.keepAlive();
+    reader.reset(&body);
+    body.reset();
+    std::string untilClose = "HTTP/1.0 502 Bad Gateway\r\n\r\nupstream";
+    reader.feed(untilClose.data(), untilClose.size());
+    ok = ok && !reader.done() && reader.finishAtClose() && reader.status() == 502 && body.size() == 8;
+    reader.reset(&body);
+    reader.feed("<html>", 6);
+    reader.feed("\n", 1);
+    ok = ok && reader.failed();
+    if (!ok) {
+        std::cerr << "ERROR: HttpResponseReader" << std::endl;
+        return false;
+    }
+
+    UringRing ring;
+    if (!ring.init(8)) {
+        std::cout << "CHECK:uring_transport:reader_splits=" << lengthForm.size() + chunkedForm.size()
+                  << ",ring=unavailable(" << strerror(errno) << ")" << std::endl;
+        return true;
+    }
+    int pair[2];
+    socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, pair);
+    char in[64];
+    struct io_uring_sqe* recv = ring.sqe();
+    recv->opcode = IORING_OP_RECV;
+    recv->fd = pair[1];
+    recv->addr = (uint64_t)(uintptr_t)in;
+    recv->len = sizeof(in);
+    recv->user_data = 2;
+    ring.submit();
+    ok = ring.peek() == nullptr;
+    struct io_uring_sqe* send = ring.sqe();
+    send->opcode = IORING_OP_SEND;
+    send->fd = pair[0];
+    send->addr = (uint64_t)(uintptr_t)"ping";
+    send->len = 4;
+    send->user_data = 1;
+    ring.submit();
+    int sent = 0;
+    int received = 0;
+    for (int i = 0; i < 2 && ok && ring.wait(1000); i++) {
+        while (struct io_uring_cqe* cqe = ring.peek()) {
+            if (cqe->user_data == 1) sent = cqe->res;
+            if (cqe->user_data == 2) received = cqe->res;
+            ring.advance();
+        }
+        if (sent && received) break;
+    }
+    close(pair[0]);
+    close(pair[1]);
+    if (!ok || sent != 4 || received != 4 || memcmp(in, "ping", 4) != 0) {
+        std::cerr << "ERROR: UringRing round trip (send " << sent << ", recv " << received << ")" << std::endl;
+        return false;
+    }
+
+    // Entries the kernel did not take are withdrawn in order, leaving the ring empty
+    uint64_t withdrawn[3] = {};
+    unsigned taken = 0;
+    for (uint64_t userData = 3; userData <= 4; userData++) ring.sqe()->user_data = userData;
+    ok = ring.takeBack([&](uint64_t userData) { withdrawn[taken++ % 3] = userData; }) == 2 &&
+         taken == 2 && withdrawn[0] == 3 && withdrawn[1] == 4 && ring.queued() == 0 && ring.submit() == 0;
+    if (!ok) {
+        std::cerr << "ERROR: UringRing takeBack" << std::endl;
+        return false;
+    }
+
+    std::cout << "CHECK:uring_transport:reader_splits=" << lengthForm.size() + chunkedForm.size()
+              << ",ring=ok" << std::endl;
+    return true;
+}
+
+int main() {
+    bool ok = checkHmacSigner() && checkRequestTemplate() && checkLatencyHistogram() && checkResponseParser() &&
+              checkRateController() && checkAttemptRing() && checkAttemptLog() && checkReplay() &&
+              checkUringTransport() && checkMarketDiscovery() && checkEdgeRouter() && checkOrderSigner() &&
+              checkOrderFixture();
+    return ok ? 0 : 1;
+}
@@ -2,12 +2,22 @@
  * C++ Latency Test for Polymarket
  *
  * Reads config from stdin, generates HMAC signatures, spams POST requests.
- * Outputs latency stats to stdout.
+ * Outputs latency stats (STATS, per-phase LATENCY percentiles) to stdout.
  *
  * Build: g++ -O3 -o dist/test-latency-cpp src/cpp/test-latency.cpp -lcurl -lssl -lcrypto
  * Usage: echo '{"body":"...","apiKey":"...","secret":"...","passphrase":"...","address":"..."}' | ./test-latency-cpp
+ *        optional "clobUrl":"https://localhost:18443","caFile":"..." point it at a mock CLOB
+ *        optional "attemptRing":"/dev/shm/..." writes attempts to a shared-memory ring instead of ATTEMPT: lines
  */
 
+#include "hmac-signer.hpp"
+#include "request-template.hpp"
+#include "clock-sync.hpp"
+#include "latency-histogram.hpp"
+#include "order-response.hpp"
+#include "rate-controller.hpp"
+#include "attempt-ring.hpp"
+#include "connection-share.hpp"
 #include <curl/curl.h>
 #include <openssl/hmac.h>
 #include <openssl/bio.h>
@@ -21,10 +31,12 @@
 #include <thread>
 #include <algorithm>
 #include <cstring>
+#include <cerrno>
 
 // Configuration
 const int DEFAULT_MAX_ATTEMPTS = 1000;
 const int DEFAULT_INTERVAL_MS = 2;
+const int CLOCK_SYNC_SAMPLES = 5;  // extra /time probes after warmup
 const char* CLOB_URL = "https://clob.polymarket.com";
 const char* ORDER_PATH = "/orders";  // Use /orders for array body [{...}]
 
@@ -189,48 +201,34 @@ int extractJsonInt(const std::string& json, const std::string& key, int defaultV
     return std::atoi(json.c_str() + numStart);
 }
 
-// Check if response indicates success (has orderID)
-bool isSuccess(const std::string& response, std::string& orderId) {
-    size_t orderIdPos = response.find("\"orderID\"");
-    if (orderIdPos == std::string::npos) {
-        orderIdPos = response.find("\"orderId\"");
-    }
-    if (orderIdPos != std::string::npos) {
-        orderId = extractJsonString(response, "orderID");
-        if (orderId.empty()) {
-            orderId = extractJsonString(response, "orderId");
-        }
-        return !orderId.empty();
-    }
-    return false;
-}
+long long extractJsonInt64(const std::string& json, const std::string& key, long long defaultVal) {
+    std::string searchKey = "\"" + key + "\"";
+    size_t keyPos = json.find(searchKey);
+    if (keyPos == std::string::npos) return defaultVal;
 
-// Extract error message from response
-std::string extractError(const std::string& response) {
-    std::string error = extractJsonString(response, "error");
-    if (error.empty()) {
-        error = extractJsonString(response, "errorMsg");
-    }
-    if (error.empty()) {
-        error = extractJsonString(response, "message");
-    }
-    if (error.empty() && !response.empty()) {
-        error = response.substr(0, std::min(response.length(), (size_t)100));
-    }
-    return error;
+    size_t colonPos = json.find(':', keyPos);
+    if (colonPos == std::string::npos) return defaultVal;
+
+    size_t numStart = colonPos + 1;
+    while (numStart < json.length() && (json[numStart] == ' ' || json[numStart] == '\t')) numStart++;
+
+    return std::atoll(json.c_str() + numStart);
 }
 
-// Fetch server time from CLOB API
-std::string fetchServerTime(CURL* curl) {
-    std::string timeUrl = std::string(CLOB_URL) + "/time";
+// Fetch server time from CLOB API and record it as a clock sample
+std::string fetchServerTime(CURL* curl, const std::string& clobUrl, ClockSync& clock) {
+    std::string timeUrl = clobUrl + "/time";
     curl_easy_setopt(curl, CURLOPT_URL, timeUrl.c_str());
     curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
     curl_easy_setopt(curl, CURLOPT_HTTPHEADER, nullptr);
 
     ResponseBuffer buf;
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, &buf);
 
+    int64_t startRawNs = ClockSync::rawNowNs();
     CURLcode res = curl_easy_perform(curl);
+    int64_t doneRawNs = ClockSync::rawNowNs();
     if (res != CURLE_OK) {
         std::cerr << "Failed to fetch server time: " << curl_easy_strerror(res) << std::endl;
         return "";
@@ -241,55 +239,51 @@ std::string fetchServerTime(CURL* curl) {
     if (!time.empty() && time[0] == '"') {
         time = time.substr(1, time.length() - 2);
     }
+    if (time.length() != RequestTemplate::TIMESTAMP_LEN) return time;
+
+    // Request left after connect/TLS, the value was read before the first response byte
+    curl_off_t pretransferUs = 0;
+    curl_off_t startTransferUs = 0;
+    curl_off_t totalUs = 0;
+    curl_easy_getinfo(curl, CURLINFO_PRETRANSFER_TIME_T, &pretransferUs);
+    curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME_T, &startTransferUs);
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &totalUs);
+    int64_t sendRawNs = startRawNs + (int64_t)pretransferUs * 1000;
+    int64_t recvRawNs = doneRawNs - (int64_t)(totalUs - startTransferUs) * 1000;
+    if (recvRawNs < sendRawNs) {
+        sendRawNs = startRawNs;
+        recvRawNs = doneRawNs;
+    }
+    clock.addSample(sendRawNs, recvRawNs, std::atoll(time.c_str()));
     return time;
 }
 
-// Perform POST request with authentication
-CURLcode postOrder(CURL* curl, const std::string& body,
-                   const std::string& apiKey, const std::string& secret,
-                   const std::string& passphrase, const std::string& address,
-                   const std::string& timestamp, ResponseBuffer& response,
-                   bool debug = false) {
-
-    std::string orderUrl = std::string(CLOB_URL) + ORDER_PATH;
+// Perform POST request with authentication.
+// URL and headers come from the pre-serialized template; only the
+// timestamp/signature slots are patched per attempt. A timestamp the slot
+// cannot take fails the attempt instead of resending the previous headers.
+CURLcode postOrder(CURL* curl, RequestTemplate& tmpl, const HmacSigner& signer,
+                   const std::string& body, const char* timestamp, size_t timestampLen,
+                   OrderResponseParser& response, bool debug = false) {
 
     // Generate signature: timestamp + method + path + body
-    std::string message = timestamp + "POST" + ORDER_PATH + body;
-    std::string signature = generateSignature(secret, message, debug);
+    response.reset();
+    if (!tmpl.patch(signer, timestamp, timestampLen, body.data(), body.length())) {
+        return CURLE_BAD_FUNCTION_ARGUMENT;
+    }
+    RequestTemplate::setBody(curl, body);
 
     if (debug) {
         std::cerr << "DEBUG HEADERS:" << std::endl;
-        std::cerr << "  POLY_ADDRESS: " << address << std::endl;
-        std::cerr << "  POLY_TIMESTAMP: " << timestamp << std::endl;
-        std::cerr << "  POLY_API_KEY: " << apiKey << std::endl;
-        std::cerr << "  POLY_PASSPHRASE: " << passphrase << std::endl;
-        std::cerr << "  POLY_SIGNATURE: " << signature << std::endl;
+        for (struct curl_slist* h = tmpl.headers(); h; h = h->next) {
+            std::cerr << "  " << h->data << std::endl;
+        }
     }
 
-    // Set URL
-    curl_easy_setopt(curl, CURLOPT_URL, orderUrl.c_str());
-
-    // Set POST
-    curl_easy_setopt(curl, CURLOPT_POST, 1L);
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.c_str());
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, body.length());
-
-    // Build headers
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-    headers = curl_slist_append(headers, ("POLY_ADDRESS: " + address).c_str());
-    headers = curl_slist_append(headers, ("POLY_SIGNATURE: " + signature).c_str());
-    headers = curl_slist_append(headers, ("POLY_TIMESTAMP: " + timestamp).c_str());
-    headers = curl_slist_append(headers, ("POLY_API_KEY: " + apiKey).c_str());
-    headers = curl_slist_append(headers, ("POLY_PASSPHRASE: " + passphrase).c_str());
-
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, OrderResponseParser::writeCallback);
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
 
-    CURLcode res = curl_easy_perform(curl);
-
-    curl_slist_free_all(headers);
-    return res;
+    return curl_easy_perform(curl);
 }
 
 int main() {
@@ -311,6 +305,12 @@ int main() {
     std::string address = extractJsonString(inputJson, "address");
     int maxAttempts = extractJsonInt(inputJson, "maxAttempts", DEFAULT_MAX_ATTEMPTS);
     int intervalMs = extractJsonInt(inputJson, "intervalMs", DEFAULT_INTERVAL_MS);
+    int probeIntervalMs = extractJsonInt(inputJson, "probeIntervalMs", intervalMs);
+    long long expectedOpenMs = extractJsonInt64(inputJson, "expectedOpenMs", 0);
+    std::string clobUrl = extractJsonString(inputJson, "clobUrl");
+    if (clobUrl.empty()) clobUrl = CLOB_URL;
+    std::string caFile = extractJsonString(inputJson, "caFile");
+    std::string attemptRing = extractJsonString(inputJson, "attemptRing");
 
     // Extract test values for signature comparison
     std::string testTimestamp = extractJsonString(inputJson, "testTimestamp");
@@ -327,11 +327,14 @@ int main() {
     if (!testTimestamp.empty()) {
         std::string testMessage = testTimestamp + "POST" + ORDER_PATH + body;
         std::string cppSignature = generateSignature(secret, testMessage, false);
+        std::string signerSignature = HmacSigner(secret).sign(testTimestamp, "POST", ORDER_PATH, body);
         std::cerr << "SIGNATURE COMPARISON (same timestamp):" << std::endl;
         std::cerr << "  Timestamp: " << testTimestamp << std::endl;
         std::cerr << "  Node.js signature: " << testSignature << std::endl;
         std::cerr << "  C++ signature:     " << cppSignature << std::endl;
+        std::cerr << "  C++ HmacSigner:    " << signerSignature << std::endl;
         std::cerr << "  Match: " << (testSignature == cppSignature ? "YES" : "NO") << std::endl;
+        std::cerr << "  HmacSigner match: " << (testSignature == signerSignature ? "YES" : "NO") << std::endl;
     }
 
     if (body.empty() || apiKey.empty() || secret.empty() || passphrase.empty() || address.empty()) {
@@ -344,10 +347,21 @@ int main() {
         return 1;
     }
 
-    std::cerr << "CONFIG: maxAttempts=" << maxAttempts << ", intervalMs=" << intervalMs << std::endl;
+    std::cerr << "CONFIG: maxAttempts=" << maxAttempts << ", intervalMs=" << intervalMs
+              << ", probeIntervalMs=" << probeIntervalMs << ", clobUrl=" << clobUrl << std::endl;
     std::cerr << "  apiKey: " << apiKey.substr(0, 8) << "..." << std::endl;
     std::cerr << "  address: " << address.substr(0, 10) << "..." << std::endl;
 
+    // HMAC key schedule is computed once; each attempt only hashes the message
+    HmacSigner signer(secret);
+
+    // Per-attempt records for the wrapper, one slot per attempt
+    AttemptRingWriter ring;
+    if (!attemptRing.empty() && !ring.open(attemptRing, (uint64_t)maxAttempts)) {
+        std::cerr << "ERROR: Failed to create attempt ring " << attemptRing << ": " << strerror(errno) << std::endl;
+        return 1;
+    }
+
     // Initialize curl
     curl_global_init(CURL_GLOBAL_ALL);
     CURL* curl = curl_easy_init();
@@ -365,15 +379,36 @@ int main() {
     curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 2L);
     curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
+    if (!caFile.empty()) curl_easy_setopt(curl, CURLOPT_CAINFO, caFile.c_str());
+    // Pinned DNS + TLS session cache, so a dropped connection reconnects without a lookup or full handshake
+    ConnectionShare share;
+    if (share.init(clobUrl, true)) share.apply(curl);
+    ConnectionInfo conn;
+    conn.track(curl);
+    int64_t firstByteUs = 0;
+    PhaseHistograms::trackFirstByte(curl, &firstByteUs);
 
     // Fetch server time for TLS warmup
     std::cerr << "Fetching server time (TLS warmup)..." << std::endl;
     auto warmupStart = std::chrono::high_resolution_clock::now();
-    std::string serverTime = fetchServerTime(curl);
+    ClockSync clock;
+    std::string serverTime = fetchServerTime(curl, clobUrl, clock);
     auto warmupEnd = std::chrono::high_resolution_clock::now();
     auto warmupMs = std::chrono::duration_cast<std::chrono::milliseconds>(warmupEnd - warmupStart).count();
 
-    if (serverTime.empty()) {
+    // More samples over the warm connection; no /time calls in the spam loop.
+    // Their TTFB is the network RTT baseline for the order TTFB.
+    PhaseHistograms timePhases;
+    for (int i = 0; i < CLOCK_SYNC_SAMPLES; i++) {
+        firstByteUs = 0;
+        auto probeStart = std::chrono::steady_clock::now();
+        if (fetchServerTime(curl, clobUrl, clock).empty()) continue;
+        auto probeUs = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - probeStart).count();
+        timePhases.record(curl, probeUs, firstByteUs, PhaseHistograms::nowUs());
+    }
+
+    if (!clock.synced()) {
         std::cerr << "ERROR: Failed to get server time" << std::endl;
         curl_easy_cleanup(curl);
         curl_global_cleanup();
@@ -382,64 +417,123 @@ int main() {
 
     std::cout << "WARMUP:" << warmupMs << std::endl;
     std::cout.flush();
-    std::cerr << "Server time: " << serverTime << " (warmup: " << warmupMs << "ms)" << std::endl;
+    std::cerr << "Server time: " << serverTime << " (warmup: " << warmupMs << "ms, clock error: +/-"
+              << (long)clock.errorMs() << "ms)" << std::endl;
+
+    // Static parts of the order request are serialized once
+    RequestTemplate tmpl(clobUrl, ORDER_PATH, address, apiKey, passphrase);
+    tmpl.apply(curl);
+    OrderResponseParser responseBuf;
+
+    // Attempt pacing: one request in flight, rate from the interval, adapted to responses
+    RateController rate(RateController::ratePerInterval(1, probeIntervalMs),
+                        RateController::ratePerInterval(1, intervalMs), 1);
+    if (expectedOpenMs > 0) rate.setExpectedOpen(clock.localTimeFor(expectedOpenMs));
+    RateController::Decision phase = rate.update(std::chrono::steady_clock::now());
+    rate.print(std::cout, phase == RateController::NONE ? RateController::PROBE : phase, std::chrono::steady_clock::now());
+    std::cout << std::endl;
 
     // Spam loop
     std::vector<long> latencies;
+    PhaseHistograms orderPhases;
     bool success = false;
     int attempts = 0;
     std::string orderId;
+    char timestamp[RequestTemplate::TIMESTAMP_LEN];
+    size_t timestampLen = 0;
 
     std::cerr << "Starting spam loop..." << std::endl;
 
     while (!success && attempts < maxAttempts) {
         attempts++;
 
-        // Fetch fresh server time every 100 requests to avoid timestamp drift
-        if (attempts % 100 == 1) {
-            std::string newTime = fetchServerTime(curl);
-            if (!newTime.empty()) {
-                serverTime = newTime;
-            }
-        }
+        // POLY_TIMESTAMP from the local estimate of the server clock (no allocation)
+        timestampLen = RequestTemplate::formatTimestamp(clock.nowServerMs() / 1000, timestamp)
+                           ? RequestTemplate::TIMESTAMP_LEN : 0;
 
-        ResponseBuffer responseBuf;
         bool debugFirst = (attempts == 1);  // Debug first request
+        firstByteUs = 0;
+        conn.reset();
+        auto sentAt = std::chrono::steady_clock::now();
         auto start = std::chrono::high_resolution_clock::now();
-        CURLcode res = postOrder(curl, body, apiKey, secret, passphrase, address, serverTime, responseBuf, debugFirst);
+        CURLcode res = postOrder(curl, tmpl, signer, body, timestamp, timestampLen, responseBuf, debugFirst);
         auto end = std::chrono::high_resolution_clock::now();
 
         auto latencyMs = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
         latencies.push_back(latencyMs);
+        long httpStatus = 0;
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpStatus);
+
+        OrderResponse response = responseBuf.result();
+        ResponseKind kind = classifyResponse(res, httpStatus, response);
+        int64_t phasesUs[PhaseHistograms::PHASE_COUNT] = {};
+        if (res == CURLE_OK) {
+            PhaseHistograms::breakdown(curl, std::chrono::duration_cast<std::chrono::microseconds>(end - start).count(),
+                                       firstByteUs, PhaseHistograms::nowUs(), phasesUs);
+            orderPhases.record(phasesUs);
+        }
+        if (AttemptRecord* record = ring.isOpen() ? ring.claim() : nullptr) {
+            record->sentNs = AttemptRingFile::steadyNs(sentAt);
+            record->doneNs = AttemptRingFile::steadyNs(std::chrono::steady_clock::now());
+            record->orderIndex = 0;
+            record->attempt = attempts;
+            record->setPhases(phasesUs);
+            record->setResult(res, httpStatus, kind, response);
+            if (conn.reused) record->flags |= AttemptRecord::REUSED;
+            if (conn.resumed) record->flags |= AttemptRecord::RESUMED;
+            ring.publish(record);
+        }
 
         if (res == CURLE_OK) {
-            if (isSuccess(responseBuf.data, orderId)) {
+            if (response.filled()) {
                 success = true;
-                std::cout << "ATTEMPT:" << attempts << ":" << latencyMs << ":true:" << orderId << std::endl;
-                std::cout.flush();
+                orderId = response.orderId.str();
+                if (!ring.isOpen()) {
+                    std::cout << "ATTEMPT:" << attempts << ":" << latencyMs << ":true:" << orderId << std::endl;
+                    std::cout.flush();
+                }
                 std::cerr << "#" << attempts << ": " << latencyMs << "ms - SUCCESS! Order: " << orderId << std::endl;
             } else {
-                std::string error = extractError(responseBuf.data);
-                std::cout << "ATTEMPT:" << attempts << ":" << latencyMs << ":false:" << error << std::endl;
-                std::cout.flush();
+                if (!ring.isOpen()) {
+                    std::cout << "ATTEMPT:" << attempts << ":" << latencyMs << ":false:";
+                    std::cout.write(response.message.data, response.message.length) << std::endl;
+                    std::cout.flush();
+                }
 
                 if (attempts % 50 == 0 || attempts <= 3) {
-                    std::cerr << "#" << attempts << ": " << latencyMs << "ms - " << error << std::endl;
+                    std::cerr << "#" << attempts << ": " << latencyMs << "ms - ";
+                    std::cerr.write(response.message.data, response.message.length) << std::endl;
                 }
             }
         } else {
             std::string curlError = curl_easy_strerror(res);
-            std::cout << "ATTEMPT:" << attempts << ":" << latencyMs << ":false:curl_" << curlError << std::endl;
-            std::cout.flush();
+            if (!ring.isOpen()) {
+                std::cout << "ATTEMPT:" << attempts << ":" << latencyMs << ":false:curl_" << curlError << std::endl;
+                std::cout.flush();
+            }
 
             if (attempts % 50 == 0) {
                 std::cerr << "#" << attempts << ": " << latencyMs << "ms - curl error: " << curlError << std::endl;
             }
         }
 
-        // Interval between requests
-        if (!success && intervalMs > 0) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+        auto now = std::chrono::steady_clock::now();
+        RateController::Decision decision = rate.onResponse(kind, httpStatus, sentAt, now);
+        if (decision != RateController::NONE) {
+            rate.print(std::cout, decision, now, 0, attempts, kind);
+            std::cout << std::endl;
+        }
+
+        // Wait for the controller's next token instead of a fixed interval
+        while (!success) {
+            now = std::chrono::steady_clock::now();
+            decision = rate.update(now);
+            if (decision != RateController::NONE) {
+                rate.print(std::cout, decision, now);
+                std::cout << std::endl;
+            }
+            if (rate.tryAcquire(0)) break;
+            std::this_thread::sleep_until(rate.nextTokenAt(now));
         }
     }
 
@@ -472,6 +566,14 @@ int main() {
                   << "ms, median=" << median << "ms, total=" << latencies.size() << std::endl;
     }
 
+    orderPhases.print(std::cout, "orders");
+    timePhases.print(std::cout, "time");
+    if (ring.isOpen()) {
+        std::cout << "RING:records=" << ring.written() << ",dropped=" << ring.dropped()
+                  << ",capacity=" << ring.capacity() << std::endl;
+    }
+    std::cout.flush();
+
     // Cleanup
     curl_easy_cleanup(curl);
     curl_global_cleanup();
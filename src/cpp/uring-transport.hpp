@@ -0,0 +1,1169 @@
+/**
+ * UringTransport - order requests over persistent TLS connections driven by io_uring
+ *
+ * The curl path pays per attempt for curl_multi_add_handle (option and
+ * connection bookkeeping), curl_multi_perform walking every transfer, and
+ * one send/recv/poll syscall per socket event. Here every pooled request
+ * owns one persistent HTTP/1.1 connection, opened (and TLS-handshaked)
+ * concurrently at startup:
+ *   send()    serializes the request (request line, Host, the template's
+ *             header list, Content-Length, body) into the connection's
+ *             reused buffer, encrypts it and queues one IORING_OP_SEND
+ *   submit()  hands every queued send to the kernel in one io_uring_enter,
+ *             however many requests a launch pass released
+ *   reap()    walks the completion queue (shared memory, no syscall): a
+ *             RECV stays armed on every connection, its bytes are decrypted
+ *             and fed to HttpResponseReader, whose body goes to the
+ *             request's OrderResponseParser
+ * The ring's eventfd wakes the engine's curl_multi_poll next to curl's own
+ * sockets (the /time probes stay on curl).
+ *
+ * TLS runs in OpenSSL over memory BIOs after a regular socket handshake,
+ * so the ring moves ciphertext. With kernel TLS (SSL_OP_ENABLE_KTLS, a tls
+ * ULP and a cipher the kernel supports) the kernel encrypts: a connection
+ * whose send side went kTLS queues plaintext, one whose receive side went
+ * kTLS waits for POLLIN on the ring and reads through SSL_read (control
+ * records such as session tickets need OpenSSL).
+ *
+ * A connection that closes is reopened in the background: a non-blocking
+ * connect, then the TLS handshake stepped by poll completions on the same
+ * ring, so the engine thread never waits for it. A send() on a connection
+ * still down completes at once with CURLE_COULDNT_CONNECT. revalidate() is
+ * the heartbeat: it reopens closed idle connections (blocking, outside the
+ * window) and sends GET <path> on the others.
+ *
+ * io_uring is used through its raw syscalls (no liburing); init() fails
+ * where the kernel does not provide it, and the engine stays on curl.
+ */
+
+#pragma once
+
+#include "order-response.hpp"
+#include "latency-histogram.hpp"
+#include <curl/curl.h>
+#include <linux/io_uring.h>
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <strings.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * HttpResponseReader - incremental HTTP/1.1 response parser
+ *
+ * Takes the response in whatever pieces it arrives. Status line and
+ * headers are scanned line by line (Content-Length, Transfer-Encoding:
+ * chunked, Connection); body bytes go straight to the sink, de-chunked.
+ * Interim 1xx responses are skipped; a body without length ends with the
+ * connection (finishAtClose()).
+ */
+class HttpResponseReader {
+public:
+    static const size_t LINE_CAPACITY = 256;   // longer header lines are only scanned up to here
+
+    void reset(OrderResponseParser* sink) {
+        sink_ = sink;
+        state_ = STATUS;
+        status_ = 0;
+        received_ = 0;
+        lineLen_ = 0;
+        resetHeaders();
+    }
+
+    // Consume bytes of the response; returns how many were used (the rest follows the response)
+    size_t feed(const char* data, size_t length) {
+        size_t pos = 0;
+        received_ += length;
+        while (pos < length && state_ != DONE && state_ != BAD) {
+            if (state_ == BODY || state_ == CHUNK_DATA || state_ == UNTIL_CLOSE) {
+                size_t take = length - pos;
+                if (state_ != UNTIL_CLOSE) take = (size_t)std::min<uint64_t>(take, remaining_);
+                if (sink_) sink_->append(data + pos, take);
+                pos += take;
+                if (state_ == UNTIL_CLOSE) continue;
+                remaining_ -= take;
+                if (remaining_ == 0) state_ = state_ == BODY ? DONE : CHUNK_END;
+                continue;
+            }
+
+            char c = data[pos++];
+            if (c != '\n') {
+                if (lineLen_ < LINE_CAPACITY) line_[lineLen_] = c;
+                lineLen_++;
+                continue;
+            }
+            size_t lineLen = std::min(lineLen_, LINE_CAPACITY);
+            if (lineLen > 0 && line_[lineLen - 1] == '\r') lineLen--;
+            lineLen_ = 0;
+            onLine(lineLen);
+        }
+        return pos;
+    }
+
+    // The connection closed: a body delimited by the close is complete
+    bool finishAtClose() {
+        if (state_ == UNTIL_CLOSE) state_ = DONE;
+        return state_ == DONE;
+    }
+
+    bool done() const { return state_ == DONE; }
+    bool failed() const { return state_ == BAD; }
+    bool started() const { return received_ > 0; }
+    long status() const { return status_; }
+    bool keepAlive() const { return keepAlive_; }
+
+private:
+    enum State { STATUS, HEADERS, BODY, CHUNK_SIZE, CHUNK_DATA, CHUNK_END, TRAILERS, UNTIL_CLOSE, DONE, BAD };
+
+    OrderResponseParser* sink_ = nullptr;
+    State state_ = STATUS;
+    long status_ = 0;
+    uint64_t received_ = 0;
+    char line_[LINE_CAPACITY];
+    size_t lineLen_ = 0;
+    int64_t contentLength_ = -1;
+    bool chunked_ = false;
+    bool keepAlive_ = true;
+    uint64_t remaining_ = 0;
+
+    void resetHeaders() {
+        contentLength_ = -1;
+        chunked_ = false;
+        keepAlive_ = true;
+        remaining_ = 0;
+    }
+
+    bool headerIs(size_t lineLen, const char* name, const char*& value, size_t& valueLen) const {
+        size_t nameLen = std::strlen(name);
+        if (lineLen <= nameLen || line_[nameLen] != ':' || strncasecmp(line_, name, nameLen) != 0) return false;
+        value = line_ + nameLen + 1;
+        valueLen = lineLen - nameLen - 1;
+        while (valueLen > 0 && (*value == ' ' || *value == '\t')) {
+            value++;
+            valueLen--;
+        }
+        return true;
+    }
+
+    static bool containsToken(const char* value, size_t valueLen, const char* token) {
+        size_t tokenLen = std::strlen(token);
+        for (size_t i = 0; i + tokenLen <= valueLen; i++) {
+            if (strncasecmp(value + i, token, tokenLen) == 0) return true;
+        }
+        return false;
+    }
+
+    void onLine(size_t lineLen) {
+        switch (state_) {
+        case STATUS: {
+            // "HTTP/1.1 200 OK"
+            if (lineLen == 0) return;  // stray CRLF between responses
+            if (lineLen < 12 || std::strncmp(line_, "HTTP/1.", 7) != 0) {
+                state_ = BAD;
+                return;
+            }
+            status_ = 0;
+            for (size_t i = 9; i < 12; i++) {
+                if (line_[i] < '0' || line_[i] > '9') {
+                    state_ = BAD;
+                    return;
+                }
+                status_ = status_ * 10 + (line_[i] - '0');
+            }
+            resetHeaders();
+            keepAlive_ = line_[7] != '0';  // HTTP/1.0 closes unless told otherwise
+            state_ = HEADERS;
+            return;
+        }
+        case HEADERS: {
+            if (lineLen > 0) {
+                const char* value;
+                size_t valueLen;
+                if (headerIs(lineLen, "content-length", value, valueLen)) {
+                    contentLength_ = 0;
+                    for (size_t i = 0; i < valueLen && value[i] >= '0' && value[i] <= '9'; i++) {
+                        contentLength_ = contentLength_ * 10 + (value[i] - '0');
+                    }
+                } else if (headerIs(lineLen, "transfer-encoding", value, valueLen)) {
+                    chunked_ = containsToken(value, valueLen, "chunked");
+                } else if (headerIs(lineLen, "connection", value, valueLen)) {
+                    if (containsToken(value, valueLen, "close")) keepAlive_ = false;
+                    else if (containsToken(value, valueLen, "keep-alive")) keepAlive_ = true;
+                }
+                return;
+            }
+            // End of headers
+            if (status_ < 200) {
+                state_ = STATUS;               // 100 Continue and friends: the real response follows
+            } else if (status_ == 204 || status_ == 304) {
+                state_ = DONE;
+            } else if (chunked_) {
+                state_ = CHUNK_SIZE;
+            } else if (contentLength_ >= 0) {
+                remaining_ = (uint64_t)contentLength_;
+                state_ = remaining_ > 0 ? BODY : DONE;
+            } else {
+                keepAlive_ = false;
+                state_ = UNTIL_CLOSE;
+            }
+            return;
+        }
+        case CHUNK_SIZE: {
+            uint64_t size = 0;
+            size_t digits = 0;
+            for (; digits < lineLen; digits++) {
+                char c = line_[digits];
+                int v = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10
+                      : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+                if (v < 0) break;
+                size = size * 16 + (uint64_t)v;
+            }
+            if (digits == 0) {
+                state_ = BAD;
+                return;
+            }
+            remaining_ = size;
+            state_ = size > 0 ? CHUNK_DATA : TRAILERS;
+            return;
+        }
+        case CHUNK_END:
+            state_ = lineLen == 0 ? CHUNK_SIZE : BAD;
+            return;
+        case TRAILERS:
+            if (lineLen == 0) state_ = DONE;
+            return;
+        default:
+            return;
+        }
+    }
+};
+
+/**
+ * UringRing - minimal io_uring: setup, SQE/CQE rings in shared memory, eventfd
+ *
+ * Submission entries are filled in place and published with one release
+ * store of the tail; submit() is the only syscall. Completions are read
+ * from the shared CQ ring. The registered eventfd becomes readable when
+ * completions are posted, so the ring can be waited on with poll().
+ */
+class UringRing {
+public:
+    UringRing() = default;
+    UringRing(const UringRing&) = delete;
+    UringRing& operator=(const UringRing&) = delete;
+
+    ~UringRing() { close(); }
+
+    // Ring with at least `entries` submission entries; false (errno set) without io_uring
+    bool init(unsigned entries) {
+        struct io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd_ = (int)syscall(__NR_io_uring_setup, entries, &params);
+        if (fd_ < 0) return false;
+
+        sqEntries_ = params.sq_entries;
+        sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        singleMmap_ = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMmap_) sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+
+        sqRing_ = mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+        if (sqRing_ == MAP_FAILED) return fail();
+        cqRing_ = singleMmap_ ? sqRing_
+                              : mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+        if (cqRing_ == MAP_FAILED) return fail();
+        sqesSize_ = params.sq_entries * sizeof(struct io_uring_sqe);
+        void* sqes = mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) return fail();
+        sqes_ = static_cast<struct io_uring_sqe*>(sqes);
+
+        char* sq = static_cast<char*>(sqRing_);
+        sqHead_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        unsigned* array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        for (unsigned i = 0; i < sqEntries_; i++) array[i] = i;  // entry i always sits in slot i
+        char* cq = static_cast<char*>(cqRing_);
+        cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+        sqeTail_ = *sqTail_;
+
+        eventFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (eventFd_ < 0) return fail();
+        if (syscall(__NR_io_uring_register, fd_, IORING_REGISTER_EVENTFD, &eventFd_, 1) < 0) return fail();
+        return true;
+    }
+
+    bool isOpen() const { return fd_ >= 0; }
+    int eventFd() const { return eventFd_; }
+    unsigned entries() const { return sqEntries_; }
+
+    // Next free submission entry (zeroed), nullptr while all are queued
+    struct io_uring_sqe* sqe() {
+        unsigned head = __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+        if (sqeTail_ - head >= sqEntries_) return nullptr;
+        struct io_uring_sqe* entry = &sqes_[sqeTail_ & sqMask_];
+        sqeTail_++;
+        std::memset(entry, 0, sizeof(*entry));
+        return entry;
+    }
+
+    // Entries filled since the last submit()
+    unsigned queued() const { return sqeTail_ - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE); }
+
+    // Hand every queued entry to the kernel: one io_uring_enter; returns how many it
+    // took (entries it did not take stay queued) or -errno
+    int submit() {
+        __atomic_store_n(sqTail_, sqeTail_, __ATOMIC_RELEASE);
+        unsigned count = queued();
+        if (count == 0) return 0;
+        enters_++;
+        long taken;
+        do {
+            taken = syscall(__NR_io_uring_enter, fd_, count, 0, 0, nullptr, 0);
+        } while (taken < 0 && errno == EINTR);
+        return taken < 0 ? -errno : (int)taken;
+    }
+
+    // onEntry(user_data) for each entry the kernel has not taken yet
+    template <typename Fn>
+    void forEachQueued(Fn onEntry) const {
+        unsigned head = __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+        for (unsigned i = head; i != sqeTail_; i++) onEntry(sqes_[i & sqMask_].user_data);
+    }
+
+    // Withdraw the entries the kernel has not taken; onEntry(user_data) runs for each
+    template <typename Fn>
+    unsigned takeBack(Fn onEntry) {
+        unsigned head = __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+        unsigned count = sqeTail_ - head;
+        for (unsigned i = head; i != sqeTail_; i++) onEntry(sqes_[i & sqMask_].user_data);
+        sqeTail_ = head;
+        __atomic_store_n(sqTail_, sqeTail_, __ATOMIC_RELEASE);
+        return count;
+    }
+
+    // Next completion, nullptr if there is none; release it with advance()
+    struct io_uring_cqe* peek() const {
+        unsigned head = *cqHead_;
+        if (head == __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE)) return nullptr;
+        return &cqes_[head & cqMask_];
+    }
+
+    void advance() { __atomic_store_n(cqHead_, *cqHead_ + 1, __ATOMIC_RELEASE); }
+
+    // Reset the eventfd after poll() reported it (completions are read with peek())
+    void drainEvents() {
+        uint64_t count;
+        while (read(eventFd_, &count, sizeof(count)) > 0) {}
+    }
+
+    // Block until a completion is posted or timeoutMs passed
+    bool wait(int timeoutMs) {
+        if (peek()) return true;
+        struct pollfd pfd = {eventFd_, POLLIN, 0};
+        int ready = poll(&pfd, 1, timeoutMs);
+        if (ready > 0) drainEvents();
+        return peek() != nullptr;
+    }
+
+    long enters() const { return enters_; }
+
+    void close() {
+        if (eventFd_ >= 0) ::close(eventFd_);
+        if (sqes_) munmap(sqes_, sqesSize_);
+        if (cqRing_ && cqRing_ != MAP_FAILED && cqRing_ != sqRing_) munmap(cqRing_, cqRingSize_);
+        if (sqRing_ && sqRing_ != MAP_FAILED) munmap(sqRing_, sqRingSize_);
+        if (fd_ >= 0) ::close(fd_);
+        eventFd_ = fd_ = -1;
+        sqes_ = nullptr;
+        sqRing_ = cqRing_ = nullptr;
+    }
+
+private:
+    int fd_ = -1;
+    int eventFd_ = -1;
+    bool singleMmap_ = false;
+    void* sqRing_ = nullptr;
+    void* cqRing_ = nullptr;
+    size_t sqRingSize_ = 0;
+    size_t cqRingSize_ = 0;
+    size_t sqesSize_ = 0;
+    struct io_uring_sqe* sqes_ = nullptr;
+    unsigned* sqHead_ = nullptr;
+    unsigned* sqTail_ = nullptr;
+    unsigned sqMask_ = 0;
+    unsigned sqEntries_ = 0;
+    unsigned sqeTail_ = 0;             // local tail, published by submit()
+    unsigned* cqHead_ = nullptr;
+    unsigned* cqTail_ = nullptr;
+    unsigned cqMask_ = 0;
+    struct io_uring_cqe* cqes_ = nullptr;
+    long enters_ = 0;
+
+    bool fail() {
+        int error = errno;
+        close();
+        errno = error;
+        return false;
+    }
+};
+
+class UringTransport {
+public:
+    static const int HANDSHAKE_TIMEOUT_MS = 10000;
+    static const int64_t REQUEST_TIMEOUT_US = 30000000;  // as CURLOPT_TIMEOUT on the curl path
+    static const int64_t SUBMIT_RETRY_US = 50000;         // queued sends the kernel keeps refusing then fail
+    static const size_t RECV_SIZE = 16384;
+
+    // One finished request, with the curl path's result codes
+    struct Completion {
+        int index = 0;                 // connection (= pooled request) it ran on
+        CURLcode result = CURLE_OK;
+        long httpStatus = 0;
+        int64_t submittedUs = 0;       // PhaseHistograms::nowUs() of the submit() that sent it
+        int64_t firstByteUs = 0;       // first response bytes reaped (0 = none)
+        int64_t doneUs = 0;
+        bool reused = true;            // false: first request on a reopened connection
+        bool resumed = false;          // reopened with a resumed TLS session
+    };
+
+    UringTransport() = default;
+    UringTransport(const UringTransport&) = delete;
+    UringTransport& operator=(const UringTransport&) = delete;
+
+    ~UringTransport() {
+        if (!ring_.isOpen()) return;
+        // The kernel may still write into a connection's buffers: shut every
+        // socket down and wait for the outstanding operations before freeing them
+        for (auto& conn : conns_) {
+            if (conn.link) closeLink(conn);
+            if (conn.opening) abandonOpen(conn);
+        }
+        for (int i = 0; i < 100 && !retired_.empty(); i++) {
+            ring_.wait(10);
+            reap([](const Completion&) {});
+        }
+        ring_.close();
+        for (Link* link : retired_) delete link;
+        if (session_) SSL_SESSION_free(session_);
+        if (ctx_) SSL_CTX_free(ctx_);
+    }
+
+    // Open `connections` connections to host:port (address: where to connect, e.g. the
+    // pinned IP; empty = resolve host). False with a reason if io_uring, TLS or every connection failed.
+    bool init(const std::string& host, long port, const std::string& address, const std::string& caFile,
+              size_t connections, std::string& error) {
+        // Per connection at most a send, a receive (or handshake poll) and a poll
+        // cancel wait in the submission queue, so nextSqe() always finds an entry
+        if (!ring_.init((unsigned)std::max<size_t>(8, connections * 3 + 8))) {
+            error = std::string("io_uring_setup: ") + strerror(errno);
+            return false;
+        }
+        if (!resolve(address.empty() ? host : address, port, error) || !initTls(host, caFile, error)) {
+            ring_.close();
+            return false;
+        }
+        hostHeader_ = port == 443 ? host : host + ":" + std::to_string(port);
+
+        conns_ = std::vector<Connection>(connections);
+        done_.reserve(connections * 2);
+        queued_.reserve(connections);
+        std::vector<int> all;
+        for (size_t i = 0; i < connections; i++) all.push_back((int)i);
+        if (open(all) == 0) {
+            error = "no connection could be opened";
+            conns_.clear();
+            ring_.close();
+            return false;
+        }
+        return true;
+    }
+
+    bool active() const { return ring_.isOpen(); }
+    size_t size() const { return conns_.size(); }
+    int eventFd() const { return ring_.eventFd(); }
+    void drainEvents() { ring_.drainEvents(); }
+    long enters() const { return ring_.enters(); }
+
+    // Open connections whose send (receive) side runs in kernel TLS
+    int ktlsSend() const { return countLinks(&Link::ktlsSend); }
+    int ktlsRecv() const { return countLinks(&Link::ktlsRecv); }
+
+    bool busy(int index) const { return conns_[index].busy; }
+    bool connected(int index) const { return conns_[index].link != nullptr; }
+    // Sends the kernel has not taken yet (submit() retries them)
+    bool pending() const { return ring_.queued() > 0; }
+    bool revalidating() const { return internal_ > 0; }
+
+    // Block until a completion is posted or timeoutMs passed
+    bool wait(int timeoutMs) { return ring_.wait(timeoutMs); }
+
+    // PhaseHistograms phases of an answered request dispatched at dispatchedUs:
+    // QUEUE until its submit(), TTFB to the first reaped bytes, TRANSFER to the
+    // complete response (connections reopen off the request, so no CONNECT/TLS)
+    static void breakdown(const Completion& done, int64_t dispatchedUs, int64_t phasesUs[PhaseHistograms::PHASE_COUNT]) {
+        int64_t firstByteUs = done.firstByteUs > 0 ? done.firstByteUs : done.doneUs;
+        phasesUs[PhaseHistograms::QUEUE] = std::max<int64_t>(0, done.submittedUs - dispatchedUs);
+        phasesUs[PhaseHistograms::DNS] = 0;
+        phasesUs[PhaseHistograms::CONNECT] = 0;
+        phasesUs[PhaseHistograms::TLS] = 0;
+        phasesUs[PhaseHistograms::PRETRANSFER] = 0;
+        phasesUs[PhaseHistograms::TTFB] = firstByteUs - done.submittedUs;
+        phasesUs[PhaseHistograms::TRANSFER] = done.doneUs - firstByteUs;
+        phasesUs[PhaseHistograms::TOTAL] = done.doneUs - done.submittedUs;
+    }
+
+    // Queue a request on connection `index` (idle; HTTP/1.1, one request at a time).
+    // It goes out with the next submit(). On a connection that is down it completes
+    // at once with CURLE_COULDNT_CONNECT, and the connection is reopened in the background.
+    void send(int index, const char* method, const char* path, const struct curl_slist* headers,
+              const char* body, size_t bodyLength, OrderResponseParser* sink) {
+        Connection& conn = conns_[index];
+        if (conn.busy) fail(conn, CURLE_OPERATION_TIMEDOUT);  // a keepalive that never came back
+        conn.sink = sink;
+        conn.reader.reset(sink);
+        conn.firstByteUs = 0;
+        conn.submittedUs = 0;
+        conn.busy = true;
+        busyCount_++;
+
+        if (!conn.link) {
+            reconnect(conn);
+            conn.submittedUs = PhaseHistograms::nowUs();
+            complete(conn, CURLE_COULDNT_CONNECT);
+            return;
+        }
+        conn.reused = !conn.reopened;
+        conn.reopened = false;
+
+        std::string& request = conn.request;
+        request.clear();
+        request.append(method).append(" ").append(path).append(" HTTP/1.1\r\nHost: ").append(hostHeader_).append("\r\n");
+        for (const struct curl_slist* node = headers; node; node = node->next) request.append(node->data).append("\r\n");
+        if (body) {
+            char length[32];
+            int n = snprintf(length, sizeof(length), "Content-Length: %zu\r\n", bodyLength);
+            request.append(length, (size_t)n);
+        }
+        request.append("\r\n");
+        if (body) request.append(body, bodyLength);
+
+        Link& link = *conn.link;
+        if (link.ktlsSend) {
+            queueOut(link, request.data(), request.size());
+        } else {
+            SSL_write(link.ssl, request.data(), (int)request.size());
+            flushTls(link);
+        }
+        queued_.push_back(index);
+    }
+
+    // Hand everything queued since the last call to the kernel (one syscall). What the
+    // kernel does not take (-EAGAIN/-EBUSY, a short submit) stays queued for the next
+    // call, see pending(); after SUBMIT_RETRY_US of that, or on any other error, the
+    // entries are withdrawn and their requests and connections fail. Requests the
+    // kernel took are stamped submitted either way.
+    void submit() {
+        if (ring_.queued() == 0) return;
+        int taken = ring_.submit();
+        int64_t nowUs = PhaseHistograms::nowUs();
+        if (ring_.queued() > 0) {
+            bool transient = taken >= 0 || taken == -EAGAIN || taken == -EBUSY;
+            if (submitStalledUs_ == 0) submitStalledUs_ = nowUs;
+            if (transient && nowUs - submitStalledUs_ < SUBMIT_RETRY_US) {
+                stampSubmitted(nowUs);
+                return;
+            }
+            dropUnsubmitted();
+        }
+        submitStalledUs_ = 0;
+        stampSubmitted(nowUs);
+    }
+
+    // Process every posted completion; onDone(const Completion&) runs once per finished request
+    template <typename Fn>
+    void reap(Fn onDone) {
+        while (struct io_uring_cqe* cqe = ring_.peek()) {
+            Link* link = reinterpret_cast<Link*>(cqe->user_data & ~(uint64_t)OP_MASK);
+            int op = (int)(cqe->user_data & OP_MASK);
+            int res = cqe->res;
+            ring_.advance();
+
+            link->ops--;
+            if (link->closed) {
+                if (link->ops == 0) retire(link);
+                continue;
+            }
+            Connection& conn = conns_[link->index];
+            if (op == OP_SEND) onSent(conn, res);
+            else if (op == OP_RECV) onReceived(conn, res);
+            else if (op == OP_POLL) onReadable(conn, res);
+            else if (op == OP_HANDSHAKE) onHandshake(conn, res);
+        }
+        if (busyCount_ > 0 || opening_ > 0) checkTimeouts();
+        submit();                      // re-armed receives, rest of partial sends
+
+        for (size_t i = 0; i < done_.size(); i++) {
+            Completion done = done_[i];
+            onDone(done);
+        }
+        done_.clear();
+    }
+
+    // Heartbeat: reopen closed idle connections (returns how many) and send
+    // GET path on the others; their answers are consumed by reap() (see revalidating())
+    long revalidate(const char* path) {
+        long opened = reopenClosed();
+        for (size_t i = 0; i < conns_.size(); i++) {
+            Connection& conn = conns_[i];
+            if (conn.busy || !conn.link) continue;
+            send((int)i, "GET", path, nullptr, nullptr, 0, nullptr);
+            conn.internal = true;
+            internal_++;
+        }
+        submit();
+        return opened;
+    }
+
+    // Reopen closed idle connections (not the ones reopening in the background),
+    // e.g. the ones revalidate() found dead; blocks for up to HANDSHAKE_TIMEOUT_MS
+    long reopenClosed() {
+        std::vector<int> closed;
+        for (size_t i = 0; i < conns_.size(); i++) {
+            if (!conns_[i].busy && !conns_[i].link && !conns_[i].opening) closed.push_back((int)i);
+        }
+        return closed.empty() ? 0 : open(closed);
+    }
+
+private:
+    // OP_HANDSHAKE: poll during a background connect/handshake; OP_CANCEL: its removal
+    enum Op { OP_SEND = 1, OP_RECV = 2, OP_POLL = 3, OP_HANDSHAKE = 4, OP_CANCEL = 5, OP_MASK = 7 };
+
+    // One TCP + TLS connection. Outlives its close until the kernel has
+    // completed every operation on its buffers (ops == 0).
+    struct Link {
+        int index = 0;
+        int fd = -1;
+        SSL* ssl = nullptr;
+        bool ktlsSend = false;
+        bool ktlsRecv = false;
+        bool resumed = false;
+        bool closed = false;
+        bool sending = false;
+        bool connecting = false;       // TCP connect not confirmed yet
+        short events = POLLOUT;        // what the handshake waits for
+        int ops = 0;                   // submitted, not yet completed
+        std::string out;               // bytes of the SEND in flight (ciphertext, plaintext with kTLS)
+        size_t outSent = 0;
+        std::string next;              // queued behind it
+        char in[RECV_SIZE];
+    };
+    static_assert(alignof(Link) > (size_t)OP_MASK, "the op is kept in the link pointer's low bits");
+
+    struct Connection {
+        Link* link = nullptr;          // nullptr = closed
+        Link* opening = nullptr;       // reopening in the background (reconnect())
+        std::string request;           // serialized request, capacity kept across sends
+        HttpResponseReader reader;
+        OrderResponseParser* sink = nullptr;
+        bool busy = false;
+        bool internal = false;         // revalidate() keepalive, not reported
+        bool reused = true;
+        bool reopened = false;         // no request on it since reconnect() opened it
+        int64_t submittedUs = 0;
+        int64_t firstByteUs = 0;
+        int64_t openStartUs = 0;       // reconnect() began
+    };
+
+    UringRing ring_;
+    SSL_CTX* ctx_ = nullptr;
+    SSL_SESSION* session_ = nullptr;   // latest session ticket, offered by every new connection
+    std::string host_;
+    std::string hostHeader_;
+    struct sockaddr_storage address_;
+    socklen_t addressLen_ = 0;
+    std::vector<Connection> conns_;
+    std::vector<Completion> done_;
+    std::vector<int> queued_;          // connections with a request since the last submit()
+    std::vector<Link*> retired_;       // closed, operations still in the kernel
+    int busyCount_ = 0;
+    int internal_ = 0;
+    int opening_ = 0;                  // background reopens in progress
+    int64_t nextTimeoutCheckUs_ = 0;
+    int64_t submitStalledUs_ = 0;      // first submit() the kernel did not fully take, 0 = none
+    char plain_[RECV_SIZE];            // decrypted response bytes
+
+    bool resolve(const std::string& address, long port, std::string& error) {
+        std::string node = address;
+        if (node.size() > 2 && node.front() == '[' && node.back() == ']') node = node.substr(1, node.size() - 2);
+        struct addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_socktype = SOCK_STREAM;
+        struct addrinfo* result = nullptr;
+        int rc = getaddrinfo(node.c_str(), std::to_string(port).c_str(), &hints, &result);
+        if (rc != 0 || !result) {
+            error = std::string("resolve ") + node + ": " + gai_strerror(rc);
+            return false;
+        }
+        std::memcpy(&address_, result->ai_addr, result->ai_addrlen);
+        addressLen_ = result->ai_addrlen;
+        freeaddrinfo(result);
+        return true;
+    }
+
+    bool initTls(const std::string& host, const std::string& caFile, std::string& error) {
+        host_ = host;
+        ctx_ = SSL_CTX_new(TLS_client_method());
+        if (!ctx_) {
+            error = "SSL_CTX_new failed";
+            return false;
+        }
+        SSL_CTX_set_min_proto_version(ctx_, TLS1_2_VERSION);
+        SSL_CTX_set_verify(ctx_, SSL_VERIFY_PEER, nullptr);
+        SSL_CTX_set_default_verify_paths(ctx_);
+        if (!caFile.empty() && SSL_CTX_load_verify_locations(ctx_, caFile.c_str(), nullptr) != 1) {
+            error = "cannot load " + caFile;
+            return false;
+        }
+        static const unsigned char alpn[] = {8, 'h', 't', 't', 'p', '/', '1', '.', '1'};
+        SSL_CTX_set_alpn_protos(ctx_, alpn, sizeof(alpn));
+#ifdef SSL_OP_ENABLE_KTLS
+        SSL_CTX_set_options(ctx_, SSL_OP_ENABLE_KTLS);
+#endif
+        // Session tickets (TLS 1.3 sends them after the handshake) for resumption
+        SSL_CTX_set_app_data(ctx_, this);
+        SSL_CTX_set_session_cache_mode(ctx_, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        SSL_CTX_sess_set_new_cb(ctx_, newSession);
+        return true;
+    }
+
+    static int newSession(SSL* ssl, SSL_SESSION* session) {
+        UringTransport* self = static_cast<UringTransport*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+        if (self->session_) SSL_SESSION_free(self->session_);
+        self->session_ = session;
+        return 1;                      // keeps the reference
+    }
+
+    int countLinks(bool Link::*flag) const {
+        int count = 0;
+        for (const auto& conn : conns_) count += conn.link && conn.link->*flag ? 1 : 0;
+        return count;
+    }
+
+    // Connect and handshake the given (closed) connections concurrently; returns how many came up
+    long open(const std::vector<int>& indexes) {
+        std::vector<Link*> pending;
+        int64_t startUs = PhaseHistograms::nowUs();
+        for (int index : indexes) {
+            Link* link = startLink(index);
+            if (link) pending.push_back(link);
+        }
+
+        long opened = 0;
+        int64_t deadlineUs = startUs + (int64_t)HANDSHAKE_TIMEOUT_MS * 1000;
+        std::vector<struct pollfd> fds;
+        while (!pending.empty()) {
+            fds.clear();
+            for (const Link* link : pending) fds.push_back({link->fd, link->events, 0});
+            int64_t leftMs = (deadlineUs - PhaseHistograms::nowUs()) / 1000;
+            if (leftMs <= 0 || poll(fds.data(), fds.size(), (int)std::min<int64_t>(leftMs, 100)) < 0) break;
+
+            for (size_t i = pending.size(); i-- > 0;) {
+                if (fds[i].revents == 0) continue;
+                Link* link = pending[i];
+                int state = stepHandshake(*link);
+                if (state == 0) continue;
+                if (state > 0) {
+                    finishLink(conns_[link->index], link);
+                    opened++;
+                } else {
+                    destroyLink(link);
+                }
+                pending.erase(pending.begin() + (long)i);
+            }
+        }
+        for (Link* link : pending) destroyLink(link);
+        return opened;
+    }
+
+    // One step of connect + TLS handshake once the socket is ready for link.events:
+    // 1 done, 0 waiting again (for link.events), -1 failed
+    int stepHandshake(Link& link) {
+        if (link.connecting) {
+            int soError = 0;
+            socklen_t len = sizeof(soError);
+            getsockopt(link.fd, SOL_SOCKET, SO_ERROR, &soError, &len);
+            if (soError != 0) return -1;
+            link.connecting = false;
+        }
+        ERR_clear_error();
+        int rc = SSL_do_handshake(link.ssl);
+        int err = rc == 1 ? SSL_ERROR_NONE : SSL_get_error(link.ssl, rc);
+        if (err == SSL_ERROR_NONE) return 1;
+        if (err == SSL_ERROR_WANT_READ) link.events = POLLIN;
+        else if (err == SSL_ERROR_WANT_WRITE) link.events = POLLOUT;
+        else return -1;
+        return 0;
+    }
+
+    // Start reopening a closed connection without waiting for it; the handshake is
+    // stepped by OP_HANDSHAKE polls in reap(). A failed attempt is not retried here:
+    // the next send() on the connection, or the heartbeat, tries again.
+    void reconnect(Connection& conn) {
+        if (conn.link || conn.opening) return;
+        Link* link = startLink((int)(&conn - conns_.data()));
+        if (!link) return;
+        conn.opening = link;
+        conn.openStartUs = PhaseHistograms::nowUs();
+        opening_++;
+        armHandshake(*link);
+    }
+
+    void onHandshake(Connection& conn, int res) {
+        Link& link = *conn.opening;
+        int state = res == -EINTR ? 0 : res < 0 ? -1 : stepHandshake(link);
+        if (state == 0) {
+            armHandshake(link);
+        } else if (state > 0) {
+            conn.opening = nullptr;
+            opening_--;
+            conn.reopened = true;
+            finishLink(conn, &link);
+        } else {
+            abandonOpen(conn);
+        }
+    }
+
+    // Give up a background reopen; a poll still in the kernel is cancelled and
+    // the link freed once both have completed
+    void abandonOpen(Connection& conn) {
+        Link* link = conn.opening;
+        conn.opening = nullptr;
+        opening_--;
+        link->closed = true;
+        if (link->ops > 0) {
+            struct io_uring_sqe* sqe = nextSqe();
+            sqe->opcode = IORING_OP_POLL_REMOVE;
+            sqe->addr = (uint64_t)(uintptr_t)link | OP_HANDSHAKE;
+            sqe->user_data = (uint64_t)(uintptr_t)link | OP_CANCEL;
+            link->ops++;
+        }
+        SSL_free(link->ssl);
+        ::close(link->fd);
+        link->ssl = nullptr;
+        link->fd = -1;
+        if (link->ops == 0) delete link;
+        else retired_.push_back(link);
+    }
+
+    // Non-blocking connect and a client SSL on the socket, offering the latest session
+    Link* startLink(int index) {
+        int fd = socket(address_.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) return nullptr;
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &one, sizeof(one));
+        if (connect(fd, reinterpret_cast<const struct sockaddr*>(&address_), addressLen_) < 0 && errno != EINPROGRESS) {
+            ::close(fd);
+            return nullptr;
+        }
+
+        Link* link = new Link();
+        link->index = index;
+        link->fd = fd;
+        link->connecting = true;
+        link->ssl = SSL_new(ctx_);
+        SSL_set_fd(link->ssl, fd);
+        SSL_set_connect_state(link->ssl);
+        SSL_set_tlsext_host_name(link->ssl, host_.c_str());
+        SSL_set1_host(link->ssl, host_.c_str());
+        if (session_) SSL_set_session(link->ssl, session_);
+        return link;
+    }
+
+    // Handshake done: move the TLS records (of the sides not in kernel TLS) to
+    // memory BIOs and keep a receive armed
+    void finishLink(Connection& conn, Link* link) {
+        link->resumed = SSL_session_reused(link->ssl) == 1;
+#ifdef SSL_OP_ENABLE_KTLS
+        link->ktlsSend = BIO_get_ktls_send(SSL_get_wbio(link->ssl)) > 0;
+        link->ktlsRecv = BIO_get_ktls_recv(SSL_get_rbio(link->ssl)) > 0;
+#endif
+        // SSL_set_fd gave the SSL one reference per side; each set0 drops one
+        if (!link->ktlsRecv) SSL_set0_rbio(link->ssl, BIO_new(BIO_s_mem()));
+        if (!link->ktlsSend) SSL_set0_wbio(link->ssl, BIO_new(BIO_s_mem()));
+        conn.link = link;
+        armReceive(*link);
+    }
+
+    void destroyLink(Link* link) {
+        if (link->ssl) SSL_free(link->ssl);
+        if (link->fd >= 0) ::close(link->fd);
+        delete link;
+    }
+
+    // Close a connection; its link is freed once the kernel is done with it
+    void closeLink(Connection& conn) {
+        Link* link = conn.link;
+        conn.link = nullptr;
+        link->closed = true;
+        shutdown(link->fd, SHUT_RDWR);     // completes the armed receive
+        ::close(link->fd);
+        SSL_free(link->ssl);
+        link->ssl = nullptr;
+        link->fd = -1;
+        if (link->ops == 0) delete link;
+        else retired_.push_back(link);
+    }
+
+    void retire(Link* link) {
+        auto it = std::find(retired_.begin(), retired_.end(), link);
+        if (it != retired_.end()) retired_.erase(it);
+        delete link;
+    }
+
+    // Never nullptr: the ring is sized for every entry the connections can have queued (init())
+    struct io_uring_sqe* nextSqe() { return ring_.sqe(); }
+
+    void armHandshake(Link& link) {
+        struct io_uring_sqe* sqe = nextSqe();
+        sqe->opcode = IORING_OP_POLL_ADD;
+        sqe->fd = link.fd;
+        sqe->poll32_events = (uint32_t)link.events;
+        sqe->user_data = (uint64_t)(uintptr_t)&link | OP_HANDSHAKE;
+        link.ops++;
+    }
+
+    // Entries the kernel would not take: withdraw them and fail what they were for
+    // Stamp the queued requests whose send the kernel took; the others stay in queued_
+    void stampSubmitted(int64_t nowUs) {
+        size_t kept = 0;
+        for (int index : queued_) {
+            Connection& conn = conns_[index];
+            bool untaken = false;
+            if (conn.link) {
+                uint64_t send = (uint64_t)(uintptr_t)conn.link | OP_SEND;
+                ring_.forEachQueued([&untaken, send](uint64_t userData) { untaken = untaken || userData == send; });
+            }
+            if (untaken) queued_[kept++] = index;
+            else if (conn.busy) conn.submittedUs = nowUs;
+        }
+        queued_.resize(kept);
+    }
+
+    void dropUnsubmitted() {
+        std::vector<uint64_t> entries;
+        ring_.takeBack([&entries](uint64_t userData) { entries.push_back(userData); });
+        for (uint64_t userData : entries) {
+            Link* link = reinterpret_cast<Link*>(userData & ~(uint64_t)OP_MASK);
+            int op = (int)(userData & OP_MASK);
+            link->ops--;
+            if (link->closed) {
+                if (link->ops == 0) retire(link);
+                continue;
+            }
+            Connection& conn = conns_[link->index];
+            if (op == OP_HANDSHAKE) abandonOpen(conn);
+            else fail(conn, op == OP_SEND ? CURLE_SEND_ERROR : CURLE_RECV_ERROR);
+        }
+    }
+
+    void armSend(Link& link) {
+        struct io_uring_sqe* sqe = nextSqe();
+        sqe->opcode = IORING_OP_SEND;
+        sqe->fd = link.fd;
+        sqe->addr = (uint64_t)(uintptr_t)(link.out.data() + link.outSent);
+        sqe->len = (unsigned)(link.out.size() - link.outSent);
+        sqe->msg_flags = MSG_NOSIGNAL;
+        sqe->user_data = (uint64_t)(uintptr_t)&link | OP_SEND;
+        link.sending = true;
+        link.ops++;
+    }
+
+    // Keep one receive armed: into the link's buffer, or with kernel TLS a POLLIN
+    // after which OpenSSL reads the records
+    void armReceive(Link& link) {
+        struct io_uring_sqe* sqe = nextSqe();
+        sqe->fd = link.fd;
+        if (link.ktlsRecv) {
+            sqe->opcode = IORING_OP_POLL_ADD;
+            sqe->poll32_events = POLLIN;
+            sqe->user_data = (uint64_t)(uintptr_t)&link | OP_POLL;
+        } else {
+            sqe->opcode = IORING_OP_RECV;
+            sqe->addr = (uint64_t)(uintptr_t)link.in;
+            sqe->len = (unsigned)sizeof(link.in);
+            sqe->user_data = (uint64_t)(uintptr_t)&link | OP_RECV;
+        }
+        link.ops++;
+    }
+
+    // Bytes to send: now, or behind the send in flight
+    void queueOut(Link& link, const char* data, size_t length) {
+        if (link.sending) {
+            link.next.append(data, length);
+            return;
+        }
+        link.out.assign(data, length);
+        link.outSent = 0;
+        armSend(link);
+    }
+
+    // Records OpenSSL wrote into the memory BIO go out on the ring
+    void flushTls(Link& link) {
+        if (link.ktlsSend) return;
+        BIO* wbio = SSL_get_wbio(link.ssl);
+        size_t pending = BIO_ctrl_pending(wbio);
+        if (pending == 0) return;
+        std::string& target = link.sending ? link.next : link.out;
+        size_t start = target.size();
+        if (!link.sending) {
+            target.clear();
+            start = 0;
+            link.outSent = 0;
+        }
+        target.resize(start + pending);
+        BIO_read(wbio, &target[start], (int)pending);
+        if (!link.sending) armSend(link);
+    }
+
+    void complete(Connection& conn, CURLcode result) {
+        conn.busy = false;
+        busyCount_--;
+        if (conn.internal) {
+            conn.internal = false;
+            internal_--;
+            return;
+        }
+        Completion done;
+        done.index = (int)(&conn - conns_.data());
+        done.result = result;
+        done.httpStatus = result == CURLE_OK ? conn.reader.status() : 0;
+        done.submittedUs = conn.submittedUs;
+        done.firstByteUs = conn.firstByteUs;
+        done.doneUs = PhaseHistograms::nowUs();
+        done.reused = conn.reused;
+        done.resumed = !conn.reused && conn.link && conn.link->resumed;
+        done_.push_back(done);
+    }
+
+    // The connection failed or was closed by the server: reopen it in the background
+    void fail(Connection& conn, CURLcode result) {
+        if (conn.busy) {
+            if (result == CURLE_RECV_ERROR && conn.reader.finishAtClose()) result = CURLE_OK;
+            else if (result == CURLE_RECV_ERROR && !conn.reader.started()) result = CURLE_GOT_NOTHING;
+            complete(conn, result);
+        }
+        if (conn.link) {
+            closeLink(conn);
+            reconnect(conn);
+        }
+    }
+
+    void onSent(Connection& conn, int res) {
+        Link& link = *conn.link;
+        link.sending = false;
+        if (res == -EAGAIN || res == -EINTR) res = 0;
+        if (res < 0) {
+            fail(conn, CURLE_SEND_ERROR);
+            return;
+        }
+        link.outSent += (size_t)res;
+        if (link.outSent < link.out.size()) {
+            armSend(link);
+        } else if (!link.next.empty()) {
+            link.out.swap(link.next);
+            link.next.clear();
+            link.outSent = 0;
+            armSend(link);
+        }
+    }
+
+    void onReceived(Connection& conn, int res) {
+        if (res == -EAGAIN || res == -EINTR) {
+            armReceive(*conn.link);
+            return;
+        }
+        if (res <= 0) {
+            fail(conn, CURLE_RECV_ERROR);
+            return;
+        }
+        if (conn.busy && conn.firstByteUs == 0) conn.firstByteUs = PhaseHistograms::nowUs();
+        Link& link = *conn.link;
+        BIO_write(SSL_get_rbio(link.ssl), link.in, res);
+        if (readTls(conn)) armReceive(*conn.link);
+    }
+
+    void onReadable(Connection& conn, int res) {
+        if (res < 0 && res != -EINTR) {
+            fail(conn, CURLE_RECV_ERROR);
+            return;
+        }
+        if (conn.busy && conn.firstByteUs == 0) conn.firstByteUs = PhaseHistograms::nowUs();
+        if (readTls(conn)) armReceive(*conn.link);
+    }
+
+    // Decrypt what arrived and feed it to the response; false if the connection closed
+    bool readTls(Connection& conn) {
+        Link& link = *conn.link;
+        for (;;) {
+            ERR_clear_error();
+            int n = SSL_read(link.ssl, plain_, (int)sizeof(plain_));
+            if (n <= 0) {
+                int err = SSL_get_error(link.ssl, n);
+                if (err == SSL_ERROR_WANT_READ) break;
+                fail(conn, CURLE_RECV_ERROR);   // close_notify or a TLS error
+                return false;
+            }
+            if (!conn.busy) continue;  // nothing asked for it (e.g. a 408 before the server closes)
+            conn.reader.feed(plain_, (size_t)n);
+            if (conn.reader.failed()) {
+                fail(conn, CURLE_WEIRD_SERVER_REPLY);
+                return false;
+            }
+            if (conn.reader.done()) {
+                bool keepAlive = conn.reader.keepAlive();
+                complete(conn, CURLE_OK);
+                if (!keepAlive) {
+                    closeLink(conn);
+                    reconnect(conn);
+                    return false;
+                }
+            }
+        }
+        flushTls(link);                // e.g. a KeyUpdate answer
+        return true;
+    }
+
+    void checkTimeouts() {
+        int64_t nowUs = PhaseHistograms::nowUs();
+        if (nowUs < nextTimeoutCheckUs_) return;
+        nextTimeoutCheckUs_ = nowUs + 100000;
+        for (auto& conn : conns_) {
+            if (conn.busy && conn.submittedUs > 0 && nowUs - conn.submittedUs > REQUEST_TIMEOUT_US) {
+                fail(conn, CURLE_OPERATION_TIMEDOUT);
+            }
+            if (conn.opening && nowUs - conn.openStartUs > (int64_t)HANDSHAKE_TIMEOUT_MS * 1000) abandonOpen(conn);
+        }
+    }
+};
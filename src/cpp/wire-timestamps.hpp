@@ -0,0 +1,285 @@
+/**
+ * WireTimestamps - kernel send/receive timestamps of order requests (SO_TIMESTAMPING)
+ *
+ * An attempt's userspace latency (dispatch -> completion on steady_clock)
+ * also covers our own loop: curl writing the request, TLS, the wakeup after
+ * the answer arrived, decrypting and parsing it. With "wireTimestamps" every
+ * connection the engine opens gets SO_TIMESTAMPING (CURLOPT_SOCKOPTFUNCTION),
+ * and each answered attempt is split at the kernel's timestamps:
+ *   send   dispatch -> last request byte handed to the driver (TX software)
+ *   ack    last request byte out -> the server's TCP acknowledged it (TX ACK);
+ *          a network round trip without server time
+ *   wire   last request byte out -> first response segment received (RX);
+ *          network plus server, what no change on our side can cut
+ *   recv   first response segment received -> curl completed the transfer
+ *   self   send + recv, the self-inflicted part of user
+ * "hardware" also asks for NIC timestamps (the NIC must already have
+ * timestamping enabled, e.g. hwstamp_ctl -i eth0 -t 1 -r 1); wire then comes
+ * from the NIC clock when both ends of it have one.
+ *
+ * TX reports are read from each socket's error queue. RX timestamps are only
+ * delivered with recvmsg, and curl reads with recv, so collect() peeks one
+ * byte of any unread data (MSG_PEEK, control data only) right before each
+ * curl_multi_perform. An answer that lands between that peek and curl's read
+ * is not timestamped; WIRE_STATS reports how many were. Requires HTTP/1.1:
+ * one request per connection at a time, so a socket's stamps belong to the
+ * request that last sent on it.
+ *
+ * The error queue also makes a socket poll as POLLERR (curl would take an
+ * idle pooled connection for dead), so every tracked socket is drained on
+ * every collect(), whether or not an order request is running on it.
+ *
+ * Software timestamps are CLOCK_REALTIME; Request records realNowNs() next to
+ * its steady_clock send time.
+ */
+
+#pragma once
+
+#include "latency-histogram.hpp"
+#include <curl/curl.h>
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class WireTimestamps {
+public:
+    enum Mode { OFF, SOFTWARE, HARDWARE };
+
+    // Kernel stamps of the latest request on one socket (CLOCK_REALTIME ns; NIC clock for *HwNs)
+    struct Stamps {
+        int64_t txNs = 0;
+        int64_t ackNs = 0;
+        int64_t rxNs = 0;
+        int64_t txHwNs = 0;
+        int64_t rxHwNs = 0;
+    };
+
+    // One answered attempt, µs; ackUs is -1 without an ACK report
+    struct Breakdown {
+        int64_t userUs;
+        int64_t sendUs;
+        int64_t ackUs;
+        int64_t wireUs;
+        int64_t recvUs;
+        bool hardware;
+
+        int64_t selfUs() const { return sendUs + recvUs; }
+    };
+
+    // "off" (or empty), "software", "hardware"
+    static bool parseMode(const std::string& text, Mode& out) {
+        if (text.empty() || text == "off") out = OFF;
+        else if (text == "software") out = SOFTWARE;
+        else if (text == "hardware") out = HARDWARE;
+        else return false;
+        return true;
+    }
+
+    static const char* modeName(Mode mode) {
+        return mode == HARDWARE ? "hardware" : mode == SOFTWARE ? "software" : "off";
+    }
+
+    static int64_t realNowNs() {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+    }
+
+    void init(Mode mode) { mode_ = mode; }
+    bool enabled() const { return mode_ != OFF; }
+    Mode mode() const { return mode_; }
+
+    // Timestamp every connection this handle opens
+    void track(CURL* curl) {
+        if (!enabled()) return;
+        curl_easy_setopt(curl, CURLOPT_SOCKOPTFUNCTION, sockoptCallback);
+        curl_easy_setopt(curl, CURLOPT_SOCKOPTDATA, this);
+        curl_easy_setopt(curl, CURLOPT_CLOSESOCKETFUNCTION, closeCallback);
+        curl_easy_setopt(curl, CURLOPT_CLOSESOCKETDATA, this);
+    }
+
+    // Drain TX reports and note the RX stamp of unread data on every tracked
+    // socket; call right before curl_multi_perform
+    void collect() {
+        for (auto& socket : sockets_) {
+            drainErrors(socket);
+            if (socket.stamps.rxNs == 0) peekReceived(socket);
+        }
+    }
+
+    // Split the attempt that left at sentRealNs over fd and completed doneAfterNs later
+    bool breakdown(curl_socket_t fd, int64_t sentRealNs, int64_t doneAfterNs, Breakdown& out) const {
+        const Socket* socket = find(fd);
+        if (!socket) return false;
+        const Stamps& s = socket->stamps;
+        // Stamps left over from an earlier request, or an answer curl read before the peek
+        if (s.txNs < sentRealNs || s.rxNs < s.txNs) return false;
+
+        int64_t doneRealNs = sentRealNs + doneAfterNs;
+        out.userUs = doneAfterNs / 1000;
+        out.sendUs = (s.txNs - sentRealNs) / 1000;
+        out.ackUs = s.ackNs >= s.txNs ? (s.ackNs - s.txNs) / 1000 : -1;
+        out.hardware = mode_ == HARDWARE && s.txHwNs > 0 && s.rxHwNs >= s.txHwNs;
+        out.wireUs = (out.hardware ? s.rxHwNs - s.txHwNs : s.rxNs - s.txNs) / 1000;
+        out.recvUs = std::max<int64_t>(doneRealNs - s.rxNs, 0) / 1000;
+        return true;
+    }
+
+private:
+    struct Socket {
+        curl_socket_t fd;
+        Stamps stamps;
+    };
+
+    Mode mode_ = OFF;
+    std::vector<Socket> sockets_;      // open connections, a handful
+
+    const Socket* find(curl_socket_t fd) const {
+        for (const auto& socket : sockets_) {
+            if (socket.fd == fd) return &socket;
+        }
+        return nullptr;
+    }
+
+    static int sockoptCallback(void* clientp, curl_socket_t fd, curlsocktype purpose) {
+        WireTimestamps* self = static_cast<WireTimestamps*>(clientp);
+        if (purpose != CURLSOCKTYPE_IPCXN) return CURL_SOCKOPT_OK;
+
+        int flags = SOF_TIMESTAMPING_TX_SOFTWARE | SOF_TIMESTAMPING_TX_ACK | SOF_TIMESTAMPING_RX_SOFTWARE |
+                    SOF_TIMESTAMPING_SOFTWARE | SOF_TIMESTAMPING_OPT_TSONLY;
+        if (self->mode_ == HARDWARE) {
+            flags |= SOF_TIMESTAMPING_TX_HARDWARE | SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+        }
+        // Not fatal: the connection just goes untimestamped
+        if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == 0) {
+            self->sockets_.push_back({fd, Stamps()});
+        }
+        return CURL_SOCKOPT_OK;
+    }
+
+    static int closeCallback(void* clientp, curl_socket_t fd) {
+        WireTimestamps* self = static_cast<WireTimestamps*>(clientp);
+        auto& sockets = self->sockets_;
+        for (size_t i = 0; i < sockets.size(); i++) {
+            if (sockets[i].fd != fd) continue;
+            sockets[i] = sockets.back();
+            sockets.pop_back();
+            break;
+        }
+        return close(fd);
+    }
+
+    static int64_t nanos(const struct timespec& ts) { return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec; }
+
+    // scm_timestamping of a received message, if it carries one
+    static const struct scm_timestamping* timestamps(struct msghdr& msg) {
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPING) {
+                return reinterpret_cast<const struct scm_timestamping*>(CMSG_DATA(cmsg));
+            }
+        }
+        return nullptr;
+    }
+
+    // TX reports: ts[0] software, ts[2] hardware, ee_info says which point of the send
+    static void drainErrors(Socket& socket) {
+        char control[256];
+        for (;;) {
+            struct msghdr msg = {};
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+            if (recvmsg(socket.fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) return;
+
+            const struct scm_timestamping* ts = timestamps(msg);
+            const struct sock_extended_err* err = nullptr;
+            for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+                if ((cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) ||
+                    (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR)) {
+                    err = reinterpret_cast<const struct sock_extended_err*>(CMSG_DATA(cmsg));
+                }
+            }
+            if (!ts || !err || err->ee_origin != SO_EE_ORIGIN_TIMESTAMPING) continue;
+
+            Stamps& stamps = socket.stamps;
+            int64_t software = nanos(ts->ts[0]);
+            int64_t hardware = nanos(ts->ts[2]);
+            if (err->ee_info == SCM_TSTAMP_SND) {
+                if (software > stamps.txNs) {
+                    // A new send on this connection: its answer is still to come
+                    stamps.txNs = software;
+                    stamps.rxNs = 0;
+                    stamps.rxHwNs = 0;
+                }
+                if (hardware > 0) stamps.txHwNs = hardware;
+            } else if (err->ee_info == SCM_TSTAMP_ACK) {
+                stamps.ackNs = software;
+            }
+        }
+    }
+
+    // Arrival stamp of the oldest unread segment, without consuming it
+    static void peekReceived(Socket& socket) {
+        char byte;
+        char control[256];
+        struct iovec iov = {&byte, 1};
+        struct msghdr msg = {};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        if (recvmsg(socket.fd, &msg, MSG_PEEK | MSG_DONTWAIT) <= 0) return;
+
+        const struct scm_timestamping* ts = timestamps(msg);
+        if (!ts) return;
+        socket.stamps.rxNs = nanos(ts->ts[0]);
+        socket.stamps.rxHwNs = nanos(ts->ts[2]);
+    }
+};
+
+// Per-run WIRE summary: kernel-stamped phases of the answered attempts
+class WireStats {
+public:
+    void reset() {
+        for (auto& phase : phases_) phase.reset();
+        answered_ = stamped_ = hardware_ = 0;
+    }
+
+    // One answered attempt; nullptr when it could not be timestamped
+    void record(const WireTimestamps::Breakdown* breakdown) {
+        answered_++;
+        if (!breakdown) return;
+        stamped_++;
+        if (breakdown->hardware) hardware_++;
+        phases_[USER].record(breakdown->userUs);
+        phases_[SEND].record(breakdown->sendUs);
+        if (breakdown->ackUs >= 0) phases_[ACK].record(breakdown->ackUs);
+        phases_[WIRE].record(breakdown->wireUs);
+        phases_[RECV].record(breakdown->recvUs);
+        phases_[SELF].record(breakdown->selfUs());
+    }
+
+    void print(std::ostream& out, WireTimestamps::Mode mode) const {
+        static const char* names[PHASE_COUNT] = {"user", "send", "ack", "wire", "recv", "self"};
+        for (int p = 0; p < PHASE_COUNT; p++) {
+            if (phases_[p].count() > 0) phases_[p].print(out, "wire", names[p]);
+        }
+        out << "WIRE_STATS:mode=" << WireTimestamps::modeName(mode) << ",answered=" << answered_
+            << ",stamped=" << stamped_ << ",hardware=" << hardware_ << "\n";
+    }
+
+private:
+    enum Phase { USER, SEND, ACK, WIRE, RECV, SELF, PHASE_COUNT };
+
+    LatencyHistogram phases_[PHASE_COUNT];
+    long answered_ = 0;
+    long stamped_ = 0;
+    long hardware_ = 0;
+};
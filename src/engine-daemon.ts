@@ -0,0 +1,212 @@
+/**
+ * Client for updown-bot-cpp's daemon mode (src/cpp/daemon-ipc.hpp)
+ *
+ * The daemon is started once with credentials and transport settings, warms
+ * its connection pool and keeps it (and the server clock estimate) fresh
+ * between slots. Each slot submits its pre-signed orders over a Unix socket
+ * and gets the same protocol lines the one-shot process prints, so callers
+ * share their line handling between both modes.
+ *
+ * Jobs are pipelined: submit() does not wait for the job before it, the
+ * daemon queues them and runs them in order (the next slot's job can go in
+ * while the current one fires), and ping()/market() are answered during a
+ * run too.
+ *
+ * Started with "marketPrefixes", the daemon also prefetches upcoming markets
+ * from Gamma; market() reads its cache without a Gamma round trip.
+ */
+
+import * as net from 'net';
+import * as fs from 'fs';
+import { spawn, ChildProcess } from 'child_process';
+
+// Must match FrameType in daemon-ipc.hpp
+const FRAME_SUBMIT = 'S'.charCodeAt(0);
+const FRAME_PING = 'P'.charCodeAt(0);
+const FRAME_MARKET = 'M'.charCodeAt(0);
+const FRAME_QUIT = 'Q'.charCodeAt(0);
+const FRAME_LINE = 'L'.charCodeAt(0);
+const FRAME_DONE = 'D'.charCodeAt(0);
+const FRAME_STATUS = 'R'.charCodeAt(0);
+const FRAME_ERROR = 'E'.charCodeAt(0);
+const FRAME_HEADER_LEN = 5;
+
+const READY_TIMEOUT_MS = 30000;
+
+function encodeFrame(type: number, payload: string): Buffer {
+  const body = Buffer.from(payload, 'utf8');
+  const header = Buffer.alloc(FRAME_HEADER_LEN);
+  header.writeUInt32LE(body.length, 0);
+  header.writeUInt8(type, 4);
+  return Buffer.concat([header, body]);
+}
+
+export interface CachedMarket {
+  slug: string;
+  yesTokenId: string;
+  noTokenId: string;
+  acceptingOrdersTimestamp: string | null;
+  polls: number;      // Gamma requests the daemon made for it
+}
+
+interface PendingJob {
+  onLine: (line: string) => void;
+  resolve: (exitCode: number) => void;
+  reject: (err: Error) => void;
+}
+
+export class EngineDaemon {
+  private child?: ChildProcess;
+  private socket?: net.Socket;
+  private buffer = Buffer.alloc(0);
+  private jobs: PendingJob[] = [];  // submitted, in the daemon's run order
+  private pendingStatus: Array<(status: string) => void> = [];  // PING / MARKET answers, in order
+  private stderr = '';
+
+  // onDaemonLine gets the daemon's own stdout lines (DAEMON:, HEARTBEAT:, CLOCK: from idle sync)
+  constructor(
+    private readonly binary: string,
+    private readonly socketPath: string,
+    private readonly onDaemonLine: (line: string) => void = () => {}
+  ) {}
+
+  get running(): boolean {
+    return this.socket !== undefined && !this.socket.destroyed;
+  }
+
+  // Spawn the daemon with the stdin config (credentials, transport, maxOrders) and connect once it is warm
+  async start(config: object): Promise<void> {
+    const child = spawn(this.binary, [], { stdio: ['pipe', 'pipe', 'pipe'] });
+    this.child = child;
+    child.stdin!.write(JSON.stringify({ ...config, daemonSocket: this.socketPath }));
+    child.stdin!.end();
+    child.stderr!.on('data', (data) => { this.stderr += data.toString(); });
+
+    await new Promise<void>((resolve, reject) => {
+      const timer = setTimeout(() => reject(new Error('engine daemon did not become ready')), READY_TIMEOUT_MS);
+      let pending = '';
+      child.stdout!.on('data', (data) => {
+        pending += data.toString();
+        const lines = pending.split('\n');
+        pending = lines.pop() || '';
+        for (const line of lines) {
+          if (line.startsWith('DAEMON:ready:')) {
+            clearTimeout(timer);
+            resolve();
+          }
+          if (line.trim()) this.onDaemonLine(line);
+        }
+      });
+      child.on('error', (err) => {
+        clearTimeout(timer);
+        reject(err);
+      });
+      child.on('close', (code) => {
+        clearTimeout(timer);
+        const err = new Error(`engine daemon exited with code ${code}: ${this.stderr.trim()}`);
+        this.fail(err);
+        reject(err);
+      });
+    }).catch((err) => {
+      child.kill('SIGTERM');
+      throw err;
+    });
+
+    this.socket = await new Promise<net.Socket>((resolve, reject) => {
+      const socket = net.createConnection(this.socketPath, () => resolve(socket));
+      socket.once('error', reject);
+    }).catch((err) => {
+      child.kill('SIGTERM');
+      throw err;
+    });
+    this.socket.setNoDelay(true);
+    this.socket.on('data', (data) => this.onData(data));
+    this.socket.on('close', () => this.fail(new Error('engine daemon closed the connection')));
+  }
+
+  // Queue one job (orders + pacing/fire fields) after the submitted ones; its lines
+  // stream to onLine once it runs, resolves with the exit code
+  submit(job: object, onLine: (line: string) => void): Promise<number> {
+    if (!this.running) return Promise.reject(new Error('engine daemon is not running'));
+    return new Promise((resolve, reject) => {
+      this.jobs.push({ onLine, resolve, reject });
+      this.socket!.write(encodeFrame(FRAME_SUBMIT, JSON.stringify(job)));
+    });
+  }
+
+  // STATUS:jobs=..,queued=..,running=0|1,clock_error_ms=..,samples=..
+  ping(): Promise<string> {
+    return this.status(FRAME_PING, '');
+  }
+
+  // Prefetched market for slug; null while Gamma has not listed it (or discovery is off)
+  async market(slug: string): Promise<CachedMarket | null> {
+    const fields = new Map<string, string>();
+    for (const pair of (await this.status(FRAME_MARKET, slug)).replace(/^MARKET:/, '').split(',')) {
+      const eq = pair.indexOf('=');
+      if (eq > 0) fields.set(pair.slice(0, eq), pair.slice(eq + 1));
+    }
+    const status = fields.get('status');
+    if (status !== 'ready' && status !== 'listed') return null;
+    return {
+      slug,
+      yesTokenId: fields.get('yes') || '',
+      noTokenId: fields.get('no') || '',
+      acceptingOrdersTimestamp: fields.get('accepting') || null,
+      polls: parseInt(fields.get('polls') || '0'),
+    };
+  }
+
+  private status(type: number, payload: string): Promise<string> {
+    if (!this.running) return Promise.reject(new Error('engine daemon is not running'));
+    return new Promise((resolve) => {
+      this.pendingStatus.push(resolve);
+      this.socket!.write(encodeFrame(type, payload));
+    });
+  }
+
+  async stop(): Promise<void> {
+    const child = this.child;
+    if (this.running) this.socket!.end(encodeFrame(FRAME_QUIT, ''));
+    if (child && child.exitCode === null) {
+      await new Promise<void>((resolve) => {
+        const timer = setTimeout(() => child.kill('SIGTERM'), 2000);
+        child.once('close', () => {
+          clearTimeout(timer);
+          resolve();
+        });
+      });
+    }
+    this.child = undefined;
+    fs.rmSync(this.socketPath, { force: true });
+  }
+
+  private onData(data: Buffer) {
+    this.buffer = this.buffer.length ? Buffer.concat([this.buffer, data]) : data;
+    while (this.buffer.length >= FRAME_HEADER_LEN) {
+      const length = this.buffer.readUInt32LE(0);
+      if (this.buffer.length < FRAME_HEADER_LEN + length) break;
+      const type = this.buffer.readUInt8(4);
+      const payload = this.buffer.toString('utf8', FRAME_HEADER_LEN, FRAME_HEADER_LEN + length);
+      this.buffer = this.buffer.subarray(FRAME_HEADER_LEN + length);
+
+      if (type === FRAME_LINE) {
+        this.jobs[0]?.onLine(payload);
+      } else if (type === FRAME_DONE) {
+        this.jobs.shift()?.resolve(parseInt(payload));
+      } else if (type === FRAME_ERROR) {
+        // Only ever a job's rejection (protocol errors close the socket), in submit order
+        this.jobs.shift()?.reject(new Error(`engine daemon rejected job: ${payload}`));
+      } else if (type === FRAME_STATUS) {
+        this.pendingStatus.shift()?.(payload);
+      }
+    }
+  }
+
+  private fail(err: Error) {
+    const jobs = this.jobs;
+    this.jobs = [];
+    for (const job of jobs) job.reject(err);
+    this.socket?.destroy();
+  }
+}
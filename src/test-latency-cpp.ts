@@ -17,22 +17,29 @@ import * as fs from 'fs';
 import * as path from 'path';
 import { spawn } from 'child_process';
 import { TradingService } from './trading-service';
+import { AttemptRingReader, attemptRingPath } from './attempt-ring';
 import { tradingConfig, validateTradingConfig, BOT_CONFIG, getOrderSize } from './config';
 import { OrderType } from '@polymarket/clob-client';
 
 // Latency log file (unified format with summary stats in each row)
 const LATENCY_LOG_FILE = path.join(__dirname, '..', 'latency.csv');
+const RATE_LOG_FILE = path.join(__dirname, '..', 'latency-rate.csv');
 const CPP_BINARY = path.join(__dirname, '..', 'dist', 'test-latency-cpp');
 
 // CSV header (unified format with summary stats)
 const CSV_HEADER = 'server_time_ms,market_time,sec_to_market,slug,accepting_orders_timestamp,side,price,size,latency_ms,status,order_id,attempt,total_attempts,success_count,first_success_attempt,min_ms,max_ms,avg_ms,median_ms,source\n';
 
+// Rate controller decisions, joined to latency.csv by slug
+const RATE_CSV_HEADER = 'server_time_ms,slug,decision,order_index,attempt,kind,rate_rps,window,source\n';
+
 // Test parameters
 const TEST_PRICE = 0.44;
 // Get expiration buffer from ORDER_CONFIG for TEST_PRICE (use UP config)
 const TEST_EXPIRATION_BUFFER = BOT_CONFIG.ORDER_CONFIG.find(c => c.price === TEST_PRICE)?.up.expirationBuffer || 30;
 const MAX_ATTEMPTS = BOT_CONFIG.MAX_ORDER_ATTEMPTS;
 const INTERVAL_MS = 1;
+const PROBE_INTERVAL_MS = BOT_CONFIG.CPP_MODE.PROBE_INTERVAL_MS;
+const ATTEMPT_RING = BOT_CONFIG.CPP_MODE.ATTEMPT_RING;
 const DELAY_BEFORE_SPAM_MS = BOT_CONFIG.DELAY_BEFORE_SPAM_MS;
 const POLL_INTERVAL_MS = BOT_CONFIG.POLL_INTERVAL_MS;
 const INTERVAL_SECONDS = 900; // 15 minutes
@@ -57,6 +64,9 @@ function initLatencyLog() {
   if (!fs.existsSync(LATENCY_LOG_FILE)) {
     fs.writeFileSync(LATENCY_LOG_FILE, CSV_HEADER);
   }
+  if (!fs.existsSync(RATE_LOG_FILE)) {
+    fs.writeFileSync(RATE_LOG_FILE, RATE_CSV_HEADER);
+  }
 }
 
 // Update cached server time
@@ -126,6 +136,28 @@ function writeResult(
   fs.appendFileSync(LATENCY_LOG_FILE, line);
 }
 
+// Append one engine rate-controller decision (RATE:<decision>:rate_rps=..,window=..[,order=..,attempt=..,kind=..])
+function writeRateDecision(line: string) {
+  const [, decision, fields] = line.split(':');
+  const values: Record<string, string> = {};
+  for (const field of (fields || '').split(',')) {
+    const [key, value] = field.split('=');
+    values[key] = value;
+  }
+  const row = [
+    getServerTimeMs(),
+    currentSlug,
+    decision,
+    values.order ?? '',
+    values.attempt ?? '',
+    values.kind ?? '',
+    values.rate_rps ?? '',
+    values.window ?? '',
+    'cpp'
+  ].join(',') + '\n';
+  fs.appendFileSync(RATE_LOG_FILE, row);
+}
+
 /**
  * Fetch market by slug from Gamma API
  */
@@ -332,6 +364,7 @@ async function runTest(slug: string, marketTimestamp: number) {
   log(`  Message length: ${testMessage.length}`);
   log(`  Expected signature: ${testSignature}`);
 
+  const ringPath = ATTEMPT_RING ? attemptRingPath('test-latency') : undefined;
   const cppConfig = {
     body: orderBody,
     apiKey: tradingConfig.apiKey,
@@ -340,9 +373,11 @@ async function runTest(slug: string, marketTimestamp: number) {
     address: walletAddress,  // IMPORTANT: Use wallet address, not funder!
     maxAttempts: MAX_ATTEMPTS,
     intervalMs: INTERVAL_MS,
+    probeIntervalMs: PROBE_INTERVAL_MS,
     // Pass the test timestamp for signature comparison
     testTimestamp: serverTime,
     testSignature: testSignature,
+    ...(ringPath && { attemptRing: ringPath }),
   };
 
   log(`Max attempts: ${cppConfig.maxAttempts}`);
@@ -484,6 +519,15 @@ async function runTest(slug: string, marketTimestamp: number) {
           log(`Failed: ${line.split(':')[1]}`);
         } else if (line.startsWith('STATS:')) {
           log(`Stats: ${line.substring(6)}`);
+        } else if (line.startsWith('LATENCY:')) {
+          const [, scope, phase, stats] = line.split(':');
+          if (phase === 'ttfb' || phase === 'total') log(`Latency ${scope}/${phase}: ${stats}`);
+        } else if (line.startsWith('RATE:')) {
+          writeRateDecision(line);
+          const [, decision, fields] = line.split(':');
+          log(`Rate controller: ${decision} (${fields})`);
+        } else if (line.startsWith('RING:')) {
+          log(`Attempt ring: ${line.slice('RING:'.length)}`);
         }
       }
     });
@@ -497,6 +541,20 @@ async function runTest(slug: string, marketTimestamp: number) {
     cpp.on('close', (code) => {
       const spamElapsed = Math.round((Date.now() - spamStart) / 1000 * 10) / 10;
 
+      // Attempts went to the shared-memory ring instead of ATTEMPT: lines
+      if (ringPath) {
+        const ring = new AttemptRingReader(ringPath);
+        for (const record of ring.poll()) {
+          if (record.success) {
+            log(`#${record.attempt}: ${record.latencyMs}ms - SUCCESS! Order: ${record.message}`);
+            trackLatency(record.latencyMs, true, record.message);
+          } else {
+            trackLatency(record.latencyMs, false, undefined, record.message);
+          }
+        }
+        ring.close();
+      }
+
       log('');
       log('='.repeat(60));
       log('RESULTS:');
@@ -4,10 +4,11 @@
  * This bot:
  * 1. Continuously monitors for new BTC updown-15m markets
  * 2. Pre-signs 10 orders (5 price levels × 2 sides)
- * 3. Spawns 10 C++ processes for parallel HTTP spam
+ * 3. Spawns one C++ engine that spams all orders concurrently (curl_multi)
  * 4. Logs results to CSV with latency stats
  *
  * Usage: npm run updown-bot btc-updown-15m-1764929700
+ *        npm run updown-bot all-AUTO   (every MARKET_PATTERNS market per slot, pipelined; needs CPP_MODE.DAEMON)
  */
 
 import * as dotenv from 'dotenv';
@@ -17,40 +18,59 @@ import * as fs from 'fs';
 import * as path from 'path';
 import { spawn } from 'child_process';
 import { TradingService } from '../trading-service';
+import { AttemptRingReader, attemptRingPath } from '../attempt-ring';
+import { EngineDaemon } from '../engine-daemon';
 import { tradingConfig, validateTradingConfig, BOT_CONFIG } from '../config';
 import { OrderType } from '@polymarket/clob-client';
 
 // Paths
 const LATENCY_LOG_FILE = path.join(__dirname, '..', '..', 'updown-bot.csv');
+const RATE_LOG_FILE = path.join(__dirname, '..', '..', 'updown-bot-rate.csv');
+const WIRE_LOG_FILE = path.join(__dirname, '..', '..', 'updown-bot-wire.csv');
+const ATTEMPT_LOG_FILE = path.join(__dirname, '..', '..', 'updown-bot-attempts.bin');
 const CPP_BINARY = path.join(__dirname, '..', '..', 'dist', 'updown-bot-cpp');
 const STATE_DIR = path.join(__dirname, '..', '..', '.bot-state');
 const STATE_FILE_PREFIX = 'updown-bot-state-';
 
 // CSV header (22 columns - added order_index and expiration_buffer)
+const RATE_CSV_HEADER = 'server_time_ms,slug,decision,order_index,attempt,kind,rate_rps,window,source\n';
+const WIRE_CSV_HEADER = 'server_time_ms,slug,order_index,attempt,user_us,send_us,ack_us,wire_us,recv_us,hw\n';
 const CSV_HEADER = 'server_time_ms,market_time,sec_to_market,slug,accepting_orders_timestamp,order_index,side,price,size,expiration_buffer,latency_ms,status,order_id,attempt,total_attempts,success_count,first_success_attempt,min_ms,max_ms,avg_ms,median_ms,source\n';
 
 // Bot parameters
 const MAX_ATTEMPTS_PER_ORDER = 500;
 const INTERVAL_MS = 1;
+const PROBE_INTERVAL_MS = BOT_CONFIG.CPP_MODE.PROBE_INTERVAL_MS;
+const CPP_MODE = BOT_CONFIG.CPP_MODE;
 const DELAY_BEFORE_SPAM_MS = BOT_CONFIG.DELAY_BEFORE_SPAM_MS;
 const POLL_INTERVAL_MS = BOT_CONFIG.POLL_INTERVAL_MS;
 const INTERVAL_SECONDS = 900; // 15 minutes
+const ALL_MARKETS = 'all';       // pattern of the multi-asset pipeline
+const PIPELINE_DEPTH = 2;        // slot jobs in the daemon at once: the one firing and the next
 
 // State for logging
 let cachedServerTime = 0;
 let cachedLocalTime = 0;
-let currentMarketTime = 0;
-let currentSlug = '';
-let acceptingOrdersTimestamp: string | undefined;
 
 // Types
+interface MarketTokens {
+  yesTokenId: string;
+  noTokenId: string;
+  acceptingOrdersTimestamp?: string;
+  cached?: boolean;  // answered from the engine daemon's prefetch cache
+}
+
 interface SignedOrderInfo {
-  signedOrder: any;
+  signedOrder: any;  // undefined with CPP_MODE.NATIVE_SIGNING: the engine signs it
   price: number;
   size: number;
+  expiration: number;
   expirationBuffer: number;
   tokenId: string;
   side: 'YES' | 'NO';
+  slug: string;
+  marketTime: number;
+  acceptingOrdersTimestamp?: string;
 }
 
 interface OrderResult {
@@ -78,6 +98,12 @@ function initLatencyLog() {
   if (!fs.existsSync(LATENCY_LOG_FILE)) {
     fs.writeFileSync(LATENCY_LOG_FILE, CSV_HEADER);
   }
+  if (!fs.existsSync(RATE_LOG_FILE)) {
+    fs.writeFileSync(RATE_LOG_FILE, RATE_CSV_HEADER);
+  }
+  if (CPP_MODE.WIRE_TIMESTAMPS !== 'off' && !fs.existsSync(WIRE_LOG_FILE)) {
+    fs.writeFileSync(WIRE_LOG_FILE, WIRE_CSV_HEADER);
+  }
 }
 
 // State management
@@ -126,23 +152,23 @@ function getServerTimeMs(): number {
   return cachedServerTime * 1000 + elapsed;
 }
 
-// Write order result to CSV
-function writeOrderResult(
+// One order's result as a CSV row
+function orderResultRow(
   orderIndex: number,
   orderInfo: SignedOrderInfo,
   result: OrderResult
-) {
+): string {
   const serverTimeMs = getServerTimeMs();
-  const secToMarket = ((currentMarketTime * 1000) - serverTimeMs) / 1000;
+  const secToMarket = ((orderInfo.marketTime * 1000) - serverTimeMs) / 1000;
   const status = result.success ? 'success' : 'failed';
   const sideLabel = orderInfo.side === 'YES' ? 'UP' : 'DOWN';
 
-  const line = [
+  return [
     serverTimeMs,
-    currentMarketTime,
+    orderInfo.marketTime,
     secToMarket.toFixed(3),
-    currentSlug,
-    acceptingOrdersTimestamp || '',
+    orderInfo.slug,
+    orderInfo.acceptingOrdersTimestamp || '',
     orderIndex,
     sideLabel,
     orderInfo.price,
@@ -161,18 +187,57 @@ function writeOrderResult(
     result.medianMs,
     'cpp'
   ].join(',') + '\n';
+}
+
+// Append one engine rate-controller decision (RATE:<decision>:rate_rps=..,window=..[,order=..,attempt=..,kind=..])
+function writeRateDecision(line: string, slug: string) {
+  const [, decision, fields] = line.split(':');
+  const values: Record<string, string> = {};
+  for (const field of (fields || '').split(',')) {
+    const [key, value] = field.split('=');
+    values[key] = value;
+  }
+  const row = [
+    getServerTimeMs(),
+    slug,
+    decision,
+    values.order ?? '',
+    values.attempt ?? '',
+    values.kind ?? '',
+    values.rate_rps ?? '',
+    values.window ?? '',
+    'cpp'
+  ].join(',') + '\n';
+  fs.appendFileSync(RATE_LOG_FILE, row);
+}
 
-  fs.appendFileSync(LATENCY_LOG_FILE, line);
+// Append one attempt's kernel-timestamped split (WIRE:<orderIndex>:<attempt>:user_us=..,send_us=..,ack_us=..,wire_us=..,recv_us=..,hw=..)
+function writeWireAttempt(line: string, slug: string) {
+  const [, orderIndex, attempt, fields] = line.split(':');
+  const values: Record<string, string> = {};
+  for (const field of (fields || '').split(',')) {
+    const [key, value] = field.split('=');
+    values[key] = value;
+  }
+  const row = [
+    getServerTimeMs(),
+    slug,
+    orderIndex,
+    attempt,
+    values.user_us ?? '',
+    values.send_us ?? '',
+    values.ack_us ?? '',
+    values.wire_us ?? '',
+    values.recv_us ?? '',
+    values.hw ?? '',
+  ].join(',') + '\n';
+  fs.appendFileSync(WIRE_LOG_FILE, row);
 }
 
 /**
  * Fetch market by slug from Gamma API
  */
-async function fetchMarketBySlug(slug: string): Promise<{
-  yesTokenId: string;
-  noTokenId: string;
-  acceptingOrdersTimestamp?: string;
-} | null> {
+async function fetchMarketBySlug(slug: string): Promise<MarketTokens | null> {
   try {
     const url = `https://gamma-api.polymarket.com/markets/slug/${slug}`;
     const response = await fetch(url);
@@ -196,9 +261,9 @@ async function fetchMarketBySlug(slug: string): Promise<{
       return null;
     }
 
-    // Get acceptingOrdersTimestamp from markets[0]
-    let acceptingOrdersTimestamp: string | undefined;
-    if (market.markets && Array.isArray(market.markets) && market.markets[0]) {
+    // acceptingOrdersTimestamp is a field of the market object (markets[0] kept as fallback)
+    let acceptingOrdersTimestamp: string | undefined = market.acceptingOrdersTimestamp || undefined;
+    if (!acceptingOrdersTimestamp && Array.isArray(market.markets) && market.markets[0]) {
       acceptingOrdersTimestamp = market.markets[0].acceptingOrdersTimestamp;
     }
 
@@ -212,62 +277,77 @@ async function fetchMarketBySlug(slug: string): Promise<{
   }
 }
 
+/**
+ * One order signed by clob-client; undefined when the engine signs orders itself
+ */
+async function signWithClient(
+  tradingService: TradingService,
+  tokenId: string,
+  price: number,
+  size: number,
+  outcome: 'YES' | 'NO',
+  expirationTimestamp: number
+): Promise<any> {
+  if (CPP_MODE.NATIVE_SIGNING.ENABLED) return undefined;
+  return tradingService.createSignedOrder({
+    tokenId,
+    side: 'BUY',
+    price,
+    size,
+    outcome,
+    expirationTimestamp,
+    negRisk: false,
+  });
+}
+
 /**
  * Pre-sign all 10 orders (5 price levels × 2 sides)
  */
 async function preSignOrders(
   tradingService: TradingService,
-  yesTokenId: string,
-  noTokenId: string,
+  slug: string,
+  market: MarketTokens,
   marketTimestamp: number
 ): Promise<SignedOrderInfo[]> {
   const signedOrders: SignedOrderInfo[] = [];
+  const { yesTokenId, noTokenId, acceptingOrdersTimestamp } = market;
+  const marketFields = { slug, marketTime: marketTimestamp, acceptingOrdersTimestamp };
 
-  log(`Pre-signing ${BOT_CONFIG.ORDER_CONFIG.length * 2} orders...`);
+  log(CPP_MODE.NATIVE_SIGNING.ENABLED
+    ? `Preparing ${BOT_CONFIG.ORDER_CONFIG.length * 2} orders for ${slug} (signed by the engine)...`
+    : `Pre-signing ${BOT_CONFIG.ORDER_CONFIG.length * 2} orders for ${slug}...`);
 
   for (const config of BOT_CONFIG.ORDER_CONFIG) {
     const { price, up, down } = config;
 
     // UP (YES) order
     const upExpirationTimestamp = marketTimestamp - up.expirationBuffer;
-    const upSignedOrder = await tradingService.createSignedOrder({
-      tokenId: yesTokenId,
-      side: 'BUY',
-      price,
-      size: up.size,
-      outcome: 'YES',
-      expirationTimestamp: upExpirationTimestamp,
-      negRisk: false,
-    });
+    const upSignedOrder = await signWithClient(tradingService, yesTokenId, price, up.size, 'YES', upExpirationTimestamp);
 
     signedOrders.push({
       signedOrder: upSignedOrder,
       price,
       size: up.size,
+      expiration: upExpirationTimestamp,
       expirationBuffer: up.expirationBuffer,
       tokenId: yesTokenId,
       side: 'YES',
+      ...marketFields,
     });
 
     // DOWN (NO) order
     const downExpirationTimestamp = marketTimestamp - down.expirationBuffer;
-    const downSignedOrder = await tradingService.createSignedOrder({
-      tokenId: noTokenId,
-      side: 'BUY',
-      price,
-      size: down.size,
-      outcome: 'NO',
-      expirationTimestamp: downExpirationTimestamp,
-      negRisk: false,
-    });
+    const downSignedOrder = await signWithClient(tradingService, noTokenId, price, down.size, 'NO', downExpirationTimestamp);
 
     signedOrders.push({
       signedOrder: downSignedOrder,
       price,
       size: down.size,
+      expiration: downExpirationTimestamp,
       expirationBuffer: down.expirationBuffer,
       tokenId: noTokenId,
       side: 'NO',
+      ...marketFields,
     });
 
     log(`  ${price}: UP($${up.size}, exp:${new Date(upExpirationTimestamp * 1000).toLocaleString('ru-RU')}), DOWN($${down.size}, exp:${new Date(downExpirationTimestamp * 1000).toLocaleString('ru-RU')})`);
@@ -278,84 +358,349 @@ async function preSignOrders(
 }
 
 /**
- * Spawn single C++ process for one order
+ * Build POST /orders body for one pre-signed order
  */
-async function spawnCppSpammer(
-  orderInfo: SignedOrderInfo,
-  orderIndex: number,
-  walletAddress: string
-): Promise<OrderResult> {
-  return new Promise((resolve, reject) => {
-    // Transform order same as test-latency-cpp
-    const transformedOrder = {
-      ...orderInfo.signedOrder,
-      salt: parseInt(orderInfo.signedOrder.salt, 10),
-      side: orderInfo.signedOrder.side === 0 ? 'BUY' : 'SELL',
-    };
+function buildOrderBody(orderInfo: SignedOrderInfo): string {
+  // Transform order same as test-latency-cpp
+  const transformedOrder = {
+    ...orderInfo.signedOrder,
+    salt: parseInt(orderInfo.signedOrder.salt, 10),
+    side: orderInfo.signedOrder.side === 0 ? 'BUY' : 'SELL',
+  };
+
+  return JSON.stringify([
+    {
+      deferExec: false,
+      order: transformedOrder,
+      owner: tradingConfig.apiKey,
+      orderType: 'GTD',
+    },
+  ]);
+}
+
+/**
+ * Order parameters the engine signs itself (CPP_MODE.NATIVE_SIGNING)
+ */
+function engineOrderParams(orderInfo: SignedOrderInfo) {
+  return {
+    tokenId: orderInfo.tokenId,
+    price: orderInfo.price,
+    size: orderInfo.size,
+    side: 'BUY',
+    expiration: orderInfo.expiration,
+    feeRateBps: CPP_MODE.NATIVE_SIGNING.FEE_RATE_BPS,
+  };
+}
+
+type LatencyRecord = { latencyMs: number; success: boolean; attempt: number; orderId?: string };
+
+/**
+ * Aggregate per-attempt records of one order into OrderResult
+ */
+function buildOrderResult(latencyRecords: LatencyRecord[]): OrderResult {
+  const totalAttempts = latencyRecords.length;
+  const successRecords = latencyRecords.filter(r => r.success);
+  const successCount = successRecords.length;
+  const firstSuccessAttempt = successRecords.length > 0
+    ? Math.min(...successRecords.map(r => r.attempt))
+    : 0;
+
+  let minMs = 0, maxMs = 0, avgMs = 0, medianMs = 0;
+  if (latencyRecords.length > 0) {
+    const latencies = latencyRecords.map(r => r.latencyMs);
+    const sorted = [...latencies].sort((a, b) => a - b);
+    minMs = sorted[0];
+    maxMs = sorted[sorted.length - 1];
+    avgMs = Math.round(latencies.reduce((a, b) => a + b, 0) / latencies.length);
+    medianMs = sorted[Math.floor(sorted.length / 2)];
+  }
+
+  const successRecord = successRecords[0];
+  const lastRecord = latencyRecords[latencyRecords.length - 1];
+
+  return {
+    success: successCount > 0,
+    orderId: successRecord?.orderId,
+    latencyMs: (successRecord || lastRecord)?.latencyMs || 0,
+    attempt: totalAttempts,
+    totalAttempts,
+    successCount,
+    firstSuccessAttempt,
+    minMs,
+    maxMs,
+    avgMs,
+    medianMs,
+  };
+}
+
+// Credentials and transport: fixed for the lifetime of a daemon
+function engineTransportConfig(walletAddress: string) {
+  return {
+    apiKey: tradingConfig.apiKey,
+    secret: tradingConfig.secret,
+    passphrase: tradingConfig.passphrase,
+    address: walletAddress,
+    ...(CPP_MODE.NATIVE_SIGNING.ENABLED && {
+      privateKey: tradingConfig.privateKey,
+      funder: tradingConfig.funder || walletAddress,
+      signatureType: tradingConfig.signatureType,
+      chainId: tradingConfig.chainId,
+      tickSize: CPP_MODE.NATIVE_SIGNING.TICK_SIZE,
+    }),
+    http2: CPP_MODE.HTTP2,
+    pinDns: CPP_MODE.PIN_DNS,
+    heartbeatMs: CPP_MODE.HEARTBEAT_MS,
+    hedgeCopies: CPP_MODE.HEDGE.COPIES,
+    hedgeDelayMs: CPP_MODE.HEDGE.DELAY_MS,
+    batchSize: CPP_MODE.BATCH_SIZE,
+    ...(CPP_MODE.WIRE_TIMESTAMPS !== 'off' && !CPP_MODE.HTTP2 && { wireTimestamps: CPP_MODE.WIRE_TIMESTAMPS }),
+    ...(CPP_MODE.TRANSPORT === 'uring' && !CPP_MODE.HTTP2 && CPP_MODE.HEDGE.COPIES <= 1 &&
+        CPP_MODE.HEDGE.EDGE_ADDRESSES.length === 0 && CPP_MODE.WIRE_TIMESTAMPS === 'off' && { transport: 'uring' }),
+    ...(CPP_MODE.PROFILE.CPUS && { cpus: CPP_MODE.PROFILE.CPUS }),
+    ...(CPP_MODE.PROFILE.HELPER_CPUS && { helperCpus: CPP_MODE.PROFILE.HELPER_CPUS }),
+    ...(CPP_MODE.PROFILE.FIFO_PRIORITY > 0 && { fifoPriority: CPP_MODE.PROFILE.FIFO_PRIORITY }),
+    ...(CPP_MODE.PROFILE.LOCK_MEMORY && { lockMemory: true }),
+    ...(CPP_MODE.HEDGE.EDGE_ADDRESSES.length > 0 && { edgeAddresses: CPP_MODE.HEDGE.EDGE_ADDRESSES.join(',') }),
+    ...(CPP_MODE.HTTP2 && {
+      maxConnections: CPP_MODE.HTTP2_CONNECTIONS,
+      maxInFlight: CPP_MODE.MAX_IN_FLIGHT,
+    }),
+  };
+}
 
-    const orderBody = JSON.stringify([
-      {
-        deferExec: false,
-        order: transformedOrder,
-        owner: tradingConfig.apiKey,
-        orderType: 'GTD',
-      },
-    ]);
-
-    const cppConfig = {
-      body: orderBody,
-      apiKey: tradingConfig.apiKey,
-      secret: tradingConfig.secret,
-      passphrase: tradingConfig.passphrase,
-      address: walletAddress,
-      maxAttempts: MAX_ATTEMPTS_PER_ORDER,
-      intervalMs: INTERVAL_MS,
+let engineDaemon: EngineDaemon | undefined;
+let daemonMaxOrders = CPP_MODE.DAEMON.MAX_ORDERS;  // raised for the multi-asset pipeline
+
+/**
+ * Warm engine daemon shared by all slots; (re)started when missing or dead
+ */
+async function getEngineDaemon(walletAddress: string): Promise<EngineDaemon> {
+  if (engineDaemon?.running) return engineDaemon;
+  if (engineDaemon) await engineDaemon.stop();
+
+  const daemon = new EngineDaemon(CPP_BINARY, CPP_MODE.DAEMON.SOCKET_PATH, (line) => {
+    if (line.startsWith('WARMUP:')) {
+      log(`  Engine daemon warm-up: ${parseInt(line.split(':')[1])}ms`);
+    } else if (line.startsWith('HEARTBEAT:') && !line.includes('reconnected=0,')) {
+      log(`  Engine daemon: ${line}`);
+    } else if (line.startsWith('DNS:')) {
+      log(`  Engine daemon pinned ${line.slice('DNS:'.length)}`);
+    } else if (line.startsWith('PROFILE:')) {
+      log(`  Engine daemon profile: ${line.slice('PROFILE:'.length)}`);
+    } else if (line.startsWith('DAEMON:')) {
+      log(`  Engine daemon: ${line.slice('DAEMON:'.length)}`);
+    } else if (line.startsWith('MARKET:found:')) {
+      log(`  Engine daemon prefetched ${line.slice('MARKET:found:'.length)}`);
+    }
+  });
+  engineDaemon = daemon;
+  await daemon.start({
+    ...engineTransportConfig(walletAddress),
+    maxOrders: daemonMaxOrders,
+    ...(CPP_MODE.FIRE_MODE.ENABLED && { burstOffsetsMs: CPP_MODE.FIRE_MODE.BURST_OFFSETS_MS }),
+    ...(CPP_MODE.DAEMON.DISCOVERY.ENABLED && {
+      marketPrefixes: BOT_CONFIG.MARKET_PATTERNS.join(','),
+      marketLookahead: CPP_MODE.DAEMON.DISCOVERY.LOOKAHEAD_SLOTS,
+      marketPollMs: POLL_INTERVAL_MS,
+    }),
+  });
+  return daemon;
+}
+
+/**
+ * One Phase 1 poll: the daemon's prefetch cache when discovery runs there (it
+ * polls Gamma itself, so a miss waits for it), else a direct Gamma GET
+ */
+async function lookupMarket(slug: string): Promise<MarketTokens | null> {
+  if (CPP_MODE.DAEMON.ENABLED && CPP_MODE.DAEMON.DISCOVERY.ENABLED && engineDaemon?.running) {
+    try {
+      const market = await engineDaemon.market(slug);
+      if (!market) return null;
+      return {
+        yesTokenId: market.yesTokenId,
+        noTokenId: market.noTokenId,
+        acceptingOrdersTimestamp: market.acceptingOrdersTimestamp || undefined,
+        cached: true,
+      };
+    } catch {
+      // Daemon went away: poll Gamma directly
+    }
+  }
+  return fetchMarketBySlug(slug);
+}
+
+/**
+ * Run all orders concurrently in one C++ engine (one curl_multi event loop,
+ * shared connection pool): a job for the warm daemon, or a one-shot process
+ */
+async function spawnCppEngine(
+  signedOrders: SignedOrderInfo[],
+  walletAddress: string,
+  fireAtMs?: number
+): Promise<OrderResult[]> {
+  const ringPath = CPP_MODE.ATTEMPT_RING ? attemptRingPath('updown-bot') : undefined;
+  const job = {
+    orders: signedOrders.map((orderInfo, orderIndex) => ({
+      ...(CPP_MODE.NATIVE_SIGNING.ENABLED ? engineOrderParams(orderInfo) : { body: buildOrderBody(orderInfo) }),
       orderIndex,
-    };
+      market: orderInfo.slug,
+      outcome: orderInfo.side === 'YES' ? 'UP' : 'DOWN',
+      price: orderInfo.price,
+      size: orderInfo.size,
+      ...(CPP_MODE.STOP_SIDE_ON_FILL && { group: `${orderInfo.slug}:${orderInfo.side}` }),
+    })),
+    maxAttempts: MAX_ATTEMPTS_PER_ORDER,
+    intervalMs: INTERVAL_MS,
+    probeIntervalMs: PROBE_INTERVAL_MS,
+    ...(fireAtMs && {
+      fireAtMs,
+      burstOffsetsMs: CPP_MODE.FIRE_MODE.BURST_OFFSETS_MS,
+    }),
+    ...(ringPath && { attemptRing: ringPath }),
+    ...(CPP_MODE.ATTEMPT_LOG && { attemptLog: ATTEMPT_LOG_FILE }),
+  };
+
+  const latencyRecords: LatencyRecord[][] = signedOrders.map(() => []);
+  // Rate decisions without an order belong to the whole job
+  const slugs = [...new Set(signedOrders.map((orderInfo) => orderInfo.slug))];
+  const jobSlug = slugs.length === 1 ? slugs[0] : `${ALL_MARKETS}-${signedOrders[0]?.marketTime}`;
+  const slugOf = (orderIndex: string | undefined) => signedOrders[parseInt(orderIndex ?? '')]?.slug ?? jobSlug;
+
+  const handleLine = (line: string) => {
+    if (line.startsWith('ATTEMPT:')) {
+      const parts = line.split(':');
+      const orderIdx = parseInt(parts[1]);
+      const attemptNum = parseInt(parts[2]);
+      const latency = parseInt(parts[3]);
+      const success = parts[4] === 'true';
+      const message = parts.slice(5).join(':');
+
+      const records = latencyRecords[orderIdx];
+      if (records) {
+        records.push({ latencyMs: latency, success, attempt: attemptNum, orderId: success ? message : undefined });
+      }
+    } else if (line.startsWith('WIRE:')) {
+      writeWireAttempt(line, slugOf(line.split(':')[1]));
+    } else if (line.startsWith('WIRE_STATS:')) {
+      log(`  Wire timestamps: ${line.slice('WIRE_STATS:'.length)}`);
+    } else if (line.startsWith('WARMUP:')) {
+      const warmup = parseInt(line.split(':')[1]);
+      const connections = CPP_MODE.HTTP2 ? CPP_MODE.HTTP2_CONNECTIONS : signedOrders.length;
+      log(`  TLS warm-up (${connections} connections${CPP_MODE.HTTP2 ? ', HTTP/2' : ''}): ${warmup}ms`);
+    } else if (line.startsWith('SUCCESS:')) {
+      const parts = line.split(':');
+      const orderId = parts.slice(2).join(':');
+      log(`  [Order ${parts[1]}] SUCCESS! Order: ${orderId.slice(0, 20)}...`);
+    } else if (line.startsWith('FAILED:')) {
+      const parts = line.split(':');
+      log(`  [Order ${parts[1]}] Failed: ${parts[2]}`);
+    } else if (line.startsWith('SCHEDULED:')) {
+      const leadMs = parseInt(line.split(':')[2]);
+      log(`  Warm and holding: first send in ${leadMs}ms`);
+    } else if (line.startsWith('FIRE_STATS:')) {
+      log(`  Fire accuracy: ${line.slice('FIRE_STATS:'.length)}`);
+    } else if (line.startsWith('SCHED:')) {
+      // Preemptions/page faults of the engine thread between first send and last answer
+      log(`  Critical window: ${line.slice('SCHED:'.length)}`);
+    } else if (line.startsWith('PROFILE:')) {
+      log(`  Execution profile: ${line.slice('PROFILE:'.length)}`);
+    } else if (line.startsWith('SIGNAL:window_open:')) {
+      // SIGNAL:window_open:<orderIndex>:<attempt>
+      const [, , orderIdx, attemptNum] = line.split(':');
+      log(`  Orderbook open (order ${orderIdx}, attempt ${attemptNum}): all orders at ${INTERVAL_MS}ms`);
+    } else if (line.startsWith('RATE:')) {
+      writeRateDecision(line, slugOf(/order=(\d+)/.exec(line)?.[1]));
+      const [, decision, fields] = line.split(':');
+      if (decision !== 'open') log(`  Rate controller: ${decision} (${fields})`);
+    } else if (line.startsWith('CLOCK:')) {
+      log(`  Server clock: ${line.slice('CLOCK:'.length)}`);
+    } else if (line.startsWith('DNS:')) {
+      log(`  Pinned ${line.slice('DNS:'.length)}`);
+    } else if (line.startsWith('RING:')) {
+      // RING:records=..,dropped=..,capacity=..
+      if (!line.includes('dropped=0,')) log(`  Attempt ring: ${line.slice('RING:'.length)}`);
+    } else if (line.startsWith('LOG:')) {
+      // LOG:records=..,dropped=..,bytes=.. (this run's segment of the attempt log)
+      if (!line.includes('dropped=0,')) log(`  Attempt log: ${line.slice('LOG:'.length)}`);
+    } else if (line.startsWith('HEDGE:')) {
+      // HEDGE:attempts=..,copies=..,copy_first=..,late=..
+      log(`  Hedged sends: ${line.slice('HEDGE:'.length)}`);
+    } else if (line.startsWith('EDGE:')) {
+      // EDGE:<i>:address=..,sends=..,first=..,errors=..,p50_us=..,p95_us=..
+      log(`  Edge ${line.slice('EDGE:'.length)}`);
+    } else if (line.startsWith('QUEUE:')) {
+      // QUEUE:market=..,orders=..,filled=..,attempts=..,first_fill_ms=.. (one per market of the job)
+      if (slugs.length > 1) log(`  Market queue: ${line.slice('QUEUE:'.length)}`);
+    } else if (line.startsWith('CONNECTIONS:')) {
+      // CONNECTIONS:reused=..,new=..,resumed=..,first_attempt_new=..,heartbeats=..
+      if (!line.includes('first_attempt_new=0,')) log(`  Cold connections: ${line.slice('CONNECTIONS:'.length)}`);
+    } else if (line.startsWith('LATENCY:')) {
+      // LATENCY:<scope>:<phase>:count=..,p50_us=..; orders vs time TTFB separates RTT from server time
+      const [, scope, phase, stats] = line.split(':');
+      // wire/wire is network + server, wire/self what the engine's own send and receive path added
+      if (phase === 'ttfb' || phase === 'total' || (scope === 'wire' && (phase === 'wire' || phase === 'self'))) {
+        log(`  Latency ${scope}/${phase}: ${stats}`);
+      }
+    }
+  };
+
+  const collectResults = (): OrderResult[] => {
+    // Attempts went to the shared-memory ring instead of stdout
+    if (ringPath) {
+      const ring = new AttemptRingReader(ringPath);
+      for (const record of ring.poll()) {
+        latencyRecords[record.orderIndex]?.push({
+          latencyMs: record.latencyMs,
+          success: record.success,
+          attempt: record.attempt,
+          orderId: record.success ? record.message : undefined,
+        });
+      }
+      ring.close();
+    }
+    return latencyRecords.map(buildOrderResult);
+  };
+
+  if (CPP_MODE.DAEMON.ENABLED) {
+    let daemon: EngineDaemon | undefined;
+    try {
+      daemon = await getEngineDaemon(walletAddress);
+    } catch (err: any) {
+      log(`  Engine daemon unavailable (${err.message}), spawning a one-shot engine`);
+      engineDaemon = undefined;
+    }
+    if (daemon) {
+      try {
+        await daemon.submit(job, handleLine);
+      } catch (err: any) {
+        // Partial results still count; the next slot starts a fresh daemon
+        log(`  Engine daemon job failed: ${err.message}`);
+        await daemon.stop();
+        engineDaemon = undefined;
+      }
+      return collectResults();
+    }
+  }
 
+  return new Promise((resolve, reject) => {
     const cpp = spawn(CPP_BINARY, [], {
       stdio: ['pipe', 'pipe', 'pipe'],
     });
 
     // Send config via stdin
-    cpp.stdin.write(JSON.stringify(cppConfig));
+    cpp.stdin.write(JSON.stringify({ ...engineTransportConfig(walletAddress), ...job }));
     cpp.stdin.end();
 
-    let stdout = '';
     let stderr = '';
-
-    const latencyRecords: { latencyMs: number; success: boolean; attempt: number; orderId?: string }[] = [];
-    let attemptCounter = 0;
+    let pending = '';
 
     cpp.stdout.on('data', (data) => {
-      const text = data.toString();
-      const lines = text.split('\n');
+      // Lines may be split across chunks
+      pending += data.toString();
+      const lines = pending.split('\n');
+      pending = lines.pop() || '';
       for (const line of lines) {
-        if (!line.trim()) continue;
-
-        stdout += line + '\n';
-
-        // Parse output
-        if (line.startsWith('ATTEMPT:')) {
-          const parts = line.split(':');
-          const orderIdx = parseInt(parts[1]);
-          const attemptNum = parseInt(parts[2]);
-          const latency = parseInt(parts[3]);
-          const success = parts[4] === 'true';
-          const message = parts.slice(5).join(':');
-
-          attemptCounter++;
-          latencyRecords.push({ latencyMs: latency, success, attempt: attemptCounter, orderId: success ? message : undefined });
-        } else if (line.startsWith('WARMUP:')) {
-          const warmup = parseInt(line.split(':')[1]);
-          log(`  [Order ${orderIndex}] TLS warm-up: ${warmup}ms`);
-        } else if (line.startsWith('SUCCESS:')) {
-          const parts = line.split(':');
-          const orderId = parts.slice(2).join(':');
-          log(`  [Order ${orderIndex}] SUCCESS! Order: ${orderId.slice(0, 20)}...`);
-        } else if (line.startsWith('FAILED:')) {
-          log(`  [Order ${orderIndex}] Failed: ${line.split(':')[1]}`);
-        }
+        if (line.trim()) handleLine(line);
       }
     });
 
@@ -364,72 +709,35 @@ async function spawnCppSpammer(
     });
 
     cpp.on('close', (code) => {
-      // Calculate result stats
-      const totalAttempts = latencyRecords.length;
-      const successRecords = latencyRecords.filter(r => r.success);
-      const successCount = successRecords.length;
-      const firstSuccessAttempt = successRecords.length > 0
-        ? Math.min(...successRecords.map(r => r.attempt))
-        : 0;
-
-      let minMs = 0, maxMs = 0, avgMs = 0, medianMs = 0;
-      if (latencyRecords.length > 0) {
-        const latencies = latencyRecords.map(r => r.latencyMs);
-        const sorted = [...latencies].sort((a, b) => a - b);
-        minMs = sorted[0];
-        maxMs = sorted[sorted.length - 1];
-        avgMs = Math.round(latencies.reduce((a, b) => a + b, 0) / latencies.length);
-        medianMs = sorted[Math.floor(sorted.length / 2)];
-      }
-
-      const successRecord = successRecords[0];
-      const lastRecord = latencyRecords[latencyRecords.length - 1];
-
-      const result: OrderResult = {
-        success: successCount > 0,
-        orderId: successRecord?.orderId,
-        latencyMs: (successRecord || lastRecord)?.latencyMs || 0,
-        attempt: attemptCounter,
-        totalAttempts,
-        successCount,
-        firstSuccessAttempt,
-        minMs,
-        maxMs,
-        avgMs,
-        medianMs,
-      };
-
-      if (code === 0) {
-        resolve(result);
-      } else {
-        resolve(result); // Still resolve with partial data
+      if (pending.trim()) handleLine(pending);
+      if (code !== 0 && stderr.trim()) {
+        log(`  C++ engine exited with code ${code}: ${stderr.trim()}`);
       }
+      // Still resolve with partial data on non-zero exit
+      resolve(collectResults());
     });
 
     cpp.on('error', (err) => {
-      log(`  [Order ${orderIndex}] ERROR: Failed to spawn C++ binary: ${err.message}`);
+      log(`  ERROR: Failed to spawn C++ binary: ${err.message}`);
       reject(err);
     });
   });
 }
 
 /**
- * Spam all 10 orders in parallel
+ * Spam all orders in parallel from a single C++ engine
  */
 async function spamAllOrders(
   signedOrders: SignedOrderInfo[],
-  walletAddress: string
+  walletAddress: string,
+  fireAtMs?: number
 ): Promise<void> {
   log('');
-  log('--- Spawning 10 C++ processes for spam ---');
+  log(`--- Starting C++ engine for ${signedOrders.length} orders ---`);
 
   const spamStart = Date.now();
 
-  const processes = signedOrders.map((orderInfo, idx) =>
-    spawnCppSpammer(orderInfo, idx, walletAddress)
-  );
-
-  const results = await Promise.all(processes);
+  const results = await spawnCppEngine(signedOrders, walletAddress, fireAtMs);
 
   const spamElapsed = Math.round((Date.now() - spamStart) / 1000 * 10) / 10;
 
@@ -438,58 +746,33 @@ async function spamAllOrders(
   log('RESULTS:');
   log('='.repeat(60));
   log(`  Total time: ${spamElapsed}s`);
-  log(`  Processes: ${results.length}`);
+  log(`  Orders: ${results.length}`);
 
-  // Write all results to CSV
+  // Write all results to CSV (one append; every attempt is in the engine's attempt log)
+  const multiMarket = signedOrders.some((orderInfo) => orderInfo.slug !== signedOrders[0].slug);
+  fs.appendFileSync(LATENCY_LOG_FILE, results.map((result, idx) => orderResultRow(idx, signedOrders[idx], result)).join(''));
   results.forEach((result, idx) => {
-    writeOrderResult(idx, signedOrders[idx], result);
     const status = result.success ? 'SUCCESS' : 'FAILED';
     const sideLabel = signedOrders[idx].side === 'YES' ? 'UP' : 'DOWN';
-    log(`  [${idx}] ${sideLabel} @ ${signedOrders[idx].price}: ${status} (${result.avgMs}ms avg)`);
+    const market = multiMarket ? `${signedOrders[idx].slug} ` : '';
+    log(`  [${idx}] ${market}${sideLabel} @ ${signedOrders[idx].price}: ${status} (${result.avgMs}ms avg)`);
   });
 
   const successCount = results.filter(r => r.success).length;
   log(`  Success rate: ${successCount}/${results.length} (${Math.round(successCount / results.length * 100)}%)`);
   log(`Results written to: ${LATENCY_LOG_FILE}`);
+  if (CPP_MODE.ATTEMPT_LOG) log(`Attempts appended to: ${ATTEMPT_LOG_FILE} (npm run attempt-log -- stats)`);
   log('='.repeat(60));
 }
 
 /**
- * Run bot for single market
+ * Phase 1: poll until the market is listed (with retry); throws when it never shows up
  */
-async function runMarket(slug: string, marketTimestamp: number, pattern: string, tradingService: TradingService, walletAddress: string) {
-  // Initialize latency logging
-  initLatencyLog();
-
-  // Set global state for logging
-  currentMarketTime = marketTimestamp;
-  currentSlug = slug;
-  acceptingOrdersTimestamp = undefined;
-
-  log(`=`.repeat(60));
-  log(`UPDOWN BOT C++: ${slug}`);
-  log(`Market time: ${new Date(marketTimestamp * 1000).toLocaleString('ru-RU')}`);
-  log(`CSV log: ${LATENCY_LOG_FILE}`);
-  log(`C++ binary: ${CPP_BINARY}`);
-  log(`=`.repeat(60));
-
-  // Check if C++ binary exists
-  if (!fs.existsSync(CPP_BINARY)) {
-    log('ERROR: C++ binary not found. Run: npm run build:updown-bot');
-    process.exit(1);
-  }
-
-  log(`Wallet address: ${walletAddress}`);
-  log(`Funder address: ${tradingConfig.funder}`);
-
-  // ===== PHASE 1: Polling for market (with retry) =====
-  log('');
-  log('--- PHASE 1: Polling for market ---');
-
+async function pollForMarket(slug: string): Promise<MarketTokens> {
   const MAX_RETRIES = 2;
   const POLL_TIMEOUT_PER_RETRY = 18 * 60 * 1000; // 18 minutes
 
-  let market: { yesTokenId: string; noTokenId: string; acceptingOrdersTimestamp?: string } | null = null;
+  let market: MarketTokens | null = null;
 
   for (let retryAttempt = 1; retryAttempt <= MAX_RETRIES && !market; retryAttempt++) {
     if (retryAttempt > 1) {
@@ -509,25 +792,23 @@ async function runMarket(slug: string, marketTimestamp: number, pattern: string,
         break; // Break inner loop, continue with next retry
       }
 
-      market = await fetchMarketBySlug(slug);
+      market = await lookupMarket(slug);
 
       if (market) {
         const pollElapsed = Math.round((Date.now() - pollStart) / 1000);
-        log(`Market found! (${pollCount} polls, ${pollElapsed}s, attempt ${retryAttempt})`);
+        log(`Market found: ${slug} (${pollCount} polls, ${pollElapsed}s, attempt ${retryAttempt}${market.cached ? ', daemon prefetch' : ''})`);
         log(`YES Token: ${market.yesTokenId.slice(0, 20)}...`);
         log(`NO Token: ${market.noTokenId.slice(0, 20)}...`);
 
-        // Save acceptingOrdersTimestamp
-        acceptingOrdersTimestamp = market.acceptingOrdersTimestamp;
-        if (acceptingOrdersTimestamp) {
-          log(`Accepting orders since: ${new Date(acceptingOrdersTimestamp).toLocaleString('ru-RU')}`);
+        if (market.acceptingOrdersTimestamp) {
+          log(`Accepting orders since: ${new Date(market.acceptingOrdersTimestamp).toLocaleString('ru-RU')}`);
         } else {
           log(`Accepting orders: not yet (orderbook inactive)`);
         }
       } else {
         if (pollCount % 100 === 0) {
           const elapsed = Math.round((Date.now() - pollStart) / 1000);
-          log(`Polling... ${pollCount} requests, ${elapsed}s (attempt ${retryAttempt}/${MAX_RETRIES})`);
+          log(`Polling ${slug}... ${pollCount} requests, ${elapsed}s (attempt ${retryAttempt}/${MAX_RETRIES})`);
         }
         await new Promise(r => setTimeout(r, POLL_INTERVAL_MS));
       }
@@ -538,20 +819,25 @@ async function runMarket(slug: string, marketTimestamp: number, pattern: string,
   if (!market) {
     throw new Error(`Market not found after ${MAX_RETRIES} attempts (${MAX_RETRIES * 18} minutes total): ${slug}`);
   }
+  return market;
+}
 
-  // ===== PHASE 2: Pre-sign all 10 orders =====
-  log('');
-  log('--- PHASE 2: Pre-signing orders ---');
-
-  const signStart = performance.now();
-  const signedOrders = await preSignOrders(
-    tradingService,
-    market.yesTokenId,
-    market.noTokenId,
-    marketTimestamp
-  );
-  const signTime = Math.round(performance.now() - signStart);
-  log(`Pre-signing took: ${signTime}ms`);
+/**
+ * Phases 3-4: when the engine fires. FIRE_MODE hands it the server-time instant
+ * (it warms up and holds until then); otherwise wait here and return undefined
+ */
+async function waitForFire(): Promise<number | undefined> {
+  if (CPP_MODE.FIRE_MODE.ENABLED) {
+    // ===== PHASE 3+4: Hand the fire instant to the engine =====
+    // The engine warms up now and releases the first send itself at
+    // server time T (timerfd + spin), instead of being spawned after a
+    // setTimeout and warming up inside the critical window.
+    await updateServerTime();
+    const fireAtMs = getServerTimeMs() + DELAY_BEFORE_SPAM_MS;
+    log('');
+    log(`--- PHASE 3: Scheduled fire at server time ${fireAtMs} (in ${DELAY_BEFORE_SPAM_MS / 1000}s), bursts ${CPP_MODE.FIRE_MODE.BURST_OFFSETS_MS.join('/')}ms ---`);
+    return fireAtMs;
+  }
 
   // ===== PHASE 3: Wait before spam =====
   log('');
@@ -562,9 +848,54 @@ async function runMarket(slug: string, marketTimestamp: number, pattern: string,
   // ===== PHASE 4: Update server time =====
   await updateServerTime();
   log(`Server time synced: ${cachedServerTime}`);
+  return undefined;
+}
+
+function checkCppBinary() {
+  if (!fs.existsSync(CPP_BINARY)) {
+    log('ERROR: C++ binary not found. Run: npm run build:updown-bot');
+    process.exit(1);
+  }
+}
+
+/**
+ * Run bot for single market
+ */
+async function runMarket(slug: string, marketTimestamp: number, pattern: string, tradingService: TradingService, walletAddress: string) {
+  // Initialize latency logging
+  initLatencyLog();
+
+  log(`=`.repeat(60));
+  log(`UPDOWN BOT C++: ${slug}`);
+  log(`Market time: ${new Date(marketTimestamp * 1000).toLocaleString('ru-RU')}`);
+  log(`CSV log: ${LATENCY_LOG_FILE}`);
+  log(`C++ binary: ${CPP_BINARY}`);
+  log(`=`.repeat(60));
+
+  checkCppBinary();
+
+  log(`Wallet address: ${walletAddress}`);
+  log(`Funder address: ${tradingConfig.funder}`);
+
+  // ===== PHASE 1: Polling for market (with retry) =====
+  log('');
+  log('--- PHASE 1: Polling for market ---');
 
-  // ===== PHASE 5: Spawn 10 C++ processes =====
-  await spamAllOrders(signedOrders, walletAddress);
+  const market = await pollForMarket(slug);
+
+  // ===== PHASE 2: Pre-sign all 10 orders =====
+  log('');
+  log('--- PHASE 2: Pre-signing orders ---');
+
+  const signStart = performance.now();
+  const signedOrders = await preSignOrders(tradingService, slug, market, marketTimestamp);
+  const signTime = Math.round(performance.now() - signStart);
+  log(`Pre-signing took: ${signTime}ms`);
+
+  const fireAtMs = await waitForFire();
+
+  // ===== PHASE 5: Run C++ engine for all orders =====
+  await spamAllOrders(signedOrders, walletAddress, fireAtMs);
 
   // ===== PHASE 6: Save state after successful completion =====
   log('');
@@ -572,6 +903,74 @@ async function runMarket(slug: string, marketTimestamp: number, pattern: string,
   saveLastProcessedTimestamp(pattern, marketTimestamp);
 }
 
+/**
+ * Phases 1-2 of a pipelined slot: every MARKET_PATTERNS market, polled concurrently
+ */
+async function prepareSlot(marketTimestamp: number, tradingService: TradingService): Promise<SignedOrderInfo[]> {
+  const slugs = BOT_CONFIG.MARKET_PATTERNS.map((pattern) => `${pattern}-${marketTimestamp}`);
+
+  log('');
+  log(`--- PHASE 1: Polling for ${slugs.length} markets ---`);
+  const markets = await Promise.allSettled(slugs.map((slug) => pollForMarket(slug)));
+
+  log('');
+  log('--- PHASE 2: Pre-signing orders ---');
+  const signStart = performance.now();
+  const signedOrders: SignedOrderInfo[] = [];
+  for (let i = 0; i < slugs.length; i++) {
+    const market = markets[i];
+    if (market.status === 'rejected') {
+      log(`Skipping ${slugs[i]}: ${market.reason?.message ?? market.reason}`);
+      continue;
+    }
+    signedOrders.push(...await preSignOrders(tradingService, slugs[i], market.value, marketTimestamp));
+  }
+  if (signedOrders.length === 0) throw new Error(`No market of slot ${marketTimestamp} was listed`);
+  log(`Pre-signing took: ${Math.round(performance.now() - signStart)}ms`);
+  return signedOrders;
+}
+
+/**
+ * Multi-asset pipeline (`all-AUTO`): every MARKET_PATTERNS market of a slot goes
+ * into one daemon job, so their ladders share one warm pool and one rate budget
+ * (the engine launches round robin over the markets, QUEUE: line per market).
+ * A slot's job is queued on the daemon and the loop moves on: slot N+1's markets
+ * are polled and its orders signed while slot N still fires, and its job waits
+ * in the daemon's queue behind N's. At most PIPELINE_DEPTH slots are in the
+ * daemon at once. Markets still unlisted after Phase 1's retries are left out
+ * of their slot.
+ */
+async function runPipeline(firstTimestamp: number, tradingService: TradingService, walletAddress: string) {
+  initLatencyLog();
+  checkCppBinary();
+
+  const firing: Promise<void>[] = [];
+  for (let marketTimestamp = firstTimestamp; ; marketTimestamp += INTERVAL_SECONDS) {
+    // Slot N-1 has to be done before N+1 joins the queue
+    if (firing.length >= PIPELINE_DEPTH) await firing.shift();
+
+    log(`\n${'='.repeat(60)}`);
+    log(`Processing slot: ${BOT_CONFIG.MARKET_PATTERNS.join(', ')} at ${new Date(marketTimestamp * 1000).toLocaleString('ru-RU')}`);
+    log(`${'='.repeat(60)}`);
+
+    try {
+      const signedOrders = await prepareSlot(marketTimestamp, tradingService);
+      const fireAtMs = await waitForFire();
+      const slotTimestamp = marketTimestamp;
+      firing.push(spamAllOrders(signedOrders, walletAddress, fireAtMs)
+        .catch((err: any) => log(`Error running slot ${slotTimestamp}: ${err.message}`))
+        .finally(() => saveLastProcessedTimestamp(ALL_MARKETS, slotTimestamp)));
+    } catch (err: any) {
+      log(`Error preparing slot: ${err.message}`);
+      log(`Saving state and moving to next slot...`);
+      saveLastProcessedTimestamp(ALL_MARKETS, marketTimestamp);
+    }
+
+    log(`\nNext slot at ${new Date((marketTimestamp + INTERVAL_SECONDS) * 1000).toLocaleString('ru-RU')}`);
+    await new Promise(r => setTimeout(r, 1000));
+  }
+}
+
 // Main
 async function main() {
   const slug = process.argv[2];
@@ -579,6 +978,7 @@ async function main() {
   if (!slug) {
     console.log('Usage: npm run updown-bot <market-slug>');
     console.log('Example: npm run updown-bot btc-updown-15m-1764929700');
+    console.log('         npm run updown-bot all-AUTO (every MARKET_PATTERNS market, needs CPP_MODE.DAEMON)');
     process.exit(1);
   }
 
@@ -589,9 +989,18 @@ async function main() {
     process.exit(1);
   }
 
-  const pattern = match[1]; // e.g., "btc-updown-15m"
+  const pattern = match[1]; // e.g., "btc-updown-15m", or "all"
   let marketTimestamp: number;
 
+  // One job per slot carries every market's ladder: a warm daemon is what runs them together
+  if (pattern === ALL_MARKETS) {
+    if (!CPP_MODE.DAEMON.ENABLED) {
+      console.log('ERROR: all-<TIMESTAMP|AUTO> needs BOT_CONFIG.CPP_MODE.DAEMON.ENABLED');
+      process.exit(1);
+    }
+    daemonMaxOrders = Math.max(daemonMaxOrders, BOT_CONFIG.ORDER_CONFIG.length * 2 * BOT_CONFIG.MARKET_PATTERNS.length);
+  }
+
   // Validate config
   if (!validateTradingConfig(tradingConfig)) {
     log('ERROR: Invalid trading config. Check .env');
@@ -653,6 +1062,20 @@ async function main() {
     }
   }
 
+  // Warm the engine daemon now, so the first slot already starts on open connections
+  if (CPP_MODE.DAEMON.ENABLED) {
+    try {
+      await getEngineDaemon(walletAddress);
+    } catch (err: any) {
+      log(`Engine daemon failed to start (${err.message}); retrying at the first slot`);
+      engineDaemon = undefined;
+    }
+  }
+
+  if (pattern === ALL_MARKETS) {
+    return runPipeline(marketTimestamp, tradingService, walletAddress);
+  }
+
   // Continuous loop
   while (true) {
     const currentSlug = `${pattern}-${marketTimestamp}`;
@@ -682,7 +1105,9 @@ async function main() {
 // Handle termination
 process.on('SIGINT', () => {
   log('Shutting down...');
-  process.exit(0);
+  // The daemon also exits on its own when this process dies (PR_SET_PDEATHSIG)
+  const stopped = engineDaemon ? engineDaemon.stop() : Promise.resolve();
+  stopped.finally(() => process.exit(0));
 });
 
 main().catch(err => {
@@ -2,29 +2,91 @@
  * UpDownBot C++ - High-Speed HTTP Spam for Polymarket
  *
  * Reads config from stdin, generates HMAC signatures, spams POST requests.
- * Outputs latency stats to stdout.
+ * All orders are driven concurrently from one curl_multi event loop that
+ * shares a single pool of warm TLS connections.
+ * Outputs latency stats (per-order STATS, per-phase LATENCY percentiles) to stdout.
  *
- * Build: g++ -O3 -o dist/updown-bot-cpp src/updown-bot-cpp/updown-bot.cpp -lcurl -lssl -lcrypto
- * Usage: echo '{"body":"...","apiKey":"...","secret":"...","passphrase":"...","address":"...","orderIndex":0}' | ./updown-bot-cpp
+ * Build: g++ -O3 -pthread -o dist/updown-bot-cpp src/updown-bot-cpp/updown-bot.cpp -lcurl -lssl -lcrypto
+ * Usage: echo '{"orders":[{"body":"...","orderIndex":0},...],"apiKey":"...","secret":"...","passphrase":"...","address":"..."}' | ./updown-bot-cpp
+ *        (legacy single-order form {"body":"...","orderIndex":0,...} is still accepted)
+ *        optional "clobUrl":"https://localhost:18443","caFile":"..." point it at a mock CLOB
+ *        optional "attemptRing":"/dev/shm/..." writes attempts to a shared-memory ring instead of ATTEMPT: lines
+ *        optional "attemptLog":"attempts.bin" appends every attempt of the run to a binary log (AttemptLog);
+ *                 per order "market", "outcome", "price", "size" label its rows
+ *        optional "pinDns":false (default true), "heartbeatMs":15000 (keepalive pass while holding, 0 = off)
+ *        optional "hedgeCopies":2 sends each attempt over up to 2 edge IPs (HTTP/1.1), "hedgeDelayMs" (0 = edge p95),
+ *                 "edgeAddresses":"ip,ip" (default: the pinned addresses)
+ *        optional "batchSize":10 packs up to 10 due orders (at most MAX_BATCH_ORDERS) into one POST /orders
+ * Daemon: echo '{"daemonSocket":"/tmp/updown-bot.sock","maxOrders":40,"apiKey":...}' | ./updown-bot-cpp
+ *         then SUBMIT jobs ({"orders":[...],"fireAtMs":...}) over the socket, see runDaemon()
+ *         optional "marketPrefixes":"btc-updown-15m,eth-updown-15m" prefetches upcoming markets from
+ *                  "gammaUrl" ("marketLookahead" slots ahead, "marketPollMs"); MARKET frames read the cache
+ * Signing: with "privateKey" (and "funder", "signatureType", "chainId", "negRisk" or "exchangeAddress",
+ *          "tickSize") an order may be {"tokenId":"..","price":0.45,"size":20,"side":"BUY","expiration":..,
+ *          "orderIndex":0} instead of a pre-signed "body"; the engine signs it (EIP-712) itself.
+ *          "signOnly":true prints ORDER:<orderIndex>:<body> lines and exits without any request
+ * Profile: optional "cpus":"3" pins the engine thread ("helperCpus" the others), "fifoPriority":50 runs it
+ *          SCHED_FIFO, "lockMemory":true mlockall()s and pre-faults; SCHED: reports the critical window
+ *          optional "wireTimestamps":"software" ("hardware") splits each answered attempt at the kernel's
+ *          send/receive timestamps: WIRE:<orderIndex>:<attempt>:.. lines, LATENCY:wire:* (HTTP/1.1 only)
+ * Replay: echo '{"replay":"updown-bot-attempts.bin","replayIntervalMs":[1,2,5],"replayMaxAttempts":[500,2000],
+ *         "replayProbeIntervalMs":[5,10],"replayDelayShiftMs":[-2000,0,2000]}' | ./updown-bot-cpp
+ *         re-runs the recorded runs on a simulated clock per combination (ReplaySimulator, no connection):
+ *         REPLAY:run=.. model check per run, SWEEP:rank=.. best time to fill first
+ * Transport: optional "transport":"uring" sends order requests over io_uring (UringTransport): one persistent
+ *            HTTP/1.1 connection per pooled request, one submission per launch pass; /time stays on curl.
+ *            Not with http2, hedgeCopies, edgeAddresses or wireTimestamps; falls back to curl without io_uring
  */
 
+#include "../cpp/hmac-signer.hpp"
+#include "../cpp/request-template.hpp"
+#include "../cpp/precise-wait.hpp"
+#include "../cpp/clock-sync.hpp"
+#include "../cpp/latency-histogram.hpp"
+#include "../cpp/order-response.hpp"
+#include "../cpp/rate-controller.hpp"
+#include "../cpp/attempt-ring.hpp"
+#include "../cpp/attempt-log.hpp"
+#include "../cpp/replay-sim.hpp"
+#include "../cpp/daemon-ipc.hpp"
+#include "../cpp/connection-share.hpp"
+#include "../cpp/edge-router.hpp"
+#include "../cpp/market-discovery.hpp"
+#include "../cpp/order-signer.hpp"
+#include "../cpp/exec-profile.hpp"
+#include "../cpp/wire-timestamps.hpp"
+#include "../cpp/uring-transport.hpp"
 #include <curl/curl.h>
-#include <openssl/hmac.h>
-#include <openssl/bio.h>
-#include <openssl/evp.h>
-#include <openssl/buffer.h>
 #include <iostream>
+#include <iomanip>
 #include <sstream>
 #include <string>
 #include <chrono>
 #include <vector>
-#include <thread>
+#include <deque>
 #include <algorithm>
 #include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <atomic>
+#include <memory>
+#include <sys/prctl.h>
 
 // Configuration
 const int DEFAULT_MAX_ATTEMPTS = 500;  // Lower than test (production mode)
 const int DEFAULT_INTERVAL_MS = 1;
+const int DEFAULT_MAX_CONNECTIONS = 0;  // 0 = one connection per in-flight order
+const int DEFAULT_HTTP2_CONNECTIONS = 2;
+const int DEFAULT_HTTP2_MAX_IN_FLIGHT = 64;
+const int CLOCK_SYNC_SAMPLES = 5;       // back-to-back /time probes after warmup
+const int CLOCK_SYNC_QUIET_MS = 500;    // no /time probes this close to the first planned send
+const int DEFAULT_HEARTBEAT_MS = 15000;  // re-validate idle pool connections (daemon, holding for T)
+const int HEARTBEAT_GUARD_MS = 1500;    // no heartbeat this close to the first planned send
+const int DEFAULT_DAEMON_MAX_ORDERS = 40;
+const int DAEMON_SYNC_INTERVAL_MS = 5000;  // /time sample cadence between jobs
+const int DAEMON_DRAIN_MS = 1000;       // unsent frames still sent on exit
+const int SERVICE_WORK_GUARD_MS = 3;    // free wait a step of preparing the next job takes (one signature)
+const int MAX_BATCH_ORDERS = 15;        // orders per POST /orders the API accepts
 const char* CLOB_URL = "https://clob.polymarket.com";
 const char* ORDER_PATH = "/orders";
 
@@ -41,88 +103,6 @@ static size_t writeCallback(void* contents, size_t size, size_t nmemb, void* use
     return totalSize;
 }
 
-// Base64 decode - supports both standard and URL-safe base64
-std::string base64Decode(const std::string& input) {
-    static const std::string base64_chars =
-        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-
-    auto indexOf = [&](char c) -> int {
-        if (c == '=') return -1;
-        // Handle URL-safe base64: convert - to + and _ to /
-        if (c == '-') c = '+';
-        if (c == '_') c = '/';
-        size_t pos = base64_chars.find(c);
-        return (pos != std::string::npos) ? (int)pos : -2;
-    };
-
-    std::string output;
-    output.reserve((input.length() * 3) / 4);
-
-    int val = 0;
-    int bits = 0;
-
-    for (char c : input) {
-        if (c == '=' || c == '\n' || c == '\r' || c == ' ') continue;
-
-        int idx = indexOf(c);
-        if (idx < 0) continue;
-
-        val = (val << 6) | idx;
-        bits += 6;
-
-        if (bits >= 8) {
-            bits -= 8;
-            output.push_back(static_cast<char>((val >> bits) & 0xFF));
-        }
-    }
-
-    return output;
-}
-
-// Base64 encode
-std::string base64Encode(const unsigned char* input, int length) {
-    BIO* bio = BIO_new(BIO_s_mem());
-    BIO* b64 = BIO_new(BIO_f_base64());
-    BIO_set_flags(b64, BIO_FLAGS_BASE64_NO_NL);
-    bio = BIO_push(b64, bio);
-
-    BIO_write(bio, input, length);
-    BIO_flush(bio);
-
-    BUF_MEM* bufferPtr;
-    BIO_get_mem_ptr(bio, &bufferPtr);
-
-    std::string output(bufferPtr->data, bufferPtr->length);
-    BIO_free_all(bio);
-    return output;
-}
-
-// Generate HMAC-SHA256 signature
-std::string generateSignature(const std::string& secret, const std::string& message) {
-    // Decode base64 secret
-    std::string decodedSecret = base64Decode(secret);
-
-    // Generate HMAC
-    unsigned char hash[EVP_MAX_MD_SIZE];
-    unsigned int hashLen;
-
-    HMAC(EVP_sha256(),
-         decodedSecret.data(), decodedSecret.length(),
-         reinterpret_cast<const unsigned char*>(message.data()), message.length(),
-         hash, &hashLen);
-
-    // Encode to base64
-    std::string signature = base64Encode(hash, hashLen);
-
-    // Convert to URL-safe base64 (required by Polymarket)
-    for (char& c : signature) {
-        if (c == '+') c = '-';
-        else if (c == '/') c = '_';
-    }
-
-    return signature;
-}
-
 // Simple JSON value extractor
 std::string extractJsonString(const std::string& json, const std::string& key) {
     std::string searchKey = "\"" + key + "\"";
@@ -175,235 +155,2326 @@ int extractJsonInt(const std::string& json, const std::string& key, int defaultV
     return std::atoi(json.c_str() + numStart);
 }
 
-// Check if response indicates success (has orderID)
-bool isSuccess(const std::string& response, std::string& orderId) {
-    size_t orderIdPos = response.find("\"orderID\"");
-    if (orderIdPos == std::string::npos) {
-        orderIdPos = response.find("\"orderId\"");
+long long extractJsonInt64(const std::string& json, const std::string& key, long long defaultVal) {
+    std::string searchKey = "\"" + key + "\"";
+    size_t keyPos = json.find(searchKey);
+    if (keyPos == std::string::npos) return defaultVal;
+
+    size_t colonPos = json.find(':', keyPos);
+    if (colonPos == std::string::npos) return defaultVal;
+
+    size_t numStart = colonPos + 1;
+    while (numStart < json.length() && (json[numStart] == ' ' || json[numStart] == '\t')) numStart++;
+
+    return std::atoll(json.c_str() + numStart);
+}
+
+double extractJsonDouble(const std::string& json, const std::string& key, double defaultVal) {
+    std::string searchKey = "\"" + key + "\"";
+    size_t keyPos = json.find(searchKey);
+    if (keyPos == std::string::npos) return defaultVal;
+
+    size_t colonPos = json.find(':', keyPos);
+    if (colonPos == std::string::npos) return defaultVal;
+
+    size_t numStart = colonPos + 1;
+    while (numStart < json.length() && (json[numStart] == ' ' || json[numStart] == '\t')) numStart++;
+
+    return std::strtod(json.c_str() + numStart, nullptr);
+}
+
+// Extract integer array: "key":[-50,-20,0,5]
+std::vector<int> extractJsonIntArray(const std::string& json, const std::string& key) {
+    std::vector<int> values;
+    std::string searchKey = "\"" + key + "\"";
+    size_t keyPos = json.find(searchKey);
+    if (keyPos == std::string::npos) return values;
+
+    size_t arrayStart = json.find('[', keyPos + searchKey.length());
+    size_t arrayEnd = json.find(']', arrayStart);
+    if (arrayStart == std::string::npos || arrayEnd == std::string::npos) return values;
+
+    const char* p = json.c_str() + arrayStart + 1;
+    const char* end = json.c_str() + arrayEnd;
+    while (p < end) {
+        char* next = nullptr;
+        long v = std::strtol(p, &next, 10);
+        if (next == p) { p++; continue; }
+        values.push_back((int)v);
+        p = next;
     }
-    if (orderIdPos != std::string::npos) {
-        orderId = extractJsonString(response, "orderID");
-        if (orderId.empty()) {
-            orderId = extractJsonString(response, "orderId");
+    return values;
+}
+
+bool extractJsonBool(const std::string& json, const std::string& key, bool defaultVal) {
+    std::string searchKey = "\"" + key + "\"";
+    size_t keyPos = json.find(searchKey);
+    if (keyPos == std::string::npos) return defaultVal;
+
+    size_t colonPos = json.find(':', keyPos);
+    if (colonPos == std::string::npos) return defaultVal;
+
+    size_t valueStart = colonPos + 1;
+    while (valueStart < json.length() && (json[valueStart] == ' ' || json[valueStart] == '\t')) valueStart++;
+
+    if (json.compare(valueStart, 4, "true") == 0) return true;
+    if (json.compare(valueStart, 5, "false") == 0) return false;
+    return std::atoi(json.c_str() + valueStart) != 0;
+}
+
+// Extract raw JSON objects from an array field: "key":[{...},{...}]
+std::vector<std::string> extractJsonObjectArray(const std::string& json, const std::string& key) {
+    std::vector<std::string> objects;
+    std::string searchKey = "\"" + key + "\"";
+    size_t keyPos = json.find(searchKey);
+    if (keyPos == std::string::npos) return objects;
+
+    size_t arrayStart = json.find('[', keyPos + searchKey.length());
+    if (arrayStart == std::string::npos) return objects;
+
+    int depth = 0;
+    bool inString = false;
+    size_t objectStart = 0;
+
+    for (size_t i = arrayStart + 1; i < json.length(); i++) {
+        char c = json[i];
+        if (inString) {
+            if (c == '\\') i++;
+            else if (c == '"') inString = false;
+            continue;
+        }
+        if (c == '"') {
+            inString = true;
+        } else if (c == '{') {
+            if (depth == 0) objectStart = i;
+            depth++;
+        } else if (c == '}') {
+            depth--;
+            if (depth == 0) objects.push_back(json.substr(objectStart, i - objectStart + 1));
+        } else if (c == ']' && depth == 0) {
+            break;
         }
-        return !orderId.empty();
     }
-    return false;
+    return objects;
 }
 
-// Extract error message from response
-std::string extractError(const std::string& response) {
-    std::string error = extractJsonString(response, "error");
-    if (error.empty()) {
-        error = extractJsonString(response, "errorMsg");
-    }
-    if (error.empty()) {
-        error = extractJsonString(response, "message");
+// Strip quotes from /time response body.
+// Returns "" unless the result fits the fixed-width POLY_TIMESTAMP slot.
+std::string parseServerTime(const std::string& data) {
+    std::string time = data;
+    if (!time.empty() && time[0] == '"') {
+        time = time.substr(1, time.length() - 2);
     }
-    if (error.empty() && !response.empty()) {
-        error = response.substr(0, std::min(response.length(), (size_t)100));
+    if (time.length() != RequestTemplate::TIMESTAMP_LEN) return "";
+    return time;
+}
+
+// Transport settings for the engine
+struct TransportConfig {
+    std::string baseUrl = CLOB_URL;
+    std::string caFile;                            // extra CA bundle (self-signed mock server)
+    bool http2 = false;
+    int maxConnections = DEFAULT_MAX_CONNECTIONS;  // K warm connections (0 = one per in-flight request)
+    int maxInFlight = 0;                           // cap on concurrent requests/streams
+    bool pinDns = true;                            // resolve once, CURLOPT_RESOLVE on every handle
+    int heartbeatMs = DEFAULT_HEARTBEAT_MS;        // keepalive pass over idle connections (0 = off)
+    int hedgeCopies = 1;                           // sends per regular attempt over distinct edges (1 = off)
+    int hedgeDelayMs = 0;                          // between a hedged attempt's sends; 0 = the edge's p95 latency
+    std::string edgeAddresses;                     // "ip,ip" edges to bind; empty = pinned IPv4 addresses when hedging
+    int batchSize = 1;                             // orders per POST /orders (1 = one request per order)
+    WireTimestamps::Mode wireTimestamps = WireTimestamps::OFF;  // SO_TIMESTAMPING on every connection
+    bool uring = false;                            // order requests over UringTransport instead of curl_multi
+};
+
+// Apply connection/performance options shared by all handles
+void configureHandle(CURL* curl, const TransportConfig& transport) {
+    curl_easy_setopt(curl, CURLOPT_TCP_NODELAY, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_FORBID_REUSE, 0L);
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L);
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 2L);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
+    // Idle connections stay pooled until the server closes them; the heartbeat keeps them in use
+    curl_easy_setopt(curl, CURLOPT_MAXAGE_CONN, 3600L);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
+    if (!transport.caFile.empty()) curl_easy_setopt(curl, CURLOPT_CAINFO, transport.caFile.c_str());
+
+    if (transport.http2) {
+        // Multiplex streams over already-open connections instead of opening new ones
+        curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, (long)CURL_HTTP_VERSION_2TLS);
+        curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+    } else {
+        curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, (long)CURL_HTTP_VERSION_1_1);
     }
-    return error;
 }
 
-// Fetch server time from CLOB API
-std::string fetchServerTime(CURL* curl) {
-    std::string timeUrl = std::string(CLOB_URL) + "/time";
+// Prepare GET /time on a handle (used for TLS warmup and clock sync)
+void prepareTimeRequest(CURL* curl, const std::string& timeUrl, ResponseBuffer& response) {
+    response.data.clear();
     curl_easy_setopt(curl, CURLOPT_URL, timeUrl.c_str());
     curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
     curl_easy_setopt(curl, CURLOPT_HTTPHEADER, nullptr);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
+}
 
-    ResponseBuffer buf;
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &buf);
-
-    CURLcode res = curl_easy_perform(curl);
-    if (res != CURLE_OK) {
-        return "";
+// Feed a completed GET /time into the clock estimator. Send/receive instants
+// are bracketed conservatively from curl's transfer timings: the transfer
+// started no earlier than addedRawNs and finished no later than now.
+bool addTimeSample(ClockSync& clock, CURL* curl, const ResponseBuffer& response, int64_t addedRawNs) {
+    std::string serverSec = parseServerTime(response.data);
+    if (serverSec.empty()) return false;
+
+    curl_off_t pretransferUs = 0;
+    curl_off_t startTransferUs = 0;
+    curl_off_t totalUs = 0;
+    curl_easy_getinfo(curl, CURLINFO_PRETRANSFER_TIME_T, &pretransferUs);
+    curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME_T, &startTransferUs);
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &totalUs);
+
+    int64_t doneRawNs = ClockSync::rawNowNs();
+    int64_t sendRawNs = addedRawNs + (int64_t)pretransferUs * 1000;
+    int64_t recvRawNs = doneRawNs - (int64_t)(totalUs - startTransferUs) * 1000;
+    if (recvRawNs < sendRawNs) {
+        sendRawNs = addedRawNs;
+        recvRawNs = doneRawNs;
     }
+    clock.addSample(sendRawNs, recvRawNs, std::atoll(serverSec.c_str()));
+    return true;
+}
 
-    // Remove quotes if present
-    std::string time = buf.data;
-    if (!time.empty() && time[0] == '"') {
-        time = time.substr(1, time.length() - 2);
+// API credentials shared by all orders
+struct Credentials {
+    std::string apiKey;
+    std::string secret;
+    std::string passphrase;
+    std::string address;
+};
+
+// Native signing ("privateKey" in the stdin config): orders given as parameters are signed here
+struct OrderSigning {
+    OrderSigner signer;
+    OrderSigner::RoundConfig round;    // from "tickSize"
+    std::string owner;                 // the body's "owner": the API key
+};
+
+using Clock = std::chrono::steady_clock;
+
+// Engine settings parsed from stdin config
+struct EngineConfig {
+    int maxAttempts = DEFAULT_MAX_ATTEMPTS;
+    int intervalMs = DEFAULT_INTERVAL_MS;
+    int probeIntervalMs = DEFAULT_INTERVAL_MS;  // per-order pacing until any order sees the window open
+    TransportConfig transport;
+    long long fireAtMs = 0;            // server-time instant (unix ms) of the first send; 0 = immediately
+    std::vector<int> burstOffsetsMs;   // planned sends relative to fireAtMs, e.g. -50,-20,0,5
+    long long expectedOpenMs = 0;      // server-time instant the orderbook should open (rate ramp); 0 = fireAtMs
+    std::string attemptRing;           // ring file for per-attempt records; empty = ATTEMPT: lines
+    std::string attemptLog;            // binary log the run is appended to; empty = off
+};
+
+// Per-order state driven by the multi engine
+struct OrderSlot {
+    int orderIndex = 0;
+    std::string body;
+    size_t itemStart = 0;              // the order object(s) inside body's [ ], joined into batch bodies
+    size_t itemLength = 0;
+    std::string group;                 // orders sharing a group stop once one of them fills
+    std::string market;                // queue it is launched from (e.g. its market's slug); one pool and rate budget for all
+    std::string outcome;               // attempt log labels ("outcome", "price", "size" of the order)
+    double price = 0;
+    double size = 0;
+    std::vector<long long> plan;  // scheduled (burst) sends, server unix ms, ascending
+    size_t planIndex = 0;
+    Clock::time_point nextSendAt;
+    int attempts = 0;
+    int inFlight = 0;
+    bool done = false;
+    bool success = false;
+    bool groupFilled = false;          // stopped because another order of its group filled
+    Clock::time_point filledAt;
+    // Hedged attempt waiting for its first answer: attempt number of its first send,
+    // sends and in-flight sends so far, edges used (bit per edge), when the next copy is due
+    bool hedgeLive = false;
+    int hedgeAttempt = 0;
+    int hedgeSent = 0;
+    int hedgeInFlight = 0;
+    uint32_t hedgeEdges = 0;
+    Clock::time_point hedgeStartedAt;
+    Clock::time_point hedgeNextAt;
+    int stragglers = 0;                // hedged sends still in flight after their attempt was answered
+    std::string orderId;
+    std::vector<long> latencies;
+};
+
+// Body part of an order that is joined into batch bodies: the body without its enclosing [ ]
+void findBatchItem(OrderSlot& slot) {
+    const char* space = " \t\r\n";
+    const std::string& body = slot.body;
+    size_t start = body.find_first_not_of(space);
+    size_t end = body.find_last_not_of(space);
+    if (start == std::string::npos) return;
+    if (body[start] == '[' && body[end] == ']' && end > start) {
+        start = body.find_first_not_of(space, start + 1);
+        end = body.find_last_not_of(space, end - 1);
     }
-    return time;
+    slot.itemStart = start;
+    slot.itemLength = end >= start ? end - start + 1 : 0;
 }
 
-// Perform POST request with authentication
-CURLcode postOrder(CURL* curl, const std::string& body,
-                   const std::string& apiKey, const std::string& secret,
-                   const std::string& passphrase, const std::string& address,
-                   const std::string& timestamp, ResponseBuffer& response) {
-
-    std::string orderUrl = std::string(CLOB_URL) + ORDER_PATH;
+// One in-flight request (HTTP/1.1 transfer or HTTP/2 stream), pooled and reused.
+// Each pooled handle owns its own pre-serialized template so concurrent streams
+// never share patched header slots.
+struct Request {
+    struct BatchItem {
+        OrderSlot* slot;
+        int attempt;
+    };
 
-    // Generate signature: timestamp + method + path + body
-    std::string message = timestamp + "POST" + ORDER_PATH + body;
-    std::string signature = generateSignature(secret, message);
+    CURL* curl = nullptr;
+    std::unique_ptr<RequestTemplate> tmpl;
+    OrderResponseParser response;      // parsed as it arrives, buffer reused
+    ResponseBuffer warmup;             // GET /time during TLS warmup
+    OrderSlot* slot = nullptr;         // the order (a batch's first order)
+    int attempt = 0;
+    BatchItem batch[MAX_BATCH_ORDERS];  // orders of a batch POST and their attempt numbers
+    int batchCount = 0;                // 0 = single-order request
+    std::string batchBody;             // "[item,item,..]", capacity kept across sends
+    Clock::time_point sentAt;
+    int64_t sentRealNs = 0;            // sentAt on CLOCK_REALTIME, with wire timestamps
+    int64_t firstByteUs = 0;           // first response header, PhaseHistograms::nowUs()
+    ConnectionInfo conn;
+    int edge = 0;                      // EdgeRouter edge this handle connects to
+    int hedgeOf = 0;                   // attempt number of the hedged attempt this send belongs to (0 = not hedged)
+    bool hedgeCopy = false;            // a hedged attempt's second or later send
+    bool planned = false;              // released by the fire schedule
+    int plannedOffsetMs = 0;
+    Clock::time_point plannedAt;
+
+    int orders() const { return batchCount > 0 ? batchCount : 1; }
+    OrderSlot& orderSlot(int i) const { return batchCount > 0 ? *batch[i].slot : *slot; }
+    int orderAttempt(int i) const { return batchCount > 0 ? batch[i].attempt : attempt; }
+};
 
-    // Set URL
-    curl_easy_setopt(curl, CURLOPT_URL, orderUrl.c_str());
+static_assert(MAX_BATCH_ORDERS <= (int)OrderResponseParser::MAX_ITEMS, "batch results must fit the parser");
+
+// Patch timestamp/signature slots and point the handle at the order (or batch) body.
+// No heap allocations: URL and headers were applied once at startup.
+void prepareOrderRequest(Request& req, const HmacSigner& signer, const char* timestamp) {
+    const std::string& body = req.batchCount > 0 ? req.batchBody : req.slot->body;
+    req.tmpl->patch(signer, timestamp, RequestTemplate::TIMESTAMP_LEN, body.data(), body.length());
+    RequestTemplate::setBody(req.curl, body);
+    req.response.reset();
+    req.firstByteUs = 0;
+    req.conn.reset();
+}
 
-    // Set POST
-    curl_easy_setopt(curl, CURLOPT_POST, 1L);
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.c_str());
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, body.length());
+// Print per-order latency stats
+void printStats(std::ostream& out, const OrderSlot& slot) {
+    if (slot.latencies.empty()) return;
 
-    // Build headers
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-    headers = curl_slist_append(headers, ("POLY_ADDRESS: " + address).c_str());
-    headers = curl_slist_append(headers, ("POLY_SIGNATURE: " + signature).c_str());
-    headers = curl_slist_append(headers, ("POLY_TIMESTAMP: " + timestamp).c_str());
-    headers = curl_slist_append(headers, ("POLY_API_KEY: " + apiKey).c_str());
-    headers = curl_slist_append(headers, ("POLY_PASSPHRASE: " + passphrase).c_str());
+    std::vector<long> sorted = slot.latencies;
+    std::sort(sorted.begin(), sorted.end());
 
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
+    long sum = 0;
+    for (long l : slot.latencies) sum += l;
 
-    CURLcode res = curl_easy_perform(curl);
+    long minL = sorted.front();
+    long maxL = sorted.back();
+    long avg = sum / slot.latencies.size();
+    long median = sorted[sorted.size() / 2];
 
-    curl_slist_free_all(headers);
-    return res;
+    out << "STATS:" << slot.orderIndex << ":min=" << minL << ",max=" << maxL << ",avg=" << avg
+        << ",median=" << median << ",total=" << slot.latencies.size() << std::endl;
 }
 
-int main() {
-    // Read JSON config from stdin
-    std::stringstream buffer;
-    buffer << std::cin.rdbuf();
-    std::string inputJson = buffer.str();
+/**
+ * SpamEngine - one curl_multi driving all orders over a shared, pre-warmed pool
+ *
+ * start(): curl init, request handle pool, concurrent TLS warmup via GET /time,
+ *          initial server clock sync
+ * run():   event loop until every order filled or exhausted maxAttempts and
+ *          the requests still out for them are in
+ *
+ * Without a fire schedule every order starts immediately and is paced by
+ * intervalMs. With fireAtMs the engine keeps its warm pool idle until the
+ * planned server-time instants and releases each burst send with
+ * PreciseWaiter (timerfd + spin), reporting the actual deviation per send.
+ *
+ * Responses are shared market signals fed to one RateController: the
+ * first one showing the orderbook open switches every order from
+ * probeIntervalMs to intervalMs, 429s cut the global rate and in-flight
+ * window (AIMD), a fill stops the order's group (its requests already sent run
+ * on: a late fill still reports SUCCESS). The controller also ramps
+ * the rate up towards the expected open time (expectedOpenMs / fireAtMs).
+ *
+ * With hedgeCopies > 1 the pool's handles are bound to the host's edge IPs
+ * (EdgeRouter) and every send goes to the fastest edge with a free handle.
+ * Over HTTP/1.1 an attempt still unanswered after its edge's p95 latency
+ * is sent again over the next-fastest edge; the first answer settles it and
+ * re-arms the order's pacing, the other sends finish as "late" answers
+ * (cancelling would close their warm connections, and a late fill must
+ * still be seen).
+ *
+ * With batchSize > 1 the orders due at the same moment go out together: up
+ * to batchSize order objects joined into one signed POST /orders body, one
+ * rate token and one in-flight slot per batch. The response array is split
+ * per order (OrderResponseParser::item); filled orders drop out, rejected
+ * ones are due again after the interval and ride the next batch. Hedging
+ * is off in batch mode.
+ *
+ * POLY_TIMESTAMP and the fire schedule come from ClockSync. While idle before
+ * the fire instant the engine keeps probing /time (aimed at second
+ * boundaries); from CLOCK_SYNC_QUIET_MS before the first send onwards there
+ * is no /time traffic at all.
+ */
+class SpamEngine {
+public:
+    SpamEngine(const Credentials& creds, const EngineConfig& config)
+        : creds_(creds), config_(config), signer_(creds.secret),
+          timeUrl_(config.transport.baseUrl + "/time") {}
+
+    ~SpamEngine() {
+        for (auto& req : requests_) {
+            if (req.slot) curl_multi_remove_handle(multi_, req.curl);
+            if (req.curl) curl_easy_cleanup(req.curl);
+        }
+        if (timeInFlight_) curl_multi_remove_handle(multi_, timeCurl_);
+        if (timeCurl_) curl_easy_cleanup(timeCurl_);
+        if (multi_) curl_multi_cleanup(multi_);
+    }
 
-    if (inputJson.empty()) {
-        std::cerr << "ERROR: No input JSON provided via stdin" << std::endl;
-        return 1;
+    SpamEngine(const SpamEngine&) = delete;
+    SpamEngine& operator=(const SpamEngine&) = delete;
+
+    // orderCount/burstCount size the pool: the most orders and burst sends per order a run will have
+    bool start(size_t orderCount, size_t burstCount) {
+        TransportConfig& transport = config_.transport;
+
+        // HTTP/1.1: one request in flight per order (next attempt waits for the response),
+        // plus one extra handle per burst send that may overlap and per hedged copy.
+        // HTTP/2: each order fires every intervalMs, bounded by the global in-flight cap.
+        // Batch mode: the same per batch of orders instead of per order.
+        transport.batchSize = std::min(std::max(1, transport.batchSize), MAX_BATCH_ORDERS);
+        transport.hedgeCopies = transport.batchSize > 1 ? 1 : std::max(1, transport.hedgeCopies);
+        size_t streams = batchStreams(orderCount);
+        size_t perOrder = burstCount + (size_t)(transport.hedgeCopies - 1);
+        if (transport.maxInFlight <= 0) transport.maxInFlight = (int)(streams * perOrder);
+        perOrderInFlight_ = transport.http2 ? transport.maxInFlight : 1;
+        size_t poolSize = transport.http2 ? (size_t)transport.maxInFlight
+                                          : std::min((size_t)transport.maxInFlight, streams * perOrder);
+
+        // Initialize curl: one multi handle, a pool of reusable easy handles.
+        // All easy handles share the multi's connection pool.
+        multi_ = curl_multi_init();
+        timeCurl_ = curl_easy_init();
+
+        if (!multi_ || !timeCurl_) {
+            std::cerr << "ERROR: Failed to initialize curl" << std::endl;
+            return false;
+        }
+
+        // One DNS lookup and one TLS session cache for every handle
+        if (!share_.init(transport.baseUrl, transport.pinDns)) {
+            std::cerr << "ERROR: Failed to initialize curl share" << std::endl;
+            return false;
+        }
+        initEdges();
+
+        // HTTP/2 keeps at least one warm connection per edge
+        long connectionCount = transport.maxConnections > 0 ? transport.maxConnections : (long)poolSize;
+        if (transport.http2) connectionCount = std::max(connectionCount, (long)edges_.size());
+        curl_multi_setopt(multi_, CURLMOPT_MAXCONNECTS, connectionCount + 1);
+        if (transport.maxConnections > 0) {
+            curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS, (long)transport.maxConnections);
+        }
+        if (transport.http2) {
+            long streamsPerConnection = (transport.maxInFlight + connectionCount - 1) / connectionCount;
+            curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+            curl_multi_setopt(multi_, CURLMOPT_MAX_CONCURRENT_STREAMS, streamsPerConnection + 1);
+        } else {
+            curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_NOTHING);
+        }
+
+        // Every connection is stamped: any handle may open the one an order request reuses
+        wire_.init(transport.wireTimestamps);
+        configureHandle(timeCurl_, transport);
+        share_.apply(timeCurl_);
+        wire_.track(timeCurl_);
+        PhaseHistograms::trackFirstByte(timeCurl_, &timeFirstByteUs_);
+
+        requests_ = std::vector<Request>(poolSize);
+        for (auto& req : requests_) {
+            req.curl = curl_easy_init();
+            if (!req.curl) {
+                std::cerr << "ERROR: Failed to initialize curl" << std::endl;
+                return false;
+            }
+            configureHandle(req.curl, transport);
+            share_.apply(req.curl);
+            wire_.track(req.curl);
+            curl_easy_setopt(req.curl, CURLOPT_PRIVATE, &req);
+            PhaseHistograms::trackFirstByte(req.curl, &req.firstByteUs);
+            req.conn.track(req.curl);
+            req.tmpl.reset(new RequestTemplate(transport.baseUrl, ORDER_PATH, creds_.address, creds_.apiKey, creds_.passphrase));
+            freeList_.push_back(&req);
+        }
+        bindEdges();
+
+        auto warmupStart = Clock::now();
+        // The ring opens its own connections; curl then only warms what it still carries
+        if (transport.uring) startUring();
+        warmCount_ = transport.uring ? 0 : std::min(poolSize, (size_t)connectionCount);
+        warmPool();
+        auto warmupEnd = Clock::now();
+        lastHeartbeatRawNs_ = ClockSync::rawNowNs();
+
+        // Initial clock sync over the now-warm connection
+        for (int i = 0; i < CLOCK_SYNC_SAMPLES; i++) {
+            sendTimeProbe();
+            while (timeInFlight_) {
+                perform();
+                handleCompletions();
+                if (timeInFlight_) curl_multi_poll(multi_, nullptr, 0, 100, nullptr);
+            }
+        }
+
+        if (!clock_.synced()) {
+            std::cerr << "ERROR: Failed to get server time" << std::endl;
+            return false;
+        }
+
+        auto warmupMs = std::chrono::duration_cast<std::chrono::milliseconds>(warmupEnd - warmupStart).count();
+        *out_ << "WARMUP:" << warmupMs << std::endl;
+        printDns();
+        printClock();
+        out_->flush();
+        return true;
     }
 
-    // Parse config
-    std::string body = extractJsonString(inputJson, "body");
-    std::string apiKey = extractJsonString(inputJson, "apiKey");
-    std::string secret = extractJsonString(inputJson, "secret");
-    std::string passphrase = extractJsonString(inputJson, "passphrase");
-    std::string address = extractJsonString(inputJson, "address");
-    int maxAttempts = extractJsonInt(inputJson, "maxAttempts", DEFAULT_MAX_ATTEMPTS);
-    int intervalMs = extractJsonInt(inputJson, "intervalMs", DEFAULT_INTERVAL_MS);
-    int orderIndex = extractJsonInt(inputJson, "orderIndex", 0);  // NEW: order index
-
-    if (body.empty() || apiKey.empty() || secret.empty() || passphrase.empty() || address.empty()) {
-        std::cerr << "ERROR: Missing required config fields" << std::endl;
-        return 1;
+    // Where protocol lines go (stdout by default)
+    void setOutput(std::ostream& out) { out_ = &out; }
+
+    // While a run waits and fd is readable (or writable with out pending), serve(context, false)
+    // is called from the engine thread (the daemon's client socket); fd -1 turns it off.
+    // While serve returns true it has background work: a wait with SERVICE_WORK_GUARD_MS
+    // to spare calls serve(context, true) for one step of it instead.
+    void setService(int fd, bool (*serve)(void*, bool), void* context, const FrameWriter* out = nullptr) {
+        serviceFd_ = fd;
+        serve_ = serve;
+        serveContext_ = context;
+        serviceOut_ = out;
+        serviceWork_ = serve != nullptr;
     }
 
-    // Initialize curl
-    curl_global_init(CURL_GLOBAL_ALL);
-    CURL* curl = curl_easy_init();
+    // Pacing/fire settings of the next run; the transport stays as started
+    void setJob(const EngineConfig& job) {
+        TransportConfig transport = config_.transport;
+        config_ = job;
+        config_.transport = transport;
+    }
 
-    if (!curl) {
-        std::cerr << "ERROR: Failed to initialize curl" << std::endl;
-        return 1;
+    // Returns true if every order was filled
+    bool run(std::vector<OrderSlot>& slots) {
+        slots_ = &slots;
+        inFlight_ = 0;
+        syncing_ = false;
+        fireDeviationsUs_.clear();
+        orderPhases_ = PhaseHistograms();
+        timePhases_ = PhaseHistograms();
+        answers_.reset();
+        connections_ = ConnectionCounts();
+        hedge_ = HedgeCounts();
+        edges_.resetCounts();
+        wireStats_.reset();
+        sent_ = false;
+
+        // Sized for every attempt of the run: the Node reader drains it after exit.
+        // Without a ring the attempts still go out as ATTEMPT: lines.
+        size_t burstCount = config_.fireAtMs > 0 ? std::max<size_t>(1, config_.burstOffsetsMs.size()) : 1;
+        if (!config_.attemptRing.empty() &&
+            !ring_.open(config_.attemptRing, slots.size() * ((uint64_t)config_.maxAttempts + burstCount))) {
+            std::cerr << "ERROR: Failed to create attempt ring " << config_.attemptRing << ": "
+                      << strerror(errno) << std::endl;
+        }
+        if (!config_.attemptLog.empty()) beginLog(slots, slots.size() * ((uint64_t)config_.maxAttempts + burstCount));
+
+        startRateController(batchStreams(slots.size()));
+        schedule(slots);
+        remaining_ = slots.size();
+
+        // Until every order reported and their last requests are in
+        while (remaining_ > 0 || draining()) {
+            launchDue();
+
+            perform();
+            // Window opens once the first request is out (no syscall ahead of it)
+            if (sent_ && !window_.active()) window_.begin();
+            handleCompletions();
+
+            if (remaining_ == 0 && !draining()) break;
+            waitForNextSend(slots);
+        }
+        window_.end(*out_);
+
+        // Calculate stats
+        bool allSuccess = true;
+        for (const auto& slot : slots) {
+            printStats(*out_, slot);
+            allSuccess = allSuccess && (slot.success || slot.groupFilled);
+        }
+        printQueues(slots);
+        // Per-phase breakdown: orders vs /time probes (time:ttfb ~ pure network RTT)
+        orderPhases_.print(*out_, "orders");
+        timePhases_.print(*out_, "time");
+        if (answers_.count() > 0) answers_.print(*out_, "attempts", "answer");
+        if (wire_.enabled()) wireStats_.print(*out_, wire_.mode());
+        printFireStats();
+        *out_ << "CONNECTIONS:reused=" << connections_.reused << ",new=" << connections_.opened
+              << ",resumed=" << connections_.resumed << ",first_attempt_new=" << connections_.firstAttemptNew
+              << ",heartbeats=" << connections_.heartbeats << std::endl;
+        if (hedging()) {
+            *out_ << "HEDGE:attempts=" << hedge_.attempts << ",copies=" << hedge_.copies
+                  << ",copy_first=" << hedge_.copyFirst << ",late=" << hedge_.late << std::endl;
+        }
+        edges_.print(*out_);
+        lastHeartbeatRawNs_ = ClockSync::rawNowNs();  // the run itself kept the pool alive
+        if (ring_.isOpen()) {
+            *out_ << "RING:records=" << ring_.written() << ",dropped=" << ring_.dropped()
+                  << ",capacity=" << ring_.capacity() << std::endl;
+            ring_.close();
+        }
+        if (log_.active()) {
+            log_.setServerOffset(serverOffsetUs());
+            if (log_.commit(config_.attemptLog)) {
+                *out_ << "LOG:records=" << log_.records() << ",dropped=" << log_.dropped()
+                      << ",bytes=" << log_.bytes() << std::endl;
+            } else {
+                std::cerr << "ERROR: Failed to write attempt log " << config_.attemptLog << ": "
+                          << strerror(errno) << std::endl;
+            }
+        }
+        out_->flush();
+        return allSuccess;
     }
 
-    // Performance optimizations
-    curl_easy_setopt(curl, CURLOPT_TCP_NODELAY, 1L);
-    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
-    curl_easy_setopt(curl, CURLOPT_FORBID_REUSE, 0L);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 2L);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
+    // Between daemon jobs: re-validate the pool every heartbeatMs (re-resolving the
+    // pinned host) and keep sampling /time every syncIntervalMs, so a job starts on
+    // warm connections and a current clock estimate. Waits on curl's sockets plus
+    // extraFds for up to timeoutMs.
+    void idle(int syncIntervalMs, struct curl_waitfd* extraFds, unsigned extraCount, int timeoutMs) {
+        int64_t heartbeatNs = config_.transport.heartbeatMs > 0 ? (int64_t)config_.transport.heartbeatMs * 1000000
+                                                                : INT64_MAX / 2;
+        int64_t nowRaw = ClockSync::rawNowNs();
+        if (nowRaw - lastHeartbeatRawNs_ >= heartbeatNs) {
+            if (share_.refresh()) {
+                for (auto& req : requests_) share_.apply(req.curl);
+                share_.apply(timeCurl_);
+                // Edges follow the pinned addresses unless they were given explicitly
+                if (edges_.size() > 0 && config_.transport.edgeAddresses.empty()) {
+                    initEdges();
+                    bindEdges();
+                }
+                printDns();
+            }
+            heartbeat();
+            nowRaw = lastHeartbeatRawNs_;
+        }
 
-    // Fetch server time for TLS warmup
-    auto warmupStart = std::chrono::high_resolution_clock::now();
-    std::string serverTime = fetchServerTime(curl);
-    auto warmupEnd = std::chrono::high_resolution_clock::now();
-    auto warmupMs = std::chrono::duration_cast<std::chrono::milliseconds>(warmupEnd - warmupStart).count();
+        if (!timeInFlight_ && nowRaw >= nextIdleSyncRawNs_) {
+            sendTimeProbe();
+            nextIdleSyncRawNs_ = clock_.nextSampleAt(nowRaw + (int64_t)syncIntervalMs * 1000000);
+        }
 
-    if (serverTime.empty()) {
-        std::cerr << "ERROR: Failed to get server time" << std::endl;
-        curl_easy_cleanup(curl);
-        curl_global_cleanup();
-        return 1;
+        perform();
+        handleCompletions();
+
+        int64_t untilSyncNs = nextIdleSyncRawNs_ - ClockSync::rawNowNs();
+        int64_t untilHeartbeatNs = lastHeartbeatRawNs_ + heartbeatNs - ClockSync::rawNowNs();
+        long long waitMs = std::min<long long>(timeoutMs, std::min(untilSyncNs, untilHeartbeatNs) / 1000000);
+        curl_multi_poll(multi_, extraFds, extraCount, (int)std::max<long long>(waitMs, 0), nullptr);
     }
 
-    std::cout << "WARMUP:" << warmupMs << std::endl;
-    std::cout.flush();
+    const ClockSync& clock() const { return clock_; }
+
+private:
+    Credentials creds_;
+    EngineConfig config_;
+    HmacSigner signer_;
+    std::string timeUrl_;
+
+    CURLM* multi_ = nullptr;
+    CURL* timeCurl_ = nullptr;
+    std::vector<Request> requests_;
+    std::vector<Request*> freeList_;
+    int perOrderInFlight_ = 1;
+    std::vector<OrderSlot>* slots_ = nullptr;
+    std::unique_ptr<RateController> rate_;
+    int inFlight_ = 0;                 // regular (unplanned) sends in flight
+    AttemptRingWriter ring_;
+    AttemptLogWriter log_;
+    size_t warmCount_ = 0;             // pool handles that warm up / re-validate a connection
+    ConnectionShare share_;            // pinned DNS + TLS sessions of every handle
+    EdgeRouter edges_;                 // per-IP binding and latency (empty unless hedging or edgeAddresses)
+    struct HedgeCounts {
+        long attempts = 0;             // regular attempts sent hedged
+        long copies = 0;               // sends beyond each attempt's first
+        long copyFirst = 0;            // attempts a copy answered first
+        long late = 0;                 // answers after their attempt was already answered
+    } hedge_;
+    WindowUsage window_;               // critical window of a run: first send to last answer
+    bool sent_ = false;
+    Clock::time_point firstSendAt_;
+    std::vector<OrderSlot*> launchOrder_;  // the markets' queues interleaved
+    size_t launchCursor_ = 0;          // where the next launch pass starts
+    int serviceFd_ = -1;
+    bool (*serve_)(void*, bool) = nullptr;
+    void* serveContext_ = nullptr;
+    bool serviceWork_ = false;         // serve_ has background work left
+    const FrameWriter* serviceOut_ = nullptr;  // its queued frames; POLLOUT while any are unsent
+    WireTimestamps wire_;              // kernel TX/RX stamps of every connection ("wireTimestamps")
+    UringTransport uring_;             // order requests on io_uring ("transport":"uring")
+    WireStats wireStats_;
+    struct ConnectionCounts {
+        long reused = 0;
+        long opened = 0;
+        long resumed = 0;              // opened with a resumed TLS session
+        long firstAttemptNew = 0;      // orders whose first attempt paid for a connection
+        long heartbeats = 0;
+    } connections_;
+    int64_t lastHeartbeatRawNs_ = ClockSync::rawNowNs();
+    int64_t nextIdleSyncRawNs_ = 0;
+    std::ostream* out_ = &std::cout;   // protocol lines: stdout, or the daemon client's socket
+
+    ClockSync clock_;
+    ResponseBuffer timeBuf_;
+    bool timeInFlight_ = false;
+    int64_t timeSentRawNs_ = 0;
+    int64_t timeFirstByteUs_ = 0;
+    bool syncing_ = false;             // background /time probes before the fire instant
+    int64_t nextSyncRawNs_ = 0;
+    long long firstPlannedMs_ = 0;
+
+    PreciseWaiter waiter_;
+    std::vector<int> burstOffsetsMs_;  // sorted fire schedule
+    size_t remaining_ = 0;
+    std::vector<long> fireDeviationsUs_;
+    PhaseHistograms orderPhases_;
+    PhaseHistograms timePhases_;
+    LatencyHistogram answers_;         // attempt's first send -> its first answer (what hedging cuts)
+
+    // curl_multi_perform, with the sockets' kernel timestamps collected first
+    // (before curl reads an answer off its socket). On the ring: submit the
+    // launch pass's sends; curl only runs while it has a /time probe.
+    void perform() {
+        if (config_.transport.uring) {
+            uring_.submit();
+            if (!timeInFlight_) return;
+        }
+        if (wire_.enabled()) wire_.collect();
+        int running = 0;
+        curl_multi_perform(multi_, &running);
+    }
 
-    // Spam loop
-    std::vector<long> latencies;
-    bool success = false;
-    int attempts = 0;
-    std::string orderId;
+    // TLS warmup: concurrent GET /time opens the pool (K connections for HTTP/2,
+    // one per handle for HTTP/1.1). PIPEWAIT is off so each one dials its own connection;
+    // on a warm pool the same probes re-validate the idle connections, and dead ones
+    // are re-dialed here rather than on the first order. Each response is also a clock sample.
+    // Returns the number of connections that had to be opened.
+    long warmPool() {
+        int64_t warmupStartRawNs = ClockSync::rawNowNs();
+        for (size_t i = 0; i < warmCount_; i++) {
+            prepareTimeRequest(requests_[i].curl, timeUrl_, requests_[i].warmup);
+            curl_easy_setopt(requests_[i].curl, CURLOPT_PIPEWAIT, 0L);
+            curl_multi_add_handle(multi_, requests_[i].curl);
+        }
+
+        long opened = 0;
+        size_t pending = warmCount_;
+        while (pending > 0) {
+            perform();
+
+            int queued = 0;
+            while (CURLMsg* msg = curl_multi_info_read(multi_, &queued)) {
+                if (msg->msg != CURLMSG_DONE) continue;
+                CURL* easy = msg->easy_handle;
+                curl_multi_remove_handle(multi_, easy);
+                if (easy == timeCurl_) {
+                    timeProbeDone(msg->data.result);
+                    continue;
+                }
+
+                Request* req = nullptr;
+                curl_easy_getinfo(easy, CURLINFO_PRIVATE, &req);
+                if (msg->data.result == CURLE_OK) {
+                    addTimeSample(clock_, easy, req->warmup, warmupStartRawNs);
+                    int64_t phasesUs[PhaseHistograms::PHASE_COUNT];
+                    PhaseHistograms::breakdown(easy, (ClockSync::rawNowNs() - warmupStartRawNs) / 1000,
+                                               req->firstByteUs, PhaseHistograms::nowUs(), phasesUs);
+                    timePhases_.record(phasesUs);
+                    // Request to first byte: the edge's latency without the handshake
+                    edges_.onAnswer(req->edge, phasesUs[PhaseHistograms::TTFB]);
+                } else {
+                    edges_.onError(req->edge);
+                }
+                long connects = 0;
+                curl_easy_getinfo(easy, CURLINFO_NUM_CONNECTS, &connects);
+                opened += connects;
+                if (config_.transport.http2) curl_easy_setopt(easy, CURLOPT_PIPEWAIT, 1L);
+                pending--;
+            }
+
+            if (pending > 0) curl_multi_poll(multi_, nullptr, 0, 100, nullptr);
+        }
 
-    while (!success && attempts < maxAttempts) {
-        attempts++;
+        // Warmup pointed handles at /time; switch them back to the order request
+        for (auto& req : requests_) {
+            req.tmpl->apply(req.curl);
+            curl_easy_setopt(req.curl, CURLOPT_WRITEFUNCTION, OrderResponseParser::writeCallback);
+            curl_easy_setopt(req.curl, CURLOPT_WRITEDATA, &req.response);
+        }
+        return opened;
+    }
 
-        // Fetch fresh server time every 100 requests to avoid timestamp drift
-        if (attempts % 100 == 1) {
-            std::string newTime = fetchServerTime(curl);
-            if (!newTime.empty()) {
-                serverTime = newTime;
+    // Edges to bind handles to: "edgeAddresses", or for hedging the pinned IPv4
+    // addresses (IPv6 only if there are none). No edges: curl picks the address.
+    void initEdges() {
+        const TransportConfig& transport = config_.transport;
+        std::vector<std::string> addresses;
+        if (!transport.edgeAddresses.empty()) {
+            ConnectionShare::splitAddresses(transport.edgeAddresses, addresses);
+        } else if (transport.hedgeCopies > 1) {
+            for (const auto& address : share_.addressList()) {
+                if (address[0] != '[') addresses.push_back(address);
             }
+            if (addresses.empty()) addresses = share_.addressList();
+        }
+        edges_.init(share_.host(), share_.port(), addresses);
+    }
+
+    // Handles take turns over the edges, so each edge gets its share of warm connections
+    void bindEdges() {
+        if (edges_.size() == 0) return;
+        for (size_t i = 0; i < requests_.size(); i++) {
+            requests_[i].edge = (int)(i % edges_.size());
+            edges_.bind(requests_[i].curl, requests_[i].edge);
+        }
+    }
+
+    // Re-validate every warm connection (reopening dropped ones) and report it
+    void heartbeat() {
+        auto heartbeatStart = Clock::now();
+        long opened = warmPool();
+        if (config_.transport.uring) opened += revalidateRing();
+        lastHeartbeatRawNs_ = ClockSync::rawNowNs();
+        connections_.heartbeats++;
+        *out_ << "HEARTBEAT:connections=" << warmCount_ + uring_.size() << ",reconnected=" << opened << ",ms="
+              << std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - heartbeatStart).count()
+              << std::endl;
+        out_->flush();
+    }
+
+    // Order requests over UringTransport, one persistent connection per pooled
+    // request (to the pinned address). Without io_uring, or if no connection
+    // comes up, the engine stays on curl.
+    void startUring() {
+        std::vector<std::string> addresses = share_.addressList();
+        std::string address = share_.pinned() && !addresses.empty() ? addresses[0] : "";
+        std::string reason;
+        if (!uring_.init(share_.host(), share_.port(), address, config_.transport.caFile, requests_.size(), reason)) {
+            config_.transport.uring = false;
+            *out_ << "TRANSPORT:curl,fallback=" << reason << std::endl;
+            return;
         }
+        *out_ << "TRANSPORT:uring,connections=" << uring_.size() << ",ktls_send=" << uring_.ktlsSend()
+              << ",ktls_recv=" << uring_.ktlsRecv() << std::endl;
+    }
+
+    // The ring's part of a heartbeat: reopen dropped connections, GET /time on
+    // the others, then reopen the ones that turned out dead
+    long revalidateRing() {
+        long opened = uring_.revalidate("/time");
+        auto deadline = Clock::now() + std::chrono::seconds(5);
+        while (uring_.revalidating() && Clock::now() < deadline) {
+            handleCompletions();
+            if (uring_.revalidating()) uring_.wait(100);
+        }
+        return opened + uring_.reopenClosed();
+    }
 
-        ResponseBuffer responseBuf;
-        auto start = std::chrono::high_resolution_clock::now();
-        CURLcode res = postOrder(curl, body, apiKey, secret, passphrase, address, serverTime, responseBuf);
-        auto end = std::chrono::high_resolution_clock::now();
+    // Keepalive while holding for the fire instant: nothing is in flight yet, and
+    // the pass (one RTT, more if a connection has to be reopened) ends well
+    // before the first planned send
+    void keepWarm() {
+        if (!syncing_ || config_.transport.heartbeatMs <= 0) return;
+        int64_t nowRaw = ClockSync::rawNowNs();
+        if (nowRaw - lastHeartbeatRawNs_ < (int64_t)config_.transport.heartbeatMs * 1000000) return;
+        if (clock_.serverMsAt(nowRaw) >= firstPlannedMs_ - HEARTBEAT_GUARD_MS) return;
+        heartbeat();
+    }
 
-        auto latencyMs = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
-        latencies.push_back(latencyMs);
+    void printDns() const {
+        if (!share_.pinned()) return;
+        *out_ << "DNS:host=" << share_.host() << ",addresses=" << share_.addresses()
+              << std::fixed << std::setprecision(1) << ",resolve_ms=" << share_.resolveMs() << std::endl;
+    }
 
+    void timeProbeDone(CURLcode res) {
+        timeInFlight_ = false;
         if (res == CURLE_OK) {
-            if (isSuccess(responseBuf.data, orderId)) {
-                success = true;
-                // NEW: Include orderIndex in output
-                std::cout << "ATTEMPT:" << orderIndex << ":" << attempts << ":" << latencyMs << ":true:" << orderId << std::endl;
-                std::cout.flush();
+            addTimeSample(clock_, timeCurl_, timeBuf_, timeSentRawNs_);
+            timePhases_.record(timeCurl_, (ClockSync::rawNowNs() - timeSentRawNs_) / 1000,
+                               timeFirstByteUs_, PhaseHistograms::nowUs());
+        }
+        if (syncing_) nextSyncRawNs_ = clock_.nextSampleAt(ClockSync::rawNowNs());
+    }
+
+    // GET /time on the dedicated handle; the response lands in clock_
+    void sendTimeProbe() {
+        prepareTimeRequest(timeCurl_, timeUrl_, timeBuf_);
+        timeFirstByteUs_ = 0;
+        timeSentRawNs_ = ClockSync::rawNowNs();
+        curl_multi_add_handle(multi_, timeCurl_);
+        timeInFlight_ = true;
+    }
+
+    // Current server second as the fixed-width POLY_TIMESTAMP (no allocation)
+    void currentTimestamp(char* out) const {
+        long long sec = clock_.nowServerMs() / 1000;
+        for (size_t i = RequestTemplate::TIMESTAMP_LEN; i-- > 0;) {
+            out[i] = (char)('0' + sec % 10);
+            sec /= 10;
+        }
+    }
+
+    void printClock() const {
+        long long wallMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        *out_ << "CLOCK:server_minus_wall_ms=" << (clock_.nowServerMs() - wallMs)
+              << std::fixed << std::setprecision(1)
+              << ",error_ms=" << clock_.errorMs() << ",drift_ppm=" << clock_.driftPpm()
+              << ",min_rtt_ms=" << clock_.minRttMs()
+              << ",samples=" << clock_.usedSamples() << "/" << clock_.sampleCount() << std::endl;
+    }
+
+    // Build each order's burst plan (or start immediately without fireAtMs)
+    void schedule(std::vector<OrderSlot>& slots) {
+        Clock::time_point now = Clock::now();
+        burstOffsetsMs_ = config_.burstOffsetsMs;
+        if (burstOffsetsMs_.empty()) burstOffsetsMs_.push_back(0);
+        std::sort(burstOffsetsMs_.begin(), burstOffsetsMs_.end());
+
+        // One queue per market, interleaved: while the rate budget is short every
+        // market takes its turn instead of the first one in the job taking it all
+        std::vector<std::string> markets;
+        std::vector<std::vector<OrderSlot*>> queues;
+        for (auto& slot : slots) {
+            size_t m = std::find(markets.begin(), markets.end(), slot.market) - markets.begin();
+            if (m == markets.size()) {
+                markets.push_back(slot.market);
+                queues.emplace_back();
+            }
+            queues[m].push_back(&slot);
+        }
+        launchOrder_.clear();
+        for (size_t k = 0; launchOrder_.size() < slots.size(); k++) {
+            for (const auto& queue : queues) {
+                if (k < queue.size()) launchOrder_.push_back(queue[k]);
+            }
+        }
+        launchCursor_ = 0;
+
+        // Plans stay in server time and are mapped to local time when due,
+        // so clock refinements before the fire instant still apply.
+        // Immediate starts are staggered so the orders' probes (batches) together
+        // sample the window evenly.
+        size_t streams = batchStreams(slots.size());
+        for (size_t i = 0; i < launchOrder_.size(); i++) {
+            OrderSlot& slot = *launchOrder_[i];
+            slot.plan.clear();
+            slot.planIndex = 0;
+            slot.nextSendAt = now + paceInterval() * (i / config_.transport.batchSize) / streams;
+            if (config_.fireAtMs <= 0) continue;
+
+            for (int offset : burstOffsetsMs_) {
+                slot.plan.push_back(config_.fireAtMs + offset);
+            }
+        }
+
+        if (config_.fireAtMs > 0) {
+            firstPlannedMs_ = config_.fireAtMs + burstOffsetsMs_.front();
+            syncing_ = true;
+            nextSyncRawNs_ = clock_.nextSampleAt(ClockSync::rawNowNs());
+
+            auto leadMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                clock_.localTimeFor(config_.fireAtMs) - now).count();
+            *out_ << "SCHEDULED:" << config_.fireAtMs << ":" << leadMs << std::endl;
+            out_->flush();
+        }
+    }
+
+    // Background clock sync while waiting for the fire instant
+    void syncClock() {
+        if (!syncing_ || timeInFlight_) return;
+
+        int64_t nowRaw = ClockSync::rawNowNs();
+        if (clock_.serverMsAt(nowRaw) >= firstPlannedMs_ - CLOCK_SYNC_QUIET_MS) {
+            // Freeze the estimate for the burst
+            syncing_ = false;
+            printClock();
+            out_->flush();
+            return;
+        }
+        if (nowRaw >= nextSyncRawNs_) sendTimeProbe();
+    }
+
+    // A free handle on the fastest edge that has one, starting at rank firstRank and
+    // skipping avoidEdges; any free handle when none matches
+    Request* takeRequest(int firstRank, uint32_t avoidEdges) {
+        size_t pick = freeList_.size() - 1;
+        int edgeCount = edges_.size();
+        bool found = false;
+        for (int k = 0; k < edgeCount && !found; k++) {
+            int edge = edges_.rank((firstRank + k) % edgeCount);
+            if (avoidEdges & (1u << edge)) continue;
+            for (size_t i = freeList_.size(); i-- > 0;) {
+                if (freeList_[i]->edge != edge) continue;
+                pick = i;
+                found = true;
+                break;
+            }
+        }
+        // On the ring, rather a handle whose connection is up than one still reopening
+        if (config_.transport.uring && !uring_.connected((int)(freeList_[pick] - requests_.data()))) {
+            for (size_t i = freeList_.size(); i-- > 0;) {
+                if (!uring_.connected((int)(freeList_[i] - requests_.data()))) continue;
+                pick = i;
+                break;
+            }
+        }
+        Request* req = freeList_[pick];
+        freeList_[pick] = freeList_.back();
+        freeList_.pop_back();
+        return req;
+    }
+
+    Request* sendRequest(OrderSlot& slot, int firstRank = 0, uint32_t avoidEdges = 0) {
+        Request* req = takeRequest(firstRank, avoidEdges);
+        slot.attempts++;
+        slot.inFlight++;
+        req->slot = &slot;
+        req->attempt = slot.attempts;
+        req->batchCount = 0;
+        dispatch(*req);
+        return req;
+    }
+
+    // One POST carrying every order in batch (count >= 1): their objects joined into one array
+    Request* sendBatch(OrderSlot* const* batch, int count, int firstRank = 0) {
+        Request* req = takeRequest(firstRank, 0);
+        std::string& body = req->batchBody;
+        body.clear();
+        body += '[';
+        for (int i = 0; i < count; i++) {
+            OrderSlot& slot = *batch[i];
+            if (i > 0) body += ',';
+            body.append(slot.body, slot.itemStart, slot.itemLength);
+            slot.attempts++;
+            slot.inFlight++;
+            req->batch[i] = {&slot, slot.attempts};
+        }
+        body += ']';
+        req->slot = batch[0];
+        req->attempt = batch[0]->attempts;
+        req->batchCount = count;
+        dispatch(*req);
+        return req;
+    }
+
+    // Sign and start a request whose orders are set
+    void dispatch(Request& req) {
+        bool first = !sent_;
+        sent_ = true;
+        char timestamp[RequestTemplate::TIMESTAMP_LEN];
+        currentTimestamp(timestamp);
+
+        req.planned = false;
+        req.hedgeOf = 0;
+        req.hedgeCopy = false;
+        prepareOrderRequest(req, signer_, timestamp);
+        if (config_.transport.uring) {
+            const std::string& body = req.batchCount > 0 ? req.batchBody : req.slot->body;
+            uring_.send((int)(&req - requests_.data()), "POST", ORDER_PATH, req.tmpl->headers(),
+                        body.data(), body.length(), &req.response);
+        } else {
+            curl_multi_add_handle(multi_, req.curl);
+        }
+        req.sentAt = Clock::now();
+        if (first) firstSendAt_ = req.sentAt;
+        if (wire_.enabled()) req.sentRealNs = WireTimestamps::realNowNs();
+        edges_.onSend(req.edge);
+
+        // HTTP/2 paces by send time; HTTP/1.1 re-arms on response
+        if (config_.transport.http2) {
+            for (int i = 0; i < req.orders(); i++) req.orderSlot(i).nextSendAt = req.sentAt + paceInterval();
+        }
+    }
+
+    bool batching() const { return config_.transport.batchSize > 1; }
+
+    // Requests that carry orderCount orders: one per order, or one per batch
+    size_t batchStreams(size_t orderCount) const {
+        size_t batchSize = (size_t)std::max(1, config_.transport.batchSize);
+        return (orderCount + batchSize - 1) / batchSize;
+    }
+
+    std::chrono::milliseconds paceInterval() const {
+        return std::chrono::milliseconds(rate_->ramping() ? config_.intervalMs : config_.probeIntervalMs);
+    }
+
+    // Rates cover all orders: one send per order (per batch) per interval
+    void startRateController(size_t orderCount) {
+        rate_.reset(new RateController(RateController::ratePerInterval(orderCount, config_.probeIntervalMs),
+                                       RateController::ratePerInterval(orderCount, config_.intervalMs),
+                                       perOrderInFlight_ * (int)orderCount));
+        if (config_.expectedOpenMs > 0) rate_->setExpectedOpen(clock_.localTimeFor(config_.expectedOpenMs));
+
+        Clock::time_point now = Clock::now();
+        RateController::Decision phase = rate_->update(now);
+        rate_->print(*out_, phase == RateController::NONE ? RateController::PROBE : phase, now);
+        *out_ << std::endl;
+    }
+
+    void updateRate(Clock::time_point now) {
+        RateController::Decision decision = rate_->update(now);
+        if (decision == RateController::NONE) return;
+        rate_->print(*out_, decision, now);
+        *out_ << std::endl;
+    }
+
+    // Apply what one order's response (item of a batch) says to every order
+    void applySignal(ResponseKind kind, long httpStatus, const Request& req, int item, Clock::time_point now) {
+        RateController::Decision decision = rate_->onResponse(kind, httpStatus, req.sentAt, now);
+        if (decision == RateController::NONE) return;
+        int orderIndex = req.orderSlot(item).orderIndex;
+        rate_->print(*out_, decision, now, orderIndex, req.orderAttempt(item), kind);
+        *out_ << std::endl;
+
+        if (decision == RateController::OPEN) {
+            *out_ << "SIGNAL:window_open:" << orderIndex << ":" << req.orderAttempt(item) << std::endl;
+            for (auto& slot : *slots_) {
+                if (!slot.done) slot.nextSendAt = std::min(slot.nextSendAt, now);
+            }
+        }
+    }
+
+    // Mark an order finished, withdraw its unsent requests and report it.
+    void finishSlot(OrderSlot& slot, const char* failReason) {
+        slot.done = true;
+        remaining_--;
+        cancelUnsent(slot);
+
+        if (slot.success) {
+            *out_ << "SUCCESS:" << slot.orderIndex << ":" << slot.orderId << std::endl;
+        } else {
+            *out_ << "FAILED:" << slot.orderIndex << ":" << failReason << std::endl;
+        }
+        out_->flush();
+    }
+
+    // Another order of slot's group filled: nothing more goes out for it. Requests
+    // already on the wire run on (the server may still fill them, and on HTTP/1.1
+    // cancelling would close their warm connections); it reports once they are in.
+    void stopForGroup(OrderSlot& slot) {
+        slot.groupFilled = true;
+        cancelUnsent(slot);
+        if (slot.inFlight == 0) finishSlot(slot, "group_filled");
+    }
+
+    // Withdraw the requests carrying slot that curl has not started sending yet
+    // (still waiting for a connection). A batch only once none of its orders still
+    // sends. The ring submits in the launch pass itself, so it has none.
+    void cancelUnsent(const OrderSlot& slot) {
+        if (config_.transport.uring) return;
+        for (auto& other : requests_) {
+            if (!other.slot) continue;
+            bool carries = false;
+            bool running = false;
+            for (int i = 0; i < other.orders(); i++) {
+                const OrderSlot& order = other.orderSlot(i);
+                carries = carries || &order == &slot;
+                running = running || !(order.done || order.groupFilled);
+            }
+            if (!carries || running) continue;
+            curl_off_t pretransferUs = 0;
+            curl_easy_getinfo(other.curl, CURLINFO_PRETRANSFER_TIME_T, &pretransferUs);
+            if (pretransferUs > 0) continue;
+            curl_multi_remove_handle(multi_, other.curl);
+            releaseRequest(other);
+        }
+    }
+
+    // Requests still out for finished orders (a late answer may be a fill)
+    bool draining() const {
+        for (const auto& req : requests_) {
+            if (req.slot) return true;
+        }
+        return false;
+    }
+
+    void launchDue() {
+        keepWarm();
+        syncClock();
+
+        Clock::time_point now = Clock::now();
+        updateRate(now);
+        if (batching()) {
+            launchBatches(now);
+            return;
+        }
+        bool throttled = false;
+        size_t count = launchOrder_.size();
+        size_t resumeAt = count;           // first order left waiting for a handle or a rate token
+        for (size_t k = 0; k < count; k++) {
+            size_t position = (launchCursor_ + k) % count;
+            OrderSlot& slot = *launchOrder_[position];
+            if (freeList_.empty()) {
+                resumeAt = position;
+                break;
+            }
+            if (slot.done || slot.groupFilled || slot.attempts >= config_.maxAttempts) continue;
+
+            // Planned burst sends ignore the per-order in-flight limit
+            if (slot.planIndex < slot.plan.size()) {
+                Clock::time_point plannedAt = clock_.localTimeFor(slot.plan[slot.planIndex]);
+                if (now < plannedAt) continue;
+
+                // Burst sends spread over the edges, fastest first
+                Request* req = sendRequest(slot, (int)slot.planIndex);
+                req->planned = true;
+                req->plannedAt = plannedAt;
+                req->plannedOffsetMs = burstOffsetsMs_[slot.planIndex];
+                slot.planIndex++;
+                continue;
+            }
+
+            // Next copy of a hedged attempt still without an answer, like planned
+            // sends outside the per-order limit and the rate window
+            if (slot.hedgeLive && slot.hedgeSent < config_.transport.hedgeCopies && now >= slot.hedgeNextAt) {
+                sendHedgeCopy(slot);
+                continue;
+            }
+
+            if (throttled || slot.inFlight - slot.stragglers >= perOrderInFlight_ || now < slot.nextSendAt) continue;
+            if (!rate_->tryAcquire(inFlight_)) {
+                throttled = true;
+                resumeAt = position;
+                continue;
+            }
+            Request* req = sendRequest(slot);
+            inFlight_++;
+            if (hedging()) startHedge(slot, *req);
+        }
+        // The order that missed out goes first next time (round robin over the queues)
+        if (resumeAt < count) launchCursor_ = resumeAt;
+    }
+
+    // Batch mode: due orders are packed batchSize per POST, in slot order. Planned
+    // sends due now form their own batches (outside the rate window like single
+    // planned sends); regular batches take one rate token each.
+    void launchBatches(Clock::time_point now) {
+        OrderSlot* planned[MAX_BATCH_ORDERS];
+        OrderSlot* regular[MAX_BATCH_ORDERS];
+        int plannedCount = 0;
+        int regularCount = 0;
+        int plannedBatches = 0;
+        Clock::time_point plannedAt;
+        int plannedOffsetMs = 0;
+        bool throttled = false;
+        int batchSize = config_.transport.batchSize;
+
+        auto flushPlanned = [&]() {
+            if (plannedCount == 0) return;
+            // Burst batches spread over the edges, fastest first
+            Request* req = sendBatch(planned, plannedCount, plannedBatches++);
+            req->planned = true;
+            req->plannedAt = plannedAt;
+            req->plannedOffsetMs = plannedOffsetMs;
+            for (int i = 0; i < plannedCount; i++) planned[i]->planIndex++;
+            plannedCount = 0;
+        };
+        auto flushRegular = [&]() {
+            if (regularCount == 0) return;
+            sendBatch(regular, regularCount);
+            inFlight_++;
+            regularCount = 0;
+        };
+
+        size_t count = launchOrder_.size();
+        size_t resumeAt = count;
+        for (size_t k = 0; k < count; k++) {
+            size_t position = (launchCursor_ + k) % count;
+            OrderSlot& slot = *launchOrder_[position];
+            if (slot.done || slot.groupFilled || slot.attempts >= config_.maxAttempts) continue;
+
+            if (slot.planIndex < slot.plan.size()) {
+                Clock::time_point due = clock_.localTimeFor(slot.plan[slot.planIndex]);
+                if (now < due) continue;
+                if (plannedCount == 0) {
+                    // Needs a handle of its own besides the open regular batch
+                    if (freeList_.size() < (regularCount > 0 ? 2u : 1u)) {
+                        resumeAt = position;
+                        break;
+                    }
+                    plannedAt = due;
+                    plannedOffsetMs = burstOffsetsMs_[slot.planIndex];
+                }
+                planned[plannedCount++] = &slot;
+                if (plannedCount == batchSize) flushPlanned();
+                continue;
+            }
+
+            if (throttled || slot.inFlight >= perOrderInFlight_ || now < slot.nextSendAt) continue;
+            if (regularCount == 0) {
+                if (freeList_.size() < (plannedCount > 0 ? 2u : 1u)) {
+                    resumeAt = position;
+                    break;
+                }
+                if (!rate_->tryAcquire(inFlight_)) {
+                    throttled = true;
+                    resumeAt = position;
+                    continue;
+                }
+            }
+            regular[regularCount++] = &slot;
+            if (regularCount == batchSize) flushRegular();
+        }
+        flushPlanned();
+        flushRegular();
+        if (resumeAt < count) launchCursor_ = resumeAt;
+    }
+
+    // Delay before the next send of a hedged attempt whose latest send went over edge
+    Clock::duration hedgeDelay(int edge) const {
+        if (config_.transport.hedgeDelayMs > 0) return std::chrono::milliseconds(config_.transport.hedgeDelayMs);
+        return std::chrono::microseconds(edges_.hedgeDelayUs(edge));
+    }
+
+    // HTTP/1.1 waits for each answer before the next attempt, so one slow path stalls
+    // the order; HTTP/2 sends every intervalMs regardless, and only routes by edge
+    bool hedging() const { return config_.transport.hedgeCopies > 1 && !config_.transport.http2 && !batching(); }
+
+    // A regular send opens a hedged attempt (the previous one is settled: one per order in flight)
+    void startHedge(OrderSlot& slot, Request& req) {
+        slot.hedgeLive = true;
+        slot.hedgeAttempt = req.attempt;
+        slot.hedgeSent = 1;
+        slot.hedgeInFlight = 1;
+        slot.hedgeEdges = 1u << req.edge;
+        slot.hedgeStartedAt = req.sentAt;
+        slot.hedgeNextAt = req.sentAt + hedgeDelay(req.edge);
+        req.hedgeOf = req.attempt;
+        hedge_.attempts++;
+    }
+
+    // Same order over the fastest edge the attempt has not used yet
+    void sendHedgeCopy(OrderSlot& slot) {
+        Request* req = sendRequest(slot, 0, slot.hedgeEdges);
+        req->hedgeOf = slot.hedgeAttempt;
+        req->hedgeCopy = true;
+        slot.hedgeSent++;
+        slot.hedgeInFlight++;
+        slot.hedgeEdges |= 1u << req->edge;
+        slot.hedgeNextAt = req->sentAt + hedgeDelay(req->edge);
+        hedge_.copies++;
+    }
+
+    // Hedge bookkeeping for a completed send. True if it settles its attempt: the
+    // first answer, or the last send of an attempt none answered. A send whose
+    // attempt was already answered only counts as late.
+    bool settleHedge(const Request& req, bool answered) {
+        OrderSlot& slot = *req.slot;
+        if (req.hedgeOf == 0) return true;
+        if (!slot.hedgeLive || req.hedgeOf != slot.hedgeAttempt) {
+            slot.stragglers--;
+            if (answered) hedge_.late++;
+            return false;
+        }
+
+        slot.hedgeInFlight--;
+        if (answered) {
+            if (req.hedgeCopy) hedge_.copyFirst++;
+            slot.hedgeLive = false;
+            slot.stragglers += slot.hedgeInFlight;
+            slot.hedgeInFlight = 0;
+            return true;
+        }
+        if (slot.hedgeInFlight > 0) {
+            // Transport error with a sibling still in flight: the next copy goes now
+            slot.hedgeNextAt = Clock::now();
+            return false;
+        }
+        slot.hedgeLive = false;
+        return true;
+    }
+
+    // One attempt (order of a batch) into the shared-memory ring, written in place (replaces the ATTEMPT: line)
+    void recordAttempt(const Request& req, int item, CURLcode res, long httpStatus, ResponseKind kind,
+                       const OrderResponse& response, Clock::time_point end, const int64_t phasesUs[]) {
+        AttemptRecord* record = ring_.claim();
+        if (!record) return;
+        record->sentNs = AttemptRingFile::steadyNs(req.sentAt);
+        record->doneNs = AttemptRingFile::steadyNs(end);
+        record->orderIndex = req.orderSlot(item).orderIndex;
+        record->attempt = req.orderAttempt(item);
+        record->setPhases(phasesUs);
+        record->setResult(res, httpStatus, kind, response);
+        if (req.planned) record->flags |= AttemptRecord::PLANNED;
+        if (req.conn.reused) record->flags |= AttemptRecord::REUSED;
+        if (req.conn.resumed) record->flags |= AttemptRecord::RESUMED;
+        if (req.hedgeCopy) record->flags |= AttemptRecord::HEDGE_COPY;
+        if (req.batchCount > 0) record->flags |= AttemptRecord::BATCHED;
+        ring_.publish(record);
+    }
+
+    // CLOB clock minus the unix clock, as the clock sync currently estimates it
+    int64_t serverOffsetUs() const {
+        int64_t wallMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        return (clock_.nowServerMs() - wallMs) * 1000;
+    }
+
+    // Segment of the attempt log for this run: its pacing and one row per order, in slot order
+    void beginLog(const std::vector<OrderSlot>& slots, uint64_t capacity) {
+        AttemptLogRun run;
+        run.serverOffsetUs = serverOffsetUs();
+        run.fireAtMs = config_.fireAtMs;
+        run.expectedOpenMs = config_.expectedOpenMs;
+        run.intervalMs = config_.intervalMs;
+        run.probeIntervalMs = config_.probeIntervalMs;
+        run.maxAttempts = config_.maxAttempts;
+        run.batchSize = config_.transport.batchSize;
+        if (config_.fireAtMs > 0) run.burstOffsetsMs = config_.burstOffsetsMs;
+        log_.begin(capacity, run);
+        for (const auto& slot : slots) log_.addOrder(slot.orderIndex, slot.market, slot.outcome, slot.price, slot.size);
+    }
+
+    // One attempt (order of a batch) into the run's log segment, alongside its ring record or ATTEMPT: line
+    void logAttempt(const Request& req, int item, CURLcode res, long httpStatus, ResponseKind kind,
+                    const OrderResponse& response, Clock::time_point end, const int64_t phasesUs[]) {
+        AttemptLogRecord* record = log_.claim();
+        if (!record) return;
+        log_.setTimes(record, req.sentAt, end);
+        record->order = (uint16_t)(&req.orderSlot(item) - slots_->data());
+        record->attempt = req.orderAttempt(item);
+        record->setPhases(phasesUs);
+        log_.setResult(record, res, httpStatus, kind, response);
+        if (req.planned) record->flags |= AttemptRecord::PLANNED;
+        if (req.conn.reused) record->flags |= AttemptRecord::REUSED;
+        if (req.conn.resumed) record->flags |= AttemptRecord::RESUMED;
+        if (req.hedgeCopy) record->flags |= AttemptRecord::HEDGE_COPY;
+        if (req.batchCount > 0) record->flags |= AttemptRecord::BATCHED;
+    }
+
+    // Return a request to the pool after completion or cancellation. A request
+    // cancelled on the ring keeps its connection until the answer is in (uringDone).
+    void releaseRequest(Request& req) {
+        for (int i = 0; i < req.orders(); i++) req.orderSlot(i).inFlight--;
+        if (!req.planned && !req.hedgeCopy) inFlight_--;
+        req.slot = nullptr;
+        req.batchCount = 0;
+        if (config_.transport.uring && uring_.busy((int)(&req - requests_.data()))) return;
+        freeList_.push_back(&req);
+    }
+
+    void handleCompletions() {
+        int queued = 0;
+        while (CURLMsg* msg = curl_multi_info_read(multi_, &queued)) {
+            if (msg->msg != CURLMSG_DONE) continue;
+
+            CURL* easy = msg->easy_handle;
+            CURLcode res = msg->data.result;
+            // The connection it used, while the transfer still points at it
+            curl_socket_t socket = CURL_SOCKET_BAD;
+            if (wire_.enabled() && easy != timeCurl_) curl_easy_getinfo(easy, CURLINFO_ACTIVESOCKET, &socket);
+            curl_multi_remove_handle(multi_, easy);
+
+            if (easy == timeCurl_) {
+                timeProbeDone(res);
+                continue;
+            }
+
+            Request* req = nullptr;
+            curl_easy_getinfo(easy, CURLINFO_PRIVATE, &req);
+
+            auto end = Clock::now();
+            int64_t phasesUs[PhaseHistograms::PHASE_COUNT] = {};
+            if (res == CURLE_OK) {
+                PhaseHistograms::breakdown(easy, std::chrono::duration_cast<std::chrono::microseconds>(end - req->sentAt).count(),
+                                           req->firstByteUs, PhaseHistograms::nowUs(), phasesUs);
+            }
+            long httpStatus = 0;
+            curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &httpStatus);
+            completeRequest(req, res, httpStatus, phasesUs, socket, end);
+        }
+
+        if (config_.transport.uring) {
+            uring_.reap([this](const UringTransport::Completion& done) { uringDone(done); });
+        }
+    }
+
+    // A request the ring finished, timed from the transport's own stamps
+    void uringDone(const UringTransport::Completion& done) {
+        Request& req = requests_[done.index];
+        if (!req.slot) {
+            freeList_.push_back(&req);  // cancelled while in flight, see releaseRequest()
+            return;
+        }
+        auto end = Clock::now();
+        req.conn.reused = done.reused;
+        req.conn.resumed = done.resumed;
+        int64_t phasesUs[PhaseHistograms::PHASE_COUNT] = {};
+        if (done.result == CURLE_OK) {
+            int64_t dispatchedUs = std::chrono::duration_cast<std::chrono::microseconds>(req.sentAt.time_since_epoch()).count();
+            UringTransport::breakdown(done, dispatchedUs, phasesUs);
+        }
+        completeRequest(&req, done.result, done.httpStatus, phasesUs, CURL_SOCKET_BAD, end);
+    }
+
+    // Report an answered (or failed) request and move its orders on: attempt
+    // records, fills, rate signal, hedge settlement, pacing. socket is the
+    // connection it ran on, for wire timestamps.
+    void completeRequest(Request* req, CURLcode res, long httpStatus, const int64_t phasesUs[],
+                         curl_socket_t socket, Clock::time_point end) {
+        auto latencyMs = std::chrono::duration_cast<std::chrono::milliseconds>(end - req->sentAt).count();
+        if (req->conn.reused) {
+            connections_.reused++;
+        } else {
+            connections_.opened++;
+            if (req->conn.resumed) connections_.resumed++;
+            if (req->attempt == 1) connections_.firstAttemptNew++;
+        }
+        if (res == CURLE_OK) orderPhases_.record(phasesUs);
+
+        // How far the actual release was from the planned instant
+        long deviationUs = 0;
+        if (req->planned) {
+            deviationUs = std::chrono::duration_cast<std::chrono::microseconds>(req->sentAt - req->plannedAt).count();
+            fireDeviationsUs_.push_back(deviationUs);
+        }
+
+        // Userspace latency split at the kernel's send/receive stamps (answered requests)
+        WireTimestamps::Breakdown wire{};
+        bool stamped = false;
+        if (wire_.enabled() && res == CURLE_OK) {
+            stamped = wire_.breakdown(socket, req->sentRealNs,
+                                      std::chrono::duration_cast<std::chrono::nanoseconds>(end - req->sentAt).count(), wire);
+            wireStats_.record(stamped ? &wire : nullptr);
+        }
+
+        // Per order (result item of a batch). Classified while it arrived;
+        // message/orderId are spans into the pooled buffer. Orders that finished
+        // while their batch was in flight are still reported, not updated.
+        int signalItem = 0;
+        ResponseKind signalKind = ResponseKind::TRANSPORT_ERROR;
+        for (int i = 0; i < req->orders(); i++) {
+            OrderSlot& slot = req->orderSlot(i);
+            int attempt = req->orderAttempt(i);
+            OrderResponse response = req->batchCount > 0 ? req->response.item(i) : req->response.result();
+            ResponseKind kind = classifyResponse(res, httpStatus, response);
+            if (!slot.done) {
+                slot.latencies.push_back(latencyMs);
+                if (res == CURLE_OK && response.filled()) {
+                    slot.success = true;
+                    slot.filledAt = end;
+                    slot.orderId = response.orderId.str();
+                }
+            }
+            if (req->planned) {
+                *out_ << "FIRE:" << slot.orderIndex << ":" << attempt << ":" << req->plannedOffsetMs
+                      << ":" << deviationUs << std::endl;
+            }
+            if (ring_.isOpen()) {
+                recordAttempt(*req, i, res, httpStatus, kind, response, end, phasesUs);
+            } else if (res == CURLE_OK) {
+                if (response.filled()) {
+                    *out_ << "ATTEMPT:" << slot.orderIndex << ":" << attempt << ":" << latencyMs << ":true:";
+                    out_->write(response.orderId.data, response.orderId.length) << std::endl;
+                } else {
+                    *out_ << "ATTEMPT:" << slot.orderIndex << ":" << attempt << ":" << latencyMs << ":false:";
+                    out_->write(response.message.data, response.message.length) << std::endl;
+                }
             } else {
-                std::string error = extractError(responseBuf.data);
-                std::cout << "ATTEMPT:" << orderIndex << ":" << attempts << ":" << latencyMs << ":false:" << error << std::endl;
-                std::cout.flush();
+                std::string curlError = curl_easy_strerror(res);
+                *out_ << "ATTEMPT:" << slot.orderIndex << ":" << attempt << ":" << latencyMs << ":false:curl_" << curlError << std::endl;
+            }
+            if (log_.active()) logAttempt(*req, i, res, httpStatus, kind, response, end, phasesUs);
+            if (stamped) {
+                *out_ << "WIRE:" << slot.orderIndex << ":" << attempt << ":user_us=" << wire.userUs
+                      << ",send_us=" << wire.sendUs << ",ack_us=" << wire.ackUs << ",wire_us=" << wire.wireUs
+                      << ",recv_us=" << wire.recvUs << ",hw=" << (wire.hardware ? 1 : 0) << "\n";
             }
+
+            // One signal per request: the first item showing the orderbook open, else the first
+            if (i == 0 || (!impliesWindowOpen(signalKind, httpStatus) && impliesWindowOpen(kind, httpStatus))) {
+                signalItem = i;
+                signalKind = kind;
+            }
+        }
+
+        applySignal(signalKind, httpStatus, *req, signalItem, end);
+        out_->flush();
+
+        // Any HTTP answer settles a hedged attempt; transport errors count against the edge
+        bool settled = settleHedge(*req, res == CURLE_OK);
+        if (settled && res == CURLE_OK) {
+            Clock::time_point startedAt = req->hedgeOf != 0 ? req->slot->hedgeStartedAt : req->sentAt;
+            answers_.record(std::chrono::duration_cast<std::chrono::microseconds>(end - startedAt).count());
+        }
+        if (res == CURLE_OK) {
+            edges_.onAnswer(req->edge, std::chrono::duration_cast<std::chrono::microseconds>(end - req->sentAt).count(),
+                            settled && req->hedgeOf != 0);
         } else {
-            std::string curlError = curl_easy_strerror(res);
-            std::cout << "ATTEMPT:" << orderIndex << ":" << attempts << ":" << latencyMs << ":false:curl_" << curlError << std::endl;
-            std::cout.flush();
+            edges_.onError(req->edge);
+        }
+
+        // The pooled request is reused from here on: take its orders first
+        OrderSlot* orders[MAX_BATCH_ORDERS];
+        int orderCount = req->orders();
+        for (int i = 0; i < orderCount; i++) orders[i] = &req->orderSlot(i);
+        releaseRequest(*req);
+
+        for (int i = 0; i < orderCount; i++) {
+            OrderSlot* slot = orders[i];
+            if (slot->done) continue;
+            bool planPending = slot->planIndex < slot->plan.size();
+            bool exhausted = slot->groupFilled || (slot->attempts >= config_.maxAttempts && !planPending);
+            if (slot->success || (exhausted && slot->inFlight == 0)) {
+                // A late fill of a stopped order still reports SUCCESS
+                finishSlot(*slot, slot->groupFilled ? "group_filled" : "max_attempts_reached");
+
+                // A fill stops the rest of its group
+                if (slot->success && !slot->group.empty()) {
+                    for (auto& other : *slots_) {
+                        if (other.done || other.groupFilled || other.group != slot->group) continue;
+                        stopForGroup(other);
+                    }
+                }
+            } else if (!config_.transport.http2 && !planPending && settled) {
+                // Interval between requests
+                slot->nextSendAt = end + paceInterval();
+            }
+        }
+    }
+
+    // Sleep until the next send or socket activity. Planned sends are released
+    // with timerfd + spin; regular pacing uses curl_multi_poll's ms timeout.
+    void waitForNextSend(const std::vector<OrderSlot>& slots) {
+        Clock::time_point now = Clock::now();
+        bool havePlanned = false;
+        Clock::time_point nextPlanned = Clock::time_point::max();
+        Clock::time_point nextToken = rate_->nextTokenAt(now);
+        bool windowFull = inFlight_ >= rate_->window();  // regular sends wait for a completion
+        int waitMs = 1000;
+
+        if (!freeList_.empty()) {
+            for (const auto& slot : slots) {
+                if (slot.done || slot.groupFilled || slot.attempts >= config_.maxAttempts) continue;
+
+                if (slot.planIndex < slot.plan.size()) {
+                    havePlanned = true;
+                    nextPlanned = std::min(nextPlanned, clock_.localTimeFor(slot.plan[slot.planIndex]));
+                    continue;
+                }
+                if (slot.hedgeLive && slot.hedgeSent < config_.transport.hedgeCopies) {
+                    auto untilUs = std::chrono::duration_cast<std::chrono::microseconds>(slot.hedgeNextAt - now).count();
+                    waitMs = std::min(waitMs, (int)std::max<long long>((untilUs + 999) / 1000, 0));
+                }
+                if (windowFull || slot.inFlight - slot.stragglers >= perOrderInFlight_) continue;
+                // Round token waits up: a token due in under 1ms must not turn into a busy loop
+                Clock::time_point due = std::max(slot.nextSendAt, nextToken);
+                auto untilUs = std::chrono::duration_cast<std::chrono::microseconds>(due - now).count();
+                long long untilMs = due > nextToken ? untilUs / 1000 : (untilUs + 999) / 1000;
+                waitMs = std::min(waitMs, (int)std::max<long long>(untilMs, 0));
+            }
+        }
+
+        // Wake for the next clock probe (ms precision is enough, its bounds are measured)
+        if (syncing_ && !timeInFlight_) {
+            long long untilMs = (nextSyncRawNs_ - ClockSync::rawNowNs()) / 1000000;
+            waitMs = std::min(waitMs, (int)std::max<long long>(untilMs, 0));
+        }
+        if (syncing_ && config_.transport.heartbeatMs > 0) {
+            long long untilMs = (lastHeartbeatRawNs_ - ClockSync::rawNowNs()) / 1000000 + config_.transport.heartbeatMs;
+            waitMs = std::min(waitMs, (int)std::max<long long>(untilMs, 0));
+        }
+        // Sends the kernel did not take yet go out with the next perform()
+        if (config_.transport.uring && uring_.pending()) waitMs = std::min(waitMs, 1);
+
+        if (havePlanned && PreciseWaiter::withinSpinWindow(nextPlanned)) {
+            PreciseWaiter::spinUntil(nextPlanned);
+            return;
+        }
+        if (waitMs <= 0) return;
+        // Time to spare goes to the service's background work, a step per wait
+        if (serviceWork_ && waitMs >= SERVICE_WORK_GUARD_MS &&
+            (!havePlanned || nextPlanned - Clock::now() > std::chrono::milliseconds(SERVICE_WORK_GUARD_MS))) {
+            serviceWork_ = serve_(serveContext_, true);
+            return;
+        }
+
+        struct curl_waitfd waitFds[3] = {};
+        unsigned waitCount = 0;
+        bool timerArmed = havePlanned && waiter_.arm(nextPlanned);
+        if (timerArmed) {
+            waitFds[waitCount].fd = waiter_.fd();
+            waitFds[waitCount++].events = CURL_WAIT_POLLIN;
+        }
+        unsigned serviceWait = waitCount;
+        if (serviceFd_ >= 0) {
+            waitFds[waitCount].fd = serviceFd_;
+            waitFds[waitCount++].events =
+                CURL_WAIT_POLLIN | (serviceOut_ && serviceOut_->pending() ? CURL_WAIT_POLLOUT : 0);
+        }
+        unsigned ringWait = waitCount;
+        if (config_.transport.uring) {
+            waitFds[waitCount].fd = uring_.eventFd();
+            waitFds[waitCount++].events = CURL_WAIT_POLLIN;
+        }
+
+        curl_multi_poll(multi_, waitCount ? waitFds : nullptr, waitCount, waitMs, nullptr);
+
+        // Off the send path: a planned send due now goes first
+        if (timerArmed) {
+            waiter_.drain();
+            if (PreciseWaiter::withinSpinWindow(nextPlanned)) PreciseWaiter::spinUntil(nextPlanned);
+        }
+        if (ringWait < waitCount && waitFds[ringWait].revents) uring_.drainEvents();
+        if (serviceWait < ringWait && waitFds[serviceWait].revents) serviceWork_ = serve_(serveContext_, false);
+    }
+
+    // One QUEUE: line per market when the orders carry one (multi-market jobs):
+    // fills, attempts and the first fill in ms since the run's first send
+    void printQueues(const std::vector<OrderSlot>& slots) const {
+        std::vector<std::string> markets;
+        for (const auto& slot : slots) {
+            if (!slot.market.empty() && std::find(markets.begin(), markets.end(), slot.market) == markets.end()) {
+                markets.push_back(slot.market);
+            }
+        }
+        for (const auto& market : markets) {
+            int orders = 0;
+            int filled = 0;
+            int attempts = 0;
+            long long firstFillMs = -1;
+            for (const auto& slot : slots) {
+                if (slot.market != market) continue;
+                orders++;
+                attempts += slot.attempts;
+                if (!slot.success) continue;
+                filled++;
+                long long fillMs = std::chrono::duration_cast<std::chrono::milliseconds>(slot.filledAt - firstSendAt_).count();
+                if (firstFillMs < 0 || fillMs < firstFillMs) firstFillMs = fillMs;
+            }
+            *out_ << "QUEUE:market=" << market << ",orders=" << orders << ",filled=" << filled
+                  << ",attempts=" << attempts << ",first_fill_ms=" << firstFillMs << std::endl;
         }
+    }
 
-        // Interval between requests
-        if (!success && intervalMs > 0) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+    void printFireStats() const {
+        if (fireDeviationsUs_.empty()) return;
+
+        long sumAbs = 0;
+        long maxAbs = 0;
+        for (long d : fireDeviationsUs_) {
+            long a = d < 0 ? -d : d;
+            sumAbs += a;
+            maxAbs = std::max(maxAbs, a);
         }
+        *out_ << "FIRE_STATS:count=" << fireDeviationsUs_.size()
+              << ",avg_abs_us=" << sumAbs / (long)fireDeviationsUs_.size()
+              << ",max_abs_us=" << maxAbs << std::endl;
     }
+};
+
+// Body of an order given as {"tokenId","price","size","side","expiration",...}; false if it has none
+bool signOrder(const std::string& order, OrderSigning& signing, std::string& body) {
+    OrderParams params;
+    params.tokenId = extractJsonString(order, "tokenId");
+    params.price = extractJsonDouble(order, "price", 0);
+    params.size = extractJsonDouble(order, "size", 0);
+    params.side = extractJsonString(order, "side") == "SELL" ? OrderSigner::SELL : OrderSigner::BUY;
+    params.expiration = extractJsonInt64(order, "expiration", 0);
+    params.feeRateBps = extractJsonInt(order, "feeRateBps", 0);
+    params.salt = (unsigned long long)extractJsonInt64(order, "salt", 0);
+    if (params.price <= 0 || params.size <= 0) return false;
+    return signing.signer.buildBody(params, signing.round, signing.owner, body);
+}
 
-    // Output result
-    if (success) {
-        std::cout << "SUCCESS:" << orderIndex << ":" << orderId << std::endl;
+// Pacing/fire fields and orders of one run (stdin config or a daemon SUBMIT).
+// Orders given as parameters keep an empty body; orderObjects holds each
+// order's JSON object for signJobOrder().
+void readJob(const std::string& json, EngineConfig& config, std::vector<OrderSlot>& slots,
+             std::vector<std::string>& orderObjects) {
+    config.maxAttempts = extractJsonInt(json, "maxAttempts", DEFAULT_MAX_ATTEMPTS);
+    config.intervalMs = extractJsonInt(json, "intervalMs", DEFAULT_INTERVAL_MS);
+    config.probeIntervalMs = extractJsonInt(json, "probeIntervalMs", config.intervalMs);
+    config.fireAtMs = extractJsonInt64(json, "fireAtMs", 0);
+    config.expectedOpenMs = extractJsonInt64(json, "expectedOpenMs", config.fireAtMs);
+    config.burstOffsetsMs = extractJsonIntArray(json, "burstOffsetsMs");
+    config.attemptRing = extractJsonString(json, "attemptRing");
+    config.attemptLog = extractJsonString(json, "attemptLog");
+
+    // Orders: "orders":[{"body":"...","orderIndex":0},...] or legacy single "body"
+    slots.clear();
+    orderObjects = extractJsonObjectArray(json, "orders");
+    if (orderObjects.empty()) {
+        OrderSlot slot;
+        slot.body = extractJsonString(json, "body");
+        slot.orderIndex = extractJsonInt(json, "orderIndex", 0);
+        slots.push_back(std::move(slot));
     } else {
-        std::cout << "FAILED:" << orderIndex << ":max_attempts_reached" << std::endl;
+        for (size_t i = 0; i < orderObjects.size(); i++) {
+            OrderSlot slot;
+            slot.body = extractJsonString(orderObjects[i], "body");
+            slot.orderIndex = extractJsonInt(orderObjects[i], "orderIndex", (int)i);
+            slot.group = extractJsonString(orderObjects[i], "group");
+            slot.market = extractJsonString(orderObjects[i], "market");
+            slot.outcome = extractJsonString(orderObjects[i], "outcome");
+            slot.price = extractJsonDouble(orderObjects[i], "price", 0);
+            slot.size = extractJsonDouble(orderObjects[i], "size", 0);
+            slots.push_back(std::move(slot));
+        }
     }
-    std::cout.flush();
+    for (auto& slot : slots) findBatchItem(slot);
+}
+
+// Sign order i of a read job if it was given as parameters; false if there was nothing to sign
+bool signJobOrder(const std::vector<std::string>& orderObjects, size_t i, OrderSigning* signing, OrderSlot& slot) {
+    if (!slot.body.empty() || !signing || i >= orderObjects.size()) return false;
+    if (signOrder(orderObjects[i], *signing, slot.body)) findBatchItem(slot);
+    return true;
+}
+
+bool haveBodies(const std::vector<OrderSlot>& slots) {
+    return std::none_of(slots.begin(), slots.end(), [](const OrderSlot& s) { return s.body.empty(); });
+}
+
+// readJob() with every order signed that needs it (signing given).
+// Returns false if there are no orders or one has no body.
+bool parseJob(const std::string& json, EngineConfig& config, std::vector<OrderSlot>& slots,
+              OrderSigning* signing) {
+    std::vector<std::string> orderObjects;
+    readJob(json, config, slots, orderObjects);
+    for (size_t i = 0; i < slots.size(); i++) signJobOrder(orderObjects, i, signing, slots[i]);
+    return haveBodies(slots);
+}
+
+std::atomic<bool> daemonStop{false};
 
-    // Calculate stats
-    if (!latencies.empty()) {
-        std::vector<long> sorted = latencies;
-        std::sort(sorted.begin(), sorted.end());
+void onDaemonSignal(int) { daemonStop = true; }
 
-        long sum = 0;
-        for (long l : latencies) sum += l;
+// MARKET frame answer for slug
+std::string marketStatus(MarketDiscovery* discovery, const std::string& slug) {
+    std::ostringstream status;
+    status << "MARKET:slug=" << slug;
+    if (!discovery) {
+        status << ",status=off";
+        return status.str();
+    }
+    MarketInfo market;
+    discovery->lookup(slug, market);
+    status << ",status=" << (market.complete() ? "ready" : market.listed() ? "listed" : "pending");
+    if (market.listed()) {
+        status << ",yes=" << market.yesTokenId << ",no=" << market.noTokenId
+               << ",accepting=" << market.acceptingOrdersTimestamp;
+    }
+    status << ",polls=" << market.polls;
+    return status.str();
+}
 
-        long minL = sorted.front();
-        long maxL = sorted.back();
-        long avg = sum / latencies.size();
-        long median = sorted[sorted.size() / 2];
+// A SUBMIT waiting for its run, prepared (read, then signed an order at a time)
+// from the waits of the run before it
+struct QueuedJob {
+    std::string payload;
+    bool read = false;
+    EngineConfig config;
+    std::vector<OrderSlot> slots;
+    std::vector<std::string> orderObjects;
+    size_t nextSign = 0;               // next order to sign if it was given as parameters
+};
 
-        std::cout << "STATS:min=" << minL << ",max=" << maxL << ",avg=" << avg
-                  << ",median=" << median << ",total=" << latencies.size() << std::endl;
-        std::cout.flush();
+// One step of preparing job: read it or sign one order. False once it is ready.
+bool prepareJob(QueuedJob& job, OrderSigning* signing) {
+    if (!job.read) {
+        readJob(job.payload, job.config, job.slots, job.orderObjects);
+        job.read = true;
+        return true;
     }
+    while (job.nextSign < job.slots.size()) {
+        size_t i = job.nextSign++;
+        if (signJobOrder(job.orderObjects, i, signing, job.slots[i])) return true;
+    }
+    return false;
+}
 
-    // Cleanup
-    curl_easy_cleanup(curl);
-    curl_global_cleanup();
+// One client connection of the daemon and its queue of submitted jobs
+struct DaemonSession {
+    SpamEngine* engine = nullptr;
+    MarketDiscovery* discovery = nullptr;
+    OrderSigning* signing = nullptr;
+    int clientFd = -1;
+    bool clientGone = false;           // hung up during a run; closed once the run is over
+    FrameReader reader;
+    FrameWriter out;                   // frames to the client, sent as its socket takes them
+    std::deque<QueuedJob> queued;      // SUBMITs, run in order
+    bool running = false;
+    int jobs = 0;
+    bool quit = false;
+};
+
+// Send what the client's socket takes, then read its frames: PING and MARKET are
+// answered, SUBMITs queued. False once the client is gone, fell FRAME_OUT_LIMIT
+// behind reading, or sent a frame of unknown type (closing it is the answer, so
+// every ERROR stays the answer to a SUBMIT). Frames read before a hang-up are
+// still served: a client's last QUIT often comes with its FIN.
+bool serveClient(DaemonSession& session) {
+    if (!session.out.flush()) return false;
+    bool open = session.reader.readFrom(session.clientFd);
+
+    FrameType type;
+    std::string payload;
+    while (session.reader.next(type, payload)) {
+        if (type == FRAME_QUIT) {
+            session.quit = true;
+        } else if (type == FRAME_PING) {
+            const ClockSync& clock = session.engine->clock();
+            std::ostringstream status;
+            status << "STATUS:jobs=" << session.jobs << ",queued=" << session.queued.size()
+                   << ",running=" << (session.running ? 1 : 0) << ",clock_error_ms=" << (long)clock.errorMs()
+                   << ",samples=" << clock.usedSamples() << "/" << clock.sampleCount();
+            session.out.send(FRAME_STATUS, status.str());
+        } else if (type == FRAME_MARKET) {
+            session.out.send(FRAME_STATUS, marketStatus(session.discovery, payload));
+        } else if (type == FRAME_SUBMIT) {
+            session.queued.emplace_back();
+            session.queued.back().payload = std::move(payload);
+        } else {
+            return false;
+        }
+    }
+    return open && !session.out.failed();
+}
+
+// Engine service hook while a run holds the thread: serve the client and, in
+// waits with time to spare (work), take one step of preparing the queued jobs.
+// True while a queued job may not be ready yet.
+bool serveDuringRun(void* context, bool work) {
+    DaemonSession& session = *static_cast<DaemonSession*>(context);
+    if (!serveClient(session)) {
+        session.clientGone = true;
+        session.engine->setService(-1, nullptr, nullptr);
+        return false;
+    }
+    if (!work) return !session.queued.empty();
+    for (auto& job : session.queued) {
+        if (prepareJob(job, session.signing)) return true;
+    }
+    return false;
+}
+
+void closeClient(DaemonSession& session) {
+    if (session.clientFd >= 0) close(session.clientFd);
+    session.clientFd = -1;
+    session.clientGone = false;
+    session.reader.clear();
+    session.out.reset(-1);
+    session.queued.clear();
+}
+
+// Run the next queued job, streaming its lines to the client; what the run
+// before it left unprepared is done here
+void runNextJob(DaemonSession& session, size_t maxOrders) {
+    QueuedJob queued = std::move(session.queued.front());
+    session.queued.pop_front();
+    while (prepareJob(queued, session.signing)) {
+    }
+
+    EngineConfig& job = queued.config;
+    std::vector<OrderSlot>& slots = queued.slots;
+    if (!haveBodies(slots)) {
+        session.out.send(FRAME_ERROR, session.signing ? "missing order body or invalid order" : "missing order body");
+        return;
+    }
+    if (slots.size() > maxOrders) {
+        // The pool and in-flight cap were sized for maxOrders at start
+        session.out.send(FRAME_ERROR, "more orders than maxOrders=" + std::to_string(maxOrders));
+        return;
+    }
+
+    SpamEngine& engine = *session.engine;
+    FrameStreamBuf lines(session.out);
+    std::ostream out(&lines);
+    engine.setOutput(out);
+    engine.setJob(job);
+    engine.setService(session.clientFd, serveDuringRun, &session, &session.out);
+    session.running = true;
+    bool allSuccess = engine.run(slots);
+    session.running = false;
+    engine.setService(-1, nullptr, nullptr);
+    out.flush();
+    engine.setOutput(std::cout);
+    session.jobs++;
+    session.out.send(FRAME_DONE, allSuccess ? "0" : "1");
+}
+
+/**
+ * Daemon mode ("daemonSocket" in the stdin config): warm up once, then serve
+ * jobs from one client at a time over a Unix socket (framing in
+ * daemon-ipc.hpp). Between jobs the engine re-validates its pool every
+ * "heartbeatMs" and keeps sampling /time, so a SUBMIT starts on warm
+ * connections with a current clock estimate: no process start, DNS, TCP or
+ * TLS before the first POST. A job's protocol lines stream back as LINE
+ * frames, followed by DONE with the exit code the process mode would return.
+ * Daemon-level lines (DAEMON:, HEARTBEAT:, CLOCK:, MARKET:found) stay on stdout.
+ * The client socket is non-blocking: frames queue in the session's FrameWriter
+ * and go out as it polls writable, so a client slow to read costs memory (up
+ * to FRAME_OUT_LIMIT, then it is dropped), never a stalled send.
+ *
+ * Jobs are pipelined: the client is served while a run holds the engine
+ * (from the run's waits, never between a planned send and its release), so
+ * the next slot's job can be submitted while the current one fires. SUBMITs
+ * queue up and run in order, each answered with its LINE frames and DONE (or
+ * ERROR). A queued job is read and its parameter orders signed during the
+ * run before it, a step (one order) per wait with SERVICE_WORK_GUARD_MS to
+ * spare, so it starts the moment that run ends; one with a later fireAtMs
+ * then holds the warm pool until its instant.
+ * STATUS carries queued=<jobs waiting> and running=0|1. A job may hold
+ * several markets' orders ("market" per order): they share the pool and the
+ * rate budget, launched round robin over the markets, with a QUEUE: line
+ * per market.
+ *
+ * With market discovery running, MARKET frames answer from its cache:
+ *   MARKET:slug=..,status=ready|listed|pending|off,yes=..,no=..,accepting=..,polls=..
+ *     ready: token IDs and acceptingOrdersTimestamp; listed: token IDs only
+ * With a signer, SUBMIT orders may be parameters instead of bodies, so a
+ * market's token IDs go from a MARKET answer into a job without a JS
+ * signing round.
+ */
+int runDaemon(SpamEngine& engine, const std::string& socketPath, size_t maxOrders, MarketDiscovery* discovery,
+              OrderSigning* signing) {
+    int listenFd = listenUnix(socketPath);
+    if (listenFd < 0) {
+        std::cerr << "ERROR: Failed to listen on " << socketPath << ": " << strerror(errno) << std::endl;
+        return 1;
+    }
+    signal(SIGTERM, onDaemonSignal);
+    signal(SIGINT, onDaemonSignal);
+    signal(SIGPIPE, SIG_IGN);
+    // Exit with the orchestrator instead of holding connections for nobody
+    prctl(PR_SET_PDEATHSIG, SIGTERM);
+
+    std::cout << "DAEMON:ready:socket=" << socketPath << std::endl;
+
+    DaemonSession session;
+    session.engine = &engine;
+    session.discovery = discovery;
+    session.signing = signing;
+    while (!session.quit && !daemonStop) {
+        struct curl_waitfd waitFds[2] = {};
+        unsigned waitCount = 0;
+        waitFds[waitCount].fd = listenFd;
+        waitFds[waitCount++].events = CURL_WAIT_POLLIN;
+        if (session.clientFd >= 0) {
+            waitFds[waitCount].fd = session.clientFd;
+            waitFds[waitCount++].events = CURL_WAIT_POLLIN | (session.out.pending() ? CURL_WAIT_POLLOUT : 0);
+        }
+        engine.idle(DAEMON_SYNC_INTERVAL_MS, waitFds, waitCount, 1000);
+        if (discovery) discovery->printEvents(std::cout);
+
+        // One client at a time: a new connection replaces the previous one
+        int accepted = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+        if (accepted >= 0) {
+            closeClient(session);
+            session.clientFd = accepted;
+            session.out.reset(accepted);
+        }
+        if (session.clientFd < 0) continue;
+
+        if (!serveClient(session)) {
+            closeClient(session);
+            continue;
+        }
+        // Frames that arrived during a run were served from it; its queue runs here
+        while (!session.queued.empty() && !session.quit && !daemonStop) {
+            runNextJob(session, maxOrders);
+            if (discovery) discovery->printEvents(std::cout);
+            if (session.clientGone) closeClient(session);
+        }
+    }
+
+    // QUIT's last DONE still goes out, but a client not reading cannot hold the exit
+    if (session.clientFd >= 0) session.out.drain(DAEMON_DRAIN_MS);
+    closeClient(session);
+    close(listenFd);
+    unlink(socketPath.c_str());
+    std::cout << "DAEMON:stopped:jobs=" << session.jobs << std::endl;
+    return 0;
+}
 
-    return success ? 0 : 1;
+// "replay": recorded runs of an attempt log (or its CSV export) re-run on a
+// simulated clock for every combination of the replay* lists (ReplaySimulator).
+// Lists left out replay as recorded. No connection at all.
+int runReplay(const std::string& json, const std::string& path) {
+    std::vector<ReplayScenario> scenarios;
+    size_t skipped = 0;
+    bool csv = path.size() > 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+    if (!(csv ? loadReplayCsv(path, scenarios, skipped) : loadReplayLog(path, scenarios, skipped))) {
+        std::cerr << "ERROR: Cannot read " << path << " (attempt log or attempt-log export --csv)" << std::endl;
+        return 1;
+    }
+    if (scenarios.empty()) {
+        std::cerr << "ERROR: No run in " << path << " saw the orderbook open (" << skipped << " skipped)" << std::endl;
+        return 1;
+    }
+    // A CSV has no pacing: the job's stands in for the recorded one
+    for (auto& scenario : scenarios) {
+        if (scenario.intervalMs > 0) continue;
+        scenario.intervalMs = extractJsonInt(json, "intervalMs", DEFAULT_INTERVAL_MS);
+        scenario.probeIntervalMs = extractJsonInt(json, "probeIntervalMs", scenario.intervalMs);
+        scenario.maxAttempts = extractJsonInt(json, "maxAttempts", DEFAULT_MAX_ATTEMPTS);
+    }
+
+    ReplayParams base;
+    base.http2 = extractJsonBool(json, "http2", false);
+    base.perOrderInFlight = base.http2 ? extractJsonInt(json, "maxInFlight", DEFAULT_HTTP2_MAX_IN_FLIGHT) : 1;
+    auto listOf = [&json](const char* key, int recorded) {
+        std::vector<int> values = extractJsonIntArray(json, key);
+        if (values.empty()) values.push_back(recorded);
+        return values;
+    };
+    std::vector<int> intervals = listOf("replayIntervalMs", ReplayParams::RECORDED);
+    std::vector<int> probeIntervals = listOf("replayProbeIntervalMs", ReplayParams::RECORDED);
+    std::vector<int> maxAttempts = listOf("replayMaxAttempts", ReplayParams::RECORDED);
+    std::vector<int> delayShifts = listOf("replayDelayShiftMs", 0);
+
+    auto start = Clock::now();
+    ReplaySimulator simulator;
+
+    // Each run as recorded next to its replay with the recorded pacing: how far the model is off
+    for (size_t i = 0; i < scenarios.size(); i++) {
+        const ReplayScenario& scenario = scenarios[i];
+        ReplayResult recorded;
+        ReplayResult replayed;
+        ReplayResult::recorded(scenario, recorded);
+        simulator.run(scenario, base, replayed);
+        std::cout << "REPLAY:run=" << i << ",markets=" << scenario.markets.size()
+                  << ",latency_samples=" << scenario.latencies.size() << ",limit_rps=" << (long)scenario.limitRps;
+        for (const auto& market : scenario.markets) {
+            if (market.closedUntilUs > 0 && market.openedByUs != INT64_MAX) {
+                std::cout << ",open_gap_us=" << std::max<int64_t>(0, market.openedByUs - market.closedUntilUs);
+                break;
+            }
+        }
+        std::cout << ",recorded:";
+        recorded.print(std::cout);
+        std::cout << ",replayed:";
+        replayed.print(std::cout);
+        std::cout << std::endl;
+    }
+
+    struct Combination {
+        ReplayParams params;
+        ReplayResult result;
+    };
+    std::vector<Combination> combinations;
+    int64_t replayedUs = 0;
+    for (int interval : intervals) {
+        for (int probeInterval : probeIntervals) {
+            for (int attempts : maxAttempts) {
+                for (int shift : delayShifts) {
+                    Combination combination;
+                    combination.params = base;
+                    combination.params.intervalMs = interval;
+                    combination.params.probeIntervalMs = probeInterval;
+                    combination.params.maxAttempts = attempts;
+                    combination.params.delayShiftMs = shift;
+                    for (const auto& scenario : scenarios) simulator.run(scenario, combination.params, combination.result);
+                    replayedUs += combination.result.replayedUs;
+                    combinations.push_back(std::move(combination));
+                }
+            }
+        }
+    }
+    std::stable_sort(combinations.begin(), combinations.end(), [](const Combination& a, const Combination& b) {
+        return a.result.betterThan(b.result);
+    });
+    auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+
+    auto value = [](int v) { return v == ReplayParams::RECORDED ? std::string("recorded") : std::to_string(v); };
+    for (size_t rank = 0; rank < combinations.size(); rank++) {
+        Combination& combination = combinations[rank];
+        std::cout << "SWEEP:rank=" << rank + 1 << ",interval_ms=" << value(combination.params.intervalMs)
+                  << ",probe_interval_ms=" << value(combination.params.probeIntervalMs)
+                  << ",max_attempts=" << value(combination.params.maxAttempts)
+                  << ",delay_shift_ms=" << combination.params.delayShiftMs << ",";
+        combination.result.print(std::cout);
+        std::cout << "\n";
+    }
+    std::cout << "REPLAY:done:runs=" << scenarios.size() << ",skipped=" << skipped
+              << ",combinations=" << combinations.size() << ",replayed_s=" << replayedUs / 1000000
+              << ",elapsed_ms=" << elapsedMs << std::endl;
+    return 0;
+}
+
+int main() {
+    // Read JSON config from stdin
+    std::stringstream buffer;
+    buffer << std::cin.rdbuf();
+    std::string inputJson = buffer.str();
+
+    if (inputJson.empty()) {
+        std::cerr << "ERROR: No input JSON provided via stdin" << std::endl;
+        return 1;
+    }
+
+    std::string replayPath = extractJsonString(inputJson, "replay");
+    if (!replayPath.empty()) return runReplay(inputJson, replayPath);
+
+    // Parse config
+    Credentials creds;
+    creds.apiKey = extractJsonString(inputJson, "apiKey");
+    creds.secret = extractJsonString(inputJson, "secret");
+    creds.passphrase = extractJsonString(inputJson, "passphrase");
+    creds.address = extractJsonString(inputJson, "address");
+
+    // Native signing: key set up (address, domain separator) before any order is parsed
+    std::unique_ptr<OrderSigning> signing;
+    std::string privateKey = extractJsonString(inputJson, "privateKey");
+    if (!privateKey.empty()) {
+        signing.reset(new OrderSigning());
+        long long chainId = extractJsonInt64(inputJson, "chainId", 137);
+        std::string exchange = extractJsonString(inputJson, "exchangeAddress");
+        if (exchange.empty()) exchange = OrderSigner::exchangeAddress(chainId, extractJsonBool(inputJson, "negRisk", false));
+        std::string tickSize = extractJsonString(inputJson, "tickSize");
+        signing->owner = creds.apiKey;
+        if (!signing->signer.init(privateKey, extractJsonString(inputJson, "funder"),
+                                  extractJsonInt(inputJson, "signatureType", 0), chainId, exchange) ||
+            !OrderSigner::roundConfig(tickSize.empty() ? "0.01" : tickSize, signing->round)) {
+            std::cerr << "ERROR: Invalid signing config (privateKey, exchangeAddress or tickSize)" << std::endl;
+            return 1;
+        }
+        OPENSSL_cleanse(&privateKey[0], privateKey.size());
+    }
+
+    EngineConfig config;
+    std::vector<OrderSlot> slots;
+    auto signStart = Clock::now();
+    bool haveOrders = parseJob(inputJson, config, slots, signing.get());
+    long parseUs = (long)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - signStart).count();
+
+    // Sign only: bodies to stdout, no connection at all
+    if (extractJsonBool(inputJson, "signOnly", false)) {
+        if (!signing || !haveOrders || creds.apiKey.empty()) {
+            std::cerr << "ERROR: signOnly needs privateKey, apiKey and valid orders" << std::endl;
+            return 1;
+        }
+        for (const auto& slot : slots) std::cout << "ORDER:" << slot.orderIndex << ":" << slot.body << std::endl;
+        std::cout << "SIGNED:orders=" << slots.size() << ",signer=" << signing->signer.address()
+                  << ",total_us=" << parseUs << std::endl;
+        return 0;
+    }
+
+    TransportConfig& transport = config.transport;
+    std::string clobUrl = extractJsonString(inputJson, "clobUrl");
+    if (!clobUrl.empty()) transport.baseUrl = clobUrl;
+    transport.caFile = extractJsonString(inputJson, "caFile");
+    transport.http2 = extractJsonBool(inputJson, "http2", false);
+    transport.maxConnections = extractJsonInt(inputJson, "maxConnections",
+                                              transport.http2 ? DEFAULT_HTTP2_CONNECTIONS : DEFAULT_MAX_CONNECTIONS);
+    transport.maxInFlight = extractJsonInt(inputJson, "maxInFlight",
+                                           transport.http2 ? DEFAULT_HTTP2_MAX_IN_FLIGHT : 0);
+    transport.pinDns = extractJsonBool(inputJson, "pinDns", true);
+    transport.heartbeatMs = extractJsonInt(inputJson, "heartbeatMs", DEFAULT_HEARTBEAT_MS);
+    transport.hedgeCopies = extractJsonInt(inputJson, "hedgeCopies", 1);
+    transport.hedgeDelayMs = extractJsonInt(inputJson, "hedgeDelayMs", 0);
+    transport.edgeAddresses = extractJsonString(inputJson, "edgeAddresses");
+    transport.batchSize = extractJsonInt(inputJson, "batchSize", 1);
+    if (!WireTimestamps::parseMode(extractJsonString(inputJson, "wireTimestamps"), transport.wireTimestamps) ||
+        (transport.wireTimestamps != WireTimestamps::OFF && transport.http2)) {
+        std::cerr << "ERROR: Invalid wireTimestamps (off, software or hardware; HTTP/1.1 only)" << std::endl;
+        return 1;
+    }
+    std::string transportName = extractJsonString(inputJson, "transport");
+    transport.uring = transportName == "uring";
+    if ((!transportName.empty() && transportName != "curl" && !transport.uring) ||
+        (transport.uring && (transport.http2 || transport.hedgeCopies > 1 || !transport.edgeAddresses.empty() ||
+                             transport.wireTimestamps != WireTimestamps::OFF))) {
+        std::cerr << "ERROR: Invalid transport (curl or uring; uring is HTTP/1.1 without hedging, edges or wireTimestamps)"
+                  << std::endl;
+        return 1;
+    }
+
+    ExecConfig exec;
+    exec.fifoPriority = extractJsonInt(inputJson, "fifoPriority", 0);
+    exec.lockMemory = extractJsonBool(inputJson, "lockMemory", false);
+    if (!ExecProfile::parseCpuList(extractJsonString(inputJson, "cpus"), exec.cpus) ||
+        !ExecProfile::parseCpuList(extractJsonString(inputJson, "helperCpus"), exec.helperCpus) ||
+        exec.fifoPriority < 0 || exec.fifoPriority > 99) {
+        std::cerr << "ERROR: Invalid execution profile (cpus, helperCpus or fifoPriority)" << std::endl;
+        return 1;
+    }
+
+    // Daemon: orders arrive later; the pool is sized for "maxOrders" with "burstOffsetsMs" bursts
+    std::string daemonSocket = extractJsonString(inputJson, "daemonSocket");
+    size_t orderCount = daemonSocket.empty() ? slots.size()
+                                             : (size_t)extractJsonInt(inputJson, "maxOrders", DEFAULT_DAEMON_MAX_ORDERS);
+    size_t burstCount = config.fireAtMs > 0 || !daemonSocket.empty()
+                            ? std::max<size_t>(1, config.burstOffsetsMs.size()) : 1;
+
+    if ((daemonSocket.empty() && !haveOrders) || creds.apiKey.empty() || creds.secret.empty() ||
+        creds.passphrase.empty() || creds.address.empty()) {
+        std::cerr << "ERROR: Missing required config fields" << std::endl;
+        return 1;
+    }
+
+    curl_global_init(CURL_GLOBAL_ALL);
+
+    int exitCode = 1;
+    {
+        SpamEngine engine(creds, config);
+        if (!engine.start(orderCount, burstCount)) {
+            curl_global_cleanup();
+            return 1;
+        }
+        if (daemonSocket.empty()) {
+            if (exec.any()) ExecProfile::apply(exec, {}, std::cout);
+            exitCode = engine.run(slots) ? 0 : 1;
+        } else {
+            // Market discovery runs on its own thread and curl handle next to the engine loop
+            MarketDiscovery discovery;
+            MarketDiscovery::Config market;
+            std::string gammaUrl = extractJsonString(inputJson, "gammaUrl");
+            if (!gammaUrl.empty()) market.gammaUrl = gammaUrl;
+            market.caFile = transport.caFile;
+            market.lookahead = extractJsonInt(inputJson, "marketLookahead", market.lookahead);
+            market.pollMs = extractJsonInt(inputJson, "marketPollMs", market.pollMs);
+            std::stringstream prefixes(extractJsonString(inputJson, "marketPrefixes"));
+            std::string prefix;
+            while (std::getline(prefixes, prefix, ',')) {
+                if (!prefix.empty()) market.prefixes.push_back(prefix);
+            }
+            bool discovering = !market.prefixes.empty() && discovery.start(market);
+            // After the helper thread exists, so it is not pinned next to the engine
+            if (exec.any()) {
+                std::vector<pthread_t> helpers;
+                if (discovering) helpers.push_back(discovery.nativeHandle());
+                ExecProfile::apply(exec, helpers, std::cout);
+            }
+            exitCode = runDaemon(engine, daemonSocket, orderCount, discovering ? &discovery : nullptr, signing.get());
+        }
+    }
+
+    curl_global_cleanup();
+    return exitCode;
 }